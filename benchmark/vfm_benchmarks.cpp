@@ -0,0 +1,708 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+///
+/// Microbenchmarks for the hot paths of vfm: parsing, simplification, JIT and compact evaluation, FSM stepping,
+/// vfmacro expansion, CEX parsing, state space exploration, event scheduling, polygon and text rasterization,
+/// view projection, GIF rendering and the constant passes of the C++ parser. All inputs are synthetic and generated
+/// from fixed seeds, nothing needs nuXmv or network access.
+///
+/// Usage:
+///   vfmBenchmarks [--filter <substring>] [--quick] [--min-time <seconds>] [--out <file.json>]
+///   vfmBenchmarks --compare <baseline.json> <current.json> [--threshold <percent>]
+///
+/// The first form runs the benchmarks and prints a table; with --out, the results are also written
+/// as JSON. The second form compares two such files by median latency and exits with 1 if any
+/// benchmark got slower by more than the threshold (default 10%).
+
+#include "parser.h"
+#include "data_pack.h"
+#include "fsm.h"
+#include "compact_term.h"
+#include "static_helper.h"
+#include "vfmacro/script.h"
+#include "simplification/simplification.h"
+#include "geometry/images.h"
+#include "geometry/gif_writer.h"
+#include "model_checking/model_checker.h"
+#include "simulation/highway_translators.h"
+#include "simulation/very_fast_simulation/event_calendar.h"
+#include "cpp_parsing/cpp_parser.h"
+#include "json_parsing/json.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace vfm;
+using json = nlohmann::json;
+
+namespace {
+
+struct Config {
+   bool quick_{ false };
+   double min_time_{ 1.0 };      // Seconds per benchmark, after one warm-up iteration.
+   int min_iterations_{ 5 };
+   int max_iterations_{ 100000 };
+   std::string filter_{};
+   std::string out_{};
+};
+
+/// A benchmark prepares its input outside of the measurement and returns the body to be timed.
+/// One call of the body is one iteration, processing items_per_iteration items.
+struct Benchmark {
+   std::string name_;
+   std::string subsystem_;
+   std::string unit_;            // What an item is.
+   std::function<std::function<void()>(const Config&, long& items_per_iteration)> prepare_;
+};
+
+struct Result {
+   std::string name_;
+   std::string subsystem_;
+   std::string unit_;
+   long iterations_{};
+   long items_per_iteration_{};
+   double min_ns_{}, mean_ns_{}, p50_ns_{}, p90_ns_{}, p99_ns_{}, max_ns_{};
+   double items_per_second_{};
+   long peak_rss_kb_{};
+};
+
+// --- Helpers ---
+
+long readProcStatusKb(const std::string& key)
+{
+   std::ifstream status{ "/proc/self/status" };
+   std::string line{};
+
+   while (std::getline(status, line)) {
+      if (StaticHelper::stringStartsWith(line, key + ":")) {
+         return std::stol(StaticHelper::removeWhiteSpace(line.substr(key.size() + 1)));
+      }
+   }
+
+   return -1;
+}
+
+/// Resets the peak RSS to the current RSS (Linux 4.0+), so each benchmark reports its own peak. Best effort.
+void resetPeakRss()
+{
+   std::ofstream clear_refs{ "/proc/self/clear_refs" };
+
+   if (clear_refs) clear_refs << "5";
+}
+
+double percentile(const std::vector<double>& sorted, const double p)
+{
+   if (sorted.empty()) return 0;
+   const double pos{ p * (sorted.size() - 1) };
+   const size_t low = pos;
+   const size_t high{ std::min(low + 1, sorted.size() - 1) };
+   return sorted[low] + (sorted[high] - sorted[low]) * (pos - low);
+}
+
+std::string randomFormula(std::mt19937& rng, const int depth, const int num_vars)
+{
+   static const std::vector<std::string> OPTORS{ "+", "-", "*", "/", "<", "==", "&&", "||", "max", "min" };
+
+   if (depth == 0) {
+      return rng() % 3 ? "x" + std::to_string(rng() % num_vars) : std::to_string(rng() % 10);
+   }
+
+   const std::string& op{ OPTORS[rng() % OPTORS.size()] };
+   const std::string left{ randomFormula(rng, depth - 1, num_vars) };
+   const std::string right{ randomFormula(rng, depth - 1, num_vars) };
+
+   return op.size() > 2 ? op + "(" + left + ", " + right + ")" : "(" + left + " " + op + " " + right + ")";
+}
+
+std::shared_ptr<DataPack> dataForVars(const int num_vars)
+{
+   auto data{ std::make_shared<DataPack>() };
+
+   for (int i = 0; i < num_vars; i++) {
+      data->addOrSetSingleVal("x" + std::to_string(i), (float) (i % 7) - 3);
+   }
+
+   return data;
+}
+
+/// A nuXmv-style counterexample with the given number of states and variables.
+std::string syntheticNusmvCex(const int num_states, const int num_vars)
+{
+   std::string cex{ "-- specification G !(env.cnt = 0) is false\n-- as demonstrated by the following execution sequence\n"
+      "Trace Description: LTL Counterexample\nTrace Type: Counterexample\n" };
+   std::mt19937 rng{ 7 };
+
+   for (int s = 1; s <= num_states; s++) {
+      if (s == num_states / 2) cex += "  -- Loop starts here\n";
+
+      cex += "  -> State: 1." + std::to_string(s) + " <-\n";
+
+      for (int v = 0; v < num_vars; v++) {
+         if (s == 1 || rng() % 4 == 0) {
+            cex += "    env.veh___6" + std::to_string(v) + "9___.v = " + std::to_string((int) (rng() % 100)) + "\n";
+         }
+      }
+   }
+
+   return cex;
+}
+
+/// A planner in the style of the dummy planner with num_blocks if statements on the gaps.
+std::string syntheticPlanner(const int num_blocks)
+{
+   std::string program{ R"(// #vfm-begin
+enum class ActionDir { LEFT = 0, CENTER = 1, RIGHT = 2, NONE = 3 };
+
+struct Gap {
+   int s_dist_front{256}; // #vfm-tal[[0..256]]
+   int v_front{70};       // #vfm-tal[[0..70]]
+};
+
+struct Agent {
+   int v{}; // #vfm-tal[[0..34]]
+   int a{}; // #vfm-tal[[-8..6]]
+   std::array<Gap, 3> gaps;
+};
+
+void plan(
+   Agent& agent // #vfm-aka[[ literal(ego) ]]
+   )
+{
+   // #vfm-gencode-begin[[ condition=false ]]
+   static constexpr int MIN_DIST = 14;
+   int acceleration = 0;
+)" };
+
+   for (int i = 0; i < num_blocks; i++) {
+      const std::string gap{ "agent.gaps[static_cast<int>(ActionDir::" + std::string(i % 3 == 0 ? "LEFT" : i % 3 == 1 ? "CENTER" : "RIGHT") + ")]" };
+      program += "   if (" + gap + ".s_dist_front < MIN_DIST + " + std::to_string(i) + ") {\n"
+         + "      acceleration = std::max(acceleration - " + gap + ".v_front, -8);\n   }\n";
+   }
+
+   return program + "   agent.a = acceleration;\n   // #vfm-gencode-end\n}\n// #vfm-end";
+}
+
+/// Parses a synthetic planner and returns the body which re-runs the constant passes of CppParser on it. After the
+/// first run, nothing is left to change, so this mainly measures the read-only phase which runs on num_threads threads.
+std::function<void()> cppParserConstPasses(const Config& config, long& items, const int num_threads)
+{
+   const std::string options{ "// #vfm-begin\n"
+      "// #vfm-option[[ general_mode << regular ]]\n"
+      "// #vfm-option[[ target_mc << nusmv ]]\n"
+      "// #vfm-option[[ inline_functions << always ]]\n"
+      "// #vfm-option[[ create_additional_files << none ]]\n"
+      "// #vfm-end" };
+   std::stringstream discard{};
+   const auto cout_buf{ std::cout.rdbuf(discard.rdbuf()) }; // CppParser resets its output levels when parsing, so mute it this way.
+   const auto parser{ std::make_shared<CppParser>(options) };
+   parser->parseProgram(syntheticPlanner(config.quick_ ? 10 : 100));
+   std::cout.rdbuf(cout_buf);
+   parser->setOutputLevels(ErrorLevelEnum::error);
+   parser->setNodeParallelism(num_threads, 128); // Small jobs, so the model spreads over all threads.
+   items = 0;
+
+   for (const auto& function : parser->getFunctionDefinitions()) {
+      items += function.second->getNodeCount();
+   }
+
+   return [parser]() {
+      parser->createConstantsFromPointRangeVariables();
+      parser->insertLiteralValuesForConstants();
+   };
+}
+
+// --- The benchmarks ---
+
+std::vector<Benchmark> allBenchmarks()
+{
+   std::vector<Benchmark> benchmarks{};
+
+   benchmarks.push_back({ "parsing/random_formula", "parsing", "chars", [](const Config& config, long& items) {
+      std::mt19937 rng{ 1 };
+      const auto formula{ randomFormula(rng, config.quick_ ? 8 : 12, 20) };
+      const auto parser{ SingletonFormulaParser::getInstance() };
+      items = formula.size();
+
+      return [formula, parser]() {
+         MathStruct::parseMathStruct(formula, parser);
+      };
+   } });
+
+   benchmarks.push_back({ "simplification/simplify_fast", "simplification", "nodes", [](const Config& config, long& items) {
+      std::mt19937 rng{ 2 };
+      const auto parser{ SingletonFormulaParser::getInstance() };
+      const auto formula{ MathStruct::parseMathStruct(randomFormula(rng, config.quick_ ? 6 : 9, 5), parser)->toTermIfApplicable() };
+      items = formula->getNodeCount();
+
+      return [formula, parser]() {
+         simplification::simplifyFast(formula->copy(), parser);
+      };
+   } });
+
+   benchmarks.push_back({ "jit/compile", "jit", "nodes", [](const Config& config, long& items) {
+      std::mt19937 rng{ 3 };
+      const auto parser{ SingletonFormulaParser::getInstance() };
+      const auto formula{ MathStruct::parseMathStruct(randomFormula(rng, config.quick_ ? 6 : 10, 20), parser)->toTermIfApplicable() };
+      const auto data{ dataForVars(20) };
+      items = formula->getNodeCount();
+
+      return [formula, parser, data]() {
+         formula->copy()->createAssembly(data, parser);
+      };
+   } });
+
+   benchmarks.push_back({ "jit/eval", "jit", "evaluations", [](const Config& config, long& items) {
+      std::mt19937 rng{ 4 };
+      const auto parser{ SingletonFormulaParser::getInstance() };
+      const auto formula{ MathStruct::parseMathStruct(randomFormula(rng, 10, 20), parser)->toTermIfApplicable() };
+      const auto data{ dataForVars(20) };
+      formula->createAssembly(data, parser);
+      items = config.quick_ ? 1000 : 100000;
+
+      return [formula, data, items]() {
+         volatile float sink{};
+         for (long i = 0; i < items; i++) sink = formula->eval(data);
+         (void) sink;
+      };
+   } });
+
+   benchmarks.push_back({ "jit/eval_interpreted", "jit", "evaluations", [](const Config& config, long& items) {
+      std::mt19937 rng{ 4 };
+      const auto parser{ SingletonFormulaParser::getInstance() };
+      const auto formula{ MathStruct::parseMathStruct(randomFormula(rng, 10, 20), parser)->toTermIfApplicable() };
+      const auto data{ dataForVars(20) };
+      items = config.quick_ ? 100 : 10000;
+
+      return [formula, data, items]() {
+         volatile float sink{};
+         for (long i = 0; i < items; i++) sink = formula->eval(data);
+         (void) sink;
+      };
+   } });
+
+   benchmarks.push_back({ "compact_term/eval", "compact_term", "evaluations", [](const Config& config, long& items) {
+      std::mt19937 rng{ 4 };
+      const auto parser{ SingletonFormulaParser::getInstance() };
+      const auto formula{ MathStruct::parseMathStruct(randomFormula(rng, 10, 20), parser)->toTermIfApplicable() };
+      formula->setChildrensFathers();
+      const auto compact{ std::make_shared<CompactFormula>(CompactFormula::fromTerm(formula)) };
+      const auto data{ dataForVars(20) };
+      items = config.quick_ ? 100 : 10000;
+
+      return [compact, data, items]() {
+         volatile float sink{};
+         for (long i = 0; i < items; i++) sink = compact->eval(data);
+         (void) sink;
+      };
+   } });
+
+   benchmarks.push_back({ "fsm/step", "fsm", "steps", [](const Config& config, long& items) {
+      constexpr int num_states{ 50 };
+      const auto parser{ SingletonFormulaParser::getInstance() };
+      auto fsm{ std::make_shared<fsm::FSMs>() };
+      fsm->getData()->addOrSetSingleVal("x", 0);
+
+      for (int s = 1; s <= num_states; s++) {
+         for (int k = 1; k <= 3; k++) {
+            const auto condition{ MathStruct::parseMathStruct("x % " + std::to_string(k + 2) + " == " + std::to_string(s % (k + 2)), parser)->toTermIfApplicable() };
+            fsm->addTransition(s, (s + k * 7) % num_states + 1, condition);
+         }
+      }
+
+      items = config.quick_ ? 100 : 10000;
+
+      return [fsm, items]() {
+         for (long i = 0; i < items; i++) {
+            fsm->getData()->addOrSetSingleVal("x", (float) (i % 97));
+            fsm->step();
+         }
+      };
+   } });
+
+   benchmarks.push_back({ "vfmacro/for_and_eval", "vfmacro", "chars out", [](const Config& config, long& items) {
+      const int loop_end{ config.quick_ ? 50 : 1000 };
+      const std::string script{ "@{var_[i] := [i];\n}@.for[[i], 0, " + std::to_string(loop_end) + "]\n@{1 + 2 * 3}@.eval\n" };
+      items = macro::Script::processScript(script).size();
+
+      return [script]() {
+         macro::Script::processScript(script);
+      };
+   } });
+
+   benchmarks.push_back({ "cex/parse_nusmv", "cex", "states", [](const Config& config, long& items) {
+      items = config.quick_ ? 50 : 1000;
+      const auto cex{ syntheticNusmvCex(items, 40) };
+
+      return [cex]() {
+         StaticHelper::extractMCTracesFromNusmv(cex);
+      };
+   } });
+
+   benchmarks.push_back({ "model_checking/acc_state_space", "model_checking", "states", [](const Config& config, long& items) {
+      const AccRanges ranges{ config.quick_ ? AccRanges{} : AccRanges{ 0, 8, 1, 3, 60, 3 } };
+      ExplorationOptions options{};
+      options.paint_states_ = false;
+
+      const auto explore = [ranges, options]() {
+         MC mc{ MC::createConfigSimpleACC(ranges) };
+         mc.setOutputLevels(ErrorLevelEnum::warning); // No progress notes within the measurement.
+         mc.generateModel(false, 10000000, 10000000, 100000, false, 1, true, options);
+         return mc.getLastExplorationStats().num_states_;
+      };
+
+      items = explore();
+
+      return [explore]() {
+         explore();
+      };
+   } });
+
+   benchmarks.push_back({ "simulation/event_calendar", "simulation", "events", [](const Config& config, long& items) {
+      const int num_slots{ config.quick_ ? 100 : 10000 };
+      constexpr double horizon{ 100 };
+
+      // Every plugin slot re-schedules itself periodically, like the plugins of SimulationTime.
+      const auto simulate = [num_slots, horizon]() {
+         EventCalendar calendar{};
+         long num_events{ 0 };
+
+         for (int slot = 0; slot < num_slots; slot++) {
+            calendar.schedule(1 + slot % 7, slot);
+         }
+
+         while (!calendar.empty() && calendar.nextTime() <= horizon) {
+            const double time{ calendar.nextTime() };
+
+            calendar.popAllAt(time, [&](const int slot) {
+               num_events++;
+               calendar.schedule(time + 1 + slot % 7, slot);
+            });
+         }
+
+         return num_events;
+      };
+
+      items = simulate();
+
+      return [simulate]() {
+         simulate();
+      };
+   } });
+
+   benchmarks.push_back({ "images/fill_polygons", "images", "polygons", [](const Config& config, long& items) {
+      std::mt19937 rng{ 5 };
+      std::vector<Pol2Df> polygons{};
+      items = config.quick_ ? 20 : 500;
+
+      for (long i = 0; i < items; i++) {
+         Pol2Df pol{};
+         const int num_points{ 3 + (int) (rng() % 6) };
+         for (int k = 0; k < num_points; k++) pol.add({ (float) (rng() % 640), (float) (rng() % 480) });
+         polygons.push_back(pol);
+      }
+
+      auto img{ std::make_shared<Image>(640, 480) };
+
+      return [img, polygons]() {
+         img->fillImg(BLACK);
+
+         for (size_t i = 0; i < polygons.size(); i++) {
+            img->fillPolygon(polygons[i], i % 2 ? RED : GREEN, i % 3 ? FillRule::even_odd : FillRule::non_zero, i % 2);
+         }
+      };
+   } });
+
+   benchmarks.push_back({ "images/write_ascii_text", "images", "chars", [](const Config& config, long& items) {
+      const std::string line{ "Speed: 42 km/h, lane 3 [ok]\n" };
+      const int num_lines{ config.quick_ ? 10 : 200 };
+      std::string text{};
+
+      for (int i = 0; i < num_lines; i++) text += line;
+
+      items = text.size();
+      auto img{ std::make_shared<Image>(400, 300) };
+
+      return [img, text]() {
+         img->fillImg(DARK_GREY);
+         img->writeAsciiText(10, 10, text, CoordTrans::dont_do_it, false, FUNC_IGNORE_BLACK_CONVERT_TO_YELLOW);
+      };
+   } });
+
+   benchmarks.push_back({ "images/view_projection", "images", "polygons", [](const Config& config, long& items) {
+      std::mt19937 rng{ 6 };
+      std::vector<Pol3D> polygons{};
+      items = config.quick_ ? 100 : 10000;
+
+      for (long i = 0; i < items; i++) {
+         const float x{ (float) (rng() % 200) - 50 };
+         const float y{ (float) (rng() % 20) - 10 };
+         polygons.push_back(Pol3D{ { { x, y, 0 }, { x, y + 2, 0 }, { x + 4, y + 2, 0 }, { x + 4, y, 0 } } });
+      }
+
+      auto trans{ std::make_shared<Plain3DTranslator>(false) };
+      trans->setHighwayData(500, 300, 0, 0, 1, 0, { 0, 0 });
+      trans->getPerspective()->parseProgram("Perspective [pos_xyz(-10,0,-3), rot_xyz<0.2,0,0>, disp_xyz{0.5,0.5,1}]");
+
+      return [trans, polygons]() {
+         trans->translatePolygons(polygons);
+      };
+   } });
+
+   benchmarks.push_back({ "gif/render_frames", "gif", "frames", [](const Config& config, long& items) {
+      constexpr int width{ 320 };
+      constexpr int height{ 200 };
+      const auto path{ (std::filesystem::temp_directory_path() / "vfm_benchmark.gif").string() };
+      items = config.quick_ ? 3 : 30;
+
+      return [path, items]() {
+         GifWriter writer{};
+         Image img{ width, height };
+         GifBegin(&writer, path.c_str(), width, height, 10);
+
+         for (long frame = 0; frame < items; frame++) {
+            img.fillImg(BLACK);
+
+            for (int car = 0; car < 8; car++) {
+               img.fillRectangle((frame * 7 + car * 40) % width, 20 + car * 22, 30, 14, car % 2 ? RED : GREEN);
+            }
+
+            img.writeAsciiText(10, height - 20, "frame " + std::to_string(frame));
+            const auto raw{ img.getRawImage() };
+            GifWriteFrame(&writer, (const uint8_t*) raw.data(), width, height, 10);
+         }
+
+         GifEnd(&writer);
+      };
+   } });
+
+   benchmarks.push_back({ "cpp_parser/const_passes_serial", "cpp_parser", "nodes", [](const Config& config, long& items) {
+      return cppParserConstPasses(config, items, 1);
+   } });
+
+   benchmarks.push_back({ "cpp_parser/const_passes_parallel", "cpp_parser", "nodes", [](const Config& config, long& items) {
+      return cppParserConstPasses(config, items, 0); // One thread per core.
+   } });
+
+   return benchmarks;
+}
+
+// --- Running ---
+
+Result run(const Benchmark& benchmark, const Config& config)
+{
+   Result result{};
+   result.name_ = benchmark.name_;
+   result.subsystem_ = benchmark.subsystem_;
+   result.unit_ = benchmark.unit_;
+
+   resetPeakRss();
+   const auto body{ benchmark.prepare_(config, result.items_per_iteration_) };
+   body(); // Warm-up.
+
+   std::vector<double> samples{};
+   const auto start{ std::chrono::steady_clock::now() };
+
+   while ((int) samples.size() < config.max_iterations_
+      && ((int) samples.size() < config.min_iterations_
+         || std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < config.min_time_)) {
+      const auto before{ std::chrono::steady_clock::now() };
+      body();
+      samples.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - before).count());
+   }
+
+   double total{ 0 };
+   for (const double sample : samples) total += sample;
+
+   std::sort(samples.begin(), samples.end());
+   result.iterations_ = samples.size();
+   result.min_ns_ = samples.front();
+   result.max_ns_ = samples.back();
+   result.mean_ns_ = total / samples.size();
+   result.p50_ns_ = percentile(samples, 0.5);
+   result.p90_ns_ = percentile(samples, 0.9);
+   result.p99_ns_ = percentile(samples, 0.99);
+   result.items_per_second_ = result.items_per_iteration_ * samples.size() / (total / 1e9);
+   result.peak_rss_kb_ = readProcStatusKb("VmHWM");
+
+   return result;
+}
+
+json toJson(const std::vector<Result>& results, const Config& config)
+{
+   json benchmarks = json::array();
+
+   for (const auto& r : results) {
+      benchmarks.push_back({
+         { "name", r.name_ },
+         { "subsystem", r.subsystem_ },
+         { "unit", r.unit_ },
+         { "iterations", r.iterations_ },
+         { "items_per_iteration", r.items_per_iteration_ },
+         { "latency_ns", { { "min", r.min_ns_ }, { "mean", r.mean_ns_ }, { "p50", r.p50_ns_ }, { "p90", r.p90_ns_ }, { "p99", r.p99_ns_ }, { "max", r.max_ns_ } } },
+         { "items_per_second", r.items_per_second_ },
+         { "peak_rss_kb", r.peak_rss_kb_ },
+      });
+   }
+
+   return {
+      { "context", {
+         { "timestamp", (long) std::time(nullptr) },
+         { "num_cpus", std::thread::hardware_concurrency() },
+         { "quick", config.quick_ },
+         { "min_time_s", config.min_time_ },
+      } },
+      { "benchmarks", benchmarks },
+   };
+}
+
+std::string formatNs(const double ns)
+{
+   std::stringstream s{};
+   s << std::fixed << std::setprecision(2);
+
+   if (ns >= 1e9) s << ns / 1e9 << " s";
+   else if (ns >= 1e6) s << ns / 1e6 << " ms";
+   else if (ns >= 1e3) s << ns / 1e3 << " us";
+   else s << ns << " ns";
+
+   return s.str();
+}
+
+int runBenchmarks(const Config& config)
+{
+   std::vector<Result> results{};
+
+   std::cout << std::left << std::setw(32) << "benchmark" << std::right << std::setw(8) << "iters" << std::setw(12) << "p50"
+      << std::setw(12) << "p90" << std::setw(12) << "p99" << std::setw(16) << "items/s" << std::setw(12) << "peak RSS" << std::endl;
+
+   for (const auto& benchmark : allBenchmarks()) {
+      if (!config.filter_.empty() && !StaticHelper::stringContains(benchmark.name_, config.filter_)) continue;
+
+      const auto r{ run(benchmark, config) };
+      results.push_back(r);
+
+      std::cout << std::left << std::setw(32) << r.name_ << std::right << std::setw(8) << r.iterations_ << std::setw(12) << formatNs(r.p50_ns_)
+         << std::setw(12) << formatNs(r.p90_ns_) << std::setw(12) << formatNs(r.p99_ns_) << std::setw(16) << (long) r.items_per_second_
+         << std::setw(9) << r.peak_rss_kb_ / 1024 << " MB" << std::endl;
+   }
+
+   if (!config.out_.empty()) {
+      std::ofstream out{ config.out_ };
+      out << toJson(results, config).dump(3) << std::endl;
+
+      if (!out) {
+         std::cerr << "Could not write '" << config.out_ << "'." << std::endl;
+         return 2;
+      }
+   }
+
+   return 0;
+}
+
+// --- Comparing ---
+
+int compare(const std::string& baseline_path, const std::string& current_path, const double threshold_percent)
+{
+   json baseline{};
+   json current{};
+
+   try {
+      std::ifstream(baseline_path) >> baseline;
+      std::ifstream(current_path) >> current;
+   }
+   catch (const std::exception& e) {
+      std::cerr << "Could not read benchmark results: " << e.what() << std::endl;
+      return 2;
+   }
+
+   std::map<std::string, double> baseline_p50{};
+
+   for (const auto& b : baseline["benchmarks"]) {
+      baseline_p50[b["name"].get<std::string>()] = b["latency_ns"]["p50"].get<double>();
+   }
+
+   int regressions{ 0 };
+
+   std::cout << std::left << std::setw(32) << "benchmark" << std::right << std::setw(12) << "baseline" << std::setw(12) << "current"
+      << std::setw(10) << "change" << std::endl;
+
+   for (const auto& c : current["benchmarks"]) {
+      const auto name{ c["name"].get<std::string>() };
+      const double now{ c["latency_ns"]["p50"].get<double>() };
+
+      if (!baseline_p50.count(name)) {
+         std::cout << std::left << std::setw(32) << name << std::right << std::setw(12) << "-" << std::setw(12) << formatNs(now) << "  (new)" << std::endl;
+         continue;
+      }
+
+      const double before{ baseline_p50.at(name) };
+      const double change{ before > 0 ? (now / before - 1) * 100 : 0 };
+      const bool regression{ change > threshold_percent };
+      regressions += regression;
+      baseline_p50.erase(name);
+
+      std::cout << std::left << std::setw(32) << name << std::right << std::setw(12) << formatNs(before) << std::setw(12) << formatNs(now)
+         << std::setw(9) << std::fixed << std::setprecision(1) << std::showpos << change << "%" << std::noshowpos
+         << (regression ? "  REGRESSION" : "") << std::endl;
+   }
+
+   for (const auto& missing : baseline_p50) {
+      std::cout << std::left << std::setw(32) << missing.first << "  (missing in current results)" << std::endl;
+   }
+
+   std::cout << regressions << " regression(s) beyond " << threshold_percent << "% in median latency." << std::endl;
+   return regressions ? 1 : 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+   Config config{};
+   std::vector<std::string> args(argv + 1, argv + argc);
+
+   if (!args.empty() && args[0] == "--compare") {
+      if (args.size() < 3) {
+         std::cerr << "Usage: vfmBenchmarks --compare <baseline.json> <current.json> [--threshold <percent>]" << std::endl;
+         return 2;
+      }
+
+      const double threshold{ args.size() >= 5 && args[3] == "--threshold" ? std::stod(args[4]) : 10.0 };
+      return compare(args[1], args[2], threshold);
+   }
+
+   for (size_t i = 0; i < args.size(); i++) {
+      const bool has_value{ i + 1 < args.size() };
+
+      if (args[i] == "--quick") {
+         config.quick_ = true;
+         config.min_time_ = 0.05;
+         config.min_iterations_ = 2;
+      }
+      else if (args[i] == "--filter" && has_value) config.filter_ = args[++i];
+      else if (args[i] == "--min-time" && has_value) config.min_time_ = std::stod(args[++i]);
+      else if (args[i] == "--out" && has_value) config.out_ = args[++i];
+      else {
+         std::cerr << "Unknown argument '" << args[i] << "'." << std::endl;
+         return 2;
+      }
+   }
+
+   return runBenchmarks(config);
+}
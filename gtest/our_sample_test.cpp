@@ -1,9 +1,32 @@
 #include "static_helper.h"
+#include "bracket_index.h"
 #include "testing/test_functions.h"
 #include "vfmacro/script.h"
+#include "model_checking/process_runner.h"
+#include "model_checking/model_checker.h"
+#include "model_checking/mc_build_graph.h"
+#include "model_checking/mc_portfolio.h"
+#include "model_checking/smv_parsing/smv_module.h"
+#include "fsm.h"
+#include "geometry/images.h"
+#include "compact_term.h"
+#include "cpp_parsing/cpp_lexer.h"
+#include "cpp_parsing/cpp_parser.h"
+#include "cpp_parsing/interval_analysis.h"
+#include "simulation/highway_translators.h"
+#include "simulation/road_graph.h"
+#include "simulation/road_graph_index.h"
+#include "simulation/very_fast_simulation/event_calendar.h"
+#include "xml/xml_writer.h"
+#include "model_checking/cex_processing/mc_trajectory_visualizers.h"
+#include "output_sink.h"
 #include <gtest/gtest.h>
+#include <chrono>
 #include <cstdint>
 #include <filesystem>
+#include <iostream>
+#include <random>
+#include <sstream>
 
 namespace fs = std::filesystem;
 
@@ -136,6 +159,975 @@ TEST(StaticTests, StaticHelper) {
 
 }
 
+TEST(McBuildGraphTests, SkipsOnlyUnchangedStages) {
+    const fs::path dir{ fs::temp_directory_path() / "vfm_build_graph_test" };
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const fs::path output{ dir / "mc_output.txt" };
+    vfm::StaticHelper::writeTextToFile("result", output);
+
+    {
+        vfm::mc::McBuildGraph graph{ dir };
+        graph.setInput("mc", "model", "MODULE main");
+        EXPECT_FALSE(graph.isUpToDate("mc", { output })); // Never built.
+        graph.markBuilt("mc");
+    }
+
+    vfm::mc::McBuildGraph unchanged{ dir }; // Reloaded from disk.
+    unchanged.setInput("mc", "model", "MODULE main");
+    EXPECT_TRUE(unchanged.isUpToDate("mc", { output }));
+    EXPECT_FALSE(unchanged.isUpToDate("preview", { output })); // Other stages are independent.
+
+    vfm::mc::McBuildGraph changed{ dir };
+    changed.setInput("mc", "model", "MODULE main -- changed");
+    EXPECT_FALSE(changed.isUpToDate("mc", { output }));
+
+    fs::remove(output);
+    EXPECT_FALSE(unchanged.isUpToDate("mc", { output }));
+
+    fs::remove_all(dir);
+}
+
+#if __linux__
+TEST(ProcessRunnerTests, StubModelChecker) {
+    const fs::path stub{ fs::temp_directory_path() / "vfm_stub_nuxmv.sh" };
+    vfm::StaticHelper::writeTextToFile(R"(#!/bin/sh
+echo "-- invariant x < 1 is false"
+echo "Trace Description: AG alpha Counterexample"
+echo "Trace Type: Counterexample"
+echo "  -> State: 1.1 <-"
+echo "    x = 0"
+echo "  -> State: 1.2 <-"
+echo "    x = 1"
+echo "-- invariant x < 5 is true"
+sleep 30
+)", stub);
+    fs::permissions(stub, fs::perms::owner_all);
+
+    vfm::mc::ProcessRunner runner{};
+    vfm::mc::ProcessLimits limits{};
+    limits.wall_clock_seconds = 2;
+    int cex_steps{ 0 };
+    bool cex_before_end{ false };
+    vfm::mc::NusmvCexStreamer streamer{ [&cex_steps, &cex_before_end, &runner](const vfm::MCTrace& trace, const int cex_num) {
+        cex_steps = trace.size();
+        cex_before_end = runner.isRunning();
+    } };
+
+    const auto stats{ runner.run({ "/bin/sh", stub.string() }, {}, limits, [&streamer](const std::string& chunk) { streamer.feed(chunk); }) };
+    streamer.finish();
+
+    EXPECT_TRUE(stats.spawned);
+    EXPECT_TRUE(stats.timed_out);
+    EXPECT_FALSE(stats.isSuccess());
+    EXPECT_LT(stats.wall_time, std::chrono::seconds(10));
+    EXPECT_EQ(streamer.getNumCexsFound(), 1);
+    const auto batch_traces{ vfm::StaticHelper::extractMCTracesFromNusmv(streamer.getFullOutput()) }; // Two states, each followed by a planner step.
+    ASSERT_EQ(batch_traces.size(), 1);
+    EXPECT_EQ(cex_steps, batch_traces[0].size());
+    EXPECT_EQ(cex_steps, 4);
+    EXPECT_TRUE(cex_before_end);
+
+    const auto stats_exit{ runner.run({ "/bin/sh", "-c", "exit 3" }) };
+    EXPECT_EQ(stats_exit.exit_code, 3);
+    EXPECT_FALSE(stats_exit.timed_out);
+
+    vfm::mc::ProcessLimits memory_limits{};
+    memory_limits.memory_bytes = 512 * 1024 * 1024;
+    std::string limit_output{};
+    const auto stats_limit{ runner.run({ "/bin/sh", "-c", "ulimit -v" }, {}, memory_limits, [&limit_output](const std::string& chunk) { limit_output += chunk; }) };
+    EXPECT_EQ(stats_limit.exit_code, 0);
+    EXPECT_EQ(vfm::StaticHelper::trimAndReturn(limit_output), "524288"); // Active right from the start of the process.
+}
+#endif
+
+TEST(McPortfolioTests, ClassifyOutput) {
+    using vfm::mc::McPortfolio;
+    using vfm::mc::McVerdict;
+
+    EXPECT_EQ(McPortfolio::classifyNuXmvOutput("-- invariant x < 5 is true\n-- invariant x < 1 is false\n"), McVerdict::falsified);
+    EXPECT_EQ(McPortfolio::classifyNuXmvOutput("-- invariant x < 5 is true\n  -- LTL specification G x < 7 is true\n"), McVerdict::proved);
+    EXPECT_EQ(McPortfolio::classifyNuXmvOutput("-- invariant x < 5 is true\n-- no counterexample found with bound 10\n"), McVerdict::inconclusive);
+    EXPECT_EQ(McPortfolio::classifyNuXmvOutput("x is true\nnuXmv > quit\n"), McVerdict::inconclusive); // Not a verdict line.
+    EXPECT_EQ(McPortfolio::classifyNuXmvOutput(""), McVerdict::inconclusive);
+}
+
+TEST(McPortfolioTests, OrderByPastWins) {
+    const fs::path stats_path{ fs::temp_directory_path() / "vfm_portfolio_statistics_test.json" };
+    const auto variants{ vfm::mc::McPortfolio::createDefaultVariants(vfm::mc::PORTFOLIO_TEMPLATE_INVAR, "go_msat\nmsat_check_invar_bmc -k 40\nquit\n") };
+    const auto names = [](const std::vector<vfm::mc::PortfolioVariant>& vs) {
+        std::vector<std::string> res{};
+        for (const auto& v : vs) res.push_back(v.name_);
+        return res;
+    };
+
+    ASSERT_EQ(names(variants), (std::vector<std::string>{ "bmc_k10", "bmc_k40", "ic3", "bdd" }));
+
+    fs::remove(stats_path);
+    vfm::mc::McPortfolio portfolio{ stats_path };
+    EXPECT_EQ(names(portfolio.orderByPastWins(vfm::mc::PORTFOLIO_TEMPLATE_INVAR, variants)), names(variants)); // No statistics yet.
+
+    vfm::StaticHelper::writeTextToFile(R"({ "invar": { "ic3": { "runs": 5, "wins": 3 }, "bdd": { "runs": 5, "wins": 1 } }, "ltl": { "bmc_k40": { "runs": 1, "wins": 9 } } })", stats_path);
+    EXPECT_EQ(names(portfolio.orderByPastWins(vfm::mc::PORTFOLIO_TEMPLATE_INVAR, variants)), (std::vector<std::string>{ "ic3", "bdd", "bmc_k10", "bmc_k40" }));
+
+    vfm::StaticHelper::writeTextToFile("{ corrupt", stats_path);
+    EXPECT_EQ(names(portfolio.orderByPastWins(vfm::mc::PORTFOLIO_TEMPLATE_INVAR, variants)), names(variants));
+
+    fs::remove(stats_path);
+}
+
+TEST(RoadGraphIndexTests, SameAnswersAsRoadGraph) {
+    std::vector<std::shared_ptr<vfm::RoadGraph>> nodes{};
+    for (int id = 0; id < 5; id++) {
+        nodes.push_back(std::make_shared<vfm::RoadGraph>(id));
+        nodes.back()->setMyRoad(vfm::StraightRoadSection{ 2, 2, 50.0f + id, vfm::LANE_WIDTH_M });
+        nodes.back()->setOriginPoint({ 200.0f * id, 0 });
+    }
+    nodes[0]->addSuccessor(nodes[1]);
+    nodes[1]->addSuccessor(nodes[2]);
+    nodes[1]->addSuccessor(nodes[3]);
+    nodes[3]->addSuccessor(nodes[4]);
+    nodes[4]->addSuccessor(nodes[0]); // Circular.
+
+    vfm::RoadGraphIndex index{ nodes[2] }; // Not the root, predecessors have to be found, too.
+    ASSERT_EQ(index.size(), (int) nodes[0]->getAllNodes().size());
+    EXPECT_EQ(index.getAllNodes(), nodes[2]->getAllNodes()); // Same traversal order.
+
+    for (const auto& node : nodes) {
+        const int i{ index.indexOf(node->getID()) };
+        ASSERT_GE(i, 0);
+        EXPECT_EQ(index.findSectionWithID(node->getID()), nodes[0]->findSectionWithID(node->getID()));
+        EXPECT_EQ(index.getSection(i).length_, node->getMyRoad().getLength());
+
+        std::vector<int> successor_ids{};
+        for (const int succ : index.getSuccessorIndices(i)) successor_ids.push_back(index.getSection(succ).id_);
+        std::vector<int> expected_ids{};
+        for (const auto& succ : node->getSuccessors()) expected_ids.push_back(succ->getID());
+        EXPECT_EQ(successor_ids, expected_ids);
+
+        const auto at_origin{ index.querySectionsAt(node->getOriginPoint()) };
+        EXPECT_NE(std::find(at_origin.begin(), at_origin.end(), i), at_origin.end());
+    }
+
+    EXPECT_EQ(index.indexOf(42), -1);
+    EXPECT_EQ(index.findSectionWithID(42), nullptr);
+    EXPECT_TRUE(index.querySections(vfm::Rec2D{ { 5000, 5000 }, { 6000, 6000 } }).empty());
+    EXPECT_EQ(index.querySections(vfm::Rec2D{ { 390, -1 }, { 410, 1 } }), std::vector<int>{ index.indexOf(2) });
+
+    // Ego is scanned for directly, other cars are only seen by the car index after a refresh.
+    EXPECT_EQ(index.findSectionWithEgoIfAny(), nullptr);
+    nodes[3]->getMyRoad().setEgo(std::make_shared<vfm::CarPars>(0, 10, 5, vfm::RoadGraph::EGO_MOCK_ID, vfm::CarDimensions{}));
+    nodes[4]->getMyRoad().addOther(vfm::CarPars{ 1, 20, 5, 7, vfm::CarDimensions{} });
+    EXPECT_EQ(index.findSectionWithEgoIfAny(), nodes[3]);
+    EXPECT_EQ(index.findEgo().on_section_or_origin_section_, nodes[0]->findEgo().on_section_or_origin_section_);
+    EXPECT_EQ(index.findSectionWithCar(7), nullptr);
+
+    index.refreshCarIndex();
+    EXPECT_EQ(index.findSectionWithCar(7), nodes[0]->findSectionWithCar(7));
+    EXPECT_EQ(index.findSectionWithCar(vfm::RoadGraph::EGO_MOCK_ID), nodes[3]);
+
+    index.cleanFromAllCars();
+    EXPECT_EQ(nodes[0]->findSectionWithEgoIfAny(), nullptr);
+    EXPECT_EQ(index.findEgo().the_car_, nullptr);
+    EXPECT_EQ(index.findSectionWithCar(7), nullptr);
+}
+
+TEST(XmlWriterTests, StreamingOsmEqualsCodeXml) {
+    vfm::StraightRoadSection section1{ 3, 3, 50, vfm::LANE_WIDTH_M };
+    vfm::StraightRoadSection section2{ 2, 2, 60, vfm::LANE_WIDTH_M };
+    section1.addLaneSegment({ 0, 0, 4 });
+    section2.addLaneSegment({ 0, 0, 2 });
+    section2.addLaneSegment({ 30, 2, 4 });
+
+    auto r1 = std::make_shared<vfm::RoadGraph>(1);
+    auto r2 = std::make_shared<vfm::RoadGraph>(2);
+    r1->setMyRoad(section1);
+    r1->setOriginPoint({ 0, 6 });
+    r1->setAngle(0);
+    r2->setMyRoad(section2);
+    r2->setOriginPoint({ 75, 20 });
+    r2->setAngle(3.1415 / 2.1);
+    r1->addSuccessor(r2);
+
+    vfm::resetOSMIdCounter();
+    const std::string legacy{ r1->generateOSM()->serializeBlock() };
+
+    vfm::resetOSMIdCounter();
+    vfm::StringSink sink{};
+    {
+        vfm::xml::XmlWriter writer{ sink };
+        r1->generateOSM(writer);
+        EXPECT_EQ(writer.getDepth(), 0);
+    }
+
+    EXPECT_FALSE(legacy.empty());
+    EXPECT_EQ(sink.str(), legacy);
+}
+
+TEST(XmlWriterTests, Escaping) {
+    vfm::StringSink sink{};
+    vfm::xml::XmlWriter writer{ sink, vfm::xml::XmlFormat{ false, "", "/>" } };
+    writer.startElement("a", { { "x", "1 < 2 & \"3\"" } }).textElement("b", {}, "it's <b>").endElement();
+
+    EXPECT_EQ(sink.str(), "<a x=\"1 &lt; 2 &amp; &quot;3&quot;\"><b>it&apos;s &lt;b&gt;</b></a>");
+}
+
+// Small synthetic CEX: ego, one vehicle changing lanes, one vehicle keeping its lane; four
+// EnvironmentModel/TacticalPlanner step pairs as produced by the model checker.
+static vfm::MCTrace syntheticLaneChangeTrace() {
+    vfm::MCTrace trace{};
+
+    for (int i = 0; i < 4; i++) {
+        vfm::VarVals vals{
+            { "num_lanes", "3" }, { "num_technical_lanes", "3" }, { "lane_width", "350" },
+            { "ego.v", std::to_string(20 + i) }, { "ego.a", "1" }, { "ego.abs_pos", std::to_string(20 * i + i * i / 2) },
+            { "ego.on_straight_section", "0" }, { "ego.traversion_from", "-1" }, { "ego.traversion_to", "-1" },
+            { "veh___609___.on_lane", std::to_string(i < 2 ? 0 : 2) },
+            { "veh___609___.v", std::to_string(25 - i) }, { "veh___609___.a", "-1" }, { "veh___609___.abs_pos", std::to_string(30 + 25 * i) },
+            { "veh___609___.on_straight_section", "0" }, { "veh___609___.traversion_from", "-1" }, { "veh___609___.traversion_to", "-1" },
+            { "veh___609___.turn_signals", i == 1 ? "ActionDir____LEFT" : "ActionDir____CENTER" },
+            { "veh___619___.on_lane", "4" },
+            { "veh___619___.v", "18" }, { "veh___619___.a", "0" }, { "veh___619___.abs_pos", std::to_string(60 + 18 * i) },
+            { "veh___619___.on_straight_section", "0" }, { "veh___619___.traversion_from", "-1" }, { "veh___619___.traversion_to", "-1" },
+            { "veh___619___.turn_signals", "ActionDir____CENTER" },
+        };
+
+        vals["Array.CurrentState"] = "state_EnvironmentModel";
+        trace.addTraceStep({ "1." + std::to_string(2 * i + 1), vals });
+        vals["Array.CurrentState"] = "state_TacticalPlanner";
+        trace.addTraceStep({ "1." + std::to_string(2 * i + 2), vals });
+    }
+
+    return trace;
+}
+
+// Sizes and hashes are those of the string-template based exporters before the XmlWriter port.
+TEST(XmlWriterTests, VtdAndOscExportersUnchanged) {
+    using namespace vfm::mc::trajectory_generator;
+    const MCinterpretedTrace trace(0, { syntheticLaneChangeTrace() }, InterpretationConfiguration::getLaneChangeConfiguration());
+
+    const std::string vtd{ VTDgenerator(trace.clone()).generate() };
+    EXPECT_EQ(vtd.size(), 8015);
+    EXPECT_EQ(fnv1a64(vtd), 0x3cebb28de5990d53ULL);
+
+    vfm::StringSink vtd_sink{};
+    VTDgenerator(trace.clone()).generate(vtd_sink);
+    EXPECT_EQ(vtd_sink.str(), vtd);
+
+    const std::string osc_with_ego{ OSCgenerator(trace.clone()).generate("scen", true) };
+    EXPECT_EQ(osc_with_ego.size(), 5555);
+    EXPECT_EQ(fnv1a64(osc_with_ego), 0x09e8dc929ac2344eULL);
+
+    const std::string osc_free_ego{ OSCgenerator(trace.clone()).generate("scen", false) };
+    EXPECT_EQ(osc_free_ego.size(), 4242);
+    EXPECT_EQ(fnv1a64(osc_free_ego), 0x86b4c661cce33226ULL);
+
+    std::ostringstream osc_stream{};
+    OSCgenerator(trace.clone()).generate(osc_stream, "scen", true);
+    EXPECT_EQ(osc_stream.str(), osc_with_ego);
+}
+
+TEST(VfmHeapTests, LazyPages) {
+    using vfm::VfmHeap;
+    const int addr{ 3 * VfmHeap::PAGE_SIZE + 7 };
+    const int untouched{ VFM_HEAP_SIZE - 1 };
+
+    VfmHeap heap{};
+    EXPECT_EQ(heap.getNumLivePages(), 0);
+    EXPECT_EQ(heap.get(untouched), VFM_HEAP_EMPTY_VALUE);
+    EXPECT_EQ(heap[addr], VFM_HEAP_EMPTY_VALUE);
+
+    heap.set(addr, 1);
+    EXPECT_EQ(heap.get(addr), 1);
+    EXPECT_EQ(heap.get(addr + 1), VFM_HEAP_EMPTY_VALUE); // Rest of a freshly allocated page is empty, too.
+    EXPECT_EQ(heap.getNumLivePages(), 1);
+    EXPECT_TRUE(heap.isPageLive(addr / VfmHeap::PAGE_SIZE));
+    EXPECT_FALSE(heap.isPageLive(untouched / VfmHeap::PAGE_SIZE));
+    EXPECT_EQ(heap.get(untouched), VFM_HEAP_EMPTY_VALUE);
+
+    EXPECT_THROW(heap.set(VFM_HEAP_SIZE, 1), std::out_of_range);
+    EXPECT_THROW(heap.get(-1), std::out_of_range);
+    EXPECT_EQ(heap.getNumLivePages(), 1);
+}
+
+TEST(VfmHeapTests, CopyOnWrite) {
+    using vfm::VfmHeap;
+    const int addr{ 3 * VfmHeap::PAGE_SIZE + 7 };
+    const int untouched{ VFM_HEAP_SIZE - 1 };
+
+    VfmHeap heap{};
+    heap.set(addr, 1);
+
+    VfmHeap copy{ heap };
+    for (int page = 0; page < VfmHeap::NUM_PAGES; page++) EXPECT_TRUE(copy.sharesPageWith(heap, page));
+
+    // The first write un-shares the page, and only this one.
+    copy.set(addr + 1, 2);
+    EXPECT_FALSE(copy.sharesPageWith(heap, addr / VfmHeap::PAGE_SIZE));
+    EXPECT_TRUE(copy.sharesPageWith(heap, addr / VfmHeap::PAGE_SIZE - 1));
+    EXPECT_EQ(copy.get(addr), 1);
+    EXPECT_EQ(heap.get(addr + 1), VFM_HEAP_EMPTY_VALUE);
+
+    // Both sides now own their page exclusively, so further writes go in place, i.e., no second copy.
+    float* copy_cell{ copy.getCellAddress(addr) };
+    float* heap_cell{ heap.getCellAddress(addr) };
+    copy.set(addr, 3);
+    heap.set(addr, 4);
+    EXPECT_EQ(*copy_cell, 3);
+    EXPECT_EQ(*heap_cell, 4);
+
+    // Pages never written to read back as empty and stay untouched in both heaps.
+    EXPECT_EQ(copy.get(untouched), VFM_HEAP_EMPTY_VALUE);
+    EXPECT_FALSE(copy.isPageLive(untouched / VfmHeap::PAGE_SIZE));
+    EXPECT_FALSE(heap.isPageLive(untouched / VfmHeap::PAGE_SIZE));
+    EXPECT_EQ(copy.getNumLivePages(), 1);
+}
+
+TEST(VfmHeapTests, DataPackForkIsIsolated) {
+    auto data{ std::make_shared<vfm::DataPack>() };
+    data->addOrSetSingleVal("x", 1);
+    data->addOrSetSingleVal("y", 2);
+
+    const auto forked{ data->fork() };
+    const int page_x{ data->getAddressOf("x") / vfm::VfmHeap::PAGE_SIZE };
+
+    forked->addOrSetSingleVal("x", 10);
+    EXPECT_EQ(forked->getSingleVal("x"), 10);
+    EXPECT_EQ(data->getSingleVal("x"), 1); // Write after fork does not leak into the parent...
+    EXPECT_EQ(forked->getSingleVal("y"), 2);
+    EXPECT_FALSE(forked->getVfmMemory().sharesPageWith(data->getVfmMemory(), page_x));
+
+    data->addOrSetSingleVal("y", 20);
+    EXPECT_EQ(forked->getSingleVal("y"), 2); // ...nor the other way round.
+    EXPECT_EQ(data->getSingleVal("y"), 20);
+}
+
+TEST(MetaRuleIndexTests, SimplifyMatchesBaseline) {
+    const auto parser{ vfm::SingletonFormulaParser::getInstance() };
+
+    // Expected results computed with the linear scan over all rules before the index was introduced.
+    const std::vector<std::pair<std::string, std::string>> cases{
+        { "(-(0) == min((z && a), 1))", "!(min(a && z, 1))" },
+        { "(min((0 == 0), (z != z)) == ((0 - x) != (y || 2)))", " --(x) == 1" },
+        { "((z || z) + !(!(0)))", "z || z" },
+        { "min((min(z, a) < -(a)), -((1 / y)))", "min((min(a, z) < -(a)), -(1 / y))" },
+        { "(((b != a) < (0 * 2)) == (-(1) / (y > 2)))", "((a != b) < 0) == -(1) / (y > 2)" },
+        { "!(!(-(1)))", "1" },
+        { "(((a == a) < (0 / b)) > max(y, (z ? x : z)))", "0 > max(y, if(z)\n   {\n      x\n   }\n   else {\n      z\n   })" },
+        { "max((b / 0), (z <= (0 ? y : y)))", "max(b / 0, (z <= y))" },
+        { "(!(!(b)) * !(a))", "boolify(b) * !(a)" },
+        { "((!(0) || z) > ((a || x) - !(b)))", "1 > (a || x) - !(b)" },
+        { "(!((b && b)) <= (-(0) ? x : 2))", "(b => !(b)) <= 2" },
+        { "(((2 && a) == (z == a)) == (min(0, 1) <= x))", "(boolify(a) == (a == z)) == (0 <= x)" },
+        { "(((b > b) + min(a, b)) != !(max(0, z)))", "min(a, b) != !(max(0, z))" },
+        { "!((!(b) || -(2)))", "0" },
+        { "((x + (b > z)) != ((1 ? x : z) / (b == z)))", "x + (b > z) != x / (b == z)" },
+        { "!(((2 * 1) < (x < b)))", "2 >= (x < b)" },
+        { "(((1 * a) <= x) || ((y * y) && max(a, 2)))", "(a <= x) || y ** 2 && max(a, 2)" },
+    };
+
+    for (const auto& c : cases) {
+        const auto formula{ vfm::MathStruct::parseMathStruct(c.first, true, false, parser)->toTermIfApplicable() };
+        EXPECT_EQ(vfm::MathStruct::simplify(formula, false, nullptr, false, parser)->serialize(), c.second) << c.first;
+    }
+}
+
+TEST(AttributeCacheTests, InvalidatedOnReplace) {
+    vfm::MathStruct::setCrossCheckAttributeCache(true);
+    const int errors_before{ vfm::Failable::getSingleton("AttributeCache")->hasErrorOccurred() };
+    auto formula{ vfm::MathStruct::parseMathStruct("(x + 2) * (3 + 4)") };
+    auto x{ formula->getOperands()[0]->getOperands()[0] };
+
+    EXPECT_EQ(formula->getNodeCount(), 7);
+    EXPECT_EQ(formula->getDepth(), 3);
+    EXPECT_FALSE(formula->isOverallConstant());
+    EXPECT_EQ(formula->getVariableNames(), std::set<std::string>{ "x" });
+
+    x->replace(vfm::_val(3));
+
+    EXPECT_TRUE(formula->isOverallConstant());
+    EXPECT_TRUE(formula->getVariableNames().empty());
+    EXPECT_EQ(formula->getStructuralHash(), vfm::MathStruct::parseMathStruct("(3 + 2) * (3 + 4)")->getStructuralHash());
+
+    // Rule application writes operands of the (copied) rule trees directly when binding metas.
+    const auto parser{ vfm::SingletonFormulaParser::getInstance() };
+
+    for (const std::string& f : { "(x * 0 + 1) * (y - y)", "min(a, a) + (b ? 2 : 2)", "!(!(z && 1)) == (3 + 4) * x" }) {
+        vfm::MathStruct::simplify(vfm::MathStruct::parseMathStruct(f, true, false, parser)->toTermIfApplicable(), false, nullptr, false, parser);
+    }
+
+    EXPECT_EQ(vfm::Failable::getSingleton("AttributeCache")->hasErrorOccurred(), errors_before);
+    vfm::MathStruct::setCrossCheckAttributeCache(false);
+}
+
+TEST(EventCalendarTests, PeriodicReschedulingAndCancelling) {
+    // Plugin slots re-scheduling themselves periodically, every tenth one cancelled on the way.
+    // (Throughput for many more slots is measured in vfmBenchmarks, "simulation/event_calendar".)
+    constexpr int num_slots{ 400 };
+    constexpr double horizon{ 200 };
+    vfm::EventCalendar calendar{};
+    std::vector<vfm::EventCalendar::Handle> next(num_slots);
+    std::vector<int> counts(num_slots, 0);
+
+    for (int slot = 0; slot < num_slots; slot++) {
+        next[slot] = calendar.schedule(1 + slot % 7, slot);
+        calendar.schedule(1 + slot % 7, slot); // Duplicate, ignored.
+    }
+
+    EXPECT_EQ(calendar.size(), num_slots);
+
+    double last_time{ 0 };
+
+    while (!calendar.empty() && calendar.nextTime() <= horizon) {
+        const double time{ calendar.nextTime() };
+        EXPECT_GT(time, last_time);
+        last_time = time;
+
+        calendar.popAllAt(time, [&](const int slot) {
+            counts[slot]++;
+            next[slot] = calendar.schedule(time + 1 + slot % 7, slot);
+
+            if (slot % 10 == 0 && counts[slot] == 3) {
+                EXPECT_TRUE(calendar.cancel(next[slot]));
+                EXPECT_FALSE(calendar.cancel(next[slot]));
+            }
+        });
+    }
+
+    for (int slot = 0; slot < num_slots; slot++) {
+        EXPECT_EQ(counts[slot], slot % 10 == 0 ? 3 : (int) (horizon / (1 + slot % 7)));
+    }
+
+    calendar.cancelAllOf(1);
+    EXPECT_TRUE(calendar.getTimesOf(1).empty());
+    EXPECT_EQ(calendar.getTimesOf(2).size(), 1);
+
+    vfm::EventCalendar small{};
+    std::vector<int> order{};
+    small.schedule(5, 3);
+    small.schedule(5, 1);
+    small.schedule(2, 7);
+    small.schedule(5, 2);
+    small.popAllAt(small.nextTime(), [&](const int slot) { order.push_back(slot); });
+    small.popAllAt(small.nextTime(), [&](const int slot) { order.push_back(slot); });
+    EXPECT_EQ(order, (std::vector<int>{ 7, 3, 1, 2 })); // By time, then in scheduling order.
+}
+
+TEST(ModelGenerationTests, ParallelAndBitstateExplorationAgree) {
+    // CONFIG_SIMPLE_ACC with larger ranges than the default. (Exploration speed is measured in vfmBenchmarks, "model_checking/acc_state_space".)
+    const vfm::AccRanges ranges{ 0, 8, 1, 3, 60, 3 };
+    vfm::ExplorationOptions options{};
+    options.paint_states_ = false;
+    std::vector<vfm::ExplorationStats> stats{};
+    std::vector<size_t> num_transitions{};
+
+    for (const int num_threads : { 1, 4 }) {
+        options.num_threads_ = num_threads;
+        vfm::MC mc{ vfm::MC::createConfigSimpleACC(ranges) };
+        mc.generateModel(false, 10000000, 10000000, 100000, false, 1, true, options);
+        stats.push_back(mc.getLastExplorationStats());
+        num_transitions.push_back(mc.getModel().getTransitions()->size());
+    }
+
+    options.bitstate_ = true;
+    options.bitstate_log2_bits_ = 24;
+    vfm::MC mc_bitstate{ vfm::MC::createConfigSimpleACC(ranges) };
+    mc_bitstate.generateModel(false, 10000000, 10000000, 100000, false, 1, true, options);
+    stats.push_back(mc_bitstate.getLastExplorationStats());
+
+    EXPECT_GT(stats[0].num_states_, (long) vfm::MC::generateFullSystemSeedACC(ranges).size());
+    EXPECT_EQ(stats[1].num_states_, stats[0].num_states_);
+    EXPECT_EQ(stats[1].num_successors_, stats[0].num_successors_);
+    EXPECT_EQ(num_transitions[1], num_transitions[0]);
+    EXPECT_EQ(stats[2].num_states_, stats[0].num_states_); // No collisions expected at this size.
+}
+
+TEST(FSMGraphRendererTests, IncrementalEqualsFullRepaint) {
+    vfm::fsm::FSMs m{};
+    m.addTransition(1, 2);
+    m.addTransition(2, 3);
+    m.addTransition(3, 1);
+    m.addTransition(2, 4);
+    m.addTransition(4, 4);
+
+    vfm::fsm::FSMGraphRenderer incremental{ m.getGraphTopology() };
+    vfm::fsm::FSMGraphRenderer fresh{ m.getGraphTopology() };
+
+    for (const int state : { 1, 2, 4, 3 }) {
+        incremental.render(state);
+    }
+
+    vfm::Image a{ incremental.render(3) };
+    vfm::Image b{ fresh.render(3) };
+    const auto raw_a{ a.getRawImage() };
+    const auto raw_b{ b.getRawImage() };
+
+    ASSERT_GT(incremental.getWidth(), 0);
+    ASSERT_EQ(raw_a.size(), raw_b.size());
+    EXPECT_TRUE(std::equal(raw_a.begin(), raw_a.end(), raw_b.begin(), [](const vfm::Color& c1, const vfm::Color& c2) {
+        return c1.r == c2.r && c1.g == c2.g && c1.b == c2.b && c1.a == c2.a;
+    }));
+}
+
+TEST(CompactTermTests, EvalEqualsTermEval) {
+    // A random formula of some 100k nodes over ten variables, with a few compound operators in between.
+    // (Evaluation speed is measured in vfmBenchmarks, "compact_term/eval".)
+    const auto parser{ vfm::SingletonFormulaParser::getInstance() };
+    const std::vector<std::string> optors{ vfm::SYMB_PLUS, vfm::SYMB_MINUS, vfm::SYMB_MULT, vfm::SYMB_DIV, vfm::SYMB_MAX, vfm::SYMB_SM, vfm::SYMB_AND, vfm::SYMB_EQ };
+    std::mt19937 rng{ 42 };
+
+    std::function<std::shared_ptr<vfm::Term>(int)> randomTerm = [&](const int depth) -> std::shared_ptr<vfm::Term> {
+        if (depth == 0) {
+            return rng() % 3 ? vfm::_var_plain("x" + std::to_string(rng() % 10)) : vfm::_val_plain(rng() % 5);
+        }
+
+        if (rng() % 50 == 0) return vfm::_not_plain(randomTerm(depth - 1));
+        return parser->termFactory(optors[rng() % optors.size()], { randomTerm(depth - 1), randomTerm(depth - 1) });
+    };
+
+    auto term{ randomTerm(16) };
+    term->setChildrensFathers();
+    auto compact{ vfm::CompactFormula::fromTerm(term) };
+    auto data{ std::make_shared<vfm::DataPack>() };
+    auto same = [](const float a, const float b) { return a == b || (std::isnan(a) && std::isnan(b)); };
+
+    ASSERT_GT(compact.getNumOpaqueTerms(), 0);
+
+    for (int i = 0; i < 10; i++) {
+        data->addOrSetSingleVal("x" + std::to_string(i), i - 3.5f);
+    }
+
+    EXPECT_TRUE(same(compact.eval(data), term->eval(data)));
+    EXPECT_TRUE(same(compact.toTerm()->eval(data), term->eval(data)));
+
+    const float before_simplification{ compact.eval(data) };
+    compact.simplify();
+    EXPECT_TRUE(same(compact.eval(data), before_simplification));
+}
+
+TEST(OperatorRegistryTests, MatchesOperatorMaps) {
+    auto parser{ std::make_shared<vfm::FormulaParser>() };
+    parser->addDefaultDynamicTerms();
+    parser->addDynamicTerm(vfm::OperatorStructure(vfm::OutputFormatEnum::prefix, vfm::AssociativityTypeEnum::left, 2, -1, "twice_sum", false, false), "(p_(0) + p_(1)) * 2");
+
+    for (const auto& ops : parser->getAllOps()) {
+        for (const auto& op : ops.second) {
+            if (op.first < 0) continue;
+
+            const auto& relevant{ ops.second.count(vfm::PARNUM_FLEXIBLE_MODE) ? ops.second.at(vfm::PARNUM_FLEXIBLE_MODE) : op.second };
+            EXPECT_EQ(parser->prio(ops.first, op.first), relevant.precedence) << ops.first;
+            EXPECT_EQ(parser->isLeftAssoc(ops.first, op.first), relevant.associativity == vfm::AssociativityTypeEnum::left) << ops.first;
+            EXPECT_TRUE(parser->getNumParams(ops.first).count(op.first)) << ops.first;
+        }
+    }
+
+    auto formula{ vfm::MathStruct::parseMathStruct("twice_sum(x, 3) - 2 * x", parser)->toTermIfApplicable() };
+    auto data{ std::make_shared<vfm::DataPack>() };
+    data->addOrSetSingleVal("x", 5);
+
+    EXPECT_FLOAT_EQ(formula->eval(data, parser), 6);
+    EXPECT_EQ(parser->termFactory("no_such_operator", { vfm::_val_plain(1) }), nullptr);
+}
+
+TEST(BracketIndexTests, MatchesLevelwiseHelpers) {
+    const std::string code{ "f(a, \"(\", g(b, (c)), @{ ) }@ h(d)) (e) x(\")\"" };
+    const std::vector<std::string> ignore_beg{ "\"", "@{" };
+    const std::vector<std::string> ignore_end{ "\"", "}@" };
+    const vfm::BracketIndex index{ code, vfm::StaticHelper::tagsWithPrepended("(", ignore_beg), vfm::StaticHelper::tagsWithPrepended(")", ignore_end) };
+
+    for (int pos = -1; pos <= (int) code.size(); pos++) {
+        EXPECT_EQ(index.isWithinAnyOther(pos, 0), vfm::StaticHelper::isWithinAnyLevelwise(code, pos, ignore_beg, ignore_end)) << pos;
+        EXPECT_EQ(index.isWithin(pos, 0), vfm::StaticHelper::isWithinLevelwise(code, pos, "(", ")")) << pos;
+
+        if (pos >= 0 && pos < (int) code.size()) {
+            int pos_index{ pos };
+            int pos_helper{ pos };
+            EXPECT_EQ(index.findMatchingEndTag(pos_index, 0), vfm::StaticHelper::findMatchingEndTagLevelwise(code, pos_helper, "(", ")", ignore_beg, ignore_end)) << pos;
+            EXPECT_EQ(pos_index, pos_helper);
+        }
+    }
+
+    int pos_f{ 1 };
+    EXPECT_EQ(index.findMatchingEndTag(pos_f, 0), 33);
+    EXPECT_EQ(index.findMatchingBegTag(33, 0), 1);
+
+    // The StaticHelper overloads on a prebuilt index (expected values from the plain string versions).
+    EXPECT_EQ(vfm::StaticHelper::indexOfOnTopLevel(index, { "," }, 4), 8);
+    EXPECT_EQ(vfm::StaticHelper::indexOfOnTopLevel(index, { "," }, 9), 19);
+    EXPECT_EQ(vfm::StaticHelper::indexOfOnTopLevel(index, { "," }, 20), 33); // Stops at the enclosing end tag.
+    EXPECT_EQ(vfm::StaticHelper::indexOfOnTopLevel(index, { "," }, 34), -1);
+    EXPECT_EQ(vfm::StaticHelper::indexOfFirstInnermostBeginBracket(index), 15);
+    EXPECT_EQ(vfm::StaticHelper::findMatchingBegTagLevelwise(index, 18), 11);
+    EXPECT_EQ(vfm::StaticHelper::extractSubstringsLevelwise(code, "(", ")", 0, ignore_beg, ignore_end), (std::vector<std::string>{ "e", "a, \"(\", g(b, (c)), @{ ) }@ h(d)" }));
+    EXPECT_EQ(vfm::StaticHelper::splitOnTopLevel("a; case x; esac; b;", ";", { "case" }, { "esac" }), (std::vector<std::string>{ "a", " case x; esac", " b", "" }));
+    EXPECT_EQ(vfm::StaticHelper::removeMultiLineComments("a /* b /* c */ d */ e /* f */ g", "/*", "*/"), "a  e  g");
+}
+
+TEST(CppLexerTests, SameOutputAsStringPasses) {
+    std::string program{};
+    std::mt19937 rng{ 42 };
+    const std::vector<std::string> pieces{
+        "int x = 1;", "/* block */", "/* outer /* inner */ still outer */", "// line", "\n", "\r\n", "   ", "\t",
+        "s = \"a // b\";", "c = '/';", "y /= 2;", "/", "*", "a/**/b", "// x /* y\nz */ w", "f(a, b);" };
+
+    for (int i = 0; i < 20000; i++) {
+        program += pieces[rng() % pieces.size()];
+    }
+
+    const vfm::CppLexer lexer{ program };
+    std::string concatenated{};
+
+    for (const auto& token : lexer.getTokens()) {
+        concatenated += lexer.getTokenText(token);
+    }
+
+    EXPECT_EQ(concatenated, lexer.getText());
+    EXPECT_EQ(lexer.rewriteWithoutCommentsAndBlankLines(), vfm::StaticHelper::removeBlankLines(vfm::StaticHelper::removeComments(program)));
+
+    const vfm::CppLexer small{ "int a;\n/* x\n */ b = 2;" };
+    const auto& b_token{ small.getTokens()[small.getTokens().size() - 6] };
+    EXPECT_EQ(small.getTokenText(b_token), "b");
+    EXPECT_EQ(small.getLineAndColumn(b_token.source_offset_), (std::pair<int, int>{ 3, 5 }));
+
+    // The later passes run on comment-free code.
+    std::string code{};
+    const std::vector<std::string> code_pieces{
+        "a[i]", "b[ j ][k ]", " [", "] ", "[", "]", "\n", "\r\n", "   ", "\t", "x = \"s [ t ] using u;\";", "c = '[';",
+        "using A = int;", "using B=std::vector<int> ;", "f(a, b);", "y = z;" };
+
+    for (int i = 0; i < 3000; i++) {
+        code += code_pieces[rng() % code_pieces.size()];
+    }
+
+    EXPECT_EQ(vfm::CppLexer(code, false).getText(), code);
+
+    std::string expected_arrays{ code };
+    vfm::StaticHelper::preprocessCppConvertCStyleArraysToVars(expected_arrays);
+    EXPECT_EQ(vfm::CppLexer(code, false).rewriteCStyleArraysToVars(), expected_arrays);
+
+    // String version of the 'using' pass: blank out from every "using" not within quotes up to the next ';'.
+    std::string expected_using{ code };
+    std::vector<std::string> expected_statements{};
+
+    for (int pos = expected_using.find("using"); pos >= 0; pos = expected_using.find("using", pos + 1)) {
+        if (vfm::StaticHelper::isWithinLevelwise(expected_using, pos, "\"", "\"")) continue;
+        const int pos2 = expected_using.find(';', pos);
+        expected_statements.push_back(expected_using.substr(pos, pos2 - pos));
+        std::fill(expected_using.begin() + pos, expected_using.begin() + pos2 + 1, '-');
+    }
+
+    std::vector<std::string> statements{};
+    EXPECT_EQ(vfm::CppLexer(code, false).rewriteWithoutUsingStatements(statements), expected_using);
+    EXPECT_EQ(statements, expected_statements);
+}
+
+TEST(CppParserTests, InliningSubstitutesArgumentsSimultaneously) {
+    vfm::CppParser parser{ R"(// #vfm-begin
+// #vfm-option[[ general_mode << regular ]]
+// #vfm-option[[ target_mc << nusmv ]]
+// #vfm-option[[ inline_functions << always ]]
+// #vfm-option[[ create_additional_files << none ]]
+// #vfm-end)" };
+
+    // The arguments of the first call are named like the parameters, swapped. Before, 'diff(y, x)' was inlined as 'plan.x - plan.x'.
+    ASSERT_TRUE(parser.parseProgram(R"(// #vfm-begin
+struct Agent {
+   int v{}; // #vfm-tal[[0..34]]
+   int a{}; // #vfm-tal[[-8..6]]
+   int d{}; // #vfm-tal[[0..100]]
+};
+
+int diff(int x, int y)
+{
+   int r = x - y; // #vfm-tal[[-100..100]]
+   return r;
+}
+
+void plan(
+   Agent& agent // #vfm-aka[[ literal(ego) ]]
+   )
+{
+   // #vfm-gencode-begin[[ condition=false ]]
+   int y = agent.v; // #vfm-tal[[0..34]]
+   int x = agent.d; // #vfm-tal[[0..100]]
+   agent.a = diff(y, x) + diff(x, 3);
+   // #vfm-gencode-end
+}
+// #vfm-end)"));
+
+    ASSERT_TRUE(parser.getFunctionDefinitions().count("plan"));
+    EXPECT_EQ(parser.getFunctionDefinitions().at("plan")->serialize(),
+        "plan.y = agent.v;\n"
+        "plan.x = agent.d;\n"
+        "diff.r = plan.y - plan.x;\n"
+        "TEMPORAREY0 = diff.r;\n"
+        "diff.r.1 = plan.x - 3;\n"
+        "TEMPORAREY1 = diff.r.1;\n"
+        "agent.a = TEMPORAREY0 + TEMPORAREY1");
+}
+
+TEST(CppParserTests, ConstnessSameInSerialAndParallelRun) {
+    const std::string options{ R"(// #vfm-begin
+// #vfm-option[[ general_mode << regular ]]
+// #vfm-option[[ target_mc << nusmv ]]
+// #vfm-option[[ inline_functions << always ]]
+// #vfm-option[[ create_additional_files << none ]]
+// #vfm-end)" };
+
+    const std::string program{ R"(// #vfm-begin
+enum class ActionDir
+{
+    LEFT = 0,
+    CENTER = 1,
+    RIGHT = 2,
+    NONE = 3
+};
+
+struct Gap
+{
+   int s_dist_front{256}; // #vfm-tal[[0..256]]
+   int v_front{70};       // #vfm-tal[[0..70]]
+   ActionDir turn_signals_front{ActionDir::NONE};
+};
+
+struct Agent {
+   int v{}; // #vfm-tal[[0..34]]
+   int a{}; // #vfm-tal[[-8..6]]
+   std::array<Gap, 3> gaps;
+};
+
+void plan(
+   Agent& agent // #vfm-aka[[ literal(ego) ]]
+   )
+{
+   // #vfm-gencode-begin[[ condition=false ]]
+   static constexpr int MIN_DIST = 14;
+   bool pressured_left = agent.gaps[static_cast<int>(ActionDir::LEFT)].turn_signals_front == ActionDir::RIGHT;
+   bool pressured_right = agent.gaps[static_cast<int>(ActionDir::RIGHT)].turn_signals_front == ActionDir::LEFT;
+   int acceleration = std::min(agent.gaps[static_cast<int>(ActionDir::CENTER)].v_front - agent.v, 2);
+
+   if (agent.gaps[static_cast<int>(ActionDir::CENTER)].s_dist_front < MIN_DIST || pressured_left || pressured_right) {
+      acceleration = std::max(-agent.v, -8);
+   }
+
+   agent.a = acceleration;
+   // #vfm-gencode-end
+}
+// #vfm-end)" };
+
+    const auto const_variables = [](const vfm::CppParser& parser) {
+        std::string s{};
+
+        for (const auto& function : parser.getFunctionDefinitions()) {
+            s += function.first + ": " + function.second->serialize() + "\n";
+
+            function.second->applyToMeAndMyChildren([&s](const vfm::MathStructPtr m) {
+                const auto m_var{ m->toVariableIfApplicable() };
+
+                if (m_var && m_var->isConstVariable()) {
+                    s += m_var->getVariableName() + " = " + std::to_string(m_var->constEval()) + "\n";
+                }
+            }, vfm::TraverseCompoundsType::go_into_compound_structures);
+        }
+
+        return s;
+    };
+
+    vfm::CppParser serial{ options };
+    vfm::CppParser parallel{ options };
+    serial.setNodeParallelism(1);
+    parallel.setNodeParallelism(4, 1); // One job per thread regardless of the node count.
+
+    ASSERT_TRUE(serial.parseProgram(program));
+    ASSERT_TRUE(parallel.parseProgram(program));
+    EXPECT_NE(const_variables(serial).find(" = "), std::string::npos);
+    EXPECT_EQ(const_variables(serial), const_variables(parallel));
+}
+
+TEST(IntervalAnalysisTests, FixpointWithWidening) {
+    using Interval = vfm::IntervalAnalysis::Interval;
+    vfm::IntervalAnalysis analysis{ [](const int op, const Interval& a, const Interval& b) { // 0: plus, 1: times (non-negative only).
+        return op == 0 ? Interval{ a.first + b.first, a.second + b.second } : Interval{ a.first * b.first, a.second * b.second };
+    } };
+
+    const int x{ analysis.getVariableId("x") };
+    const int y{ analysis.getVariableId("y") };
+    const int z{ analysis.getVariableId("z") };
+    const int c{ analysis.getVariableId("c") };
+    analysis.setInitialInterval(z, { 0, 3 });
+
+    // x = y + 1 comes before y = 2 * z; a single pass would leave x empty.
+    analysis.addAssignment(x, analysis.addOperator(0, { analysis.addVariable(y), analysis.addConstant(1) }));
+    analysis.addAssignment(y, analysis.addOperator(1, { analysis.addConstant(2), analysis.addVariable(z) }));
+
+    // c = c + 1; c = 0; grows until widening gives up and freezes the upper bound.
+    analysis.addAssignment(c, analysis.addOperator(0, { analysis.addVariable(c), analysis.addConstant(1) }));
+    analysis.addAssignment(c, analysis.addConstant(0));
+
+    analysis.solve();
+
+    EXPECT_EQ(analysis.getInterval(y), (Interval{ 0, 6 }));
+    EXPECT_EQ(analysis.getInterval("x"), (Interval{ 1, 7 }));
+    EXPECT_EQ(analysis.getInterval(c).first, 0);
+    EXPECT_EQ(analysis.getVariablesWithFrozenBounds(), std::vector<int>{ c });
+}
+
+TEST(SmvModuleTests, CachedQueriesAndSectionUpdate) {
+    vfm::mc::smv::Module module{};
+    module.parseProgram(
+        "MODULE main\n"
+        "VAR\n"
+        "   x : 0..10; -- comment; with semicolon\n"
+        "   b : boolean;\n"
+        "DEFINE\n"
+        "   d := case x > 5 : 1; TRUE : 0; esac;\n"
+        "ASSIGN\n"
+        "   init(x) := 3;\n"
+        "   next(x) := x;\n");
+
+    EXPECT_EQ(module.getVariablesWithTypes().size(), 2);
+    EXPECT_EQ(module.getVariableType("x")->getSMVName(), "0..10");
+    EXPECT_EQ(module.getVariableType("b")->getSMVName(), "boolean");
+    EXPECT_EQ(module.getAllVariableInits().at("x"), "3");
+    EXPECT_EQ(module.getVariableDefines().at("d"), "case x > 5 : 1; TRUE : 0; esac");
+    EXPECT_EQ(module.getAllVariablesAndDefinesForOutsideUsage(), (std::set<std::string>{ "b", "d", "x" }));
+
+    const auto type_x{ module.getVariableType("x") };
+    module.setSectionCode(vfm::mc::smv::NAME_DEFINE, "   e := x + 1;\n");
+
+    EXPECT_EQ(module.getVariableDefines(), (std::map<std::string, std::string>{ { "e", "x + 1" } }));
+    EXPECT_EQ(module.getAllVariablesAndDefinesForOutsideUsage(), (std::set<std::string>{ "b", "e", "x" }));
+    EXPECT_EQ(module.getVariableType("x"), type_x); // VAR section not re-parsed.
+    EXPECT_TRUE(vfm::StaticHelper::stringContains(module.serialize(), "DEFINE\n   e := x + 1;\n"));
+}
+
+TEST(PolygonRasterizerTests, FillRulesAndAntiAliasing) {
+    vfm::Image img{ 20, 20 };
+    img.fillImg(vfm::BLACK);
+
+    // Pentagram around (10, 10): its center is wound twice, i.e., inside for non-zero, outside for even-odd.
+    const vfm::Pol2Df star{ { 10, 1 }, { 15.3f, 17.3f }, { 1.4f, 7.2f }, { 18.6f, 7.2f }, { 4.7f, 17.3f } };
+
+    img.fillPolygon(star, vfm::WHITE, vfm::FillRule::even_odd);
+    EXPECT_EQ(img.getPixel(10, 10), vfm::BLACK);
+    EXPECT_EQ(img.getPixel(10, 4), vfm::WHITE);
+    EXPECT_EQ(img.getPixel(0, 0), vfm::BLACK);
+
+    img.fillPolygon(star, vfm::WHITE, vfm::FillRule::non_zero);
+    EXPECT_EQ(img.getPixel(10, 10), vfm::WHITE);
+
+    // Half of pixel column 5 is covered.
+    img.fillImg(vfm::BLACK);
+    img.fillPolygon(vfm::Pol2Df{ { 2, 2 }, { 5.5f, 2 }, { 5.5f, 8 }, { 2, 8 } }, vfm::WHITE, vfm::FillRule::even_odd, true);
+    EXPECT_EQ(img.getPixel(3, 4), vfm::WHITE);
+    EXPECT_GT(img.getPixel(5, 4).r, 30);
+    EXPECT_LT(img.getPixel(5, 4).r, 225);
+    EXPECT_EQ(img.getPixel(6, 4), vfm::BLACK);
+}
+
+TEST(GlyphAtlasTests, SameTextAsPerGlyphImages) {
+    const std::vector<vfm::Image> table_copy{ vfm::Image::MONOSPACE_NEW_CACHED_ASCII_TABLE }; // Not the default table ==> old path.
+    const std::string text{ "Speed: 42 km/h\nlane 3 [ok]" };
+
+    for (const bool center : { false, true }) {
+        for (const auto& f : std::vector<std::function<vfm::Color(const vfm::Color&, const vfm::Color&)>>{
+            vfm::FUNC_IGNORE_BLACK_CONVERT_TO_YELLOW, vfm::FUNC_IGNORE_BLACK_CONVERT_TO_COMPLEMENT }) {
+            vfm::Image atlas_img{ 200, 60 };
+            vfm::Image table_img{ 200, 60 };
+            atlas_img.fillImg(vfm::DARK_GREY);
+            table_img.fillImg(vfm::DARK_GREY);
+
+            for (int i = 0; i < 3; i++) { // Second and third time from the cache.
+                atlas_img.writeAsciiText(60 + i, 30, text, vfm::CoordTrans::dont_do_it, center, f);
+                table_img.writeAsciiText(60 + i, 30, text, vfm::CoordTrans::dont_do_it, center, f, table_copy);
+            }
+
+            EXPECT_TRUE(atlas_img.getRawImage() == table_img.getRawImage());
+        }
+    }
+}
+
+TEST(ViewProjectionTests, BatchMatchesSinglePointsAndFollowsCamera) {
+    vfm::Plain3DTranslator trans{ false };
+    trans.setHighwayData(500, 300, 0, 0, 1, 0, { 0, 0 });
+    trans.getPerspective()->parseProgram("Perspective [pos_xyz(-10,0,-3), rot_xyz<0.2,0,0>, disp_xyz{0.5,0.5,1}]");
+
+    const vfm::Pol3D in_front{ { { 5, -1, 0 }, { 5, 1, 0 }, { 8, 1, 0 }, { 8, -1, 0 } } };
+    const vfm::Pol3D half_behind{ { { -20, -1, 0 }, { 20, -1, 0 }, { 20, 1, 0 }, { -20, 1, 0 } } };
+    const auto batch{ trans.translatePolygons({ in_front, half_behind }) };
+
+    ASSERT_EQ(batch.size(), 2);
+    ASSERT_EQ(batch[0].points_.size(), 4);
+
+    for (int i = 0; i < 4; i++) {
+        const auto single{ trans.translate(in_front.points_[i]) };
+        EXPECT_NEAR(batch[0].points_[i].x, single.x, 1e-3);
+        EXPECT_NEAR(batch[0].points_[i].y, single.y, 1e-3);
+    }
+
+    EXPECT_EQ(batch[1].points_.size(), 4); // Cut at the display plane.
+
+    for (const auto& point : batch[1].points_) {
+        EXPECT_TRUE(std::isfinite(point.x) && std::isfinite(point.y));
+    }
+
+    EXPECT_TRUE(std::isnan(trans.translate(vfm::Vec3D{ -20, 0, 0 }).x));
+
+    const auto before{ trans.translate(vfm::Vec3D{ 5, 1, 0 }) };
+    trans.getPerspective()->setCameraY(2); // Camera moves sideways ==> cached matrix is outdated.
+    EXPECT_GT(std::abs(trans.translate(vfm::Vec3D{ 5, 1, 0 }).x - before.x), 1);
+
+    auto base{ std::make_shared<vfm::Plain3DTranslator>(false) };
+    base->setHighwayData(500, 300, 0, 0, 1, 0, { 0, 0 });
+    base->getPerspective()->parseProgram("Perspective [pos_xyz(-10,0,-3), rot_xyz<0.2,0,0>, disp_xyz{0.5,0.5,1}]");
+    const auto shift = [](const vfm::Vec3D& p) { return vfm::Vec3D{ p.x + 1, p.y, p.z }; };
+    const auto unshift = [](const vfm::Vec3D& p) { return vfm::Vec3D{ p.x - 1, p.y, p.z }; };
+    vfm::HighwayTranslatorWrapper wrapper{ base, shift, unshift };
+    const auto wrapped_batch{ wrapper.translatePolygons({ in_front, half_behind }) };
+
+    ASSERT_EQ(wrapped_batch.size(), 2);
+
+    for (int i = 0; i < 2; i++) {
+        const auto single{ wrapper.translatePolygon(i == 0 ? in_front : half_behind) };
+        ASSERT_EQ(wrapped_batch[i].points_.size(), single.points_.size());
+
+        for (int j = 0; j < single.points_.size(); j++) {
+            EXPECT_NEAR(wrapped_batch[i].points_[j].x, single.points_[j].x, 1e-3);
+            EXPECT_NEAR(wrapped_batch[i].points_[j].y, single.points_[j].y, 1e-3);
+        }
+    }
+}
+
+TEST(OutputSinkTests, HashingSinkMatchesWholeContentAndFileSinkRoundTrips) {
+    const std::string small{ "(function main ((var x int))\n" };
+    const std::string large(vfm::FileSink::DEFAULT_BUFFER_SIZE + 17, 'k');
+
+    vfm::StringSink string_sink{};
+    vfm::HashingSink hashing_sink{ &string_sink };
+    hashing_sink << small << large << small;
+
+    EXPECT_EQ(string_sink.str(), small + large + small);
+    EXPECT_EQ(hashing_sink.getSize(), string_sink.str().size());
+    EXPECT_EQ(hashing_sink.getHashHex(), vfm::StaticHelper::hashFNV1aHex(string_sink.str()));
+
+    const fs::path path{ fs::temp_directory_path() / "vfm_output_sink_test.k2" };
+
+    {
+        vfm::FileSink file_sink{ path.string() };
+        ASSERT_TRUE(file_sink.isOpen());
+        file_sink << small << large << small;
+        file_sink.flush();
+        EXPECT_FALSE(file_sink.hasErrorOccurred());
+    }
+
+    EXPECT_EQ(vfm::StaticHelper::readFile(path), string_sink.str());
+    fs::remove(path);
+
+    vfm::FileSink failing_sink{ (fs::temp_directory_path() / "vfm_no_such_dir" / "x.k2").string() };
+    EXPECT_FALSE(failing_sink.isOpen());
+    EXPECT_TRUE(failing_sink.hasErrorOccurred());
+}
+
 int main(int argc, char **argv) {
     testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,82 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace vfm {
+
+/// \brief Index over the bracket-like regions of one string, built in one pass per tag pair.
+///
+/// The levelwise functions of StaticHelper answer "is position p within (...)?" by scanning
+/// the string, and the bracket matching functions ask that question at every character they
+/// pass, which makes a single match quadratic in the string length. A BracketIndex is built
+/// once for a string and a list of tag pairs, after which
+/// - isWithin() / isWithinAny() are O(1),
+/// - findMatchingEndTag() is O(1) for every begin tag a left-to-right scan stops at
+///   (otherwise linear in the distance), and findMatchingBegTag() is O(log n),
+/// - findOnTopLevel() yields all split points of a delimiter outside of all regions in O(n).
+///
+/// Results are identical to the respective StaticHelper functions (including their treatment
+/// of malformed strings); when matching the tags of one pair, the regions of all other pairs
+/// in the index are ignored, like the "ignore tags" of the StaticHelper functions.
+/// The index refers to the string, which must outlive it and must not change.
+class BracketIndex {
+public:
+   static constexpr int MAX_NUM_PAIRS{ 64 };
+
+   /// At most MAX_NUM_PAIRS pairs; empty tags never match.
+   BracketIndex(const std::string& string, const std::vector<std::string>& begin_tags, const std::vector<std::string>& end_tags);
+
+   /// Same as StaticHelper::isWithinLevelwise(string, pos, begin_tags[pair], end_tags[pair]).
+   bool isWithin(const int pos, const int pair) const;
+
+   /// Same as StaticHelper::isWithinAnyLevelwise(string, pos, begin_tags, end_tags).
+   bool isWithinAny(const int pos) const;
+
+   /// Within any pair, except the given one.
+   bool isWithinAnyOther(const int pos, const int pair) const;
+
+   /// Same as StaticHelper::findMatchingEndTagLevelwise(string, pos, begin_tags[pair], end_tags[pair], <all other pairs>),
+   /// including moving pos to the next begin tag.
+   int findMatchingEndTag(int& pos, const int pair) const;
+
+   /// Same as StaticHelper::findMatchingBegTagLevelwise(string, begin_tags[pair], end_tags[pair], pos, <all other pairs>).
+   int findMatchingBegTag(const int pos, const int pair) const;
+
+   /// The non-overlapping occurrences of the delimiter (searched from left to right) that are not within any of the pairs.
+   std::vector<int> findOnTopLevel(const std::string& delimiter) const;
+
+   int size() const;
+   int getNumPairs() const;
+   const std::string& getString() const;
+   const std::vector<std::string>& getBeginTags() const;
+   const std::vector<std::string>& getEndTags() const;
+
+private:
+   struct Matching {
+      bool initialized_{ false };
+      std::vector<int> match_end_{};                  // For each begin tag a left-to-right scan stops at: the matching end or -1; -2 elsewhere.
+      std::vector<int> balance_{};                    // Non-ignored begin minus end tags left of each position (no skipping).
+      std::map<int, std::vector<int>> positions_by_balance_{};
+   };
+
+   bool startsWith(const int pos, const std::string& tag) const;
+   const Matching& getMatching(const int pair) const;
+
+   const std::string& string_;
+   std::vector<std::string> begin_tags_{};
+   std::vector<std::string> end_tags_{};
+   std::vector<uint64_t> within_{};                    // Bit k of entry pos + 1: position pos is within pair k.
+   uint64_t within_after_end_{};                       // Bit k: positions right of the string are within pair k (only possible if begin tag == end tag).
+   mutable std::vector<Matching> matchings_{};
+};
+
+} // vfm
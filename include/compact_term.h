@@ -0,0 +1,104 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace vfm {
+
+class Term;
+class DataPack;
+class FormulaParser;
+
+/// \brief Compact, arena-allocated representation of a formula, meant for large formulas
+/// that are evaluated or simplified many times.
+///
+/// All nodes of a formula live in one contiguous vector in postorder (every child precedes its
+/// father, the root is the last node), children are 32-bit indices into one shared child array,
+/// and operators are interned into 16-bit ids. A node thus costs 12 bytes plus 4 bytes per child,
+/// rather than one heap-allocated MathStruct with its operand vector and father pointer each.
+/// Common sub-terms of the source term (i.e., if it is a DAG) are stored only once.
+///
+/// Natively handled are the side-effect-free operators with a fixed number of operands
+/// (+, -, *, /, %, **, --, min, max, abs, trunc, the comparisons, && and ||), values and plain
+/// variables. Every other sub-term (compound operators, arrays, assignments, anything with
+/// side effects, ...) is kept as an opaque leaf holding the original Term, which is evaluated
+/// via Term::eval. Evaluation results equal the ones of Term::eval, including the emulation
+/// of the x86 NaN behavior.
+///
+/// Evaluation uses a scratch buffer of the formula, i.e., a CompactFormula must not be evaluated
+/// from several threads at once; copy it per thread instead.
+class CompactFormula {
+public:
+   using OperatorId = uint16_t;
+   using NodeIndex = uint32_t;
+
+   /// The natively evaluated operators; their ids are fixed, further operator names get
+   /// interned behind them on demand.
+   enum NativeOperator : OperatorId {
+      op_value, op_variable, op_opaque,
+      op_plus, op_minus, op_mult, op_div, op_mod, op_pow, op_neg, op_min, op_max, op_abs, op_trunc,
+      op_and, op_or, op_eq, op_neq, op_sm, op_smeq, op_gr, op_greq,
+      num_native_operators
+   };
+
+   struct Node {
+      OperatorId op_{};
+      uint16_t num_children_{};
+      NodeIndex first_child_{}; // Offset into the child array.
+      uint32_t payload_{};      // Float bits of a value, or index of a variable or opaque term.
+   };
+
+   CompactFormula() = default;
+
+   static CompactFormula fromTerm(const std::shared_ptr<Term>& term);
+
+   /// Re-creates a Term tree (no shared sub-terms; opaque sub-terms are copied).
+   std::shared_ptr<Term> toTerm(const std::shared_ptr<FormulaParser>& parser = nullptr) const;
+
+   /// Evaluates the formula in one linear pass over the nodes. Variables are looked up
+   /// once per evaluation, no matter how often they occur.
+   float eval(const std::shared_ptr<DataPack>& data, const std::shared_ptr<FormulaParser>& parser = nullptr) const;
+
+   /// Same with the values of getVariableNames() given in this order; opaque sub-terms
+   /// still need data for evaluation.
+   float eval(const std::vector<float>& var_values, const std::shared_ptr<DataPack>& data = nullptr, const std::shared_ptr<FormulaParser>& parser = nullptr) const;
+
+   /// Folds all natively handled sub-terms without variables or opaque leaves into values,
+   /// and removes neutral operands (x + 0, x - 0, x * 1, x / 1, -- -- x). Opaque sub-terms are
+   /// left as they are. Unreachable nodes are dropped. Returns the number of removed nodes.
+   size_t simplify();
+
+   bool empty() const;
+   size_t getNumNodes() const;
+   size_t getNumOpaqueTerms() const;
+   const std::vector<std::string>& getVariableNames() const;
+   const std::vector<Node>& getNodes() const;
+
+   /// Bytes of the arena including the variable table, excluding the opaque Terms.
+   size_t getMemoryUsage() const;
+
+   static OperatorId internOperator(const std::string& optor_name);
+   static std::string getOperatorName(const OperatorId id);
+
+private:
+   NodeIndex addNode(const OperatorId op, const std::vector<NodeIndex>& children, const uint32_t payload);
+   NodeIndex addValue(const float val);
+   float evalNode(const Node& node, const float* values) const;
+   void evalInto(const float* var_values, const std::shared_ptr<DataPack>& data, const std::shared_ptr<FormulaParser>& parser) const;
+
+   std::vector<Node> nodes_{};
+   std::vector<NodeIndex> children_{};
+   std::vector<std::string> var_names_{};
+   std::vector<std::shared_ptr<Term>> opaque_terms_{};
+   mutable std::vector<float> scratch_{};
+};
+
+} // vfm
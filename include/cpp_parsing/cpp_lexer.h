@@ -0,0 +1,87 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vfm {
+
+enum class CppTokenType {
+   whitespace,      // A run of white space characters other than '\n'.
+   newline,         // A single '\n'.
+   identifier,
+   number,
+   string_literal,
+   char_literal,
+   punctuation      // A single character.
+};
+
+struct CppToken {
+   CppTokenType type_{};
+   int begin_{};         // Position in the comment-free text of the lexer.
+   int length_{};
+   int source_offset_{}; // Position of the first character in the original code.
+};
+
+/// \brief Single-pass lexer for the C++ code fed into CppParser.
+///
+/// Comments are removed exactly the way the string-based preprocessing always did it, so that
+/// token rewriters can replace those passes one by one without changing the parsed program:
+/// block comments are removed first (levelwise, i.e., nested ones count, and also within string
+/// literals), and line comments are cut from the resulting text, i.e., a block comment inside
+/// a line comment may take the rest of the following line into the line comment. Everything
+/// not in a comment is split into tokens which refer to the comment-free text and to their
+/// position in the original code. Code that is already free of comments (i.e., in the later
+/// preprocessing stages) is tokenized as it is if strip_comments is false.
+class CppLexer {
+public:
+   explicit CppLexer(const std::string& code, const bool strip_comments = true);
+
+   const std::vector<CppToken>& getTokens() const;
+
+   /// The code without comments; the tokens partition it.
+   const std::string& getText() const;
+
+   std::string getTokenText(const CppToken& token) const;
+
+   /// Line (starting at 1) and column (starting at 1) of an offset into the original code.
+   std::pair<int, int> getLineAndColumn(const int source_offset) const;
+
+   /// Same as StaticHelper::removeBlankLines(StaticHelper::removeComments(code)): every line of the
+   /// comment-free text with anything else than white space in it, terminated with "\r\n".
+   std::string rewriteWithoutCommentsAndBlankLines() const;
+
+   /// Same as StaticHelper::preprocessCppConvertCStyleArraysToVars(text): white space next to
+   /// '[' or ']' is removed, and the brackets are replaced by the array index denoters.
+   std::string rewriteCStyleArraysToVars() const;
+
+   /// Replaces every "using ...;" statement, including the ';', by as many '-', the way
+   /// CppParser::processUsingKeyword always did. Only the keyword counts, not identifiers
+   /// or string literals containing "using". The statements (without ';') go to using_statements.
+   std::string rewriteWithoutUsingStatements(std::vector<std::string>& using_statements) const;
+
+private:
+   void stripBlockComments(const std::string& code);
+   void emit(const char c, const int source_offset);     // Receives the text without block comments.
+   void emitUncommented(const char c, const int source_offset); // Receives the text without any comments.
+   void finish();
+
+   std::string text_{};
+   std::vector<CppToken> tokens_{};
+   std::vector<int> line_starts_{ 0 };
+
+   // Lexer state.
+   bool pending_slash_{ false };
+   int pending_slash_offset_{};
+   bool in_line_comment_{ false };
+   bool in_literal_{ false };
+   bool literal_escape_{ false };
+};
+
+} // vfm
@@ -10,6 +10,7 @@
 #include "parser.h"
 #include "cpp_parsing/options.h"
 #include "static_helper.h"
+#include "output_sink.h"
 #include <map>
 #include <vector>
 #include <string>
@@ -57,6 +58,8 @@ const std::string VFM_INVARIANT_DENOTER = "// #vfm-invar";
 const std::string VFM_INJECTION_DENOTER = "// #vfm-inject"; // Injects the given code into vfm before the parsing starts (as opposed to: at the position where written, which can be achieved via '// #vfm:').
 const std::string VFM_OPTION_DENOTER = "// #vfm-option";
 
+constexpr int MIN_NODES_PER_PARALLEL_JOB = 4096; // Below that, spreading the nodes over threads costs more than it saves.
+
 
 enum class VariableSpecifierModeEnum {
    AKA,
@@ -173,6 +176,12 @@ public:
 
    std::map<std::string, CppFunctionSignature>& getFunctionSignatures();
    std::vector<std::shared_ptr<CppTypeStruct>>& getDataTypes();
+   const std::map<std::string, std::shared_ptr<Term>>& getFunctionDefinitions() const;
+
+   /// Threads used by the passes over all MC nodes (see applyToSelectedMCNodes), 0 meaning one per hardware thread
+   /// and 1 a serial run. Each job gets at least min_nodes_per_job nodes. The same holds for the variable
+   /// initializations in the Kratos code (see serializeKratosInitializations), counting each as a node.
+   void setNodeParallelism(const int num_threads, const int min_nodes_per_job = MIN_NODES_PER_PARALLEL_JOB);
 
    std::string getTypeBaseName(const std::string& member) const;
 
@@ -207,6 +216,18 @@ public:
 
    std::string getInitVarStringNuSMVOrKratos(const std::string& evar, std::pair<std::map<std::string, std::string>, std::string>& additional_functions, const bool init = false, const bool next = false, const bool kratos = false, const std::map<std::string, std::string>& enum_values = {}) const;
 
+   /// The assignment of its init value to the variable, which getInitVarStringNuSMVOrKratos serializes in Kratos mode.
+   /// Only for variables with a non-empty declaration; nullptr for the ones which are DEFINEd.
+   TermPtr getInitAssignmentKratos(const std::string& evar) const;
+
+   /// Serializes the init assignments (one line each, empty for nullptr) in parallel chunks, one StringSink per chunk,
+   /// using the threads and job size of setNodeParallelism. A chunk which creates new ndet functions is serialized again
+   /// afterwards, in order, since these functions are numbered by creation. So the result equals that of a serial run.
+   std::vector<std::string> serializeKratosInitializations(
+      const std::vector<TermPtr>& init_assignments,
+      const std::map<std::string, std::string>& enum_values,
+      std::pair<std::map<std::string, std::string>, std::string>& additional_functions) const;
+
    bool performCodeGenerationAndMCCodeCreation(
       const char* path_to_file_list_file_code,
       const char* path_to_file_list_file_env_model,
@@ -271,6 +292,7 @@ private:
    bool parseNativeEnvModel(const std::string& program);
 
    std::pair<float, float> getSingleRange(const MathStructPtr m, const std::pair<float, float>& range1, const std::pair<float, float>& range2) const;
+   std::pair<float, float> getSingleRange(const std::string& optor, const std::string& compound_optor, const std::pair<float, float>& range1, const std::pair<float, float>& range2) const;
    void findVariableNamesInArrayAccess(std::string& original_arr_full_access, std::string& arr_full_access, std::set<std::string>& var_names_in_single_array);
    void createDimsVector(std::set<std::string>& var_names_in_single_array, std::shared_ptr<vfm::mc::TypeAbstractionLayer>& tal, std::vector<int>& dims_counter, std::vector<int>& dims, std::vector<int>& dims_min);
    void createIfStatement(std::vector<int>& dims_counter, std::shared_ptr<vfm::Term>& current_if, std::vector<int>& dims, std::string& arr_full_access, std::vector<int>& dims_min, std::set<std::string>& var_names_in_single_array, std::shared_ptr<vfm::TermVar>& m2_var, vfm::TermPtr& m2_var_right_side, std::string& original_arr_full_access, std::shared_ptr<vfm::mc::TypeAbstractionLayer>& tal);
@@ -335,6 +357,23 @@ private:
 
    void replaceReturnWithAssignment(const TermPtr enc_function, const std::string& set_var_name);
 
+   struct InliningLocalSlot {
+      std::string name_{};               // As used in the function body, e.g., "f.x" or "&f.x.y".
+      std::string name_clean_{};         // Without ref symbol; key of its type, TAL, AKA and init records (looked up per call since they can change).
+   };
+
+   /// A function prepared once for inlining, see inlineFunction. Every call clones the body and visits
+   /// its variables in the same order as the analysis did, so renaming a variable is an index lookup.
+   struct InliningTemplate {
+      TermPtr source_{};                                                    // As registered in parser_; a different one means the function has been redefined.
+      std::vector<InliningLocalSlot> locals_{};
+      std::vector<int> local_of_variable_{};                                // Per variable: index into locals_, or -1 if not local to the function.
+      std::vector<std::vector<std::pair<int, bool>>> params_of_variable_{}; // Per variable: (parameter index, accessed via SYMB_REF) for each parameter it refers to, in signature order.
+   };
+
+   const InliningTemplate& getInliningTemplate(const std::string& function_name, const vfm::CppFunctionSignature& sig);
+   static std::vector<std::shared_ptr<TermVar>> collectVariablesForInlining(const TermPtr enc_function); // In the order the template relies on.
+
    /// Embed a function f into a function g at the position f is called from g. E.g.:
    /// f(var) { return var + 1; }
    /// g() { ... y = f(x); ... }
@@ -463,6 +502,31 @@ private:
    /// <param name="include_all_functions">Iff all functions are included, not only the main function.</param>
    void applyToAllMCItems(const std::function<void(std::shared_ptr<MathStruct>)>& f, const bool include_constraints, const bool include_all_functions = false);
 
+   /// <summary>
+   /// Like applyToAllMCItems(apply), but split into a parallel read phase and a serial apply phase. First, select is
+   /// evaluated concurrently on a thread pool for the nodes of all items. Each job collects the selected nodes into a
+   /// vector of its own, so there's no shared state to lock. Then, apply is called on the selected nodes serially, in
+   /// traversal order, once per distinct node (nodes shared among several items, such as compound structures, are
+   /// changed only once). This makes the result (including the log) independent of the number of threads.
+   /// select must only read, i.e., no logging, no parsing and no changes to the nodes (which would invalidate the
+   /// cached attributes along the father chains other threads are traversing). It has to hold for every node on which
+   /// apply does something, and whether it holds must not depend on the changes apply makes. INIT formulas go through
+   /// parser_ and the TAL, so they are handled serially by applyToMCItemInitFormulas.
+   /// </summary>
+   void applyToSelectedMCNodes(
+      const std::function<bool(const MathStructPtr&)>& select,
+      const std::function<void(const MathStructPtr&)>& apply,
+      const bool include_constraints,
+      const bool include_all_functions = false);
+
+   /// Pointers to the roots of all MC items except the INIT formulas, in the order of applyToAllMCItems.
+   /// Roots of dynamic term metas are taken from (and written back to) dynamic_term_metas_copy.
+   std::vector<TermPtr*> getMCItemRoots(
+      const bool include_constraints,
+      const bool include_all_functions,
+      std::map<std::string, std::map<int, std::shared_ptr<Term>>>& dynamic_term_metas_copy);
+   void applyToMCItemInitFormulas(const std::function<void(std::shared_ptr<MathStruct>)>& f);
+
    std::string serializeKratos(
       const TermPtr main_formula,
       const std::string& entry_function_name,
@@ -473,6 +537,18 @@ private:
       const std::map<std::string, std::string>& all_variables_except_immutable_enum_and_bool_with_type,
       VariablesWithKinds& fsm_controlled) const;
 
+   /// Writes the Kratos code into the sink piece by piece rather than assembling it as a whole first.
+   void serializeKratos(
+      OutputSink& out,
+      const TermPtr main_formula,
+      const std::string& entry_function_name,
+      const std::map<std::string, std::string>& enum_values,
+      const std::vector<std::string>& variables_ordered,
+      const std::set<std::string> blacklist,
+      const bool native_env_model_wf,
+      const std::map<std::string, std::string>& all_variables_except_immutable_enum_and_bool_with_type,
+      VariablesWithKinds& fsm_controlled) const;
+
    /// <summary>
    /// Prints most members of the CppParser class.
    /// </summary>
@@ -484,6 +560,7 @@ private:
    void addPlainEnumVariable(const std::string& enum_name, const std::shared_ptr<std::map<float, std::string>> values);
 
    std::map<std::string, int> function_call_counters_{};
+   std::map<std::string, InliningTemplate> inlining_templates_{};
    std::string main_function_name_{};
    std::string main_namespace_name_{};
    std::map<std::string, std::string> using_mapping_{};
@@ -492,6 +569,8 @@ private:
    std::map<std::string, CppTypeWithQualifiers> types_of_variables_{};
    std::vector<std::string> variables_ordering_{};
    std::vector<CppType> data_types_{};
+   int node_parallelism_threads_{ 0 };
+   int min_nodes_per_parallel_job_{ MIN_NODES_PER_PARALLEL_JOB };
    std::set<std::string> ignore_tokens_for_functions_{ "const", "&" };
    
    std::vector<TermPtr> list_of_nusmv_constraints_{};
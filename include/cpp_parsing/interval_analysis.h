@@ -0,0 +1,112 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+#pragma once
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace vfm {
+
+/// \brief Interval abstract interpretation over a set of assignments "x = expression".
+///
+/// Variables are interned to dense ids, their intervals live in one table. Expressions are
+/// stored in postorder in one node array; operator nodes carry a client-defined operator id
+/// which is handed to the transfer function together with the intervals of the (one or two)
+/// operands. Every assignment depends on the variables its expression reads; solve() runs
+/// a worklist over the assignments (starting in the order they were added) until no interval
+/// changes anymore:
+///
+///     interval(x) = initial(x) JOIN expression_1(x) JOIN ... JOIN expression_n(x)
+///
+/// An interval with first > second is empty (bottom), like the ranges of the
+/// TypeAbstractionLayer; an operator with an empty operand yields an empty interval.
+///
+/// To guarantee termination on cyclic dependencies (x = x + 1), a bound that has grown
+/// WIDENING_DELAY times is widened to the next threshold beyond it (the constants of all
+/// expressions and the bounds of all initial intervals). If there is no such threshold, the
+/// bound grows once more and is then frozen; such variables are reported by
+/// getVariablesWithFrozenBounds(), their intervals are not sound.
+class IntervalAnalysis {
+public:
+   using Interval = std::pair<float, float>;
+   using TransferFunction = std::function<Interval(const int operator_id, const Interval& operand1, const Interval& operand2)>;
+
+   static constexpr int WIDENING_DELAY{ 3 };
+   static const Interval EMPTY;
+
+   explicit IntervalAnalysis(const TransferFunction& transfer);
+
+   int getVariableId(const std::string& name);
+
+   /// The interval the variable has regardless of assignments (e.g., from its type). Variables
+   /// without an initial interval start empty.
+   void setInitialInterval(const int variable_id, const Interval& interval);
+
+   /// Use these to write the expression of an assignment in postorder, then call addAssignment
+   /// with the index of the root. Operator nodes refer to their operands by index.
+   int addConstant(const float value);
+   int addVariable(const int variable_id);
+   int addOperator(const int operator_id, const std::vector<int>& operands);
+
+   /// Returns the id of the assignment.
+   int addAssignment(const int target_variable_id, const int expression_root);
+
+   /// Runs to the fixpoint; returns the number of assignment evaluations.
+   long solve();
+
+   Interval getInterval(const int variable_id) const;
+   Interval getInterval(const std::string& name) const;
+   bool isConstant(const int variable_id) const;
+   const std::string& getVariableName(const int variable_id) const;
+   int getNumVariables() const;
+   std::vector<int> getVariablesWithFrozenBounds() const;
+
+private:
+   enum class NodeKind { constant, variable, optor };
+
+   struct Node {
+      NodeKind kind_{};
+      int id_{};             // Variable or operator id.
+      float value_{};
+      int first_operand_{};  // Into operands_.
+      int num_operands_{};
+   };
+
+   struct Assignment {
+      int target_{};
+      int first_node_{};     // The expression consists of the nodes first_node_ .. root_.
+      int root_{};
+   };
+
+   struct VariableState {
+      std::string name_{};
+      Interval interval_{ EMPTY };
+      int growths_low_{};
+      int growths_high_{};
+      bool frozen_low_{};
+      bool frozen_high_{};
+      std::vector<int> readers_{}; // Assignments reading the variable.
+   };
+
+   Interval evaluate(const Assignment& assignment);
+   bool joinInto(VariableState& variable, const Interval& interval);
+
+   TransferFunction transfer_{};
+   std::unordered_map<std::string, int> variable_ids_{};
+   std::vector<VariableState> variables_{};
+   std::vector<Node> nodes_{};
+   std::vector<int> operands_{};
+   std::vector<Assignment> assignments_{};
+   std::vector<float> thresholds_{};
+   std::vector<Interval> scratch_{};
+   int first_node_of_next_assignment_{ 0 };
+};
+
+} // vfm
@@ -6,6 +6,7 @@
 /// @file
 #pragma once
 #include "parsable.h"
+#include "vfm_heap.h"
 #include <functional>
 #include <set>
 #include <map>
@@ -15,8 +16,6 @@
 
 namespace vfm { class DataPack; }
 std::ostream& operator<<(std::ostream &os, const vfm::DataPack & m);
-constexpr auto VFM_HEAP_SIZE = 1000000;
-constexpr auto VFM_HEAP_EMPTY_VALUE = 0;
 
 namespace vfm {
 
@@ -122,6 +121,10 @@ public:
    void initializeValuesBy(const DataPack& other);
    void initializeValuesBy(const std::shared_ptr<DataPack> other);
 
+   /// \brief Snapshot of this DataPack. Heap pages are shared with this until either side writes to them,
+   /// so consecutive states of a trace only hold their own copy of the pages that actually changed.
+   std::shared_ptr<DataPack> fork() const;
+
    std::string toString() const;
    std::string toStringHeap() const;
    std::string toValString(const std::string& var_name);
@@ -271,7 +274,7 @@ public:
    int deleteHeapCells(const int cells);
    int getUsedHeapSize() const;
 
-   std::vector<float> getVfmMemory() const;
+   const VfmHeap& getVfmMemory() const;
    void addStringToDataPack(const std::string& string_raw, const std::string& var_name);
    std::string printHeap(const std::string& varname, const std::string& default_on_undeclared = "") const;
    void isStringAtAdressWhichComparesTo(const std::string& address_var, const std::string& comp_string, bool& same_length, bool& same);
@@ -309,7 +312,7 @@ public:
    /// TODO: Handle bool and char; for now this works only with float externals (unless you know from somewhere else which type your entry is).
    void precalculateExternalAddresses(int max_address_exclusive = -1, int min_address_inclusive = -1);
 
-   std::vector<void*> getPrecalculatedExternalAddresses();
+   const std::vector<void*>& getPrecalculatedExternalAddresses() const;
 
    void setParserForProgramParsing(const std::shared_ptr<FormulaParser> parser);
 
@@ -323,7 +326,7 @@ public:
 
    using AssociationFunction = std::function<void*(
       const int heap_address,
-      const std::vector<float>& vfm_memory,
+      const VfmHeap& vfm_memory,
       const std::string& optional_var_name, // If the address is labeled, there MAY be the name stored here to allow for faster processing.
       const std::map<const std::string, int>& names_to_addresses, 
       const std::map<const int, std::string>& addresses_to_names,
@@ -333,13 +336,13 @@ public:
 
    using AssociationFunctionSimple = std::function<void*(
       const int heap_address, 
-      const std::vector<float>& vfm_memory,
+      const VfmHeap& vfm_memory,
       const std::map<const std::string, int>& names_to_addresses, 
       const std::map<const int, std::string>& addresses_to_names)>;
 
    using AssociationFunctionVerySimple = std::function<void*(
       const int heap_address, 
-      const std::vector<float>& vfm_memory,
+      const VfmHeap& vfm_memory,
       const std::map<const std::string, int>& names_to_addresses)>;
 
    using AssociationFunctionVeryVerySimple = std::function<void*(
@@ -377,6 +380,7 @@ public:
 
 private:
    std::map<AssociationType, std::vector<AssociationFunction>> association_functions_{};
+   bool has_custom_association_functions_{ false }; /// Any beyond the default ones looking up the static external addresses.
 public:
 #endif // DISALLOW_EXTERNAL_ASSOCIATIONS
 
@@ -385,9 +389,12 @@ public:
 private:
    static std::shared_ptr<DataPack> instance_;
 
+   /// True if var_name is a plain heap variable at the same address in both DataPacks, and the heap page is shared, i.e., equal.
+   bool sharesHeapCellWith(const DataPack& other, const std::string& var_name) const;
+
    std::shared_ptr<FormulaParser> parser_for_program_parsing_{};
    int external_addresses_need_recalculation_from_{ 0 };
-   std::vector<void*> precalculated_external_addresses_{};
+   std::vector<void*> precalculated_external_addresses_{}; /// Sized to VFM_HEAP_SIZE on first use, never reallocated afterwards.
 
    int current_recursion_var_depth_id_{ 0 };
    int first_free_heap_index_{ 0 };
@@ -397,7 +404,7 @@ private:
    std::map<const std::string, std::shared_ptr<DataSrcArray>> arrays_{};
    std::map<const std::string, int> names_to_addresses_{};
    std::map<const int, std::string> addresses_to_names_{};
-   std::vector<float> vfm_memory_{};
+   VfmHeap vfm_memory_{};
    std::set<std::string> internal_variables_{};
    std::map<const std::string, bool*> static_external_bool_addresses_{};
    std::map<const std::string, char*> static_external_char_addresses_{};
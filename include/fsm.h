@@ -24,6 +24,7 @@
 #include "term_logic_eq.h"
 #include "static_helper.h"
 #include "geometry/images.h"
+#include "fsm_graph_renderer.h"
 #include "term_var.h"
 #include "meta_rule.h"
 #include "cpp_parsing/cpp_type_struct.h"
@@ -163,6 +164,10 @@ public:
    /// format is produced.
    int createGraficOfCurrentGraph(const std::string& base_filename, const bool mark_current_state = true, const std::string& format = "", const bool mc_mode = false, const GraphvizOutputSelector which = GraphvizOutputSelector::all) const;
 
+   /// \brief States, labels and transitions of the FSM, for painting it with an FSMGraphRenderer
+   /// rather than Graphviz. Labels are formatted as in the DOT output.
+   FSMGraphTopology getGraphTopology() const;
+
    inline void createStateVisualizationOfCurrentState(
       const std::string& filename,
       std::vector<PainterVariableDescription>& variables_to_be_painted,
@@ -2630,6 +2635,7 @@ std::shared_ptr<MathStruct> FSM<F>::collectIfConditions(const std::shared_ptr<Ma
          vec.push_back(condition->getOperands()[0]);
          vec.push_back(cond);
          condition->getOperands()[0] = std::make_shared<TermLogicAnd>(vec);
+         condition->invalidateAttributes();
       }
 
       *trace = m2;
@@ -3952,6 +3958,30 @@ int FSM<F>::createGraficOfCurrentGraph(const std::string& base_filename, const b
    }
 }
 
+template<class F>
+inline FSMGraphTopology FSM<F>::getGraphTopology() const
+{
+   FSMGraphTopology topology{};
+   std::set<std::pair<int, int>> transitions{};
+
+   topology.initial_state_ = getInitialStateNum();
+
+   for (const auto& state : states_plain_set_) {
+      topology.states_.push_back(state);
+      const auto name = state_id_to_state_name_.find(state);
+      const std::string state_name = name != state_id_to_state_name_.end() ? name->second : std::to_string(state);
+      topology.labels_[state] = StaticHelper::replaceAll(StaticHelper::replaceAll(StaticHelper::replaceAll(state_name, "::::", "\n"), ":::", " = "), "..:..", "-");
+   }
+
+   for (const auto& trans : *transitions_plain_set_) {
+      if (transitions.insert({ trans->state_source_, trans->state_destination_ }).second) {
+         topology.transitions_.push_back({ trans->state_source_, trans->state_destination_ });
+      }
+   }
+
+   return topology;
+}
+
 ///////////////// EO XWizard/Graphviz output ////////////////
 
 template<class F>
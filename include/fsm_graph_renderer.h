@@ -0,0 +1,84 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+#pragma once
+
+#include "failable.h"
+#include "geometry/images.h"
+#include "geometry/gif_writer.h"
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vfm {
+namespace fsm {
+
+/// The plain graph of an FSM, as far as needed for painting it.
+struct FSMGraphTopology {
+   std::vector<int> states_{};
+   std::map<int, std::string> labels_{};
+   std::vector<std::pair<int, int>> transitions_{}; // (source, destination), no duplicates.
+   int initial_state_{ -1 };
+};
+
+/// \brief In-process alternative to createGraficOfCurrentGraph for replaying counterexamples:
+/// the graph is laid out once on construction (layered by BFS distance from the initial state),
+/// and painted once into a base image. Marking another current state only restores the box of
+/// the previously marked state from the base image and paints the new one, i.e., a step costs
+/// time proportional to the size of two state boxes rather than a Graphviz run.
+///
+/// Output is PNG (or any raster type) per step, an animated GIF with one frame per step, or PDF
+/// which is re-painted from the cached geometry.
+class FSMGraphRenderer : public Failable {
+public:
+   struct NodeGeometry {
+      float x_{};      // Top-left corner.
+      float y_{};
+      float width_{};
+      float height_{};
+      std::vector<std::string> label_lines_{};
+   };
+
+   FSMGraphRenderer(const FSMGraphTopology& topology);
+
+   /// The image with the given state marked as current; -1 for none.
+   const Image& render(const int current_state);
+
+   void store(const int current_state, const std::string& filename, const OutputType type = OutputType::png);
+
+   /// Starts collecting frames into an animated GIF, written progressively to the file.
+   bool startAnimation(const std::string& filename, const int frame_delay_hundredths = 50);
+   void addAnimationFrame(const int current_state);
+   void finishAnimation();
+   bool isAnimationRunning() const;
+
+   const NodeGeometry& getNodeGeometry(const int state) const;
+   int getWidth() const;
+   int getHeight() const;
+
+private:
+   void layout(const FSMGraphTopology& topology);
+   void paintGraph(Image& img) const;
+   void paintEdge(Image& img, const int source, const int destination) const;
+   void paintNode(Image& img, const int state, const bool current) const;
+
+   std::map<int, NodeGeometry> nodes_{};
+   std::vector<std::pair<int, int>> edges_{};
+   int width_{};
+   int height_{};
+
+   Image base_{};          // Graph without a current state.
+   Image current_image_{}; // Base image plus the mark of current_state_.
+   int current_state_{ -1 };
+
+   GifWriter gif_writer_{};
+   bool animation_running_{ false };
+   int frame_delay_{};
+};
+
+} // fsm
+} // vfm
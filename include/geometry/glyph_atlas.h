@@ -0,0 +1,74 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+#pragma once
+
+#include "geometry/images.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace vfm {
+
+/// \brief All glyphs of an ASCII table (as used by Image::writeAsciiText) packed side by side into one bitmap.
+///
+/// Text can be measured and drawn from the atlas without copying glyph images. Additionally, renderLine()
+/// turns a line of text into runs of "ink" pixels (i.e., non-black, the ones a FUNC_IGNORE_BLACK_CONVERT_TO_...
+/// blend function paints); the result is cached per string, since labels tend to repeat from frame to frame.
+class GlyphAtlas {
+public:
+   struct GlyphRect {
+      int x_{};      // Within the atlas.
+      int width_{};
+      int height_{};
+   };
+
+   struct Run {
+      int y_{};
+      int x_begin_{}; // [x_begin_, x_end_), relative to the top-left corner of the line.
+      int x_end_{};
+   };
+
+   struct RenderedLine {
+      int width_{};
+      int height_{};
+      std::vector<Run> runs_{};
+   };
+
+   static constexpr size_t MAX_CACHED_LINES{ 4096 }; // The cache is dropped as a whole when full.
+
+   explicit GlyphAtlas(const std::vector<Image>& ascii_table);
+
+   /// The atlas of Image::MONOSPACE_NEW_CACHED_ASCII_TABLE, built on first use.
+   static const GlyphAtlas& getMonospace();
+
+   /// Same glyph choice as Image::getAsciiImage, i.e., '~' for everything not printable.
+   const GlyphRect& getGlyph(const char symbol) const;
+   Color getPixel(const GlyphRect& glyph, const int x, const int y) const;
+   bool isInk(const GlyphRect& glyph, const int x, const int y) const;
+
+   /// Sum of the widths of all glyphs (a '\n' counts as '~') and the height of the last one, which is
+   /// what writeAsciiText uses for centering.
+   std::pair<int, int> measure(const std::string& text) const;
+
+   /// The line must not contain '\n'. Thread-safe.
+   std::shared_ptr<const RenderedLine> renderLine(const std::string& line) const;
+
+private:
+   int width_{};
+   int height_{};
+   std::vector<Color> pixels_{};
+   std::vector<bool> ink_{};
+   std::vector<GlyphRect> glyphs_{};
+
+   mutable std::mutex cache_mutex_{};
+   mutable std::unordered_map<std::string, std::shared_ptr<const RenderedLine>> cache_{};
+};
+
+} // vfm
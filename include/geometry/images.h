@@ -10,10 +10,12 @@
 #include "geometry/polygon_3d.h"
 #include "geometry/vector_3d.h"
 #include "geometry/plane_3d.h"
+#include "geometry/polygon_rasterizer.h"
 #include "geometry/haru/hpdf.h"
 #include "data_pack.h"
 #include "static_helper.h"
 #include <stdio.h>
+#include <atomic>
 #include <vector>
 #include <functional>
 #include <limits>
@@ -126,13 +128,23 @@ const Color DARK_ORANGE = Color(180, 125, 0);
 const auto FUNC_RETURN_TARGET_PIXEL = [](const Color& oldPix, const Color& newPix) { return newPix; };
 const auto FUNC_IGNORE_BLACK = [](const Color& oldPix, const Color& newPix) { return newPix.r == 0 && newPix.g == 0 && newPix.b == 0 ? oldPix : newPix; };
 const auto FUNC_IGNORE_WHITE = [](const Color& oldPix, const Color& newPix) { return newPix.r == 255 && newPix.g == 255 && newPix.b == 255 ? oldPix : newPix; };
-const auto FUNC_IGNORE_BLACK_CONVERT_TO_YELLOW = [](const Color& oldPix, const Color& newPix) { return newPix.r == 0 && newPix.g == 0 && newPix.b == 0 ? oldPix : YELLOW; };
-const auto FUNC_IGNORE_BLACK_CONVERT_TO_BLUE = [](const Color& oldPix, const Color& newPix) { return newPix.r == 0 && newPix.g == 0 && newPix.b == 0 ? oldPix : BLUE; };
-const auto FUNC_IGNORE_BLACK_CONVERT_TO_GREEN = [](const Color& oldPix, const Color& newPix) { return newPix.r == 0 && newPix.g == 0 && newPix.b == 0 ? oldPix : GREEN; };
-const auto FUNC_IGNORE_BLACK_CONVERT_TO_DARK_GREEN = [](const Color& oldPix, const Color& newPix) { return newPix.r == 0 && newPix.g == 0 && newPix.b == 0 ? oldPix : DARK_GREEN; };
-const auto FUNC_IGNORE_BLACK_CONVERT_TO_RED = [](const Color& oldPix, const Color& newPix) { return newPix.r == 0 && newPix.g == 0 && newPix.b == 0 ? oldPix : RED; };
-const auto FUNC_IGNORE_BLACK_CONVERT_TO_WHITE = [](const Color& oldPix, const Color& newPix) { return newPix.r == 0 && newPix.g == 0 && newPix.b == 0 ? oldPix : WHITE; };
-const auto FUNC_IGNORE_BLACK_CONVERT_TO_BLACK = [](const Color& oldPix, const Color& newPix) { return newPix.r == 0 && newPix.g == 0 && newPix.b == 0 ? oldPix : BLACK; };
+
+/// Keeps the old pixel where the new one is black, paints the given color elsewhere. A named type rather than
+/// a lambda, so that writeAsciiText can recognize it within the std::function and paint whole runs of pixels.
+struct IgnoreBlackConvertTo
+{
+   Color color_;
+
+   Color operator()(const Color& oldPix, const Color& newPix) const { return newPix.r == 0 && newPix.g == 0 && newPix.b == 0 ? oldPix : color_; }
+};
+
+const IgnoreBlackConvertTo FUNC_IGNORE_BLACK_CONVERT_TO_YELLOW{ YELLOW };
+const IgnoreBlackConvertTo FUNC_IGNORE_BLACK_CONVERT_TO_BLUE{ BLUE };
+const IgnoreBlackConvertTo FUNC_IGNORE_BLACK_CONVERT_TO_GREEN{ GREEN };
+const IgnoreBlackConvertTo FUNC_IGNORE_BLACK_CONVERT_TO_DARK_GREEN{ DARK_GREEN };
+const IgnoreBlackConvertTo FUNC_IGNORE_BLACK_CONVERT_TO_RED{ RED };
+const IgnoreBlackConvertTo FUNC_IGNORE_BLACK_CONVERT_TO_WHITE{ WHITE };
+const IgnoreBlackConvertTo FUNC_IGNORE_BLACK_CONVERT_TO_BLACK{ BLACK };
 const auto FUNC_IGNORE_BLACK_CONVERT_TO_COMPLEMENT = [](const Color& oldPix, const Color& newPix) { return newPix.r == 0 && newPix.g == 0 && newPix.b == 0 ? oldPix : Color(255 - oldPix.r, 255 - oldPix.g, 255 - oldPix.b); };
 
 const Color PAVEMENT_COLOR = LIGHT_GREY;
@@ -244,13 +256,22 @@ public:
       display_window_y_ = std::stof(dis[1]);
       display_window_z_ = std::stof(dis[2]);
 
+      changedRotationX();
+      changedRotationY();
+      changedRotationZ();
+      changedDisplay();
+
       return true;
    }
 
-   inline void changedRotationX() const { changed_rotation_x_ = true; }
-   inline void changedRotationY() const { changed_rotation_y_ = true; }
-   inline void changedRotationZ() const { changed_rotation_z_ = true; }
-   inline void changedDisplay() const { changed_display_ = true; }
+   inline void changedRotationX() const { changed_rotation_x_ = true; version_ = nextVersion(); }
+   inline void changedRotationY() const { changed_rotation_y_ = true; version_ = nextVersion(); }
+   inline void changedRotationZ() const { changed_rotation_z_ = true; version_ = nextVersion(); }
+   inline void changedDisplay() const { changed_display_ = true; version_ = nextVersion(); }
+
+   /// Changes with every modification of the perspective and is unique among all perspective objects
+   /// (except for copies in the same state). Lets translators cache data derived from the perspective.
+   inline unsigned long long getVersion() const { return version_; }
 
    inline float getCameraX() const { return camera_x_; }
    inline float getCameraY() const { return camera_y_; }
@@ -261,9 +282,9 @@ public:
    inline float getDisplayWindowX() const { return display_window_x_; }
    inline float getDisplayWindowY() const { return display_window_y_; }
    inline float getDisplayWindowZ() const { return display_window_z_; }
-   inline void setCameraX(const float val) { camera_x_ = val; }
-   inline void setCameraY(const float val) { camera_y_ = val; }
-   inline void setCameraZ(const float val) { camera_z_ = val; }
+   inline void setCameraX(const float val) { camera_x_ = val; version_ = nextVersion(); }
+   inline void setCameraY(const float val) { camera_y_ = val; version_ = nextVersion(); }
+   inline void setCameraZ(const float val) { camera_z_ = val; version_ = nextVersion(); }
    inline void setCameraRotationX(const float val) { camera_rotation_x_ = val; changedRotationX(); }
    inline void setCameraRotationY(const float val) { camera_rotation_y_ = val; changedRotationY(); }
    inline void setCameraRotationZ(const float val) { camera_rotation_z_ = val; changedRotationZ(); }
@@ -349,6 +370,12 @@ public:
    }
 
 private:
+   static inline unsigned long long nextVersion()
+   {
+      static std::atomic<unsigned long long> counter{ 0 };
+      return ++counter;
+   }
+
    float camera_x_{};
    float camera_y_{};
    float camera_z_{};
@@ -376,6 +403,8 @@ private:
    float display_window_z_{};
 
    mutable Pln3D display_plane_{ { 0, 0, 0 }, CAMERA_PLANE_IN_CAMERA_COORDINATES.normal_vector_ };
+
+   mutable unsigned long long version_{ nextVersion() };
 };
 
 class VisTranslator : public Failable
@@ -408,6 +437,12 @@ public:
       return reverseTranslatePolygonCore(pol);
    }
 
+   /// Same as calling translatePolygon for each polygon, but translators may process the whole batch at once.
+   inline std::vector<Pol2D> translatePolygons(const std::vector<Pol3D>& pols)
+   {
+      return translatePolygonsCore(pols);
+   }
+
    virtual inline void setPerspective(const std::shared_ptr<VisPerspective> perspective)
    {
       perspective_ = perspective;
@@ -438,6 +473,18 @@ public:
       return result;
    }
 
+   inline virtual std::vector<Pol2D> translatePolygonsCore(const std::vector<Pol3D>& pols)
+   {
+      std::vector<Pol2D> result{};
+      result.reserve(pols.size());
+
+      for (const auto& pol : pols) {
+         result.push_back(translatePolygonCore(pol));
+      }
+
+      return result;
+   }
+
    inline virtual Pol3D reverseTranslatePolygonCore(const Pol3D& pol)
    {
       Pol3D result{};
@@ -476,6 +523,8 @@ enum class CoordTrans {
    dont_do_it
 };
 
+class GlyphAtlas;
+
 class Image {
 public:
    // Note that on Linux the default path is relative to the project root.
@@ -487,6 +536,7 @@ public:
       "../examples/monospace_new.ppm", const int symb_width_pixel = 12, const int offset_left_pixel = 0);
 
    static Image getAsciiImage(const char symbol, const std::vector<Image>& ascii_table);
+   static const Image& getAsciiImageRef(const char symbol, const std::vector<Image>& ascii_table);
 
    Image(const int width, const int height);
    Image();
@@ -520,6 +570,8 @@ public:
    Image copyArea(const int x0, const int y0, const int x1, const int y1) const;
 
    /// Note that tilde ~ is not printable for now (TODO).
+   /// With the default table, glyphs come from GlyphAtlas::getMonospace(); for the FUNC_IGNORE_BLACK_CONVERT_TO_...
+   /// functions, the text is painted as cached pixel runs without calling f per pixel.
    void writeAsciiText(
       const float x, 
       const float y, 
@@ -555,7 +607,14 @@ public:
 
    Image scale(const Vec2Df factor);
 
-   void fillPolygon(const Polygon3D<float>& pol, const Color& col = WHITE); // Accepts 2D polygon, as well.
+   /// Scanline fill, see PolygonRasterizer. Anti-aliasing blends the edge pixels with the background
+   /// (the PDF output is not affected by either option).
+   void fillPolygon(const Polygon3D<float>& pol, const Color& col = WHITE, const FillRule rule = FillRule::even_odd, const bool anti_aliasing = false); // Accepts 2D polygon, as well.
+
+   /// Counterparts of drawPolygon and fillPolygon for polygons that have already been translated, e.g., a whole
+   /// batch at once via getTranslator()->translatePolygons(...) (no coordinate translation).
+   void drawTranslatedPolygon(const Pol2D& translated_pol, const Color& col = WHITE, const bool close_polygon = true, const bool paint_nodes = false, const bool print_coordinates = false);
+   void fillTranslatedPolygon(const Pol2D& translated_pol, const Color& col = WHITE, const FillRule rule = FillRule::even_odd, const bool anti_aliasing = false);
 
    void drawPolygons(const std::vector<Polygon2D<float>>& pols);
    void drawPolygons(
@@ -570,7 +629,7 @@ public:
    /// Note this expects the vertices ordered as a non-self-overlapping "triangle strip": Top-Left, Top-Right, Bottom-Left, Bottom-Right.
    void fillQuad(const Vec2Df v1, const Vec2Df v2, const Vec2Df v3, const Vec2Df v4, const Color& col = WHITE);
 
-   /// Fill a singular triangle.
+   /// Fill a singular triangle (no coordinate translation).
    void fillTriangle(Vec2Df v1, Vec2Df v2, Vec2Df v3, const Color& col = WHITE);
 
    std::shared_ptr<VisTranslator> getTranslator() const;
@@ -628,11 +687,20 @@ private:
    /// Note that this method does not preserve the original image.
    void resize(const int new_width, const int new_height);
    void putPixelUnsafe(int x, int y, const Color& c);
+   void expandToInclude(const int x, const int y); // Only if auto-expansion is active in the respective direction.
+   void fillSpanUnsafe(const int y, const int x_begin, const int x_end, const Color& c);
+   void writeAsciiTextWithTable(
+      const float x,
+      const float y,
+      const std::string text,
+      const CoordTrans translate_position,
+      const bool center,
+      const std::function<Color(const Color& oldPix, const Color& newPix)>& f,
+      const std::vector<Image>& ascii_table);
+   void writeAsciiTextLine(const GlyphAtlas& atlas, const std::string& line, const int x, const int y, const std::function<Color(const Color& oldPix, const Color& newPix)>& f);
+   void rasterizePolygon(const std::vector<Vec2Df>& points, const Color& col, const FillRule rule, const bool anti_aliasing); // No coordinate translation, no PDF.
    void storePPM(const std::string& name) const;
 
-   // Helper methods for fillTriangle
-   void fillBottomFlatTriangle(Vec2Df v1, Vec2Df v2, Vec2Df v3, const Color& col);
-   void fillTopFlatTriangle(Vec2Df v1, Vec2Df v2, Vec2Df v3, const Color& col);
    void clipLine(int& x1, int& y1, int& x2, int& y2);
    
    int width_{};
@@ -642,6 +710,7 @@ private:
    int expand_dynamically_to_the_bottom_{}; // ---
 
    std::shared_ptr<VisTranslator> translator_{ std::make_shared<DefaultTranslator>() };
+   PolygonRasterizer rasterizer_{};
 
    // PDF stuff
    HPDF_Doc  pdf_document_{ nullptr };
@@ -0,0 +1,69 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+#pragma once
+
+#include "geometry/polygon_2d.h"
+#include <functional>
+#include <vector>
+
+namespace vfm {
+
+enum class FillRule {
+   even_odd, // A point is inside if a ray from it crosses the outline an odd number of times.
+   non_zero  // A point is inside if the outline winds around it at least once (in any direction).
+};
+
+/// \brief Scanline rasterizer for polygons with an edge table and an active edge list.
+///
+/// Produces horizontal spans of pixels within a width x height canvas; the caller writes them into its
+/// pixel buffer. Without anti-aliasing a pixel belongs to the polygon iff its center does, so polygons
+/// sharing an edge don't overlap or leave gaps. With anti-aliasing every pixel row is sampled on
+/// SUBSAMPLES_Y sub-scanlines, each of which contributes the exact horizontal overlap of its spans with
+/// the pixel; spans are then reported with their coverage in (0, 1].
+///
+/// The object keeps its buffers between calls, so painting many polygons does not allocate.
+class PolygonRasterizer {
+public:
+   using SpanCallback = std::function<void(const int y, const int x_begin, const int x_end, const float coverage)>; // [x_begin, x_end)
+
+   static constexpr int SUBSAMPLES_Y{ 4 };
+
+   void rasterize(
+      const std::vector<Vec2Df>& points,
+      const int width,
+      const int height,
+      const FillRule rule,
+      const bool anti_aliasing,
+      const SpanCallback& span);
+
+private:
+   struct Edge {
+      float y_top_{};
+      float y_bottom_{};
+      float x_at_top_{};
+      float dx_per_dy_{};
+      int winding_{};   // +1 downwards, -1 upwards.
+      float x_{};       // At the current scanline.
+   };
+
+   void buildEdgeTable(const std::vector<Vec2Df>& points);
+   void advanceTo(const float y);                                                  // Updates the active edges.
+   template<class F> void forEachInsideInterval(const FillRule rule, const F& f);  // f(x_left, x_right) of the current scanline.
+   void addCoverage(const float x_left, const float x_right, const float weight);
+
+   std::vector<Edge> edges_{};     // Sorted by y_top_.
+   std::vector<int> active_{};     // Indices into edges_, sorted by x_.
+   size_t next_edge_{};
+   int width_{};
+
+   std::vector<float> coverage_{}; // Per pixel of the current row, anti-aliasing only...
+   std::vector<float> full_{};     // ...plus a difference array for fully covered runs.
+   int row_min_x_{};
+   int row_max_x_{};
+};
+
+} // vfm
@@ -0,0 +1,52 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+#pragma once
+
+#include "geometry/images.h"
+#include <array>
+#include <vector>
+
+namespace vfm {
+
+/// \brief The camera of a VisPerspective as one 4x4 view-projection matrix, as used by Plain3DTranslator.
+///
+/// A world point p maps to the homogeneous (X, Y, Z, W) = M * (p, 1), where W is the depth of the point
+/// in camera coordinates and (X / W, Y / W) its position on the image. The matrix is rebuilt only when
+/// the perspective (see VisPerspective::getVersion), the mirroring or the image size changes.
+///
+/// Polygons are transformed as a whole, first all vertices into a structure-of-arrays buffer (a plain
+/// loop the compiler vectorizes), then clipped in a single Sutherland-Hodgman pass. Points count as visible
+/// if they are in front of the camera; edges leaving the visible part are cut at the display plane.
+class ViewProjection {
+public:
+   /// Cheap if nothing changed since the last call.
+   void update(const VisPerspective& perspective, const bool mirrored, const float width, const float height);
+
+   /// NaN for points behind the camera.
+   Vec2D project(const Vec3D& point) const;
+
+   /// Empty if no point is in front of the camera.
+   Pol2D projectPolygon(const Pol3D& pol);
+
+private:
+   void transformVertices(const std::vector<Vec3D>& points); // Into xs_, ys_, ws_.
+
+   std::array<float, 16> matrix_{}; // Row-major.
+   float display_z_{};              // Depth of the display plane.
+
+   bool valid_{ false };
+   unsigned long long perspective_version_{};
+   bool mirrored_{};
+   float width_{};
+   float height_{};
+
+   std::vector<float> xs_{};
+   std::vector<float> ys_{};
+   std::vector<float> ws_{};
+};
+
+} // vfm
@@ -57,6 +57,7 @@ class TermArray;
 class TermCompound;
 class TermCompoundOperator;
 class MetaRule;
+class OutputSink;
 
 namespace earley {
    class Grammar;
@@ -215,6 +216,22 @@ enum class DotTreatment
    as_operator
 };
 
+/// Attributes of the sub-tree below (and including) a node. They are computed bottom-up on first
+/// request, stored at the node, and dropped along the father chain when the sub-tree changes
+/// (replaceOperand*, swap*, setChildrensFathers with a new child, etc.).
+/// Sub-trees containing compounds or invalid nodes are not cacheable (cacheable_ == false,
+/// all other fields unset); for them, the attributes are calculated by traversal as before.
+struct NodeAttributes {
+   bool cacheable_{ false };
+   bool constant_{ false };       /// isOverallConstant()
+   bool sideeffects_{ false };    /// hasSideeffects()
+   bool purely_numbers_{ false }; /// consistsPurelyOfNumbers()
+   int node_count_{ 0 };          /// getNodeCount()
+   int depth_{ 0 };               /// A leaf has depth 1.
+   size_t hash_{ 0 };             /// Equal for structurally equal sub-trees.
+   std::shared_ptr<const std::set<std::string>> variables_{}; /// Filled on first request only.
+};
+
 class VariablesWithKinds {
 public:
    void addInputVariable(const std::string& var_name) { input_variables_.insert(var_name); }
@@ -1224,12 +1241,26 @@ public:
       const std::shared_ptr<DataPack> data,
       std::set<std::shared_ptr<const MathStruct>>& visited) const;
 
-   virtual std::string serializeK2(const std::map<std::string, std::string>& enum_values, std::pair<std::map<std::string, std::string>, std::string>& additional_functions, int& label_counter) const;
+   virtual void serializeK2(OutputSink& out, const std::map<std::string, std::string>& enum_values, std::pair<std::map<std::string, std::string>, std::string>& additional_functions, int& label_counter) const;
+   std::string serializeK2(const std::map<std::string, std::string>& enum_values, std::pair<std::map<std::string, std::string>, std::string>& additional_functions, int& label_counter) const;
    std::string serializeK2(const std::map<std::string, std::string>& enum_values, std::pair<std::map<std::string, std::string>, std::string>& additional_functions) const;
    std::string serializeK2() const;
 
    int getNodeCount();
    int getLeafCount();
+   int getDepth();
+   size_t getStructuralHash();
+   std::set<std::string> getVariableNames();
+
+   /// Never nullptr, see NodeAttributes.
+   std::shared_ptr<const NodeAttributes> getAttributes();
+
+   /// Drops the cached attributes of this node and of all fathers up to the first one without cached attributes.
+   /// Call after modifying the operands directly, i.e., not via replaceOperand, setChildrensFathers etc.
+   void invalidateAttributes();
+
+   /// If set, each use of a cached attribute is cross-checked against a full re-computation (for debugging, slow).
+   static void setCrossCheckAttributeCache(const bool cross_check);
    int getNodeCount(const TraverseCompoundsType include_compound_structures);
    int getLeafCount(const TraverseCompoundsType include_compound_structures);
    bool printBrackets() const;
@@ -1347,6 +1378,15 @@ private:
       const std::shared_ptr<vfm::Term>& to_father,
       const std::shared_ptr<std::map<std::shared_ptr<Term>, std::shared_ptr<Term>>>& condition_fathers);
 
+   /// Read-only pre-check for applicableMetaRule: matches the structure of the (uncopied) from side
+   /// of a rule against this term, binding metas to formula nodes in a side table. Accepts every
+   /// term applicableMetaRule accepts (and possibly more), so a false answer means the rule
+   /// does not need to be copied at all. In concrete mode, from is a bound formula node.
+   bool mayApplyMetaRule(
+      const std::shared_ptr<vfm::Term>& from,
+      std::map<float, std::shared_ptr<MathStruct>>& bound_metas,
+      const bool concrete = false);
+
    /// Replaces a term t with lambda(t) at specified  positions. This allows
    /// to simply write, e.g.:
    ///   for (@i, 5, 8) { printfln(i) }
@@ -1358,6 +1398,14 @@ private:
 
    static std::shared_ptr<std::vector<std::string>> additional_test_info_;
 
+   std::shared_ptr<NodeAttributes> computeAttributes();
+   void crossCheckAttributes(const NodeAttributes& cached);
+   bool hasSideeffectsByTraversal() const;
+   bool consistsPurelyOfNumbersByTraversal();
+
+   std::shared_ptr<NodeAttributes> attributes_{};
+   static bool cross_check_attribute_cache_;
+
    /// When a father gets redirected, the former child is marked invalid.
    /// Also, children of such terms may get invalid (but don't have to, for efficiency reasons).
    bool is_valid_{ true };
@@ -0,0 +1,71 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+#pragma once
+
+#include "meta_rule.h"
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vfm {
+
+/// \brief Discrimination tree over the "from" patterns of a set of MetaRules, used by MathStruct::simplify
+/// to find the rules worth trying at a node without copying any rule.
+///
+/// Each pattern is flattened in pre-order into a path of symbols "operator/arity". Parts of the pattern which
+/// the matcher in MathStruct::applicableMetaRule can bind to arbitrary sub-trees (metas, optionals and
+/// anyways) become wildcards that skip the corresponding sub-tree of the formula. Constants and conditions are
+/// not looked at, i.e., the candidates are a superset of the applicable rules, and the full (copying) matcher
+/// still has the final say.
+///
+/// Candidates are returned in the order MathStruct::simplify has always tried the rules: first the ones
+/// for the node's operator and arity, then the SYMB_ANYWAY rules, grouped by their arity.
+class MetaRuleIndex
+{
+public:
+   struct Candidate {
+      const MetaRule* rule_{};
+      int group_{};            // 0 for the rules of the node's operator, 1, 2, ... for the SYMB_ANYWAY groups.
+      int order_{};            // Position in the original rule set.
+
+      bool operator<(const Candidate& other) const { return order_ < other.order_; }
+   };
+
+   explicit MetaRuleIndex(const Rules& rules);
+
+   std::vector<Candidate> getCandidates(const MathStructPtr& m) const;
+
+   int size() const;
+
+private:
+   static constexpr int WILDCARD{ -1 };
+
+   struct Node {
+      std::map<int, int> children_{};       // Symbol id ==> node index.
+      int wildcard_child_{ -1 };            // Node index, or -1.
+      std::vector<Candidate> rules_{};      // Rules whose pattern ends here.
+   };
+
+   void insert(const int root_num, const MetaRule& rule, const int group, const int order);
+   void flattenPattern(const MathStructPtr& pattern, std::vector<int>& path);
+   void collect(const int node_num, std::vector<MathStructPtr>& pending, std::vector<Candidate>& result) const;
+
+   void collectFrom(const int root_num, const MathStructPtr& m, std::vector<Candidate>& result) const;
+   int symbolOf(const MathStructPtr& m) const; // Symbol of a formula node, WILDCARD if unknown to the index.
+   int getOrCreateSymbol(const std::string& optor, const int arity);
+   static std::string symbolName(const std::string& optor, const int arity);
+
+   std::vector<Node> nodes_{ Node{} };         // Node 0 is the root of the SYMB_ANYWAY rules.
+   std::map<std::pair<std::string, int>, int> roots_{}; // (Operator, arg_num) ==> root node of its rules.
+   std::map<std::string, int> symbol_ids_{};
+   std::map<int, int> anyway_symbol_ids_{}; // Arity ==> id of the symbol for "any operator with that arity".
+   int size_{ 0 };
+};
+
+} // vfm
@@ -262,10 +262,18 @@ void MCinterpretedTrace::interpolate(const std::string& vehicle_name, FullTrajec
 	double factor = 1.0 / (steps_between + 1);
    int trace_cnt{ 0 };
 
-	for (size_t i = 0; i < editable_trajectory.size() - 1; i++)
+	if (editable_trajectory.empty()) return;
+
+	// Rebuild by appending; inserting into the middle would shift the whole tail once per interpolated step.
+	const FullTrajectory original{ std::move(editable_trajectory) };
+	editable_trajectory.clear();
+	editable_trajectory.reserve(original.size() + (original.size() - 1) * steps_between);
+
+	for (size_t i = 0; i < original.size() - 1; i++)
 	{
-		TrajectoryPosition prev = editable_trajectory[i];
-		TrajectoryPosition next = editable_trajectory[i + 1];
+		const TrajectoryPosition& prev = original[i];
+		const TrajectoryPosition& next = original[i + 1];
+		editable_trajectory.push_back(prev);
 		double next_time = next.first;
 		ParameterMap next_param = next.second;
 		ParameterMap prev_param = prev.second;
@@ -360,29 +368,31 @@ void MCinterpretedTrace::interpolate(const std::string& vehicle_name, FullTrajec
 
 			interp_p.second = interp_params;
 
-			editable_trajectory.insert(editable_trajectory.begin() + i + (j), interp_p);
+			editable_trajectory.push_back(interp_p);
 		}
 
-		i += steps_between;
       trace_cnt += 2;
 	}
+
+	editable_trajectory.push_back(original.back());
 }
 
 void MCinterpretedTrace::interpolateDataPacks(DataPackTrace& data_trace, const size_t steps_between)
 {
-	double factor = 1.0 / (steps_between + 1);
+	if (data_trace.empty()) return;
+
+	// The interpolated steps share the DataPack of the following state, so only pointers are copied here.
+	DataPackTrace interpolated{};
+	interpolated.reserve(data_trace.size() + (data_trace.size() - 1) * steps_between);
 
 	for (size_t i = 0; i < data_trace.size() - 1; i++)
 	{
-		auto data = data_trace[i + 1];
-
-		for (size_t j = 1; j < (steps_between + 1); j++)
-		{
-			data_trace.insert(data_trace.begin() + i + j, data);
-		}
-
-		i += steps_between;
+		interpolated.push_back(data_trace[i]);
+		interpolated.insert(interpolated.end(), steps_between, data_trace[i + 1]);
 	}
+
+	interpolated.push_back(data_trace.back());
+	data_trace = std::move(interpolated);
 }
 
 const std::vector<std::string> MCinterpretedTrace::getVehicleNames(const bool skip_ego) const
@@ -478,12 +488,9 @@ void MCinterpretedTrace::endState()
 
 	m_timestamp_last_state = m_timestamp_this_state;
 
-	// Clear everything related to the current state that has ended.
-	auto temp_data{ std::make_shared<DataPack>() };
-
-	if (m_current_data) {
-		temp_data->initializeValuesBy(m_current_data);
-	}
+	// Clear everything related to the current state that has ended. The next state starts as a
+	// copy-on-write snapshot, so unchanged heap pages are shared across the whole trace.
+	auto temp_data{ m_current_data ? m_current_data->fork() : std::make_shared<DataPack>() };
 
 	associateEnums(*temp_data);
 
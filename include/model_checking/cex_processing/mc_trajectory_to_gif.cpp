@@ -237,6 +237,7 @@ std::shared_ptr<RoadGraph> LiveSimGenerator::getRoadGraphTopologyFrom(const MCTr
 
 void vfm::mc::trajectory_generator::LiveSimGenerator::equipRoadGraphWithCars(
    const std::shared_ptr<RoadGraph> r, 
+   RoadGraphIndex& r_index,
    const size_t trajectory_index, 
    const double x_scaling,
    const CarDimensions& car_dim)
@@ -244,7 +245,7 @@ void vfm::mc::trajectory_generator::LiveSimGenerator::equipRoadGraphWithCars(
    const auto& ego_trajectory = m_trajectory_provider_.getEgoTrajectory();
    const auto& current_ego = ego_trajectory[trajectory_index];
 
-   r->cleanFromAllCars();
+   r_index.cleanFromAllCars();
 
    float lane_width{ r->getMyRoad().getLaneWidth() };
 
@@ -263,28 +264,29 @@ void vfm::mc::trajectory_generator::LiveSimGenerator::equipRoadGraphWithCars(
    const int traversion_to{ (int)current_ego.second.at(PossibleParameter::traversion_to) };
 
    if (on_straight_section >= 0) {
-      auto rg = r->findSectionWithID(on_straight_section);
+      auto rg = r_index.findSectionWithID(on_straight_section);
       if (rg) {
          rg->getMyRoad().setEgo(ego);
       }
       else {
          addError("Ego vehicle cannot be painted on section '" + std::to_string(on_straight_section) + "' which is not reachable from the current setion '" + std::to_string(r->getID()) + "'. (Note that sections unconnected to the main road graph are currently not considered.)");
          addError("Ego vehicle will be painted on section '0' instead.");
-         r->findSectionWithID(0)->getMyRoad().setEgo(ego);
+         r_index.findSectionWithID(0)->getMyRoad().setEgo(ego);
       }
    }
    else if (traversion_from >= 0 && traversion_to >= 0) {
-      const auto from_section = r->findSectionWithID(traversion_from);
-      if (from_section) {
-         from_section->addNonegoOnCrossingTowards(traversion_to, *ego);
+      const auto from_section = r_index.findSectionWithID(traversion_from);
+      const auto to_section = r_index.findSectionWithID(traversion_to);
+      if (from_section && to_section) {
+         from_section->addNonegoOnCrossingTowards(to_section, *ego);
       }
       else {
-         addError("Cannot place car on connection from sec '" + std::to_string(traversion_from) + "' to sec '" + std::to_string(traversion_to) + "' because the origin section does not exist.");
+         addError("Cannot place car on connection from sec '" + std::to_string(traversion_from) + "' to sec '" + std::to_string(traversion_to) + "' because the origin or target section does not exist.");
       }
    }
    else {
       addError("Ego car is placed neither on a straight section nor on a junction. Guessing it should be on section '0'.");
-      r->findSectionWithID(0)->getMyRoad().setEgo(ego);
+      r_index.findSectionWithID(0)->getMyRoad().setEgo(ego);
    }
    // EO TODO: Double code towards below.
 
@@ -308,7 +310,7 @@ void vfm::mc::trajectory_generator::LiveSimGenerator::equipRoadGraphWithCars(
       };
 
       if (on_straight_section >= 0) {
-         auto rg = r->findSectionWithID(on_straight_section);
+         auto rg = r_index.findSectionWithID(on_straight_section);
          if (rg) {
             rg->getMyRoad().addOther(veh);
          }
@@ -317,18 +319,21 @@ void vfm::mc::trajectory_generator::LiveSimGenerator::equipRoadGraphWithCars(
          }
       }
       else if (traversion_from >= 0 && traversion_to >= 0) {
-         const auto from_section = r->findSectionWithID(traversion_from);
-         if (from_section) {
-            from_section->addNonegoOnCrossingTowards(traversion_to, veh);
+         const auto from_section = r_index.findSectionWithID(traversion_from);
+         const auto to_section = r_index.findSectionWithID(traversion_to);
+         if (from_section && to_section) {
+            from_section->addNonegoOnCrossingTowards(to_section, veh);
          }
          else {
-            addError("Cannot place car on connection from sec '" + std::to_string(traversion_from) + "' to sec '" + std::to_string(traversion_to) + "' because the origin section does not exist.");
+            addError("Cannot place car on connection from sec '" + std::to_string(traversion_from) + "' to sec '" + std::to_string(traversion_to) + "' because the origin or target section does not exist.");
          }
       }
       else {
          addError("Car '" + vehicle_name + "' is placed neither on a straight section nor on a junction.");
       }
    }
+
+   r_index.refreshCarIndex(); // Once per frame, now that all cars are placed.
 }
 
 void LiveSimGenerator::generate(
@@ -343,6 +348,7 @@ void LiveSimGenerator::generate(
    const long sleep_for_ms)
 {
    std::shared_ptr<RoadGraph> road_graph{ getRoadGraphTopologyFrom(trace) };
+   RoadGraphIndex road_graph_index{ road_graph }; // Topology is fixed for the whole trace, only the cars move.
 
    std::string image_file_output = base_output_name + ".png";
    std::filesystem::path morty_progress_path{ base_output_name };
@@ -370,7 +376,7 @@ void LiveSimGenerator::generate(
       std::cout << StaticHelper::printProgress("Rendering Progress", trajectory_index, trajectory_length, 30); // Print output (override itself)
       StaticHelper::writeTextToFile(std::to_string(trajectory_index) + "#" + std::to_string(trajectory_length - 1) + "#" + stage_name, morty_progress_path.string());
 
-      equipRoadGraphWithCars(road_graph, trajectory_index, x_scaling, car_dim);
+      equipRoadGraphWithCars(road_graph, road_graph_index, trajectory_index, x_scaling, car_dim);
 
       ExtraVehicleArgs extra_var_vals = {}; // Extra data currently only used to inform about turn signals
       
@@ -19,12 +19,17 @@ using namespace trajectory_generator;
 
 
 std::string OSCgenerator::generate(std::string scenario_name, bool control_ego)
+{
+	std::stringstream osc_text{};
+	generate(osc_text, scenario_name, control_ego);
+	return osc_text.str();
+}
+
+void OSCgenerator::generate(std::ostream& osc_text, std::string scenario_name, bool control_ego)
 {
 	std::replace(scenario_name.begin(), scenario_name.end(), '.', '_'); // replace all '.' to '_'
 	std::replace(scenario_name.begin(), scenario_name.end(), '-', '_'); // replace all '-' to '_'
 
-	std::stringstream osc_text{};
-
 	osc_text << R"(
 # AUTO GENERATED OSC: )" << scenario_name << R"( - Source: M²oRTy
 
@@ -41,21 +46,29 @@ scenario )" << scenario_name << R"(:
 
   # Vehicles
   ego: ego_vehicle_pace  # replace with specific vehicle type if necessary
-  )" << getVechicleDefinitions("  ") << R"(
+  )";
+	writeVechicleDefinitions(osc_text, "  ");
+	osc_text << R"(
 
   # Trajectories
-  )"<<getTrajectoryDefinitions("  ", control_ego)<<R"(
+  )";
+	writeTrajectoryDefinitions(osc_text, "  ", control_ego);
+	osc_text << R"(
 
   keep(nsdm_simulation_time() < )" << (m_interpreted_trace.getDuration() + 4.0) << R"()
   do serial():
     # INIT NODES
     parallel():
-      )" << getPositionAndSpeedNodes("      ") << R"(
+      )";
+	writePositionAndSpeedNodes(osc_text, "      ");
+	osc_text << R"(
 
     # MANEUVER NODES
     parallel():
       run_customer_function_with_vmm_mock(ego)
-      )"<<getTrajectoryReplayNodes("      ", control_ego)<<R"(
+      )";
+	writeTrajectoryReplayNodes(osc_text, "      ", control_ego);
+	osc_text << R"(
 
       serial():
         parallel(): # Engage hands on mode
@@ -64,43 +77,36 @@ scenario )" << scenario_name << R"(:
 
         parallel():
           # Ego Maneuvers (rough attempt at reproducing the modelchecker output for ego)
-          )"<<getEgoManeuvers("          ", control_ego)<<R"(
+          )";
+	writeEgoManeuvers(osc_text, "          ", control_ego);
+	osc_text << R"(
           ego.drive() with:
             keep(ego.is_fully_controlled_by_sut())
 )";
-
-	return osc_text.str();
 }
 
-std::string OSCgenerator::getVechicleDefinitions(std::string indent_prefix) const
+void OSCgenerator::writeVechicleDefinitions(std::ostream& osc_ss, std::string indent_prefix) const
 {
-	std::stringstream osc_ss{};
-	osc_ss << std::endl;
+	osc_ss << "\n";
 	for (auto& vehicle_name : m_interpreted_trace.getVehicleNames(true))
 	{
-		osc_ss << indent_prefix << vehicle_name << ": vehicle" << std::endl;
+		osc_ss << indent_prefix << vehicle_name << ": vehicle" << "\n";
 	}
-   return osc_ss.str();
 }
 
-std::string OSCgenerator::getPositionAndSpeedNodes(std::string indent_prefix) const
+void OSCgenerator::writePositionAndSpeedNodes(std::ostream& osc_ss, std::string indent_prefix) const
 {
-	std::stringstream osc_ss{};
-
-	osc_ss << getPositionAndSpeedNode(indent_prefix, "ego", m_interpreted_trace.getEgoTrajectory());
+	writePositionAndSpeedNode(osc_ss, indent_prefix, "ego", m_interpreted_trace.getEgoTrajectory());
 
 	for (auto& vehicle_name : m_interpreted_trace.getVehicleNames(true))
 	{
-		osc_ss << getPositionAndSpeedNode(indent_prefix, vehicle_name, m_interpreted_trace.getVehicleTrajectory(vehicle_name));
+		writePositionAndSpeedNode(osc_ss, indent_prefix, vehicle_name, m_interpreted_trace.getVehicleTrajectory(vehicle_name));
 	}
-
-	return osc_ss.str();
 }
 
-std::string OSCgenerator::getPositionAndSpeedNode(std::string indent_prefix, std::string vehicle_name, const FullTrajectory& trajectory) const
+void OSCgenerator::writePositionAndSpeedNode(std::ostream& osc_ss, std::string indent_prefix, std::string vehicle_name, const FullTrajectory& trajectory) const
 {
-	std::stringstream osc_ss{};
-	osc_ss << std::endl;
+	osc_ss << "\n";
 
 	const ParameterMap& start_parameters = trajectory.front().second;
 
@@ -109,50 +115,46 @@ std::string OSCgenerator::getPositionAndSpeedNode(std::string indent_prefix, std
 	osc_ss << "x: " << std::to_string(start_parameters.at(PossibleParameter::pos_x));
 	osc_ss << ", y: " << std::to_string(start_parameters.at(PossibleParameter::pos_y));
 	osc_ss << ", z: " << std::to_string(start_parameters.at(PossibleParameter::pos_z));
-	osc_ss << "))" << std::endl;
-
-   osc_ss << indent_prefix << vehicle_name << ".assign_speed(" << std::to_string(start_parameters.at(PossibleParameter::vel_x)) << ")" << std::endl;
+	osc_ss << "))" << "\n";
 
-	return osc_ss.str();
+   osc_ss << indent_prefix << vehicle_name << ".assign_speed(" << std::to_string(start_parameters.at(PossibleParameter::vel_x)) << ")" << "\n";
 }
 
-std::string OSCgenerator::getTrajectoryDefinitions(std::string indent_prefix, bool control_ego) const
+void OSCgenerator::writeTrajectoryDefinitions(std::ostream& osc_ss, std::string indent_prefix, bool control_ego) const
 {
-	std::stringstream osc_ss{};
-	osc_ss << std::endl;
+	osc_ss << "\n";
 
 	if (control_ego)
 	{
-		osc_ss << getTrajectoryDefinition(indent_prefix, m_interpreted_trace.getEgoTrajectory(), "ego", true) << std::endl;
+		writeTrajectoryDefinition(osc_ss, indent_prefix, m_interpreted_trace.getEgoTrajectory(), "ego", true);
+		osc_ss << "\n";
 	}
 
 	for (auto& vehicle_name : m_interpreted_trace.getVehicleNames(true))
 	{
-		osc_ss << getTrajectoryDefinition(indent_prefix, m_interpreted_trace.getVehicleTrajectory(vehicle_name), vehicle_name, true) << std::endl;
+		writeTrajectoryDefinition(osc_ss, indent_prefix, m_interpreted_trace.getVehicleTrajectory(vehicle_name), vehicle_name, true);
+		osc_ss << "\n";
 	}
-
-   return osc_ss.str();
 }
 
-std::string OSCgenerator::getTrajectoryDefinition(std::string indent_prefix, FullTrajectory trajectory, std::string vehicle_name, bool wrap_in_osc_node) const
+void OSCgenerator::writeTrajectoryDefinition(std::ostream& osc_ss, std::string indent_prefix, const FullTrajectory& trajectory, std::string vehicle_name, bool wrap_in_osc_node) const
 {
 	const int decimals = 6;
 
-	std::stringstream osc_ss{};
-	osc_ss << indent_prefix << vehicle_name << "_trajectory : trajectory = trajectory(\\" << std::endl;
+	osc_ss << indent_prefix << vehicle_name << "_trajectory : trajectory = trajectory(\\" << "\n";
 
 	// // // All timestamps in a single line
 	osc_ss << indent_prefix << "time_stamps : [";
 	for (const auto& trajectory_position : trajectory)
 	{
-		osc_ss << std::to_string(trajectory_position.first).substr(0, decimals) << ", ";
+		if (&trajectory_position != &trajectory.front())
+			osc_ss << ", ";
+		osc_ss << std::to_string(trajectory_position.first).substr(0, decimals);
 	}
-	// move the write head two steps back to replace the last ", "
-	osc_ss.seekp(-2, osc_ss.cur);
-	osc_ss << "],\\" << std::endl;
+	osc_ss << "],\\" << "\n";
 
 	// // // Points
-	osc_ss << indent_prefix << "points: [\\" << std::endl;
+	osc_ss << indent_prefix << "points: [\\" << "\n";
 
 	auto append_param = [&osc_ss, decimals](const ParameterMap& params, PossibleParameter param_type) {
 		osc_ss << std::setw(decimals + 1) << std::setfill(' ') << std::to_string(params.at(param_type)).substr(0, decimals);
@@ -177,11 +179,11 @@ std::string OSCgenerator::getTrajectoryDefinition(std::string indent_prefix, Ful
 			osc_ss << ")),\\ ";
 		else
 			osc_ss << "))],\\";
-		osc_ss << " # T: " << timestamp_str << std::endl;
+		osc_ss << " # T: " << timestamp_str << "\n";
 	}
 
 	// // // Velocities
-   osc_ss << indent_prefix << "nsdm_translational_velocities: [\\" << std::endl;
+   osc_ss << indent_prefix << "nsdm_translational_velocities: [\\" << "\n";
 
 	for (const auto& trajectory_position : trajectory)
 	{
@@ -198,49 +200,43 @@ std::string OSCgenerator::getTrajectoryDefinition(std::string indent_prefix, Ful
 			osc_ss << "),\\";
 		else
 			osc_ss << ")])";
-		osc_ss << " # T: " << timestamp_str << std::endl;
+		osc_ss << " # T: " << timestamp_str << "\n";
 	}
-
-	return osc_ss.str();
 }
 
-std::string OSCgenerator::getTrajectoryReplayNodes(std::string indent_prefix, bool control_ego) const
+void OSCgenerator::writeTrajectoryReplayNodes(std::ostream& osc_ss, std::string indent_prefix, bool control_ego) const
 {
-	std::stringstream osc_ss{};
-	osc_ss << std::endl;
+	osc_ss << "\n";
 
 	if (control_ego)
 	{
-		osc_ss << indent_prefix << "ego.replay_trajectory(absolute: ego_trajectory)" << std::endl;
+		osc_ss << indent_prefix << "ego.replay_trajectory(absolute: ego_trajectory)" << "\n";
 	}
 
 	for (auto& vehicle_name : m_interpreted_trace.getVehicleNames(true))
 	{
-		osc_ss << indent_prefix << vehicle_name << ".replay_trajectory(absolute: " << vehicle_name << "_trajectory)" << std::endl;
+		osc_ss << indent_prefix << vehicle_name << ".replay_trajectory(absolute: " << vehicle_name << "_trajectory)" << "\n";
 	}
-
-	return osc_ss.str();
 }
 
-std::string OSCgenerator::getEgoManeuvers(std::string indent_prefix, bool control_ego) const
+void OSCgenerator::writeEgoManeuvers(std::ostream& osc_ss, std::string indent_prefix, bool control_ego) const
 {
-	std::stringstream osc_ss{};
-	osc_ss << std::endl;
+	osc_ss << "\n";
 
 	// Increase speed via the driver speed_control
 	auto append_acc_maneuver = [&osc_ss, &indent_prefix](double t, int ten_kmh_steps, std::string inc_or_dec) {
-		osc_ss << indent_prefix << "ego.set_driver_input_set_speed_control_" << inc_or_dec << "(value: true, delay_in_ms : " << (t * 1000) << ", duration_in_ms : 50)" << std::endl;
+		osc_ss << indent_prefix << "ego.set_driver_input_set_speed_control_" << inc_or_dec << "(value: true, delay_in_ms : " << (t * 1000) << ", duration_in_ms : 50)" << "\n";
 		if (ten_kmh_steps > 1)
 		{
-			osc_ss << indent_prefix << "nsdm_repeat(" << (ten_kmh_steps - 1) << "):" << std::endl;
-			osc_ss << indent_prefix << "  ego.set_driver_input_set_speed_control_" << inc_or_dec << "(value: true, delay_in_ms: 20, duration_in_ms: 50)" << std::endl;
+			osc_ss << indent_prefix << "nsdm_repeat(" << (ten_kmh_steps - 1) << "):" << "\n";
+			osc_ss << indent_prefix << "  ego.set_driver_input_set_speed_control_" << inc_or_dec << "(value: true, delay_in_ms: 20, duration_in_ms: 50)" << "\n";
 		}
 	};
 
 	// Trigger a Lanechange
 	auto append_lc_maneuver = [&osc_ss, &indent_prefix](double t, std::string dir_name) {
 		osc_ss << indent_prefix << "ego.set_driver_input_turn_indicator_lever(value: turn_indicator_lever_state!tipped_"
-			<< dir_name << ", delay_in_ms : " << (t * 1000) << ", duration_in_ms : 200)" << std::endl;
+			<< dir_name << ", delay_in_ms : " << (t * 1000) << ", duration_in_ms : 200)" << "\n";
 		};
 
 	double epsilon = 0.0001f;
@@ -288,8 +284,6 @@ std::string OSCgenerator::getEgoManeuvers(std::string indent_prefix, bool contro
 		last_indicator_left = indicator_left;
 		last_indicator_right = indicator_right;
 	}
-
-	return osc_ss.str();
 }
 
 void OSCgenerator::addVehicleTrajectoryFollower(std::stringstream& osc_ss, FullTrajectory trajectory, std::string vehicle_name, bool wrap_in_osc_node)
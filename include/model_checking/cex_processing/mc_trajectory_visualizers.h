@@ -12,6 +12,8 @@
 #include "geometry/images.h"
 #include "geometry/gif_writer.h"
 #include "geometry/polygon_2d.h"
+#include "simulation/road_graph_index.h"
+#include "xml/xml_writer.h"
 #include "geometry/images.h"
 #include "parser.h"
 #include "fsm.h"
@@ -47,16 +49,17 @@ public:
 
 	// Generate the final OSC file
 	std::string generate(std::string scenario_name, bool control_ego);
+	void generate(std::ostream& out, std::string scenario_name, bool control_ego); // Streams directly, e.g., into a file.
 	std::string generate_as_csv();
 
 private:
-	std::string getVechicleDefinitions(std::string indent_prefix) const;
-	std::string getPositionAndSpeedNodes(std::string indent_prefix) const;
-	std::string getPositionAndSpeedNode(std::string indent_prefix, std::string vehicle_name, const FullTrajectory& trajectory) const;
-	std::string getTrajectoryDefinitions(std::string indent_prefix, bool control_ego) const;
-	std::string getTrajectoryDefinition(std::string indent_prefix, FullTrajectory trajectory, std::string vehicle_name, bool wrap_in_osc_node) const;
-	std::string getTrajectoryReplayNodes(std::string indent_prefix, bool control_ego) const;
-	std::string getEgoManeuvers(std::string indent_prefix, bool control_ego) const;
+	void writeVechicleDefinitions(std::ostream& out, std::string indent_prefix) const;
+	void writePositionAndSpeedNodes(std::ostream& out, std::string indent_prefix) const;
+	void writePositionAndSpeedNode(std::ostream& out, std::string indent_prefix, std::string vehicle_name, const FullTrajectory& trajectory) const;
+	void writeTrajectoryDefinitions(std::ostream& out, std::string indent_prefix, bool control_ego) const;
+	void writeTrajectoryDefinition(std::ostream& out, std::string indent_prefix, const FullTrajectory& trajectory, std::string vehicle_name, bool wrap_in_osc_node) const;
+	void writeTrajectoryReplayNodes(std::ostream& out, std::string indent_prefix, bool control_ego) const;
+	void writeEgoManeuvers(std::ostream& out, std::string indent_prefix, bool control_ego) const;
 	
 	void addVehicleTrajectoryFollower(std::stringstream& osc_ss, FullTrajectory trajectory, std::string vehicle_name, bool wrap_in_osc_node);
 	void addIndented(std::stringstream& string_stream, std::string text, int additional_indentation = 0);
@@ -83,6 +86,7 @@ public:
 	{};
 
 	std::string generate();
+	void generate(OutputSink& sink); // Streams directly, e.g., into a FileSink.
 
 private:
 	struct Waypoint{
@@ -93,17 +97,17 @@ private:
 		double time{};
 	};
 
-	std::string generateLayout();
+	void writeLayout(xml::XmlWriter& writer);
 
-	std::string generatePlayers() const;
-	std::string generatePlayer(const std::string& vehicle_name, const double speed, const int object_index) const;
+	void writePlayers(xml::XmlWriter& writer) const;
+	void writePlayer(xml::XmlWriter& writer, const std::string& vehicle_name, const double speed, const int object_index) const;
 
-	std::string generatePlayerActions() const;
-	std::string generatePlayerAction(const std::string& vehicle_name) const;
-	std::string generateSpeedChangeAction(const std::string& vehicle_name, const std::string& name, const Waypoint& waypoint) const;
+	void writePlayerActions(xml::XmlWriter& writer) const;
+	void writePlayerAction(xml::XmlWriter& writer, const std::string& vehicle_name) const;
+	void writeSpeedChangeAction(xml::XmlWriter& writer, const std::string& vehicle_name, const std::string& name, const Waypoint& waypoint) const;
 
-	std::string generateMovingObjectsControl() const;
-	std::string generatePolylinePathShape(const std::string& vehicle_name, const int object_index) const;
+	void writeMovingObjectsControl(xml::XmlWriter& writer) const;
+	void writePolylinePathShape(xml::XmlWriter& writer, const std::string& vehicle_name, const int object_index) const;
 
 	const MCinterpretedTrace m_interpreted_trace;
 
@@ -142,6 +146,7 @@ public:
    
    void equipRoadGraphWithCars(
       const std::shared_ptr<RoadGraph> r, 
+      RoadGraphIndex& r_index,
       const size_t trajectory_index, 
       const double x_scaling,
       const CarDimensions& car_dim);
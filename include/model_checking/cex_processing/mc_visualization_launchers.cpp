@@ -461,18 +461,14 @@ bool vfm::mc::trajectory_generator::VisualizationLaunchers::interpretAndGenerate
       MCinterpretedTrace interpreted_trace_osc = interpreted_trace.clone();
       interpreted_trace_osc.applyInterpolation(settings.duration_scale * config.m_default_step_time * settings.frames_per_second_osc, trace);
 
-      std::string osc_without_ego = OSCgenerator(interpreted_trace_osc).generate(final_name, false);
-      std::string osc_with_ego = OSCgenerator(interpreted_trace_osc).generate(final_name, true);
       std::string csv_with_ego = OSCgenerator(interpreted_trace_osc).generate_as_csv();
 
-      // std::cout << "OSC WITH EGO: \n" << osc_with_ego << std::endl;
-
       std::ofstream file_without_ego(out_path + "_free_ego.osc");
-      file_without_ego << osc_without_ego;
+      OSCgenerator(interpreted_trace_osc).generate(file_without_ego, final_name, false);
       file_without_ego.close();
 
       std::ofstream file_with_ego(out_path + ".osc");
-      file_with_ego << osc_with_ego;
+      OSCgenerator(interpreted_trace_osc).generate(file_with_ego, final_name, true);
       file_with_ego.close();
 
       std::ofstream csv_file_with_ego(out_path + ".csv");
@@ -485,12 +481,9 @@ bool vfm::mc::trajectory_generator::VisualizationLaunchers::interpretAndGenerate
    {
       MCinterpretedTrace interpreted_trace_vtd = interpreted_trace.clone();
       VTDgenerator vtd_gen{interpreted_trace_vtd};
+      FileSink file_vtd_scenario{ out_path + "_vtd.xml" };
 
-      const std::string vtd_scenario_txt = vtd_gen.generate();
-
-      std::ofstream file_vtd_scenario(out_path + "_vtd.xml");
-      file_vtd_scenario << vtd_scenario_txt;
-      file_vtd_scenario.close();
+      vtd_gen.generate(file_vtd_scenario);
    }
 
    if (generate_gif)
@@ -32,6 +32,13 @@ inline void paintButton(Image& img, const PainterButtonDescription desc) {
    img.writeAsciiText(desc.second.first[0], desc.second.first[1], desc.first.second, CoordTrans::do_it, true, FUNC_IGNORE_BLACK_CONVERT_TO_BLACK);
 }
 
+/// How the state machine is visualized during a counterexample replay.
+enum class CexRenderingMode {
+   graphviz,            // DOT + external Graphviz run per step (two of them, including the data view).
+   in_process,          // Laid out once, only the current state is repainted per step; the data view is written as DOT only.
+   in_process_animation // Like in_process, but all steps go into one animated GIF in one pass, without delay.
+};
+
 enum class HorizontalAlignment {
    centered,
    left,
@@ -193,7 +200,8 @@ inline void replayCounterExample(
    std::vector<PainterVariableDescription>& variable_descriptions,
    std::vector<PainterButtonDescription>& button_descriptions,
    const std::string& fsm_output_type = "pdf",
-   const bool autostart_external_visualization = false) {
+   const bool autostart_external_visualization = false,
+   const CexRenderingMode rendering_mode = CexRenderingMode::graphviz) {
 
    bool first = true;
    Image background_image;
@@ -223,15 +231,44 @@ inline void replayCounterExample(
    m->loadFromFile(path_to_FSM_file_input, false, true);
    m->printAndThrowErrorsIfAny(true, false);
 
-   m->createGraficOfCurrentGraph(path_to_FSM_vis_output, true, fsm_output_type, false, vfm::fsm::GraphvizOutputSelector::graph_only);
-   m->createGraficOfCurrentGraph(path_to_FSM_DATA_vis_output, true, fsm_output_type, false, vfm::fsm::GraphvizOutputSelector::data_with_functions);
+   const bool in_process = rendering_mode != CexRenderingMode::graphviz;
+   const bool animation = rendering_mode == CexRenderingMode::in_process_animation;
+   const auto graph_output_type = fsm_output_type == "pdf" ? OutputType::pdf : OutputType::png;
+   std::shared_ptr<fsm::FSMGraphRenderer> renderer{};
+
+   const auto render_fsm = [&]() {
+      if (!in_process) {
+         m->createGraficOfCurrentGraph(path_to_FSM_vis_output, true, fsm_output_type, false, vfm::fsm::GraphvizOutputSelector::graph_only);
+         m->createGraficOfCurrentGraph(path_to_FSM_DATA_vis_output, true, fsm_output_type, false, vfm::fsm::GraphvizOutputSelector::data_with_functions);
+      }
+      else if (animation) {
+         renderer->addAnimationFrame(m->getCurrentState());
+      }
+      else {
+         renderer->store(m->getCurrentState(), path_to_FSM_vis_output + "." + fsm_output_type, graph_output_type);
+         m->createGraficOfCurrentGraph(path_to_FSM_DATA_vis_output, true, "", false, vfm::fsm::GraphvizOutputSelector::data_with_functions);
+      }
+   };
+
+   if (in_process) {
+      renderer = std::make_shared<fsm::FSMGraphRenderer>(m->getGraphTopology());
+
+      if (animation) {
+         renderer->startAnimation(path_to_FSM_vis_output + ".gif");
+      }
+   }
+
+   if (!animation) {
+      render_fsm();
+   }
 
    m->setStatePainter(painter);
    int loop = -1;
 
    for (int i = 0; i < ce.size();) {
-      m->createGraficOfCurrentGraph(path_to_FSM_vis_output, true, fsm_output_type, false, vfm::fsm::GraphvizOutputSelector::graph_only);
-      m->createGraficOfCurrentGraph(path_to_FSM_DATA_vis_output, true, fsm_output_type, false, vfm::fsm::GraphvizOutputSelector::data_with_functions);
+      const int i_before = i;
+
+      render_fsm();
       m->createStateVisualizationOfCurrentState(
          path_to_custom_vis_png_output, 
          variable_descriptions, 
@@ -244,8 +281,19 @@ inline void replayCounterExample(
          sw_chunk_y,
          i,
          OutputType::png);
-      std::this_thread::sleep_for(std::chrono::milliseconds(100 /*(int)m->evaluateFormula("expectedFctCycleTime")*/));
+      if (!animation) {
+         std::this_thread::sleep_for(std::chrono::milliseconds(100 /*(int)m->evaluateFormula("expectedFctCycleTime")*/));
+      }
+
       m->replayCounterExampleForOneStep(ce, i, loop, true);
+
+      if (animation && i <= i_before) { // Wrapped around into the loop, so all steps have been recorded once.
+         break;
+      }
+   }
+
+   if (animation) {
+      renderer->finishAnimation();
    }
 }
 
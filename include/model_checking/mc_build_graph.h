@@ -0,0 +1,65 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+#pragma once
+
+#include "failable.h"
+#include "json_parsing/json.hpp"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <map>
+
+namespace vfm {
+namespace mc {
+
+static const std::string FILE_NAME_MC_BUILD_GRAPH{ "mc_build_graph.json" };
+
+static const std::string MC_STAGE_MODEL_CHECKING{ "mc" };
+static const std::string MC_STAGE_PREVIEW{ "preview" };
+
+static const std::string MC_INPUT_PLANNER{ "planner_sources" };
+static const std::string MC_INPUT_ENVMODEL{ "envmodel_template" };
+static const std::string MC_INPUT_CONFIG{ "json_config_instance" };
+static const std::string MC_INPUT_SPEC{ "spec" };
+static const std::string MC_INPUT_SCRIPT{ "script_cmd" };
+static const std::string MC_INPUT_MAIN_SMV{ "main_smv" };
+static const std::string MC_INPUT_CEX{ "cex" };
+
+/// \brief Persistent, content-hash based build graph for the MC job of a single config folder.
+///
+/// Each stage (e.g., running the model checker, generating the preview) is keyed on the hashes
+/// of its inputs. A stage is up-to-date iff it has been built before with exactly the current
+/// input hashes, and all its outputs still exist on the file system. The graph is stored as
+/// json in the config folder, so it survives restarts of vfm.
+class McBuildGraph : public Failable
+{
+public:
+   McBuildGraph(const std::filesystem::path& path_generated_config_level);
+
+   void setInput(const std::string& stage, const std::string& input_name, const std::string& content);
+   void setInputFromFile(const std::string& stage, const std::string& input_name, const std::filesystem::path& path);
+
+   /// Hashes the given file list file (format of "vfm-includes.txt" and "EnvModel_IncludeFiles.txt")
+   /// together with all files listed therein, relative to the list file's folder.
+   void setInputFromFileList(const std::string& stage, const std::string& input_name, const std::filesystem::path& path_to_file_list_file, const std::string& separator);
+
+   bool isUpToDate(const std::string& stage, const std::vector<std::filesystem::path>& required_outputs) const;
+   void markBuilt(const std::string& stage);
+   void invalidate(const std::string& stage);
+
+   void load();
+   void store() const;
+
+private:
+   std::filesystem::path path_generated_config_level_{};
+   std::map<std::string, std::map<std::string, std::string>> current_inputs_{}; // { stage => { input_name => hash } }
+   nlohmann::json stored_{};
+};
+
+} // mc
+} // vfm
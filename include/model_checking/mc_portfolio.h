@@ -0,0 +1,85 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+#pragma once
+
+#include "failable.h"
+#include "model_checking/process_runner.h"
+
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace vfm {
+namespace mc {
+
+static const std::string FILE_NAME_PORTFOLIO_STATISTICS{ "mc_portfolio_statistics.json" };
+
+static const std::string PORTFOLIO_TEMPLATE_INVAR{ "invar" };
+static const std::string PORTFOLIO_TEMPLATE_LTL{ "ltl" };
+
+enum class McVerdict {
+   inconclusive,
+   falsified, // Counterexample found.
+   proved
+};
+
+/// One way of running nuXmv on a main.smv, given by the content of its script.cmd.
+struct PortfolioVariant {
+   std::string name_{};
+   std::string script_{};
+};
+
+struct PortfolioResult {
+   McVerdict verdict_{ McVerdict::inconclusive };
+   std::string winner_{};         // Empty if no variant was conclusive.
+   std::string output_{};         // Full nuXmv output of the winner (or of the first variant if none won).
+   ProcessStatistics statistics_{};
+};
+
+/// \brief Races several nuXmv engine/option variants on the same main.smv, takes the first
+/// conclusive answer and kills the rest.
+///
+/// Win statistics are kept per template (invar/ltl) in a json file, and the variants are
+/// launched in order of their past wins. This matters if fewer parallel slots than variants
+/// are available, and lets the portfolio learn a better default order over time.
+/// As in the single-engine run, the output of every variant is streamed, so that the first
+/// counterexample found by any of them can be handed out (on_first_cex) before the race is over.
+class McPortfolio : public Failable
+{
+public:
+   McPortfolio(const std::filesystem::path& path_to_statistics_file);
+
+   /// Creates the default variants (BMC with two depths, IC3, BDD) for the given template,
+   /// using the BMC depth from the regularly generated script.cmd if available.
+   static std::vector<PortfolioVariant> createDefaultVariants(const std::string& template_name, const std::string& generated_script);
+   static std::string deriveTemplateName(const std::string& main_smv);
+   static McVerdict classifyNuXmvOutput(const std::string& output);
+
+   PortfolioResult run(
+      const std::string& nuxmv_exec,
+      const std::filesystem::path& path_main_smv,
+      const std::string& template_name,
+      const std::vector<PortfolioVariant>& variants,
+      const std::map<std::string, std::string>& env,
+      const ProcessLimits& limits,
+      const int max_parallel,
+      const std::function<void(const std::string& output_so_far)>& on_first_cex = nullptr);
+
+   std::vector<PortfolioVariant> orderByPastWins(const std::string& template_name, const std::vector<PortfolioVariant>& variants) const;
+
+private:
+   void recordRun(const std::string& template_name, const std::string& variant, const bool won, const std::chrono::nanoseconds& wall_time);
+
+   std::filesystem::path path_to_statistics_file_{};
+   static std::mutex statistics_mutex_; // Jobs of several configs may share the same statistics file.
+};
+
+} // mc
+} // vfm
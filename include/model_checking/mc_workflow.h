@@ -82,6 +82,17 @@ public:
       const bool delete_old_output
    );
 
+   /// If set (off by default), runMCJob skips the model checker and preview stages whose inputs
+   /// (planner sources, EnvModel templates, JSON config instance, spec) are unchanged since the
+   /// last run, cf. McBuildGraph.
+   void setIncrementalMode(const bool incremental);
+   bool isIncrementalMode() const;
+
+   /// If set, nuXmv is run in portfolio mode, i.e., several engines/options race against
+   /// each other per config and the first conclusive one wins, cf. McPortfolio.
+   void setPortfolioMode(const bool portfolio);
+   bool isPortfolioMode() const;
+
    static void createTestCase(
       const std::string& generated_parent_dir,
       const std::string& id,
@@ -151,6 +162,8 @@ public:
 
 private:
    std::mutex main_file_mutex_{};
+   bool incremental_mode_{ false };
+   bool portfolio_mode_{ false };
 };
 
 } // mc
@@ -9,6 +9,7 @@
 #include "fsm.h"
 #include "failable.h"
 #include "simulation/highway_image.h"
+#include <chrono>
 #include <vector>
 
 namespace vfm {
@@ -19,6 +20,38 @@ typedef std::function<SystemStateVec(const SystemState& state)> TransFuncType;
 typedef std::pair<SystemStateVec, TransFuncType> ModelConfiguration;
 typedef std::pair<ModelConfiguration, std::vector<float>> ModelDesign;
 
+/// Hash consistent with the equality of SystemState, i.e., over lane, position and velocity of all cars.
+struct SystemStateHash {
+   size_t operator()(const SystemState& state) const;
+};
+
+/// Value ranges of the CONFIG_SIMPLE_ACC model; larger ranges yield larger state spaces.
+struct AccRanges {
+   int speed_min_{ 0 };      // 0
+   int speed_max_{ 2 };      // 10     // 2
+   int speed_step_{ 1 };     // 1
+   int distance_min_{ 9 };   // "Close"    // 10     // 9
+   int distance_max_{ 27 };  // "Infinite" // 25     // 27
+   int distance_step_{ 9 };  // 3      // 9
+};
+
+struct ExplorationOptions {
+   int num_threads_{ 1 };             // For computing successors, 0 means one per hardware thread. The transition function has to be thread-safe if not 1.
+   bool bitstate_{ false };           // Only count the reachable states, remembering them in a Bloom filter rather than storing them. No model is built, and states may be missed on hash collisions.
+   int bitstate_log2_bits_{ 27 };     // Size of the Bloom filter, 2^27 bits = 16 MB.
+   bool paint_states_{ true };        // Paint an image for every state once the exploration is done.
+   int progress_interval_ms_{ 1000 }; // Minimum time between two progress notes.
+};
+
+struct ExplorationStats {
+   long num_states_{};
+   long num_successors_{};            // Successor states examined, including already visited ones.
+   int num_levels_{};                 // Rounds of the breadth-first search.
+   double seconds_{};                 // Exploration only, without painting.
+
+   inline double getStatesPerSecond() const { return seconds_ > 0 ? num_states_ / seconds_ : 0; }
+};
+
 class MC : public Failable {
 public:
    static const ModelConfiguration CONFIG_HELLO_WORLD;
@@ -31,7 +64,7 @@ public:
    MC(const SystemStateVec& seed, const TransFuncType& trans_func, const int image_width = 200, const int image_height = 100, const float ego_offset_x = 0) : Failable("MC_State_Space_Generator"),
       seed_(seed), trans_func_(trans_func), img_width_(image_width), img_height_(image_height), ego_offset_x_(ego_offset_x)
    {
-      ascii_table_ = Image::retrieveAsciiTable();
+      ascii_table_ = Image::MONOSPACE_NEW_CACHED_ASCII_TABLE; // Built in, i.e., independent of the working directory.
       model_.setProhibitDoubleEdges(true);
    }
 
@@ -40,6 +73,9 @@ public:
 
    void generateOnePath(const int num_to_take_on_nondeterminism = -1, const std::shared_ptr<std::function<bool(const SystemState& state)>> fct = nullptr, const int max_states = 100000);
 
+   /// Explores the state space breadth-first from the seed states, keeping the visited states in a hash table.
+   /// Each round of the search computes the successors of the whole frontier (in parallel, if requested),
+   /// then numbers the new states and adds the transitions in a deterministic order.
    void generateModel(
       const bool try_reinserting_immediate_next_state = false, // Makes smaller graphs more connected, but can lead to infinite loops. => Choose larger insert_only_first_n_for_every_state.
       const int abort_after_n_transitions = 100000,
@@ -47,7 +83,10 @@ public:
       const int insert_only_first_n_for_every_state = 100000,
       const bool complement_of_transitions = false, 
       const int insert_every_nth_transition_only = 1,
-      const bool insert_unconnected_system_states = true);
+      const bool insert_unconnected_system_states = true,
+      const ExplorationOptions& options = {});
+
+   ExplorationStats getLastExplorationStats() const;
 
    inline void generateFullModel() 
    {
@@ -55,7 +94,8 @@ public:
       generateModel();
    }
    
-   static SystemStateVec generateFullSystemSeedACC();
+   static SystemStateVec generateFullSystemSeedACC(const AccRanges& ranges = {});
+   static ModelConfiguration createConfigSimpleACC(const AccRanges& ranges = {});
    
    fsm::FSMs getModel();
 
@@ -92,13 +132,9 @@ public:
       const std::function<bool(const SystemState& state)> is_ok = [](const SystemState& state) { return true; });
 
 private:
-   int addStateToSystem(
-      const SystemState& state, 
-      std::map<SystemState, int>& states, 
-      std::map<int, SystemState>& states_rev, 
-      std::vector<int>& unprocessed,
-      int& max_state_num);
-   
+   void exploreBitstate(const int abort_after_n_states, const ExplorationOptions& options);
+   void reportProgress(const ExplorationOptions& options, const long num_states, const long num_successors, const size_t num_unprocessed, const bool force = false);
+
    void addPainting(const int state_num, const SystemState& state);
 
    SystemStateVec seed_;
@@ -108,6 +144,9 @@ private:
    float ego_offset_x_ = 0;
    fsm::FSMs model_;
    std::vector<Image> ascii_table_;
+   ExplorationStats stats_{};
+   std::chrono::steady_clock::time_point exploration_start_{};
+   std::chrono::steady_clock::time_point last_progress_{};
 };
 
 } // vfm
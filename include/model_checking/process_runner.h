@@ -0,0 +1,108 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+#pragma once
+
+#include "failable.h"
+#include "model_checking/mc_types.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace vfm {
+namespace mc {
+
+struct ProcessLimits {
+   double wall_clock_seconds{ 0 }; // 0 means unlimited.
+   size_t memory_bytes{ 0 };       // 0 means unlimited. Applied as RLIMIT_AS (via "ulimit -v" of /bin/sh) before the process starts.
+};
+
+struct ProcessStatistics {
+   int pid{ -1 };
+   bool spawned{ false };
+   int exit_code{ -1 };            // Only valid if the process exited regularly (i.e., term_signal == 0).
+   int term_signal{ 0 };
+   bool timed_out{ false };
+   bool cancelled{ false };
+   long max_rss_kb{ 0 };
+   double user_time_seconds{ 0 };
+   double system_time_seconds{ 0 };
+   std::chrono::nanoseconds wall_time{};
+
+   bool isSuccess() const { return spawned && !timed_out && !cancelled && term_signal == 0 && exit_code == EXIT_SUCCESS; }
+   std::string serialize() const;
+};
+
+using ProcessOutputCallback = std::function<void(const std::string& chunk)>;
+
+/// \brief Spawns an external tool (nuXmv, Kratos, ...) directly via posix_spawn, without going
+/// through a shell. Stdout and stderr are merged and streamed through a pipe into the given
+/// callback while the process runs.
+///
+/// The process is put into its own process group, so that cancelling (from any thread, e.g., the
+/// GUI) or running into the wall-clock limit kills the tool including all its children.
+/// All running instances are registered globally and can be cancelled by a substring of their
+/// command line (cf. cancelAllMatching), which matches the way jobs are identified in the GUI.
+class ProcessRunner : public Failable
+{
+public:
+   ProcessRunner();
+   ~ProcessRunner();
+
+   ProcessStatistics run(
+      const std::vector<std::string>& argv,
+      const std::map<std::string, std::string>& additional_env = {},
+      const ProcessLimits& limits = {},
+      const ProcessOutputCallback& on_output = nullptr);
+
+   void cancel();
+   bool isRunning() const;
+   std::string getCommandLine() const;
+
+   /// Cancels all currently running processes whose command line contains the given substring.
+   /// Returns the number of processes cancelled.
+   static int cancelAllMatching(const std::string& command_line_substring);
+
+private:
+   std::atomic<int> pid_{ -1 };
+   std::atomic<bool> cancel_requested_{ false };
+   std::string command_line_{};
+
+   static std::mutex running_mutex_;
+   static std::set<ProcessRunner*> running_;
+};
+
+/// \brief Incrementally consumes nuXmv output and reports each counterexample as soon as it is
+/// complete, i.e., before the model checker run finishes.
+class NusmvCexStreamer
+{
+public:
+   NusmvCexStreamer(const std::function<void(const MCTrace& trace, const int cex_num)>& on_cex);
+
+   void feed(const std::string& chunk);
+   void finish();
+   const std::string& getFullOutput() const;
+   int getNumCexsFound() const;
+
+private:
+   void processCompleteLines(const bool at_end);
+   void emitCurrentCex(const size_t end_pos);
+
+   std::function<void(const MCTrace& trace, const int cex_num)> on_cex_{};
+   std::string output_{};
+   size_t scan_pos_{ 0 };
+   size_t current_cex_begin_{ std::string::npos };
+   int num_cexs_found_{ 0 };
+};
+
+} // mc
+} // vfm
@@ -14,6 +14,7 @@
 #include "cpp_parsing/cpp_type_enum.h"
 #include "data_pack.h"
 #include <memory>
+#include <optional>
 #include <variant>
 
 namespace vfm {
@@ -250,16 +251,37 @@ private:
    std::vector<std::string> possible_values_{};
 };
 
+/// A statement of a section, i.e., the code between two ";" on top level (w.r.t. case...esac),
+/// trimmed, as byte range into the comment-free code of the section.
+struct SectionStatement {
+   int begin_{};
+   int length_{};
+};
+
+struct SectionIndex {
+   std::string code_{}; // Section code without "--" comments and blank lines.
+   std::vector<SectionStatement> statements_{};
+};
+
+/// \brief An SMV module, stored section-wise as raw code.
+///
+/// Sections are split into statements only once, when first queried, and the query results (variables
+/// with types, inits, defines) are cached on top of that. Both are invalidated per section by parseProgram,
+/// setSectionCode and clear, so editing e.g. the DEFINE section does not re-parse the VAR section.
 class Module : public Failable
 {
 public:
    Module();
 
    bool parseProgram(const std::string& program);
-   std::map<std::string, std::shared_ptr<SMVDatatype>> getVariablesWithTypes() const;
-   std::map<std::string, std::string> getAllVariableInits() const;
-   std::map<std::string, std::string> getVariableDefines() const;
-   std::set<std::string> getAllVariablesAndDefinesForOutsideUsage() const;
+   const std::map<std::string, std::shared_ptr<SMVDatatype>>& getVariablesWithTypes() const;
+   const std::map<std::string, std::string>& getAllVariableInits() const;
+   const std::map<std::string, std::string>& getVariableDefines() const;
+   const std::set<std::string>& getAllVariablesAndDefinesForOutsideUsage() const;
+   std::shared_ptr<SMVDatatype> getVariableType(const std::string& var_name) const; // nullptr if not declared in VAR.
+   const SectionIndex& getSectionIndex(const std::string& section_name) const;
+   std::string getStatement(const std::string& section_name, const SectionStatement& statement) const;
+   void setSectionCode(const std::string& section_name, const std::string& code);
    std::string serialize() const;
    void clear();
 
@@ -297,7 +319,13 @@ private:
 
    std::string module_name_{};
 
-   std::vector<std::string> splitAlongLines(const std::string& raw_code) const;
+   mutable std::map<std::string, SectionIndex> section_indices_{};
+   mutable std::optional<std::map<std::string, std::shared_ptr<SMVDatatype>>> variables_with_types_{};
+   mutable std::optional<std::map<std::string, std::string>> variable_inits_{};
+   mutable std::optional<std::map<std::string, std::string>> variable_defines_{};
+   mutable std::optional<std::set<std::string>> variables_and_defines_{};
+
+   void invalidateCaches(const std::string& section_name);
 };
 
 } // smv
@@ -48,9 +48,11 @@ class ModuleElementBase : public Failable {
 public:
    std::string getModuleElementName() const;
    std::string getRawCode() const;
+   const std::string& getRawCodeRef() const;
    void setCode(const std::string& to);
    void appendCodeLine(const std::string& additional_code);
    std::string serialize() const;
+   void serializeInto(std::string& s) const; // Appends to s, same as s += serialize().
 
 protected:
    ModuleElementBase(const std::string& name);
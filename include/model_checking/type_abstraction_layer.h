@@ -187,7 +187,7 @@ public:
    std::pair<FullType, MCInitialValue> get(const std::string& var_name) const;
    bool contains(const std::string& var_name) const;
    bool hasRange(const std::string& var_name) const;
-   std::pair<float, float> getRange(const std::string& var_name) const; // Returns min > max if no range available.
+   std::pair<float, float> getRange(const std::string& var_name, const bool log_if_unavailable = true) const; // Returns min > max if no range available.
 
    /// \brief Sets the range to the union of the existing and the new range.
    /// If the variable never existed, the new range is set.
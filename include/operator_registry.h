@@ -0,0 +1,103 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+#pragma once
+
+#include "operator_structure.h"
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vfm {
+
+class Term;
+
+/// \brief The operators known to a FormulaParser, by dense id.
+///
+/// Every operator name is interned once to an id; from there on, the per-token queries of the
+/// shunting-yard loop (declared? precedence? left-associative? possible numbers of parameters?)
+/// are one hash lookup for the name plus array accesses, and the term factory finds the
+/// constructor of a built-in term by (id, number of operands) instead of comparing the name
+/// against every built-in symbol.
+///
+/// Dynamic terms are registered into the same table: the registry mirrors, per operator name,
+/// the operator structures and compound structures the parser keeps in its maps. The parser
+/// stays the owner of these maps and calls refresh() for every name it changes.
+class OperatorRegistry {
+public:
+   using OperatorId = int;
+   using NativeFactory = std::shared_ptr<Term>(*)(const std::vector<std::shared_ptr<Term>>& terms);
+
+   static constexpr OperatorId NO_OPERATOR{ -1 };
+   static constexpr int ANY_NUMBER_OF_OPERANDS{ -1 };
+
+   struct Entry {
+      std::string name_{};
+      bool declared_{ false };                                   // Name is in the parser's operator map.
+      std::map<int, OperatorStructure> op_structs_{};            // By number of parameters, incl. PARNUM_... modes.
+      std::map<int, std::shared_ptr<Term>> metas_{};             // Compound structures of dynamic terms, same keys.
+      std::set<int> num_params_{};                               // The non-negative keys of op_structs_.
+
+      // Precomputed for prio() and isLeftAssoc(); a flexible overload takes precedence over all others.
+      bool has_flexible_{ false };
+      int flexible_precedence_{};
+      bool flexible_left_assoc_{};
+      std::vector<int> precedence_by_num_params_{};
+      std::vector<signed char> left_assoc_by_num_params_{};      // -1 if there is no such overload.
+
+      std::vector<NativeFactory> native_by_num_operands_{};
+      NativeFactory native_any_num_operands_{ nullptr };
+   };
+
+   OperatorRegistry() = default;
+
+   OperatorId intern(const std::string& name);
+
+   /// NO_OPERATOR if the name has never been interned.
+   OperatorId find(const std::string& name) const;
+
+   const Entry& getEntry(const OperatorId id) const;
+
+   /// The entry of the name if it is a declared operator, nullptr otherwise.
+   const Entry* findDeclared(const std::string& name) const;
+
+   /// Registers the constructor of a built-in term. Use ANY_NUMBER_OF_OPERANDS for terms accepting any number.
+   void registerNativeFactory(const std::string& name, const int num_operands, const NativeFactory factory);
+
+   /// Nullptr if there is no built-in term of that name for that number of operands.
+   NativeFactory getNativeFactory(const OperatorId id, const int num_operands) const;
+
+   /// Re-reads the operator structures and compound structures of one name from the parser's maps.
+   void refresh(
+      const std::string& name,
+      const std::map<std::string, std::map<int, OperatorStructure>>& all_ops,
+      const std::map<std::string, std::map<int, std::shared_ptr<Term>>>& dynamic_term_metas);
+
+   /// Same for all names, including forgetting the ones no longer in the maps.
+   void refreshAll(
+      const std::map<std::string, std::map<int, OperatorStructure>>& all_ops,
+      const std::map<std::string, std::map<int, std::shared_ptr<Term>>>& dynamic_term_metas);
+
+   /// Precedence of the overload, or false if there is no such overload.
+   bool getPrecedence(const Entry& entry, const int num_params, int& precedence) const;
+
+   /// Throws std::out_of_range if there is no such overload (like the map lookup it replaces).
+   bool isLeftAssoc(const Entry& entry, const int num_params) const;
+
+private:
+   void refreshEntry(
+      Entry& entry,
+      const std::map<std::string, std::map<int, OperatorStructure>>& all_ops,
+      const std::map<std::string, std::map<int, std::shared_ptr<Term>>>& dynamic_term_metas);
+
+   std::unordered_map<std::string, OperatorId> ids_{};
+   std::vector<Entry> entries_{};
+};
+
+} // vfm
@@ -0,0 +1,85 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+#pragma once
+
+#include "failable.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace vfm {
+
+/// \brief Target of large generated texts such as XML exports or the Kratos model, written piece by piece
+/// instead of being assembled into one string first.
+class OutputSink {
+public:
+   virtual ~OutputSink() = default;
+
+   virtual void write(const char* data, const size_t size) = 0;
+   virtual void flush() {}
+
+   void write(const std::string& str);
+   OutputSink& operator<<(const std::string& str);
+   OutputSink& operator<<(const char* str);
+};
+
+class StringSink : public OutputSink {
+public:
+   void write(const char* data, const size_t size) override;
+   using OutputSink::write;
+
+   const std::string& str() const;
+
+private:
+   std::string str_{};
+};
+
+/// \brief Writes to a file (in text mode) through a fixed-size buffer, so that arbitrarily large output
+/// never has to be held in memory as a whole.
+class FileSink : public OutputSink, public Failable {
+public:
+   static constexpr size_t DEFAULT_BUFFER_SIZE{ 1 << 16 };
+
+   FileSink(const std::filesystem::path& path, const size_t buffer_size = DEFAULT_BUFFER_SIZE);
+   ~FileSink() override;
+
+   void write(const char* data, const size_t size) override;
+   using OutputSink::write;
+   void flush() override;
+
+   bool isOpen() const;
+
+private:
+   std::FILE* file_{ nullptr };
+   std::vector<char> buffer_{};
+   size_t used_{ 0 };
+};
+
+/// Computes the 64-bit FNV-1a hash (as StaticHelper::hashFNV1a) of everything written, and forwards it to
+/// the next sink, if any. So the hash of a generated file is known right after writing, without reading it back.
+class HashingSink : public OutputSink {
+public:
+   explicit HashingSink(OutputSink* next = nullptr);
+
+   void write(const char* data, const size_t size) override;
+   using OutputSink::write;
+   void flush() override;
+
+   uint64_t getHash() const;
+   std::string getHashHex() const;
+   size_t getSize() const;
+
+private:
+   OutputSink* next_{};
+   uint64_t hash_{ 0xcbf29ce484222325ULL };
+   size_t size_{};
+};
+
+} // vfm
@@ -54,6 +54,7 @@
 #include "terms_trigonometry.h"
 #include "equation.h"
 #include "earley/earley_grammar.h"
+#include "operator_registry.h"
 #include <vector>
 #include <stack>
 #include <sstream>
@@ -183,7 +184,7 @@ public:
    void postprocessFormulaFromCPP(const std::shared_ptr<MathStruct> formula, const std::map<std::string, std::set<int>>& pointerized);
    std::string preprocessProgram(const std::string& program) const override;
    bool parseProgram(const std::string& dynamic_term_commands) override;
-   std::map<std::string, std::map<int, OperatorStructure>>& getAllOps();
+   const std::map<std::string, std::map<int, OperatorStructure>>& getAllOps() const;
 
    void checkForUndeclaredVariables(const std::shared_ptr<DataPack> d);
 
@@ -245,6 +246,10 @@ private:
 
    std::set<std::pair<std::string, int>> native_funcs_{};
 
+   /// Mirrors all_ops_ and dynamic_term_metas_ by dense operator id, plus the constructors of the built-in terms.
+   /// Call operator_registry_.refresh(name, ...) after changing anything about name in these maps.
+   OperatorRegistry operator_registry_{};
+
    // Mapping from { function_name, num_params } to map from parameter num to its name.
    std::map<std::pair<std::string, int>, std::map<int, std::string>> naming_of_parameters_{};
 
@@ -263,6 +268,7 @@ private:
    }
 
    void registerAddress(const std::string& func_name, const int num_params);
+   void registerNativeTerms();
    void addDynamicTermViaFuncRef(const std::vector<std::shared_ptr<Term>>& terms);
 
    static std::string getStartSymbol(const int i);
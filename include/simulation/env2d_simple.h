@@ -10,6 +10,7 @@
 #include "geometry/polygon_2d.h"
 #include "geometry/images.h"
 #include "simulation/highway_image.h"
+#include "simulation/road_graph_index.h"
 #include <memory>
 
 
@@ -72,15 +73,17 @@ public:
    ) const
    {
       const float LANE_CONSTANT{ ((float)road_graph->getMyRoad().getNumActualLanes() - 1) * 2}; // TODO: What is different sections have different numbers of lanes?
-      StraightRoadSection& ego_road{ road_graph->findSectionWithEgoIfAny()->getMyRoad() }; // TODO: Can be null??
+      const RoadGraphIndex road_graph_index{ road_graph }; // Built once per frame, cars are looked up in its car index below.
+      StraightRoadSection& ego_road{ road_graph_index.findSectionWithCar(RoadGraph::EGO_MOCK_ID)->getMyRoad() }; // TODO: Can be null??
       const CarDimensions dim{ ego_road.getEgo()->car_dim_ };
 
       ego_road.setEgo(std::make_shared<CarPars>(ego_pos_y_, ego_pos_x_, ego_vx_ * SPEED_DIVISOR_FOR_STEP_SMOOTHNESS, RoadGraph::EGO_MOCK_ID, dim));
 
       for (int i{}; i < num_cars_; i++) {
-         CarParsVec others_vec{ road_graph->findSectionWithCar(i)->getMyRoad().getOthers() };
+         auto& car_road{ road_graph_index.findSectionWithCar(i)->getMyRoad() };
+         CarParsVec others_vec{ car_road.getOthers() };
          others_vec.push_back({ agents_pos_y_[i], agents_pos_x_[i], (int)((agents_vx_rel_[i] + ego_vx_) * SPEED_DIVISOR_FOR_STEP_SMOOTHNESS), i, dim });
-         road_graph->findSectionWithCar(i)->getMyRoad().setOthers(others_vec);
+         car_road.setOthers(others_vec);
 
          if (future_data && agents_to_draw_arrows_for.count(i)) {
             others_future_vec.insert(
@@ -9,6 +9,7 @@
 #include "highway_translators.h"
 #include "geometry/images.h"
 #include "road_graph.h"
+#include "road_graph_index.h"
 
 namespace vfm {
 
@@ -53,6 +54,14 @@ public:
       const Vec2D scale = Vec2D{ 1, 1 },
       const float angle_rad = 0);
 
+   /// Same as plotCar3D for each car in the given order (i.e., provide them back to front), but the faces
+   /// of all cars are translated as one batch.
+   void plotCars3D(
+      const std::vector<std::pair<Vec2Df, Color>>& positions_and_fill_colors,
+      const float lane_width,
+      const float car_width,
+      const float car_length);
+
    void doShoulder(
       const bool min_lane,
       const bool is_current_shoulder,
@@ -124,13 +133,13 @@ public:
       const RoadDrawingMode mode = RoadDrawingMode::both);
 
    void paintBezierConnectionsBetweenSections(
-      const std::shared_ptr<RoadGraph> my_r,
+      const RoadGraphIndex& my_r_index,
       const Vec2D& dim_raw,
       const std::shared_ptr<HighwayTranslator> old_trans
    );
 
    void paintGraphConnectionsBetweenSections(
-      const std::shared_ptr<RoadGraph> my_r,
+      const RoadGraphIndex& my_r_index,
       const std::map<std::string, std::string>& var_vals,
       const std::shared_ptr<HighwayTranslator> old_trans
    );
@@ -155,6 +164,8 @@ public:
    bool PAINT_ROUNDABOUT_AROUND_EGO_SECTION_FOR_TESTING_ = false; // TODO: Remove this whole logic once visualization of road graphs works reliably.
 
 private:
+   static void addCar3DFaces(std::vector<Pol3D>& faces, const Vec2Df& pos_car, const float lane_width, const float car_width, const float car_length); // 5 faces in painting order.
+
    std::shared_ptr<HighwayTranslator> highway_translator_{};
    std::shared_ptr<Plain2DTranslator> plain_2d_translator_{ std::make_shared<Plain2DTranslator>() };
    std::shared_ptr<HighwayTranslatorWrapper> plain_2d_translator_wrapped_{};
@@ -10,6 +10,7 @@
 #include "geometry/line_segment_3d.h"
 #include "geometry/line_3d.h"
 #include "geometry/plane_3d.h"
+#include "geometry/view_projection.h"
 #include <cmath>
 
 namespace vfm {
@@ -228,55 +229,9 @@ public:
    }
 
 private:
-   inline Vec3D getPointInCameraCoordinates(const Vec3D& point_raw) const
-   {
-      const auto perspective{ getPerspective() };
-      const Vec3D point{ point_raw.z, point_raw.y * (mirrored_ ? -1 : 1), point_raw.x };
-
-      // Cf. https://en.wikipedia.org/w/index.php?title=3D_projection&oldid=1190317936#Mathematical_formula
-      const double x{ point.x - perspective->getCameraX() };
-      const double y{ point.y - perspective->getCameraY() };
-      const double z{ point.z - perspective->getCameraZ() };
-      const double sx{ perspective->getRotationCameraXSin() };
-      const double sy{ perspective->getRotationCameraYSin() };
-      const double sz{ perspective->getRotationCameraZSin() };
-      const double cx{ perspective->getRotationCameraXCos() };
-      const double cy{ perspective->getRotationCameraYCos() };
-      const double cz{ perspective->getRotationCameraZCos() };
-
-      const double dz{ cx * (cy * z + sy * (sz * y + cz * x)) - sx * (cz * y - sz * x) };
-      const double dx{ cy * (sz * y + cz * x) - sy * z };
-      const double dy{ sx * (cy * z + sy * (sz * y + cz * x)) + cx * (cz * y - sz * x) };
-
-      return { (float)dx, (float)dy, (float)dz };
-   }
-
-   inline Vec2D projectPointInCameraPerspectiveTo2D(const Vec3D& d) const
-   {
-      const auto perspective{ getPerspective() };
-
-      const double ex{ perspective->getDisplayWindowX() };
-      const double ey{ perspective->getDisplayWindowY() };
-      const double ez{ perspective->getDisplayWindowZ() };
-
-      double bx{ ez / d.z * d.x + ex };
-      double by{ ez / d.z * d.y + ey };
-
-      bx *= real_width_;
-      //by += .06; // TODO!
-      by *= real_height_;
-
-      return { (float)bx, (float)by };
-   }
-
    inline Vec2D translateCore(const Vec3D& point_raw) override
-   {
-      const auto d{ getPointInCameraCoordinates(point_raw) };
-      if (d.z >= 0) { // Check if point it in front of the camera.
-         return projectPointInCameraPerspectiveTo2D(d);
-      } else { // Return NAN if behind the camera. For polygons partially behind camera use translatePolygon(...).
-         return { std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::quiet_NaN() };
-      }
+   { // Returns NAN if behind the camera. For polygons partially behind camera use translatePolygon(...).
+      return getViewProjection().project(point_raw);
    }
 
    inline Vec3D reverseTranslateCore(const Vec2D& point) override 
@@ -285,83 +240,31 @@ private:
       return { 0, 0, 0 };
    }
 
-   /// <summary>
-   /// Adds for two points P, Q, one of which is is behind, the other in front of the camera, the intersection point
-   /// of the line through P and Q to the resulting polygon. This accomplishes the clipping at the visible plane.
-   /// </summary>
-   /// <param name="last_point_in_camera_coordinates">One of the points P, Q, can be in front of or behind the camera.</param>
-   /// <param name="point_in_camera_coordinates">One of the points P, Q, can be in front of or behind the camera.</param>
-   /// <param name="result">The resulting polygon which the intersection will be added to.</param>
-   inline void addIntersectionPointToResult(const Vec3D& last_point_in_camera_coordinates, const Vec3D& point_in_camera_coordinates, Pol2D& result) const
-   {
-      Pln3D camera_plane{ getPerspective()->getDisplayPlane() };
-      Lin3D current_line{ LinSeg3D{ last_point_in_camera_coordinates, point_in_camera_coordinates } };
-      auto intersection{ camera_plane.intersect(current_line) };
-
-      if (intersection) {
-         result.add(projectPointInCameraPerspectiveTo2D(*intersection));
-      }
-      else {
-         Failable::getSingleton()->addFatalError("No intersection"); // TODO: Just for now, remove later.
-      }
-   }
-
    inline Pol2D translatePolygonCore(const Pol3D& pol) override
    { // Clips polygons at visible plane if they are partially behind and partially in front of the camera.
-      Pol2D result{};
-      bool last_behind_camera{ false };
-      bool current_behind_camera{ false };
-      bool yes{};
-      Vec3D current_point{ *(pol.points_.end() - 1) };
-      Vec3D last_point{};
-      Vec3D current_point_in_camera_coordinates{};
-      Vec3D last_point_in_camera_coordinates{};
-      int first{ 0 };
-      bool found{ false };
-      bool firstit{ true };
-
-      for (; first < pol.points_.size(); first++) { // Find first point that is in front of the camera.
-         last_point = current_point;
-         current_point = pol.points_.at(first);
-
-         if (getPointInCameraCoordinates(current_point).z >= 0) {
-            found = true;
-            break;
-         }
-      }
+      return getViewProjection().projectPolygon(pol);
+   }
 
-      if (!found) return {}; // No point is in front of the camera.
-
-      last_point_in_camera_coordinates = getPointInCameraCoordinates(last_point);
-
-      for (int i = first; i != first || firstit; i = (i + 1) % pol.points_.size()) {
-         current_point_in_camera_coordinates = getPointInCameraCoordinates(pol.points_.at(i));
-         current_behind_camera = current_point_in_camera_coordinates.z <= 0;
-         last_behind_camera = last_point_in_camera_coordinates.z <= 0;
-
-         if (current_behind_camera) {
-            if (!last_behind_camera) { // Current point behind the camera, but the last was still fine.
-               addIntersectionPointToResult(last_point_in_camera_coordinates, current_point_in_camera_coordinates, result);
-               yes = true;
-            }
-            else { 
-               // We are in a sequence of behind-camera points. Ignore these.
-            }
-         } else {
-            if (last_behind_camera) {        // Current point in front of camera, but last was behind.
-               addIntersectionPointToResult(last_point_in_camera_coordinates, current_point_in_camera_coordinates, result);
-               yes = true;
-            }
-
-            result.add(projectPointInCameraPerspectiveTo2D(current_point_in_camera_coordinates));
-         }
+   inline std::vector<Pol2D> translatePolygonsCore(const std::vector<Pol3D>& pols) override
+   {
+      ViewProjection& view_projection{ getViewProjection() };
+      std::vector<Pol2D> result{};
+      result.reserve(pols.size());
 
-         last_point_in_camera_coordinates = current_point_in_camera_coordinates;
-         firstit = false;
+      for (const auto& pol : pols) {
+         result.push_back(view_projection.projectPolygon(pol));
       }
 
       return result;
    }
+
+   inline ViewProjection& getViewProjection()
+   {
+      view_projection_.update(*getPerspective(), mirrored_, real_width_, real_height_);
+      return view_projection_;
+   }
+
+   ViewProjection view_projection_{};
 };
 
 /// <summary>
@@ -415,6 +318,19 @@ public:
       return base_translator_->translatePolygonCore(pol);
    }
 
+   inline std::vector<Pol2D> translatePolygonsCore(const std::vector<Pol3D>& pols_raw) override
+   { // Wraps all points first so that the base translator can project the whole batch at once.
+      std::vector<Pol3D> pols(pols_raw.size());
+
+      for (size_t i = 0; i < pols_raw.size(); i++) {
+         for (const auto& p : pols_raw[i].points_) {
+            pols[i].add(wrapper_function_(p));
+         }
+      }
+
+      return base_translator_->translatePolygonsCore(pols);
+   }
+
    bool is3D() const override
    {
       return base_translator_->is3D();
@@ -10,9 +10,11 @@
 #include "geometry/polygon_2d.h"
 #include "geometry/images.h"
 #include "xml/xml_generator.h"
+#include "xml/xml_writer.h"
 #include "failable.h"
 #include "static_helper.h"
 #include <string>
+#include <functional>
 
 namespace vfm {
 
@@ -92,6 +94,9 @@ using CarParsVec = std::vector<CarPars>;
 
 static int global_id_first_free{ 0 };
 
+/// Resets the id counter used for OSM elements (which otherwise keeps counting over all OSM exports).
+void resetOSMIdCounter(const int first_free_id = 0);
+
 class RoadGraph;
 
 struct WayIDs {
@@ -113,6 +118,11 @@ public:
    inline Way(const std::shared_ptr<RoadGraph> my_father_rg);
    std::pair<std::shared_ptr<xml::CodeXML>, std::shared_ptr<xml::CodeXML>> getXML() const;
 
+   /// Streaming counterparts of getXML(). In an OSM file, all nodes come before all ways, so writeNodes()
+   /// has to be called for all ways first; it also assigns the ids of the connector nodes used by writeWays().
+   void writeNodes(xml::XmlWriter& writer) const;
+   void writeWays(xml::XmlWriter& writer) const;
+
 private:
    WayIDs way_ids_{};
    int origin_node_left_id_{};
@@ -130,6 +140,15 @@ private:
       const std::vector<int> right_ids
    );
 
+   static void writeWayGeneric(
+      xml::XmlWriter& writer,
+      const WayIDs& way_ids,
+      const std::vector<int>& left_ids,
+      const std::vector<int>& right_ids
+   );
+
+   void computeNodes(const std::function<void(const int id, const double lat, const double lon)>& node_callback) const;
+   void checkConnectorIDs() const;
    std::shared_ptr<xml::CodeXML> getNodesXML() const;
    std::shared_ptr<xml::CodeXML> getWayXML() const;
 
@@ -208,7 +227,7 @@ public:
    int getNumTechnicalLanes() const;
    float getLaneWidth() const;
    bool isValid() const;
-   std::map<float, LaneSegment> getSegments() const;
+   const std::map<float, LaneSegment>& getSegments() const;
    std::map<float, LaneSegment>& getSegmentsRef();
 
    void setEgo(const std::shared_ptr<CarPars> ego);
@@ -217,7 +236,7 @@ public:
    void setFuturePositionsOfOthers(const std::map<int, std::pair<float, float>>& future_positions_of_others);
    void setSectionEnd(const float end);
    std::shared_ptr<CarPars> getEgo() const;
-   CarParsVec getOthers() const;
+   const CarParsVec& getOthers() const;
    std::map<int, std::pair<float, float>> getFuturePositionsOfOthers() const;
    float getLength() const;
    std::map<int, Way> addWaysToSegment(const float segment_id, const std::shared_ptr<RoadGraph> father_rg);
@@ -332,6 +351,7 @@ public:
    bool isGhost() const;
 
    std::shared_ptr<xml::CodeXML> generateOSM() const;
+   void generateOSM(xml::XmlWriter& writer) const; // Same output as generateOSM()->serializeBlock(), without building the CodeXML tree.
 
    std::shared_ptr<RoadGraph> copy() const;
 
@@ -0,0 +1,114 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+#pragma once
+
+#include "simulation/road_graph.h"
+#include "geometry/rectangle_2d.h"
+#include "failable.h"
+
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace vfm {
+
+/// \brief Contiguous view on a range of section indices within a RoadGraphIndex.
+struct SectionIndexRange {
+   const int* begin_{ nullptr };
+   const int* end_{ nullptr };
+
+   inline const int* begin() const { return begin_; }
+   inline const int* end() const { return end_; }
+   inline size_t size() const { return end_ - begin_; }
+   inline bool empty() const { return begin_ == end_; }
+};
+
+/// \brief Flattened snapshot of a RoadGraph: all sections and lane segments in contiguous arrays,
+/// successors/predecessors as integer adjacency lists (CSR layout), an id-to-section and a
+/// car-to-section index, and a uniform grid over the section footprints for spatial queries.
+///
+/// The index keeps pointers to the RoadGraph nodes it was built from. It stays valid
+/// as long as the TOPOLOGY (sections, connections, geometry) does not change; cars may move
+/// freely, only the car index needs a refreshCarIndex() to see them (once per frame after placing the cars). The shared_ptr based
+/// methods mirror the respective RoadGraph methods, so callers can switch from the recursive
+/// traversal to the index without further changes.
+class RoadGraphIndex : public Failable {
+public:
+   static constexpr float DEFAULT_GRID_CELL_SIZE{ 50.0f };
+
+   struct Section {
+      int id_{};
+      Vec2D origin_{};
+      Vec2D drain_{};
+      float angle_{};
+      float length_{};
+      float lane_width_{};
+      int num_actual_lanes_{};
+      bool ghost_{};
+      Rec2D footprint_{};       // Conservative axis-aligned bounding box of the section's lanes.
+      int first_segment_{};     // Range in getSegments().
+      int num_segments_{};
+      int first_successor_{};   // Ranges in the flat adjacency arrays.
+      int num_successors_{};
+      int first_predecessor_{};
+      int num_predecessors_{};
+   };
+
+   RoadGraphIndex(const std::shared_ptr<RoadGraph> r, const float grid_cell_size = DEFAULT_GRID_CELL_SIZE);
+
+   int size() const;
+   int indexOf(const int section_id) const;        // -1 if no such section.
+   int indexOfSectionWithCar(const int car_id) const; // Only cars ON a section (incl. ego), as of the last refreshCarIndex(). -1 if not found.
+
+   const Section& getSection(const int index) const;
+   const std::vector<Section>& getSections() const;
+   const std::vector<LaneSegment>& getSegments() const;
+   SectionIndexRange getSuccessorIndices(const int index) const;
+   SectionIndexRange getPredecessorIndices(const int index) const;
+
+   /// Returns indices of all sections whose footprint intersects the given area/contains the given point.
+   std::vector<int> querySections(const Rec2D& area) const;
+   std::vector<int> querySectionsAt(const Vec2D& point) const;
+
+   /// Re-scans all sections for cars. Needed after cars have been added, moved or removed.
+   void refreshCarIndex();
+
+   // Adapter to the RoadGraph API.
+   std::shared_ptr<RoadGraph> getNode(const int index) const;
+   std::shared_ptr<RoadGraph> findSectionWithID(const int id) const;
+   std::shared_ptr<RoadGraph> findSectionWithCar(const int car_id) const;
+   std::shared_ptr<RoadGraph> findSectionWithEgoIfAny() const;
+   RoadGraph::CarLocation findEgo() const;
+   const std::vector<std::shared_ptr<RoadGraph>>& getAllNodes() const;
+   void applyToAll(const std::function<void(const std::shared_ptr<RoadGraph>)>& action) const;
+   void cleanFromAllCars(); // Also empties the car index.
+
+private:
+   void buildSections();
+   void buildGrid(const float grid_cell_size);
+   std::pair<int, int> cellOf(const Vec2D& point) const;
+
+   std::vector<std::shared_ptr<RoadGraph>> nodes_{};
+   std::vector<Section> sections_{};
+   std::vector<LaneSegment> segments_{};
+   std::vector<int> successors_{};
+   std::vector<int> predecessors_{};
+   std::unordered_map<int, int> id_to_index_{};
+   std::unordered_map<int, int> car_to_index_{};
+
+   // Uniform grid over the bounding box of all footprints; cell (x, y) holds the sections
+   // in grid_items_[grid_offsets_[y * grid_width_ + x] .. grid_offsets_[y * grid_width_ + x + 1]).
+   Vec2D grid_origin_{};
+   float grid_cell_size_{ DEFAULT_GRID_CELL_SIZE };
+   int grid_width_{ 0 };
+   int grid_height_{ 0 };
+   std::vector<int> grid_offsets_{};
+   std::vector<int> grid_items_{};
+};
+
+} // vfm
@@ -0,0 +1,311 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace vfm {
+
+/**
+* Discrete-event calendar of the {@link SimulationTime}: a binary min-heap of
+* (time, slot) notifications, where a slot is the dense index of a plugin.</BR>
+* </BR>
+* Notifications for the same time are delivered in the order they have been
+* scheduled; scheduling the same (time, slot) pair twice yields only one
+* notification. Cancelling is O(1): a cancelled entry is only marked dead and
+* skipped when it reaches the top of the heap. To cancel everything for a slot
+* at once, each slot has a generation counter which invalidates all of its
+* entries scheduled before.
+*/
+class EventCalendar {
+
+public:
+   /**
+   * Identifies one scheduled notification. A handle becomes invalid when its
+   * notification has been delivered or cancelled; entries are reused, so the
+   * serial number guards against cancelling a later notification by mistake.
+   */
+   struct Handle {
+      int entry_{ -1 };
+      uint32_t serial_{ 0 };
+
+      inline bool isValid() const { return entry_ >= 0; }
+   };
+
+   /**
+   * Schedules a notification for the slot at the given time.
+   *
+   * @return  The handle of the notification; if the same (time, slot) pair is
+   *          already scheduled, the handle of the existing notification.
+   */
+   inline Handle schedule(const double time, const int slot)
+   {
+      ensureSlot(slot);
+      const auto existing = pending_.find(Key{ time, slot });
+
+      if (existing != pending_.end() && isAlive(existing->second)) {
+         return { existing->second, entries_[existing->second].serial_ };
+      }
+
+      int id;
+
+      if (free_entries_.empty()) {
+         id = entries_.size();
+         entries_.push_back({});
+      } else {
+         id = free_entries_.back();
+         free_entries_.pop_back();
+      }
+
+      Entry& entry = entries_[id];
+      entry.time_ = time;
+      entry.slot_ = slot;
+      entry.seq_ = next_seq_++;
+      entry.generation_ = slot_generations_[slot];
+      entry.cancelled_ = false;
+
+      pending_[Key{ time, slot }] = id;
+      heap_.push_back(id);
+      std::push_heap(heap_.begin(), heap_.end(), Later{ entries_ });
+
+      return { id, entry.serial_ };
+   }
+
+   /**
+   * Cancels the notification in O(1).
+   *
+   * @return  Iff the handle referred to a notification still pending.
+   */
+   inline bool cancel(const Handle& handle)
+   {
+      if (!handle.isValid() || handle.entry_ >= (int) entries_.size()
+         || entries_[handle.entry_].serial_ != handle.serial_ || !isAlive(handle.entry_)) {
+         return false;
+      }
+
+      entries_[handle.entry_].cancelled_ = true;
+      dead_++;
+      compactIfWorthIt();
+      return true;
+   }
+
+   /**
+   * Cancels the notification for the slot at the given time, if any.
+   */
+   inline bool cancel(const double time, const int slot)
+   {
+      const auto it = pending_.find(Key{ time, slot });
+      return it != pending_.end() && cancel(Handle{ it->second, entries_[it->second].serial_ });
+   }
+
+   /**
+   * Cancels all pending notifications of the slot in O(1).
+   */
+   inline void cancelAllOf(const int slot)
+   {
+      ensureSlot(slot);
+      slot_generations_[slot]++;
+      // The dead entries are not counted, they leave the heap on the way.
+   }
+
+   /**
+   * @return  Iff no notification is pending.
+   */
+   inline bool empty()
+   {
+      dropDeadTop();
+      return heap_.empty();
+   }
+
+   /**
+   * @return  The earliest time a notification is pending for, or infinity.
+   */
+   inline double nextTime()
+   {
+      dropDeadTop();
+      return heap_.empty() ? std::numeric_limits<double>::infinity() : entries_[heap_.front()].time_;
+   }
+
+   /**
+   * Removes all notifications pending for exactly the given time and calls
+   * the function for their slots, in scheduling order. Cancellations done by
+   * the function take effect for the remaining notifications of the time step.
+   */
+   inline void popAllAt(const double time, const std::function<void(const int slot)>& f)
+   {
+      while (!heap_.empty() && entries_[heap_.front()].time_ == time) {
+         const int id = popTop();
+
+         if (isAlive(id)) {
+            const int slot = entries_[id].slot_;
+            release(id);
+            f(slot);
+         } else {
+            release(id);
+         }
+      }
+   }
+
+   /**
+   * @return  All times a notification is pending for the slot, in ascending order.
+   *          (Linear in the size of the calendar.)
+   */
+   inline std::vector<double> getTimesOf(const int slot) const
+   {
+      std::vector<double> times;
+
+      for (const int id : heap_) {
+         if (entries_[id].slot_ == slot && isAlive(id)) {
+            times.push_back(entries_[id].time_);
+         }
+      }
+
+      std::sort(times.begin(), times.end());
+      return times;
+   }
+
+   /**
+   * @return  The number of pending notifications.
+   */
+   inline size_t size() const
+   {
+      return pending_.size() - countStaleKeys();
+   }
+
+private:
+   struct Entry {
+      double time_{};
+      int slot_{};
+      uint64_t seq_{};
+      uint32_t generation_{};
+      uint32_t serial_{};
+      bool cancelled_{};
+   };
+
+   struct Key {
+      double time_;
+      int slot_;
+
+      inline bool operator==(const Key& other) const { return time_ == other.time_ && slot_ == other.slot_; }
+   };
+
+   struct KeyHash {
+      inline size_t operator()(const Key& key) const
+      {
+         return std::hash<double>()(key.time_) * 31 + std::hash<int>()(key.slot_);
+      }
+   };
+
+   struct Later {
+      const std::vector<Entry>& entries_;
+
+      inline bool operator()(const int a, const int b) const
+      {
+         const Entry& ea = entries_[a];
+         const Entry& eb = entries_[b];
+         return ea.time_ > eb.time_ || (ea.time_ == eb.time_ && ea.seq_ > eb.seq_);
+      }
+   };
+
+   inline bool isAlive(const int id) const
+   {
+      const Entry& entry = entries_[id];
+      return !entry.cancelled_ && entry.generation_ == slot_generations_[entry.slot_];
+   }
+
+   inline void ensureSlot(const int slot)
+   {
+      if (slot >= (int) slot_generations_.size()) {
+         slot_generations_.resize(slot + 1, 0);
+      }
+   }
+
+   inline int popTop()
+   {
+      std::pop_heap(heap_.begin(), heap_.end(), Later{ entries_ });
+      const int id = heap_.back();
+      heap_.pop_back();
+      return id;
+   }
+
+   inline void dropDeadTop()
+   {
+      while (!heap_.empty() && !isAlive(heap_.front())) {
+         release(popTop());
+      }
+   }
+
+   /**
+   * Returns an entry that has left the heap to the free list.
+   */
+   inline void release(const int id)
+   {
+      Entry& entry = entries_[id];
+      const auto it = pending_.find(Key{ entry.time_, entry.slot_ });
+
+      if (it != pending_.end() && it->second == id) {
+         pending_.erase(it);
+      }
+
+      if (entry.cancelled_) {
+         dead_--;
+      }
+
+      entry.serial_++;
+      entry.cancelled_ = false;
+      free_entries_.push_back(id);
+   }
+
+   /**
+   * Rebuilds the heap without the cancelled entries once they make up the
+   * majority, so that a scheduler cancelling a lot does not grow it unboundedly.
+   */
+   inline void compactIfWorthIt()
+   {
+      if (dead_ < 64 || dead_ * 2 < heap_.size()) return;
+
+      std::vector<int> alive;
+      alive.reserve(heap_.size() - dead_);
+
+      for (const int id : heap_) {
+         if (isAlive(id)) {
+            alive.push_back(id);
+         } else {
+            release(id);
+         }
+      }
+
+      heap_ = alive;
+      std::make_heap(heap_.begin(), heap_.end(), Later{ entries_ });
+   }
+
+   inline size_t countStaleKeys() const
+   {
+      size_t stale = 0;
+
+      for (const auto& pair : pending_) {
+         if (!isAlive(pair.second)) stale++;
+      }
+
+      return stale;
+   }
+
+   std::vector<Entry> entries_{};
+   std::vector<int> free_entries_{};
+   std::vector<int> heap_{};                               // Entry ids, earliest (time, seq) on top.
+   std::unordered_map<Key, int, KeyHash> pending_{};       // For de-duplication and lookup by (time, slot).
+   std::vector<uint32_t> slot_generations_{};
+   uint64_t next_seq_{ 0 };
+   size_t dead_{ 0 };                                      // Cancelled entries still in the heap.
+};
+
+} // vfm
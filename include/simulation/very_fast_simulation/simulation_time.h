@@ -7,6 +7,7 @@
 #pragma once
 
 #include "event.h"
+#include "event_calendar.h"
 #include "master_scheduler.h"
 #include "par_collection.h"
 #include "plugin.h"
@@ -17,6 +18,7 @@
 #include <string>
 #include <map>
 #include <set>
+#include <unordered_map>
 #include <ctime>
 #include <chrono>
 #include <thread>
@@ -70,6 +72,9 @@ public:
       const std::shared_ptr<std::vector<std::shared_ptr<Plugin>>> plugs, 
       const std::shared_ptr<std::map<std::shared_ptr<MasterScheduler>, std::shared_ptr<SimulationTime>>> allTim);
 
+   /**
+   * Cancels the notification requested for the plugin at the given time step, if any.
+   */
    void neglectTimeStep(const std::shared_ptr<Plugin> p, const double timeStep);
    std::vector<double> getAllTimeStepsToBeNotified(const std::shared_ptr<Plugin> p);
 
@@ -193,8 +198,19 @@ public:
    * 
    * @param requester  The plugin to be notified.
    * @param time       The time of notification.
+   * 
+   * @return  A handle to cancel the notification with in O(1); invalid if the time
+   *          is not in the future.
+   */
+   EventCalendar::Handle requestNotification(const std::shared_ptr<Plugin> requester, const double time);
+
+   /**
+   * Cancels a notification requested before.
+   * 
+   * @param handle  As returned by {@link #requestNotification(Plugin, double)}.
+   * @return  Iff the notification was still pending.
    */
-   void requestNotification(const std::shared_ptr<Plugin> requester, const double time);
+   bool cancelNotification(const EventCalendar::Handle& handle);
 
    /**
    * Gives a notification to this SimulationTime's master scheduler 
@@ -221,7 +237,7 @@ public:
    * @param requester  The plugin to be notified.
    * @param time       The time of notification.
    */
-   void requestNotification(const double time);
+   EventCalendar::Handle requestNotification(const double time);
 
    /**
    * Requests a notification for any time step a notification occurs in
@@ -345,20 +361,51 @@ public:
 private:
    std::shared_ptr<ParCollection> pars;
    std::vector<std::shared_ptr<Plugin>> pluginsToRegisterAfterExecutionOfCurrentStep;
-   std::set<std::shared_ptr<Plugin>> neverNotify;
    bool ignoreAllExceptions = false;
    bool timeTerminated = false;
 
    /**
-   * Set of plugins that are notified at all notifications that 
+   * Every plugin known to this simulation time gets a dense slot number, 
+   * the bookkeeping below is done per slot rather than per plugin pointer.
+   */
+   std::unordered_map<const Plugin*, int> slotsByPlugin;
+   std::vector<std::shared_ptr<Plugin>> pluginsBySlot;
+
+   /**
+   * Slots of the plugins list, in the same order (i.e., master scheduler first).
+   */
+   std::vector<int> pluginSlots;
+
+   /**
+   * Per slot, iff the plugin is notified at ticks; and the number of these plugins.
+   */
+   std::vector<bool> ticksRequested;
+   int numTickRequesters = 0;
+
+   /**
+   * Per slot, iff the plugin is ignored for all future notifications.
+   */
+   std::vector<bool> neverNotified;
+
+   /**
+   * Plugins that are notified at all notifications that 
    * occur for any other plugin - NOT at events.
    * This influences only the invokation of the method runDuringSim.
-   * The plugins in this set are invoked AFTER the invokation of other
-   * plugins at the same time step.
+   * These plugins are invoked AFTER the invokation of other
+   * plugins at the same time step, in the order of their requests.
    * Note: plugins that have already been invoked at a time step are not invoked
    * in the same time step for a second time.
+   * (The list is cleaned up lazily from slots that neglected all notifications again.)
    */
-   std::set<std::shared_ptr<Plugin>> toBeNotifiedAtAllNotifications;
+   std::vector<bool> toBeNotifiedAtAllNotifications;
+   std::vector<bool> listedForAllNotifications;
+   std::vector<int> allNotificationsSlots;
+
+   /**
+   * Per slot, iff the plugin has been invoked in the current step; and the list of these slots.
+   */
+   std::vector<bool> invokedInStep;
+   std::vector<int> invokedSlots;
 
    /**
    * A list of all plugins requesting events. Every plugin is
@@ -391,22 +438,12 @@ private:
    */
    std::shared_ptr<std::thread> simThread;
 
-   /**
-   * Iff ticks are requested by any plugin.
-   */
-   bool isRequestedTicks;
-
-   /**
-   * For every plugin the information if ticks are requested or not.
-   */
-   std::map<std::shared_ptr<Plugin>, bool> requestedTicks;
    Date startTime;
 
    /**
-   * For requested notification time the plugins that requested it.
-   * Keys are sorted.
+   * The requested notifications as (time, slot) pairs.
    */
-   std::map<double, std::vector<std::shared_ptr<Plugin>>> requestedNotifications;
+   EventCalendar requestedNotifications;
 
    /**
    * @return  Iff this simulation is "ahead" of any other simultaneously running simulation.
@@ -418,6 +455,25 @@ private:
    std::string forRunnableText() const;
 
    bool isPluginSleeping(const std::shared_ptr<Plugin> p);
+   bool isNeverNotified(const std::shared_ptr<Plugin> p) const;
+
+   /**
+   * @return  The slot of the plugin, a new one if the plugin has none yet.
+   */
+   int getSlot(const std::shared_ptr<Plugin> p);
+
+   /**
+   * @return  The slot of the plugin, or -1 if the plugin has none.
+   */
+   int findSlot(const std::shared_ptr<Plugin> p) const;
+
+   /**
+   * Catches up with changes of the plugins list since the last call. Plugins are compared
+   * by identity, so removals and replacements are noticed even if the size stays the same.
+   */
+   void syncPluginSlots();
+
+   void invoke(const int slot);
    void runBeforeOrAfterSimulation(const std::shared_ptr<Plugin> p, const bool before = true);
    void registerPluginSynchronized(const std::shared_ptr<Plugin> p);
 
@@ -448,8 +504,6 @@ inline SimulationTime::SimulationTime(
    plugins(plugs),
    //runnable(runnble),
    //simThread,
-   //isRequestedTicks,
-   //requestedTicks,
    startTime(std::chrono::system_clock::now())
    //requestedNotifications 
 {
@@ -465,31 +519,17 @@ inline SimulationTime::SimulationTime(
 
 inline void SimulationTime::neglectTimeStep(const std::shared_ptr<Plugin> p, const double timeStep)
 {
-   auto plugins_at_time_step = requestedNotifications.at(timeStep);
-
-   for (int i = 0; i < plugins_at_time_step.size(); i++) {
-      const auto plugin = plugins_at_time_step[i];
+   const int slot = findSlot(p);
 
-      if (plugin->id() == p->id()) {
-         plugins_at_time_step.erase(plugins_at_time_step.begin() + i);
-      }
+   if (slot >= 0) {
+      requestedNotifications.cancel(timeStep, slot);
    }
 }
 
 inline std::vector<double> SimulationTime::getAllTimeStepsToBeNotified(const std::shared_ptr<Plugin> p)
 {
-   std::vector<double> list;
-
-   for (const auto& pair : requestedNotifications) {
-      auto plugins = pair.second;
-
-      for (const auto& plugin : plugins)
-         if (p->id() == plugin->id()) {
-            list.push_back(pair.first);
-         }
-   }
-
-   return list;
+   const int slot = findSlot(p);
+   return slot >= 0 ? requestedNotifications.getTimesOf(slot) : std::vector<double>{};
 }
 
 inline Date SimulationTime::getStartTime()
@@ -518,7 +558,7 @@ inline void SimulationTime::run()
    // Starting the plugin method before Simulation.
    for (const auto p : *plugins) {
       try {
-         if (!neverNotify.count(p)) {
+         if (!isNeverNotified(p)) {
             runBeforeOrAfterSimulation(p);
          }
       } catch (const std::exception& e) {
@@ -537,7 +577,7 @@ inline void SimulationTime::run()
    // Starting the plugin after Simulation.
    for (const auto p : *plugins) {
       try {
-         if (!neverNotify.count(p)) {
+         if (!isNeverNotified(p)) {
             runBeforeOrAfterSimulation(p, false);
          }
       } catch (const std::exception& e) {
@@ -598,20 +638,16 @@ inline void SimulationTime::checkRequiredPlugins()
 inline bool SimulationTime::setNextNotificationTime()
 {
    if (!stopSim && 
-      (isRequestedTicks || !requestedNotifications.empty())) {
+      (numTickRequesters > 0 || !requestedNotifications.empty())) {
       long nextTick = currentTime->getLastTick() + 1;
-      double nextNot = std::numeric_limits<double>::infinity();
-
-      if (!requestedNotifications.empty()) {
-         nextNot = requestedNotifications.begin()->first;
-      }
+      double nextNot = requestedNotifications.nextTime(); // Infinity if empty.
 
       // Do nothing if time is terminated.
       if (getMasterScheduler()->isTerminationRequested(currentTime)) {
          return false;
       }
 
-      if (isRequestedTicks && nextTick < nextNot) {
+      if (numTickRequesters > 0 && nextTick < nextNot) {
          // isTick is set automatically.
          currentTime->nextTick();
       } else {
@@ -627,50 +663,48 @@ inline bool SimulationTime::setNextNotificationTime()
 
 inline void SimulationTime::step()
 {
-   std::set<std::shared_ptr<Plugin>> invoked;
-
+   // Plugins may request or neglect anything while being invoked, so the
+   // slot lists are iterated by index and the flags are re-read each time.
    if (currentTime->isTick()) {
-      for (const auto p : *plugins) {
-         if (requestedTicks.at(p)) {
-            try {
-               p->step(currentTime);
-            } catch (const std::exception& e) {
-               handleExceptionInMainLoop(e, p);
-            }
+      syncPluginSlots();
+
+      for (size_t i = 0; i < pluginSlots.size(); i++) {
+         const int slot = pluginSlots[i];
 
-            invoked.insert(p);
+         if (ticksRequested[slot]) {
+            invoke(slot);
          }
       }
    } else { // Time step is no tick, i.e., a requested notification.
-      for (const auto p : requestedNotifications.at(currentTime->getExactTime())) {
-         try {
-            p->step(currentTime);
-         } catch (const std::exception& e) {
-            handleExceptionInMainLoop(e, p);
-         }
-
-         invoked.insert(p);
-      }
-
-      requestedNotifications.erase(currentTime->getExactTime());
+      requestedNotifications.popAllAt(currentTime->getExactTime(), [this](const int slot) { invoke(slot); });
    }
 
    /* 
    * Invoke all plugins that want to be notified every time anything 
    * happens.
    */
-   if (invoked.size() > 0) {
-      for (const auto p : toBeNotifiedAtAllNotifications) {
-         if (!invoked.count(p)) {
-            try {
-               p->step(currentTime);
-            } catch (const std::exception& e) {
-               handleExceptionInMainLoop(e, p);
-            }
+   if (!invokedSlots.empty()) {
+      for (size_t i = 0; i < allNotificationsSlots.size(); i++) {
+         const int slot = allNotificationsSlots[i];
+
+         if (toBeNotifiedAtAllNotifications[slot] && !invokedInStep[slot]) {
+            invoke(slot);
          }
       }
+
+      for (const int slot : invokedSlots) {
+         invokedInStep[slot] = false;
+      }
+
+      invokedSlots.clear();
    }
 
+   allNotificationsSlots.erase(std::remove_if(allNotificationsSlots.begin(), allNotificationsSlots.end(), [this](const int slot) {
+      if (toBeNotifiedAtAllNotifications[slot]) return false;
+      listedForAllNotifications[slot] = false;
+      return true;
+   }), allNotificationsSlots.end());
+
    /*
    * Register new waiting plugins.
    */
@@ -725,27 +759,28 @@ inline std::shared_ptr<Wink> SimulationTime::getCurrentWink()
 
 inline void SimulationTime::requestTicks(const std::shared_ptr<Plugin> requester)
 {
-   requestedTicks.insert({ requester, true });
-   isRequestedTicks = true;
+   const int slot = getSlot(requester);
+
+   if (!ticksRequested[slot]) {
+      ticksRequested[slot] = true;
+      numTickRequesters++;
+   }
 }
 
 inline void SimulationTime::neglectTicks(const std::shared_ptr<Plugin> requester)
 {
-   requestedTicks.insert({ requester, false });
+   const int slot = getSlot(requester);
 
-   for (const auto& pair : requestedTicks) {
-      if (pair.second) {
-         return;
-      }
+   if (ticksRequested[slot]) {
+      ticksRequested[slot] = false;
+      numTickRequesters--;
    }
-
-   isRequestedTicks = false;
 }
 
-inline void SimulationTime::requestNotification(const std::shared_ptr<Plugin> requester, const double time)
+inline EventCalendar::Handle SimulationTime::requestNotification(const std::shared_ptr<Plugin> requester, const double time)
 {
    if (time <= currentTime->getExactTime()) {
-      return;
+      return {};
    }
 
    //        if (time > this->pars->getExperimentLength()) {
@@ -763,15 +798,12 @@ inline void SimulationTime::requestNotification(const std::shared_ptr<Plugin> re
          + std::to_string(time) + " (for " + requester->id() + ") is before simulation start.");
    }
 
-   if (!requestedNotifications.count(time)) {
-      requestedNotifications.insert({ time, {} });
-   }
-
-   auto& currList = requestedNotifications.at(time);
+   return requestedNotifications.schedule(time, getSlot(requester));
+}
 
-   if (std::find(currList.begin(), currList.end(), requester) == currList.end()) {
-      currList.push_back(requester);
-   }
+inline bool SimulationTime::cancelNotification(const EventCalendar::Handle& handle)
+{
+   return requestedNotifications.cancel(handle);
 }
 
 inline void SimulationTime::requestTicks()
@@ -784,19 +816,25 @@ inline void SimulationTime::neglectTicks()
    neglectTicks(getMasterScheduler());
 }
 
-inline void SimulationTime::requestNotification(const double time)
+inline EventCalendar::Handle SimulationTime::requestNotification(const double time)
 {
-   requestNotification(getMasterScheduler(), time);
+   return requestNotification(getMasterScheduler(), time);
 }
 
 inline void SimulationTime::requestAllNotifications(const std::shared_ptr<Plugin> requester)
 {
-   toBeNotifiedAtAllNotifications.insert(requester);
+   const int slot = getSlot(requester);
+   toBeNotifiedAtAllNotifications[slot] = true;
+
+   if (!listedForAllNotifications[slot]) {
+      listedForAllNotifications[slot] = true;
+      allNotificationsSlots.push_back(slot);
+   }
 }
 
 inline void SimulationTime::neglectAllNotifications(const std::shared_ptr<Plugin> requester)
 {
-   toBeNotifiedAtAllNotifications.erase(requester);
+   toBeNotifiedAtAllNotifications[getSlot(requester)] = false;
 }
 
 inline void SimulationTime::requestAllNotifications()
@@ -811,15 +849,12 @@ inline void SimulationTime::neglectAllNotifications()
 
 inline void SimulationTime::neverNotifyAgain(const std::shared_ptr<Plugin> requester)
 {
-   neverNotify.insert(requester);
+   const int slot = getSlot(requester);
+   neverNotified[slot] = true;
    neglectAllNotifications(requester);
    neglectTicks(requester);
    eventRequestingPlugins.erase(requester);
-
-   for (const auto& pair : requestedNotifications) {
-      std::vector<std::shared_ptr<Plugin>>& list = requestedNotifications.at(pair.first);
-      list.erase(std::remove(list.begin(), list.end(), requester), list.end());
-   }
+   requestedNotifications.cancelAllOf(slot);
 }
 
 inline std::shared_ptr<MasterScheduler> SimulationTime::getMasterScheduler() const
@@ -932,7 +967,71 @@ inline bool SimulationTime::isAhead()
 
 inline bool SimulationTime::isPluginSleeping(const std::shared_ptr<Plugin> p)
 {
-   return neverNotify.count(p) && !eventRequestingPlugins.count(p);
+   return isNeverNotified(p) && !eventRequestingPlugins.count(p);
+}
+
+inline bool SimulationTime::isNeverNotified(const std::shared_ptr<Plugin> p) const
+{
+   const int slot = findSlot(p);
+   return slot >= 0 && neverNotified[slot];
+}
+
+inline int SimulationTime::getSlot(const std::shared_ptr<Plugin> p)
+{
+   const auto it = slotsByPlugin.find(p.get());
+
+   if (it != slotsByPlugin.end()) {
+      return it->second;
+   }
+
+   const int slot = pluginsBySlot.size();
+   slotsByPlugin.insert({ p.get(), slot });
+   pluginsBySlot.push_back(p);
+   ticksRequested.push_back(false);
+   neverNotified.push_back(false);
+   toBeNotifiedAtAllNotifications.push_back(false);
+   listedForAllNotifications.push_back(false);
+   invokedInStep.push_back(false);
+   return slot;
+}
+
+inline int SimulationTime::findSlot(const std::shared_ptr<Plugin> p) const
+{
+   const auto it = slotsByPlugin.find(p.get());
+   return it == slotsByPlugin.end() ? -1 : it->second;
+}
+
+inline void SimulationTime::syncPluginSlots()
+{
+   size_t in_sync = 0;
+
+   while (in_sync < pluginSlots.size()
+      && in_sync < plugins->size()
+      && pluginsBySlot[pluginSlots[in_sync]] == plugins->at(in_sync)) {
+      in_sync++;
+   }
+
+   pluginSlots.resize(in_sync); // Everything from the first deviation on is rebuilt.
+
+   for (size_t i = in_sync; i < plugins->size(); i++) {
+      pluginSlots.push_back(getSlot(plugins->at(i)));
+   }
+}
+
+inline void SimulationTime::invoke(const int slot)
+{
+   const auto p = pluginsBySlot[slot]; // Copy, the vector may grow during the step.
+
+   try {
+      p->step(currentTime);
+   } catch (const std::exception& e) {
+      handleExceptionInMainLoop(e, p);
+   }
+
+   if (!invokedInStep[slot]) {
+      invokedInStep[slot] = true;
+      invokedSlots.push_back(slot);
+   }
 }
 
 inline void SimulationTime::runBeforeOrAfterSimulation(const std::shared_ptr<Plugin> p, const bool before)
@@ -47,6 +47,7 @@ const std::string MORTY_ASCII_ART{R"(         ___
 
 class VariableScaleDescription;
 class ScaleDescription;
+class BracketIndex;
 
 enum class ScaleTypeEnum
 {
@@ -428,6 +429,10 @@ public:
       const std::vector<std::string>& ignoreBegTags = std::vector<std::string>{},
       const std::vector<std::string>& ignoreEndTags = std::vector<std::string>{});
 
+   /// Same on a prebuilt index whose first pair are the begin and end tag and whose other pairs are the
+   /// ignore tags (see tagsWithPrepended). Use this when matching repeatedly within the same string.
+   static int findMatchingEndTagLevelwise(const BracketIndex& index, int& pos);
+
    /// Returns the position of the begin tag matching the end tag at the
    /// position given as <code>pos</code>.
    /// 
@@ -447,6 +452,9 @@ public:
       const std::vector<std::string>& ignoreBegTags = std::vector<std::string>{},
       const std::vector<std::string>& ignoreEndTags = std::vector<std::string>{});
 
+   /// Same on a prebuilt index, see findMatchingEndTagLevelwise(const BracketIndex&, int&).
+   static int findMatchingBegTagLevelwise(const BracketIndex& index, const int pos);
+
    /// Retrieves the index of the begin of the first innermost bracket part in 
    /// the given string. More precisely, the algorithm looks for the first
    /// closing bracket in the string, and then returns to the matching opening
@@ -468,6 +476,13 @@ public:
       const std::function<bool(const std::string& str, const int index)>& end_function = TRUE_FUNCTION
    );
 
+   /// Same on a prebuilt index, see findMatchingEndTagLevelwise(const BracketIndex&, int&).
+   static int indexOfFirstInnermostBeginBracket(
+      const BracketIndex& index,
+      const std::function<bool(const std::string& str, const int index)>& begin_function = TRUE_FUNCTION,
+      const std::function<bool(const std::string& str, const int index)>& end_function = TRUE_FUNCTION
+   );
+
    /// Checks for several begin and end tags if the given position 
    /// {@link #isWithinLevelwise(std::string, int, std::string, std::string)} of any of them.
    /// 
@@ -541,6 +556,9 @@ public:
       const std::vector<std::string>& ignoreBegTags = std::vector<std::string>{},
       const std::vector<std::string>& ignoreEndTags = std::vector<std::string>{});
 
+   /// Same on a prebuilt index, see findMatchingEndTagLevelwise(const BracketIndex&, int&).
+   static int indexOfOnTopLevel(const BracketIndex& index, const std::vector<std::string>& find, const int startPos);
+
    /// \brief Takes three strings as input. Only the middle contains a string block that is supposed
    /// to be distributed into a before, an inner and an after part. The ints denote the portion of
    /// the string that divides the inner from the other two parts.
@@ -700,6 +718,14 @@ public:
    static void split(const std::string &s, char delim, Out result);
    static std::vector<std::string> split(const std::string& s, const std::string& delim, SplitCondition& f = FUNC_ALL_STRINGS_TO_TRUE, const bool keep_delimiter = false);
    static std::vector<std::string> split(const std::vector<std::string>& ss, const std::string& delim, SplitCondition& f = FUNC_ALL_STRINGS_TO_TRUE, const bool keep_delimiter = false);
+
+   /// Splits at the delimiters that are not within any of the begin/end tag pairs. Same result as
+   /// split(s, delim, !isWithinAnyLevelwise(...)) for pairs with different begin and end tags, but linear
+   /// in the length of the string since the regions are determined once, see BracketIndex.
+   static std::vector<std::string> splitOnTopLevel(const std::string& s, const std::string& delim, const std::vector<std::string>& beginTags, const std::vector<std::string>& endTags);
+
+   /// { tag, tags[0], tags[1], ... } - the pair to match goes first in a BracketIndex, the ignored pairs after it.
+   static std::vector<std::string> tagsWithPrepended(const std::string& tag, const std::vector<std::string>& tags);
    
    static std::string wrapOnTokens(const std::string& text_raw, const std::set<std::string>& wrap_before, const std::set<std::string>& wrap_after);
    static std::string wrapOnLineLength(const std::string& text_raw, const size_t max_line_length);
@@ -769,6 +795,12 @@ public:
 
    static std::string readFile(const std::filesystem::path& path, const bool from_utf16 = false);
 
+   /// 64-bit FNV-1a hash; not cryptographic, but stable across platforms and runs, so it can be persisted.
+   static uint64_t hashFNV1a(const std::string& str, const uint64_t seed = 0xcbf29ce484222325ULL);
+   static uint64_t hashFNV1a(const char* data, const size_t size, const uint64_t seed = 0xcbf29ce484222325ULL); // Chainable via seed.
+   static std::string hashFNV1aHex(const std::string& str);
+   static std::string hashToHex(const uint64_t hash);
+
    static std::vector<MCTrace> extractMCTracesFromKratos(const std::string& cexp_string); // For now only one CEX is extracted. Empty CEX returned as empty list.
    static std::vector<MCTrace> extractMCTracesFromKratosFile(const std::string& path, const bool from_utf16 = false);
    static std::string serializeMCTraceKratosStyle(const MCTrace& trace);
@@ -23,7 +23,8 @@ public:
 #endif
    std::set<MetaRule> getSimplificationRules(const std::shared_ptr<FormulaParser> parser) const override;
    std::shared_ptr<Term> copy(const std::shared_ptr<std::map<std::shared_ptr<Term>, std::shared_ptr<Term>>> already_copied = nullptr) override;
-   std::string serializeK2(const std::map<std::string, std::string>& enum_values, std::pair<std::map<std::string, std::string>, std::string>& additional_functions, int& label_counter) const override;
+   using MathStruct::serializeK2;
+   void serializeK2(OutputSink& out, const std::map<std::string, std::string>& enum_values, std::pair<std::map<std::string, std::string>, std::string>& additional_functions, int& label_counter) const override;
 
    TermAbs(const std::vector<std::shared_ptr<Term>>& t);
    TermAbs(const std::shared_ptr<Term>& t);
@@ -101,7 +101,8 @@ public:
    std::string getNuSMVOperator() const override;
    std::string getK2Operator() const override;
 
-   std::string serializeK2(const std::map<std::string, std::string>& enum_values, std::pair<std::map<std::string, std::string>, std::string>& additional_functions, int& label_counter) const override;
+   using MathStruct::serializeK2;
+   void serializeK2(OutputSink& out, const std::map<std::string, std::string>& enum_values, std::pair<std::map<std::string, std::string>, std::string>& additional_functions, int& label_counter) const override;
 
    std::shared_ptr<TermCompound> toTermCompoundIfApplicable() override;
    std::shared_ptr<TermSetVar> toSetVarIfApplicable() override; /// This returns a new TermSetVar which is not part of the original formula.
@@ -33,7 +33,8 @@ public:
    /// <param name="additional_functions"></param>
    /// <param name="label_counter"></param>
    /// <returns></returns>
-   std::string serializeK2(const std::map<std::string, std::string>& enum_values, std::pair<std::map<std::string, std::string>, std::string>& additional_functions, int& label_counter) const override;
+   using MathStruct::serializeK2;
+   void serializeK2(OutputSink& out, const std::map<std::string, std::string>& enum_values, std::pair<std::map<std::string, std::string>, std::string>& additional_functions, int& label_counter) const override;
 
    TermLogicEq(const std::vector<std::shared_ptr<Term>>& opds);
    TermLogicEq(const std::shared_ptr<Term> opd1, const std::shared_ptr<Term> opd2);
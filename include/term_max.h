@@ -23,7 +23,8 @@ public:
    std::shared_ptr<x86::Xmm> createSubAssembly(asmjit::x86::Compiler & cc, const std::shared_ptr<DataPack>& d, const std::shared_ptr<FormulaParser>& p = nullptr) override;
 #endif
    std::set<MetaRule> getSimplificationRules(const std::shared_ptr<FormulaParser> parser) const override;
-   std::string serializeK2(const std::map<std::string, std::string>& enum_values, std::pair<std::map<std::string, std::string>, std::string>& additional_functions, int& label_counter) const override;
+   using MathStruct::serializeK2;
+   void serializeK2(OutputSink& out, const std::map<std::string, std::string>& enum_values, std::pair<std::map<std::string, std::string>, std::string>& additional_functions, int& label_counter) const override;
 
    TermMax(const std::vector<std::shared_ptr<Term>>& t);
    TermMax(const std::shared_ptr<Term> opd1, const std::shared_ptr<Term> opd2);
@@ -59,7 +59,8 @@ public:
       const std::shared_ptr<std::map<std::shared_ptr<Term>, std::string>> visited = nullptr,
       const std::shared_ptr<std::string> only_compound_edges_to = nullptr) override;
 
-   std::string serializeK2(const std::map<std::string, std::string>& enum_values, std::pair<std::map<std::string, std::string>, std::string>& additional_functions, int& label_counter) const override;
+   using MathStruct::serializeK2;
+   void serializeK2(OutputSink& out, const std::map<std::string, std::string>& enum_values, std::pair<std::map<std::string, std::string>, std::string>& additional_functions, int& label_counter) const override;
 };
 
 } // vfm
\ No newline at end of file
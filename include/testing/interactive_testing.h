@@ -90,7 +90,8 @@ void convenienceArtifactRunHardcoded(
    const std::string& cache_dir = "./tmp",
    const std::string& path_to_external_folder = "../external/",
    const std::string& root_dir = ".",
-   const std::string& cex_file_name = "debug_trace_array.txt");
+   const std::string& cex_file_name = "debug_trace_array.txt",
+   const std::string& additional_mc_options = ""); // Appended verbatim to the '--mode mc' command line, e.g., " --mc-portfolio".
 
 std::map<std::string, std::string> retrieveEnvModelDefinitionFromJSON(const std::string json_file, const EnvModelCachedMode cached_mode);
 
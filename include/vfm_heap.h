@@ -0,0 +1,65 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+#pragma once
+
+#include <memory>
+#include <vector>
+
+constexpr auto VFM_HEAP_SIZE = 1000000;
+constexpr auto VFM_HEAP_EMPTY_VALUE = 0;
+
+namespace vfm {
+
+/// \brief The memory behind the DataPack: VFM_HEAP_SIZE float cells, split into fixed-size pages
+/// which are allocated on the first write access only.
+///
+/// Pages that have never been written to point to a shared read-only page filled with
+/// VFM_HEAP_EMPTY_VALUE, so reading needs no branch. Copying a heap shares its pages
+/// (copy-on-write), so a copy costs one pointer per page, and each copy only ever owns
+/// the pages that have been written to since.
+///
+/// Cell addresses handed out via getCellAddress() (as used by the JIT-compiled code) stay valid:
+/// such a page gets "pinned", i.e., it is never shared, moved or freed during the lifetime of the heap.
+/// Like std::vector::at, get() and set() throw std::out_of_range for an address out of range.
+class VfmHeap
+{
+public:
+   static constexpr int PAGE_BITS{ 12 };
+   static constexpr int PAGE_SIZE{ 1 << PAGE_BITS }; // 16 KB per page.
+   static constexpr int PAGE_MASK{ PAGE_SIZE - 1 };
+   static constexpr int NUM_PAGES{ (VFM_HEAP_SIZE + PAGE_SIZE - 1) / PAGE_SIZE };
+
+   VfmHeap();
+   VfmHeap(const VfmHeap& other);
+   VfmHeap& operator=(const VfmHeap& other);
+
+   inline float operator[](const int address) const { return page_table_[address >> PAGE_BITS][address & PAGE_MASK]; }
+   float get(const int address) const;
+   void set(const int address, const float val); // Allocates or un-shares the page if necessary.
+   float* getCellAddress(const int address);     // Same, plus pins the page.
+
+   int size() const;
+   bool isPageLive(const int page_num) const;
+   int getNumLivePages() const;
+
+   /// True if the page is the same memory in both heaps (including both being untouched), i.e., it can't differ.
+   bool sharesPageWith(const VfmHeap& other, const int page_num) const;
+
+   /// Takes over the cells [0, end_exclusive) from other, sharing whole pages where possible.
+   void copyRangeFrom(const VfmHeap& other, const int end_exclusive);
+
+private:
+   void checkAddress(const int address) const;
+   float* writablePage(const int page_num);
+   void copyIntoPage(const VfmHeap& other, const int page_num, const int begin, const int end);
+
+   std::vector<float*> page_table_{};               // For reading: a live page or the empty page.
+   std::vector<std::shared_ptr<float[]>> pages_{};  // Live pages, possibly shared with copies of this heap.
+   std::vector<bool> pinned_{};
+};
+
+} // vfm
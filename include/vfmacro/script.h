@@ -723,30 +723,71 @@ private:
       } 
    };
 
+   /// Parameters: number of threads [, incremental (skip configs whose inputs did not change since the last run)
+   /// [, portfolio (race several nuXmv engines per config and take the first conclusive answer)]].
+   std::string runMCJobsFromScript(const std::string& body, const std::vector<std::string>& parameters)
+   {
+      auto mc_workflow = prepareMCWorkflow(vfm_data_, vfm_parser_, body.empty());
+      std::string num_threads_str{ parameters.at(0) };
+
+      if (!StaticHelper::isParsableAsFloat(num_threads_str)) {
+         return "#ERROR<Parameter for number of threads '" + num_threads_str + "' is not a valid number in runMCJobs method>#";
+      }
+
+      if (parameters.size() > 1) {
+         if (!StaticHelper::isParsableAsBoolean(parameters[1])) {
+            return "#ERROR<Parameter for incremental mode '" + parameters[1] + "' is not a valid boolean in runMCJobs method>#";
+         }
+
+         mc_workflow.setIncrementalMode(StaticHelper::isBooleanTrue(parameters[1]));
+      }
+
+      if (parameters.size() > 2) {
+         if (!StaticHelper::isParsableAsBoolean(parameters[2])) {
+            return "#ERROR<Parameter for portfolio mode '" + parameters[2] + "' is not a valid boolean in runMCJobs method>#";
+         }
+
+         mc_workflow.setPortfolioMode(StaticHelper::isBooleanTrue(parameters[2]));
+      }
+
+      std::map<std::string, std::string> paths{ retrievePaths(mc_workflow, body, "")};
+
+      mc_workflow.runMCJobs(
+         std::filesystem::path(paths.at("path_generated")), // TODO: Don't need this parameter.
+         [](const std::string& folder) -> bool { return true; },
+         paths.at("path_template"),
+         paths.at("path_json"),
+         StaticHelper::getFileNameFromPath(body),
+         std::stoi(num_threads_str),
+         false);
+
+      return "MC runs finished for '" + paths.at("path_json") + "/" + body + "'.";
+   }
+
    ScriptMethodDescription m6{
       "runMCJobs",
       1,
       [this](const std::string& body, const std::vector<std::string>& parameters) -> std::string
       {
-         auto mc_workflow = prepareMCWorkflow(vfm_data_, vfm_parser_, body.empty());
-         std::string num_threads_str{ parameters.at(0) };
-
-         if (!StaticHelper::isParsableAsFloat(num_threads_str)) {
-            return "#ERROR<Parameter for number of threads '" + num_threads_str + "' is not a valid number in runMCJobs method>#";
-         }
-
-         std::map<std::string, std::string> paths{ retrievePaths(mc_workflow, body, "")};
+         return runMCJobsFromScript(body, parameters);
+      }
+   };
 
-         mc_workflow.runMCJobs(
-            std::filesystem::path(paths.at("path_generated")), // TODO: Don't need this parameter.
-            [](const std::string& folder) -> bool { return true; },
-            paths.at("path_template"),
-            paths.at("path_json"),
-            StaticHelper::getFileNameFromPath(body),
-            std::stoi(num_threads_str),
-            false);
+   ScriptMethodDescription m6b{
+      "runMCJobs",
+      2,
+      [this](const std::string& body, const std::vector<std::string>& parameters) -> std::string
+      {
+         return runMCJobsFromScript(body, parameters);
+      }
+   };
 
-         return "MC runs finished for '" + paths.at("path_json") + "/" + body + "'.";
+   ScriptMethodDescription m6c{
+      "runMCJobs",
+      3,
+      [this](const std::string& body, const std::vector<std::string>& parameters) -> std::string
+      {
+         return runMCJobsFromScript(body, parameters);
       }
    };
 
@@ -1056,6 +1097,8 @@ private:
           // In the following examples, the json template filename is the default, but can also explicitly be given as @{SOME_NAME.tpl.json}@.
       m5, // Example: @{}@.runMCJob[_config_d=1000_lanes=1_maxaccel=3_maxaccelego=3_minaccel=-8_minaccelego=-8_nonegos=3_sections=5_segments=1_t=1100_vehlen=5]
       m6, // Example: @{}@.runMCJobs[10]
+      m6b, // Example: @{}@.runMCJobs[10, true]    ==> Incremental, i.e., configs with unchanged inputs and existing results are skipped.
+      m6c, // Example: @{}@.runMCJobs[10, false, true]    ==> Portfolio mode, i.e., several nuXmv engines race per config.
       m7, // Example: @{}@.generateEnvmodels
       m8, // Example: @{}@.generateTestCases       ==> Will fail, but present list of available modes.
       m9, // Example: @{}@.generateTestCases[all]
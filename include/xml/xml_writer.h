@@ -0,0 +1,61 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+#pragma once
+
+#include "failable.h"
+#include "output_sink.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vfm::xml {
+
+/// Attributes in the order they are written. (Unlike VarVals, no sorting and no map nodes.)
+using XmlAttributes = std::vector<std::pair<std::string, std::string>>;
+
+struct XmlFormat {
+   bool pretty_{ true };                   // One element per line, indented by nesting depth.
+   std::string indentation_{ "   " };      // Per nesting level, only if pretty_.
+   std::string self_closing_end_{ " />" }; // "<tag a="b" />" as produced by CodeXML.
+};
+
+/// \brief SAX-style XML writer: elements are written to the sink as soon as they are opened or
+/// closed, without building a CodeXML tree first. Only the stack of open tags is kept.
+///
+/// Attribute values and text content are escaped. The default format reproduces the output
+/// of CodeXML::serializeBlock; with pretty_ set to false, no whitespace at all is inserted and
+/// the caller is in charge of the layout via raw().
+class XmlWriter : public Failable
+{
+public:
+   XmlWriter(OutputSink& sink, const XmlFormat& format = {});
+   ~XmlWriter();
+
+   XmlWriter& declaration(const XmlAttributes& pars = { { "version", "1.0" } }); // <?xml version="1.0"?>
+   XmlWriter& emptyElement(const std::string& tag, const XmlAttributes& pars);    // <tag par0="val0" ... />
+   XmlWriter& textElement(const std::string& tag, const XmlAttributes& pars, const std::string& text); // <tag ...>text</tag>
+   XmlWriter& startElement(const std::string& tag, const XmlAttributes& pars);    // <tag ...>
+   XmlWriter& endElement();                                                       // </tag>
+   XmlWriter& raw(const std::string& text);                                       // Verbatim, no escaping.
+
+   int getDepth() const;
+
+   static std::string escape(const std::string& str);
+
+private:
+   void writeIndentation();
+   void writeLineEnd();
+   void writeAttributes(const XmlAttributes& pars);
+   void writeEscaped(const std::string& str);
+
+   OutputSink& sink_;
+   XmlFormat format_{};
+   std::vector<std::string> open_tags_{};
+};
+
+} // vfm::xml
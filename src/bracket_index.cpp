@@ -0,0 +1,233 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+
+#include "bracket_index.h"
+#include <algorithm>
+#include <cassert>
+#include <climits>
+
+using namespace vfm;
+
+BracketIndex::BracketIndex(const std::string& string, const std::vector<std::string>& begin_tags, const std::vector<std::string>& end_tags)
+   : string_(string), begin_tags_(begin_tags), end_tags_(end_tags), within_(string.size() + 1, 0), matchings_(begin_tags.size())
+{
+   assert(begin_tags.size() == end_tags.size());
+   assert(begin_tags.size() <= MAX_NUM_PAIRS);
+
+   const int n = string_.size();
+
+   for (int pair = 0; pair < (int) begin_tags_.size(); pair++) {
+      const std::string& beg{ begin_tags_[pair] };
+      const std::string& end{ end_tags_[pair] };
+      const uint64_t bit{ 1ULL << pair };
+
+      if (beg == end) { // Within iff the number of tags starting at or left of the position is odd.
+         bool within{ false };
+
+         for (int i = 0; i < n; i++) {
+            within ^= startsWith(i, beg);
+            if (within) within_[i + 1] |= bit;
+         }
+
+         if (within) within_after_end_ |= bit;
+
+         continue;
+      }
+
+      // isWithinLevelwise processes the tags right of the position in order (an end tag winning over a begin tag
+      // at the same position) and reports "within" iff the count drops below zero on the way. With P(q) the count
+      // up to and including position q, this means min{ P(q) | q > pos } < P(pos).
+      std::vector<int> count(n + 1, 0); // Entry pos + 1 holds P(pos); P(-1) = 0.
+
+      for (int i = 0; i < n; i++) {
+         count[i + 1] = count[i] + (startsWith(i, end) ? -1 : startsWith(i, beg) ? 1 : 0);
+      }
+
+      int min_right{ INT_MAX };
+
+      for (int pos = n - 1; pos >= -1; pos--) {
+         if (min_right < count[pos + 1]) within_[pos + 1] |= bit;
+         min_right = std::min(min_right, count[pos + 1]);
+      }
+   }
+}
+
+bool BracketIndex::isWithin(const int pos, const int pair) const
+{
+   const uint64_t bit{ 1ULL << pair };
+
+   if (pos < -1) return false;
+   if (pos >= size()) return within_after_end_ & bit;
+
+   return within_[pos + 1] & bit;
+}
+
+bool BracketIndex::isWithinAny(const int pos) const
+{
+   if (pos < -1) return false;
+   if (pos >= size()) return within_after_end_;
+
+   return within_[pos + 1];
+}
+
+bool BracketIndex::isWithinAnyOther(const int pos, const int pair) const
+{
+   const uint64_t others{ ~(1ULL << pair) };
+
+   if (pos < -1) return false;
+   if (pos >= size()) return within_after_end_ & others;
+
+   return within_[pos + 1] & others;
+}
+
+int BracketIndex::findMatchingEndTag(int& pos, const int pair) const
+{
+   const std::string& beg{ begin_tags_[pair] };
+   const std::string& end{ end_tags_[pair] };
+
+   while (pos < size() && !startsWith(pos, beg)) pos++;
+
+   if (pos >= size()) return -1;
+
+   const Matching& matching{ getMatching(pair) };
+
+   if (matching.match_end_[pos] != -2) { // Known from the left-to-right pass.
+      return matching.match_end_[pos];
+   }
+
+   // The begin tag is not on the grid of the left-to-right pass (it overlaps a preceding tag), so scan from here.
+   int count = 0;
+   int next_inc = 1;
+
+   for (int i = pos; i < size(); i += next_inc) {
+      next_inc = 1;
+
+      if (startsWith(i, beg) && !isWithinAnyOther(i, pair)) {
+         count++;
+         next_inc = beg.size();
+      }
+
+      if (startsWith(i, end) && !isWithinAnyOther(i, pair)) {
+         count--;
+         next_inc = end.size();
+      }
+
+      if (count == 0) {
+         return i;
+      }
+   }
+
+   return -1;
+}
+
+int BracketIndex::findMatchingBegTag(const int pos, const int pair) const
+{
+   if (pos < 0) return -1;
+   if (pos >= size()) return pos;
+
+   // Scanning to the left from pos, the count is zero at i iff balance_[i] == balance_[pos + 1].
+   const Matching& matching{ getMatching(pair) };
+   const auto& candidates{ matching.positions_by_balance_.at(matching.balance_[pos + 1]) };
+   const auto it{ std::upper_bound(candidates.begin(), candidates.end(), pos) };
+
+   return it == candidates.begin() ? -1 : *(it - 1);
+}
+
+std::vector<int> BracketIndex::findOnTopLevel(const std::string& delimiter) const
+{
+   std::vector<int> result{};
+
+   if (delimiter.empty()) return result;
+
+   for (size_t pos = string_.find(delimiter); pos != std::string::npos; pos = string_.find(delimiter, pos + delimiter.size())) {
+      if (!isWithinAny(pos)) {
+         result.push_back(pos);
+      }
+   }
+
+   return result;
+}
+
+int BracketIndex::size() const
+{
+   return string_.size();
+}
+
+int BracketIndex::getNumPairs() const
+{
+   return begin_tags_.size();
+}
+
+const std::string& BracketIndex::getString() const
+{
+   return string_;
+}
+
+const std::vector<std::string>& BracketIndex::getBeginTags() const
+{
+   return begin_tags_;
+}
+
+const std::vector<std::string>& BracketIndex::getEndTags() const
+{
+   return end_tags_;
+}
+
+bool BracketIndex::startsWith(const int pos, const std::string& tag) const
+{
+   return !tag.empty() && pos + tag.size() <= string_.size() && !string_.compare(pos, tag.size(), tag);
+}
+
+const BracketIndex::Matching& BracketIndex::getMatching(const int pair) const
+{
+   Matching& matching{ matchings_[pair] };
+
+   if (matching.initialized_) return matching;
+
+   const std::string& beg{ begin_tags_[pair] };
+   const std::string& end{ end_tags_[pair] };
+   const int n = size();
+
+   // Left to right with the same skipping as findMatchingEndTagLevelwise, matching with a stack.
+   matching.match_end_.assign(n, -2);
+   std::vector<int> open{};
+
+   for (int i = 0, next_inc = 1; i < n; i += next_inc) {
+      const bool is_beg{ startsWith(i, beg) && !isWithinAnyOther(i, pair) };
+      const bool is_end{ startsWith(i, end) && !isWithinAnyOther(i, pair) };
+
+      next_inc = is_end ? end.size() : is_beg ? beg.size() : 1;
+
+      if (is_beg && is_end) {
+         matching.match_end_[i] = i; // Count is back to zero right away.
+      }
+      else if (is_beg) {
+         matching.match_end_[i] = -1;
+         open.push_back(i);
+      }
+      else if (is_end && !open.empty()) {
+         matching.match_end_[open.back()] = i;
+         open.pop_back();
+      }
+   }
+
+   // Right to left without skipping, like findMatchingBegTagLevelwise.
+   matching.balance_.assign(n + 1, 0);
+
+   for (int i = 0; i < n; i++) {
+      matching.balance_[i + 1] = matching.balance_[i]
+         + (startsWith(i, beg) && !isWithinAnyOther(i, pair))
+         - (startsWith(i, end) && !isWithinAnyOther(i, pair));
+   }
+
+   for (int i = 0; i <= n; i++) {
+      matching.positions_by_balance_[matching.balance_[i]].push_back(i);
+   }
+
+   matching.initialized_ = true;
+   return matching;
+}
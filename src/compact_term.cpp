@@ -0,0 +1,436 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+
+#include "compact_term.h"
+#include "parser.h"
+#include "data_pack.h"
+#include "term_val.h"
+#include "term_var.h"
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+using namespace vfm;
+
+namespace {
+
+struct OperatorTable {
+   std::mutex mutex_{};
+   std::vector<std::string> names_{};
+   std::unordered_map<std::string, CompactFormula::OperatorId> ids_{};
+
+   OperatorTable()
+   {
+      for (const auto& name : {
+         std::string("#value"), std::string("#variable"), std::string("#opaque"),
+         SYMB_PLUS, SYMB_MINUS, SYMB_MULT, SYMB_DIV, SYMB_MOD, SYMB_POW, SYMB_NEG, SYMB_MIN, SYMB_MAX, SYMB_ABS, SYMB_TRUNC,
+         SYMB_AND, SYMB_OR, SYMB_EQ, SYMB_NEQ, SYMB_SM, SYMB_SMEQ, SYMB_GR, SYMB_GREQ }) {
+         ids_[name] = names_.size();
+         names_.push_back(name);
+      }
+   }
+};
+
+OperatorTable& operatorTable()
+{
+   static OperatorTable table{};
+   return table;
+}
+
+int arityOf(const CompactFormula::OperatorId op)
+{
+   switch (op) {
+   case CompactFormula::op_neg: case CompactFormula::op_abs: case CompactFormula::op_trunc: return 1;
+   default: return 2;
+   }
+}
+
+bool isNative(const CompactFormula::OperatorId op)
+{
+   return op >= CompactFormula::op_plus && op < CompactFormula::num_native_operators;
+}
+
+/// Mirrors the eval functions of the respective Term classes, including their NaN handling.
+inline float apply(const CompactFormula::OperatorId op, const float a, const float b)
+{
+   switch (op) {
+   case CompactFormula::op_plus: { float d{ 0 }; d += a; return d + b; }
+   case CompactFormula::op_minus: return a - b;
+   case CompactFormula::op_mult: { float d{ 1 }; d *= a; return d * b; }
+   case CompactFormula::op_div: return a / b;
+   case CompactFormula::op_mod: return std::fmod(a, b);
+   case CompactFormula::op_pow: return std::pow(a, b);
+   case CompactFormula::op_neg: return a == 0 ? a : -a;
+   case CompactFormula::op_min: return std::isnan(a) || std::isnan(b) ? b : std::min(a, b);
+   case CompactFormula::op_max: return std::isnan(a) || std::isnan(b) ? b : std::max(a, b);
+   case CompactFormula::op_abs: return std::abs(a);
+   case CompactFormula::op_trunc: return std::trunc(a);
+   case CompactFormula::op_gr: return a > b;
+   case CompactFormula::op_greq: return a >= b;
+   default: break;
+   }
+
+   // The remaining ones are inverted if an operand is NaN, like the x86 assembly does.
+   const bool nan{ std::isnan(a) || std::isnan(b) };
+   bool d{};
+
+   switch (op) {
+   case CompactFormula::op_and: d = (1 && a) && b; break;
+   case CompactFormula::op_or: d = (0 || a) || b; break;
+   case CompactFormula::op_eq: d = a == b; break;
+   case CompactFormula::op_neq: d = a != b; break;
+   case CompactFormula::op_sm: d = a < b; break;
+   case CompactFormula::op_smeq: d = a <= b; break;
+   default: break;
+   }
+
+   return nan ? !d : d;
+}
+
+inline uint32_t floatBits(const float val)
+{
+   uint32_t bits;
+   std::memcpy(&bits, &val, sizeof(bits));
+   return bits;
+}
+
+inline float bitsFloat(const uint32_t bits)
+{
+   float val;
+   std::memcpy(&val, &bits, sizeof(val));
+   return val;
+}
+
+/// The natively handled operator of the term, op_opaque otherwise.
+CompactFormula::OperatorId classify(const std::shared_ptr<Term>& term)
+{
+   if (term->isTermVal()) return CompactFormula::op_value;
+
+   if (term->isTermVar()) {
+      const auto var{ term->toVariableIfApplicable() };
+      return !var->isConstVariable() && var->getOptor()[0] != SYMB_REF[0] ? CompactFormula::op_variable : CompactFormula::op_opaque;
+   }
+
+   if (term->isCompoundOperator() || term->hasSideeffects()) return CompactFormula::op_opaque;
+
+   const auto op{ CompactFormula::internOperator(term->getOptor()) };
+   return isNative(op) && term->getOperands().size() == (size_t) arityOf(op) ? op : (CompactFormula::OperatorId) CompactFormula::op_opaque;
+}
+
+} // namespace
+
+CompactFormula::OperatorId CompactFormula::internOperator(const std::string& optor_name)
+{
+   auto& table{ operatorTable() };
+   std::lock_guard<std::mutex> lock{ table.mutex_ };
+   const auto it{ table.ids_.find(optor_name) };
+
+   if (it != table.ids_.end()) return it->second;
+
+   const OperatorId id = table.names_.size();
+   table.ids_[optor_name] = id;
+   table.names_.push_back(optor_name);
+   return id;
+}
+
+std::string CompactFormula::getOperatorName(const OperatorId id)
+{
+   auto& table{ operatorTable() };
+   std::lock_guard<std::mutex> lock{ table.mutex_ };
+   return table.names_.at(id);
+}
+
+CompactFormula CompactFormula::fromTerm(const std::shared_ptr<Term>& term)
+{
+   CompactFormula formula{};
+   std::map<const Term*, NodeIndex> done{};
+   std::map<std::string, uint32_t> var_indices{};
+   std::vector<std::pair<std::shared_ptr<Term>, bool>> stack{ { term, false } }; // (term, children already pushed)
+
+   while (!stack.empty()) {
+      auto [current, expanded] = stack.back();
+
+      if (done.count(current.get())) {
+         stack.pop_back();
+         continue;
+      }
+
+      const OperatorId op{ classify(current) };
+
+      if (isNative(op) && !expanded) {
+         stack.back().second = true;
+
+         for (auto it = current->getOperands().rbegin(); it != current->getOperands().rend(); ++it) {
+            stack.push_back({ *it, false });
+         }
+
+         continue;
+      }
+
+      stack.pop_back();
+      NodeIndex index{};
+
+      if (op == op_value) {
+         index = formula.addValue(current->toValueIfApplicable()->getValue());
+      }
+      else if (op == op_variable) {
+         const auto name{ current->getOptor() };
+         const auto inserted{ var_indices.insert({ name, (uint32_t) formula.var_names_.size() }) };
+
+         if (inserted.second) formula.var_names_.push_back(name);
+
+         index = formula.addNode(op_variable, {}, inserted.first->second);
+      }
+      else if (op == op_opaque) {
+         index = formula.addNode(op_opaque, {}, formula.opaque_terms_.size());
+         formula.opaque_terms_.push_back(current);
+      }
+      else {
+         std::vector<NodeIndex> children{};
+
+         for (const auto& operand : current->getOperands()) {
+            children.push_back(done.at(operand.get()));
+         }
+
+         index = formula.addNode(op, children, 0);
+      }
+
+      done[current.get()] = index;
+   }
+
+   return formula;
+}
+
+std::shared_ptr<Term> CompactFormula::toTerm(const std::shared_ptr<FormulaParser>& parser) const
+{
+   if (empty()) return nullptr;
+
+   const auto p{ parser ? parser : SingletonFormulaParser::getInstance() };
+   std::vector<std::shared_ptr<Term>> built(nodes_.size());
+   std::vector<bool> used(nodes_.size(), false);
+
+   for (size_t i = 0; i < nodes_.size(); i++) {
+      const Node& node{ nodes_[i] };
+
+      if (node.op_ == op_value) {
+         built[i] = _val_plain(bitsFloat(node.payload_));
+      }
+      else if (node.op_ == op_variable) {
+         built[i] = _var_plain(var_names_[node.payload_]);
+      }
+      else if (node.op_ == op_opaque) {
+         built[i] = opaque_terms_[node.payload_]->copy();
+      }
+      else {
+         std::vector<std::shared_ptr<Term>> operands{};
+
+         for (NodeIndex c = node.first_child_; c < node.first_child_ + node.num_children_; c++) {
+            const NodeIndex child{ children_[c] };
+            operands.push_back(used[child] ? built[child]->copy() : built[child]); // No sharing in the Term tree.
+            used[child] = true;
+         }
+
+         built[i] = p->termFactory(getOperatorName(node.op_), operands);
+      }
+   }
+
+   built.back()->setChildrensFathers();
+   return built.back();
+}
+
+float CompactFormula::eval(const std::shared_ptr<DataPack>& data, const std::shared_ptr<FormulaParser>& parser) const
+{
+   std::vector<float> var_values(var_names_.size());
+
+   for (size_t i = 0; i < var_names_.size(); i++) {
+      var_values[i] = data->getSingleVal(var_names_[i]);
+   }
+
+   return eval(var_values, data, parser);
+}
+
+float CompactFormula::eval(const std::vector<float>& var_values, const std::shared_ptr<DataPack>& data, const std::shared_ptr<FormulaParser>& parser) const
+{
+   if (empty()) return 0;
+
+   evalInto(var_values.data(), data, parser);
+   return scratch_.back();
+}
+
+void CompactFormula::evalInto(const float* var_values, const std::shared_ptr<DataPack>& data, const std::shared_ptr<FormulaParser>& parser) const
+{
+   scratch_.resize(nodes_.size());
+   float* values{ scratch_.data() };
+
+   for (size_t i = 0; i < nodes_.size(); i++) {
+      const Node& node{ nodes_[i] };
+
+      switch (node.op_) {
+      case op_value: values[i] = bitsFloat(node.payload_); break;
+      case op_variable: values[i] = var_values[node.payload_]; break;
+      case op_opaque: values[i] = opaque_terms_[node.payload_]->eval(data, parser); break;
+      default: values[i] = evalNode(node, values); break;
+      }
+   }
+}
+
+float CompactFormula::evalNode(const Node& node, const float* values) const
+{
+   const NodeIndex* children{ children_.data() + node.first_child_ };
+   return apply(node.op_, values[children[0]], node.num_children_ > 1 ? values[children[1]] : 0);
+}
+
+size_t CompactFormula::simplify()
+{
+   if (empty()) return 0;
+
+   const size_t old_size{ nodes_.size() };
+   CompactFormula temp{};
+   temp.var_names_ = var_names_;
+   temp.opaque_terms_ = opaque_terms_;
+   std::vector<NodeIndex> replacement(nodes_.size());
+
+   // Pass 1: fold into a temporary arena, leaving behind unreachable nodes.
+   for (size_t i = 0; i < nodes_.size(); i++) {
+      const Node& node{ nodes_[i] };
+
+      if (!isNative(node.op_)) {
+         replacement[i] = temp.addNode(node.op_, {}, node.payload_);
+         continue;
+      }
+
+      std::vector<NodeIndex> children{};
+      float operand_values[2]{};
+      bool all_values{ true };
+
+      for (NodeIndex c = 0; c < node.num_children_; c++) {
+         children.push_back(replacement[children_[node.first_child_ + c]]);
+         const Node& child{ temp.nodes_[children.back()] };
+         all_values = all_values && child.op_ == op_value;
+
+         if (child.op_ == op_value) operand_values[c] = bitsFloat(child.payload_);
+      }
+
+      auto isValue = [&temp, &children](const int k, const float val) {
+         const Node& child{ temp.nodes_[children[k]] };
+         return child.op_ == op_value && bitsFloat(child.payload_) == val;
+      };
+
+      if (all_values) {
+         replacement[i] = temp.addValue(apply(node.op_, operand_values[0], operand_values[1]));
+      }
+      else if ((node.op_ == op_plus && isValue(0, 0)) || (node.op_ == op_mult && isValue(0, 1))) {
+         replacement[i] = children[1];
+      }
+      else if (((node.op_ == op_plus || node.op_ == op_minus) && isValue(1, 0)) || ((node.op_ == op_mult || node.op_ == op_div) && isValue(1, 1))) {
+         replacement[i] = children[0];
+      }
+      else if (node.op_ == op_neg && temp.nodes_[children[0]].op_ == op_neg) {
+         replacement[i] = temp.children_[temp.nodes_[children[0]].first_child_];
+      }
+      else {
+         replacement[i] = temp.addNode(node.op_, children, 0);
+      }
+   }
+
+   // Pass 2: keep what is reachable from the root; in postorder, a father is always visited before its children here.
+   const NodeIndex root{ replacement.back() };
+   std::vector<bool> reachable(temp.nodes_.size(), false);
+   reachable[root] = true;
+
+   for (size_t i = root + 1; i-- > 0;) {
+      if (!reachable[i]) continue;
+
+      const Node& node{ temp.nodes_[i] };
+
+      for (NodeIndex c = 0; c < node.num_children_; c++) {
+         reachable[temp.children_[node.first_child_ + c]] = true;
+      }
+   }
+
+   CompactFormula result{};
+   result.var_names_ = var_names_;
+   std::vector<NodeIndex> remap(temp.nodes_.size());
+   std::vector<uint32_t> opaque_remap(opaque_terms_.size(), UINT32_MAX);
+
+   for (size_t i = 0; i <= root; i++) {
+      if (!reachable[i]) continue;
+
+      const Node& node{ temp.nodes_[i] };
+      std::vector<NodeIndex> children{};
+      uint32_t payload{ node.payload_ };
+
+      for (NodeIndex c = 0; c < node.num_children_; c++) {
+         children.push_back(remap[temp.children_[node.first_child_ + c]]);
+      }
+
+      if (node.op_ == op_opaque) {
+         if (opaque_remap[payload] == UINT32_MAX) {
+            opaque_remap[payload] = result.opaque_terms_.size();
+            result.opaque_terms_.push_back(opaque_terms_[payload]);
+         }
+
+         payload = opaque_remap[payload];
+      }
+
+      remap[i] = result.addNode(node.op_, children, payload);
+   }
+
+   *this = std::move(result);
+   return old_size > nodes_.size() ? old_size - nodes_.size() : 0;
+}
+
+bool CompactFormula::empty() const
+{
+   return nodes_.empty();
+}
+
+size_t CompactFormula::getNumNodes() const
+{
+   return nodes_.size();
+}
+
+size_t CompactFormula::getNumOpaqueTerms() const
+{
+   return opaque_terms_.size();
+}
+
+const std::vector<std::string>& CompactFormula::getVariableNames() const
+{
+   return var_names_;
+}
+
+const std::vector<CompactFormula::Node>& CompactFormula::getNodes() const
+{
+   return nodes_;
+}
+
+size_t CompactFormula::getMemoryUsage() const
+{
+   size_t bytes{ sizeof(*this) + nodes_.capacity() * sizeof(Node) + children_.capacity() * sizeof(NodeIndex)
+      + var_names_.capacity() * sizeof(std::string) + opaque_terms_.capacity() * sizeof(std::shared_ptr<Term>) };
+
+   for (const auto& name : var_names_) {
+      bytes += name.capacity() + 1;
+   }
+
+   return bytes;
+}
+
+CompactFormula::NodeIndex CompactFormula::addNode(const OperatorId op, const std::vector<NodeIndex>& children, const uint32_t payload)
+{
+   nodes_.push_back({ op, (uint16_t) children.size(), (NodeIndex) children_.size(), payload });
+   children_.insert(children_.end(), children.begin(), children.end());
+   return nodes_.size() - 1;
+}
+
+CompactFormula::NodeIndex CompactFormula::addValue(const float val)
+{
+   return addNode(op_value, {}, floatBits(val));
+}
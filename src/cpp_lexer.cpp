@@ -0,0 +1,305 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+
+#include "cpp_parsing/cpp_lexer.h"
+#include "static_helper.h"
+#include <algorithm>
+#include <cctype>
+
+using namespace vfm;
+
+namespace {
+bool isIdentifierChar(const char c)
+{
+   return std::isalnum((unsigned char) c) || c == '_';
+}
+
+bool isWhitespaceChar(const char c) // Same as StaticHelper::removeWhiteSpace, except for '\n'.
+{
+   return c != '\n' && std::isspace((unsigned char) c);
+}
+
+bool startsWith(const std::string& code, const int pos, const char* tag) // For the two-character comment tags.
+{
+   return pos + 1 < (int) code.size() && code[pos] == tag[0] && code[pos + 1] == tag[1];
+}
+}
+
+CppLexer::CppLexer(const std::string& code, const bool strip_comments)
+{
+   text_.reserve(code.size());
+   tokens_.reserve(code.size() / 4);
+
+   if (strip_comments) {
+      stripBlockComments(code);
+      finish();
+   }
+   else {
+      for (int i = 0; i < (int) code.size(); i++) {
+         if (code[i] == '\n') line_starts_.push_back(i + 1);
+         emitUncommented(code[i], i);
+      }
+   }
+}
+
+const std::vector<CppToken>& CppLexer::getTokens() const
+{
+   return tokens_;
+}
+
+const std::string& CppLexer::getText() const
+{
+   return text_;
+}
+
+std::string CppLexer::getTokenText(const CppToken& token) const
+{
+   return text_.substr(token.begin_, token.length_);
+}
+
+std::pair<int, int> CppLexer::getLineAndColumn(const int source_offset) const
+{
+   const auto it{ std::upper_bound(line_starts_.begin(), line_starts_.end(), source_offset) - 1 };
+   return { (int) (it - line_starts_.begin()) + 1, source_offset - *it + 1 };
+}
+
+std::string CppLexer::rewriteWithoutCommentsAndBlankLines() const
+{
+   std::string result{};
+   result.reserve(text_.size() + text_.size() / 16);
+   int line_begin{ 0 };
+   bool has_content{ false };
+
+   const auto finish_line = [this, &result, &line_begin, &has_content](const int line_end) {
+      if (has_content) {
+         result.append(text_, line_begin, line_end - line_begin);
+         result += "\r\n";
+      }
+
+      line_begin = line_end + 1;
+      has_content = false;
+   };
+
+   for (const auto& token : tokens_) {
+      if (token.type_ == CppTokenType::newline) {
+         finish_line(token.begin_);
+      }
+      else if (token.type_ != CppTokenType::whitespace) {
+         has_content = true;
+      }
+   }
+
+   finish_line(text_.size());
+
+   return result;
+}
+
+std::string CppLexer::rewriteCStyleArraysToVars() const
+{
+   // The string version removes "\s*\]", "\]\s*", "\s*\[" and "\[\s*", i.e., every maximal run of white space
+   // touching a bracket. Such a run can span several tokens (and reach into an unterminated literal), so it is
+   // looked up in the text when its first character comes along.
+   const auto is_bracket = [](const char c) { return c == '[' || c == ']'; };
+   const int n = text_.size();
+   std::string result{};
+   result.reserve(text_.size() + text_.size() / 8);
+   int run_end{ -1 };
+   bool drop_run{ false };
+
+   const auto append = [this, n, &is_bracket, &result, &run_end, &drop_run](const int pos) {
+      const char c{ text_[pos] };
+
+      if (std::isspace((unsigned char) c)) {
+         if (pos >= run_end) {
+            for (run_end = pos; run_end < n && std::isspace((unsigned char) text_[run_end]); run_end++);
+            drop_run = pos > 0 && is_bracket(text_[pos - 1]) || run_end < n && is_bracket(text_[run_end]);
+         }
+
+         if (!drop_run) result += c;
+      }
+      else if (c == '[') {
+         result += ARRAY_INDEX_DENOTER_OPEN;
+      }
+      else if (c == ']') {
+         result += ARRAY_INDEX_DENOTER_CLOSE;
+      }
+      else {
+         result += c;
+      }
+   };
+
+   for (const auto& token : tokens_) {
+      if (token.type_ == CppTokenType::identifier || token.type_ == CppTokenType::number) {
+         result.append(text_, token.begin_, token.length_); // Neither white space nor brackets in here.
+      }
+      else { // Like the string version, this includes brackets within literals.
+         for (int pos = token.begin_; pos < token.begin_ + token.length_; pos++) append(pos);
+      }
+   }
+
+   return result;
+}
+
+std::string CppLexer::rewriteWithoutUsingStatements(std::vector<std::string>& using_statements) const
+{
+   std::string result{ text_ };
+
+   for (size_t i = 0; i < tokens_.size(); i++) {
+      if (tokens_[i].type_ != CppTokenType::identifier || getTokenText(tokens_[i]) != "using") continue;
+
+      size_t end{ i };
+      while (end < tokens_.size() && !(tokens_[end].type_ == CppTokenType::punctuation && text_[tokens_[end].begin_] == ';')) end++;
+
+      const int begin_pos{ tokens_[i].begin_ };
+      const int end_pos{ end < tokens_.size() ? tokens_[end].begin_ : (int) text_.size() }; // Position of the ';'.
+
+      using_statements.push_back(text_.substr(begin_pos, end_pos - begin_pos));
+      std::fill(result.begin() + begin_pos, result.begin() + std::min(end_pos + 1, (int) text_.size()), '-');
+      i = end;
+   }
+
+   return result;
+}
+
+void CppLexer::stripBlockComments(const std::string& code)
+{
+   const int n = code.size();
+   bool more_comments_possible{ true }; // Once a comment is not closed, none of the following will be.
+
+   for (int i = 0; i < n; i++) {
+      if (more_comments_possible && startsWith(code, i, "/*")) {
+         int depth{ 0 };
+         int end{ -1 };
+
+         for (int j = i; j < n;) { // Same stepping as StaticHelper::findMatchingEndTagLevelwise.
+            if (startsWith(code, j, "/*")) {
+               depth++;
+               j += 2;
+            }
+            else if (startsWith(code, j, "*/")) {
+               depth--;
+               j += 2;
+            }
+            else {
+               j++;
+            }
+
+            if (depth == 0) {
+               end = j;
+               break;
+            }
+         }
+
+         if (end >= 0) {
+            for (int j = i; j < end; j++) {
+               if (code[j] == '\n') line_starts_.push_back(j + 1);
+            }
+
+            i = end - 1; // The "-1" is to compensate for the "i++".
+            continue;
+         }
+
+         more_comments_possible = false;
+      }
+
+      if (code[i] == '\n') line_starts_.push_back(i + 1);
+
+      emit(code[i], i);
+   }
+}
+
+void CppLexer::emit(const char c, const int source_offset)
+{
+   if (in_line_comment_) {
+      if (c == '\n') {
+         in_line_comment_ = false;
+         emitUncommented(c, source_offset);
+      }
+
+      return;
+   }
+
+   if (pending_slash_) {
+      pending_slash_ = false;
+
+      if (c == '/') {
+         in_line_comment_ = true;
+         return;
+      }
+
+      emitUncommented('/', pending_slash_offset_);
+   }
+
+   if (c == '/') {
+      pending_slash_ = true;
+      pending_slash_offset_ = source_offset;
+      return;
+   }
+
+   emitUncommented(c, source_offset);
+}
+
+void CppLexer::emitUncommented(const char c, const int source_offset)
+{
+   const int pos = text_.size();
+   text_ += c;
+
+   const auto extend_or_start = [this, pos, source_offset](const CppTokenType type, const bool extend) {
+      if (extend) {
+         tokens_.back().length_++;
+      }
+      else {
+         tokens_.push_back({ type, pos, 1, source_offset });
+      }
+   };
+
+   const CppTokenType* last{ tokens_.empty() ? nullptr : &tokens_.back().type_ };
+
+   if (c == '\n') {
+      in_literal_ = false;
+      literal_escape_ = false;
+      extend_or_start(CppTokenType::newline, false);
+   }
+   else if (in_literal_) {
+      extend_or_start(*last, true);
+
+      if (literal_escape_) {
+         literal_escape_ = false;
+      }
+      else if (c == '\\') {
+         literal_escape_ = true;
+      }
+      else if (c == text_[tokens_.back().begin_]) {
+         in_literal_ = false;
+      }
+   }
+   else if (isWhitespaceChar(c)) {
+      extend_or_start(CppTokenType::whitespace, last && *last == CppTokenType::whitespace);
+   }
+   else if (isIdentifierChar(c)) {
+      const bool continues{ last && (*last == CppTokenType::identifier || *last == CppTokenType::number) };
+      extend_or_start(continues ? *last : std::isdigit((unsigned char) c) ? CppTokenType::number : CppTokenType::identifier, continues);
+   }
+   else if (c == '.' && last && *last == CppTokenType::number) {
+      extend_or_start(CppTokenType::number, true);
+   }
+   else if (c == '"' || c == '\'') {
+      in_literal_ = true;
+      extend_or_start(c == '"' ? CppTokenType::string_literal : CppTokenType::char_literal, false);
+   }
+   else {
+      extend_or_start(CppTokenType::punctuation, false);
+   }
+}
+
+void CppLexer::finish()
+{
+   if (pending_slash_) {
+      pending_slash_ = false;
+      emitUncommented('/', pending_slash_offset_);
+   }
+}
@@ -8,9 +8,12 @@
 #include "cpp_parsing/cpp_parser.h"
 #include "cpp_parsing/cpp_type_atomic.h"
 #include "cpp_parsing/cpp_type_enum.h"
+#include "cpp_parsing/cpp_lexer.h"
+#include "cpp_parsing/interval_analysis.h"
 #include "earley/recognizer/earley_recognizer.h"
 #include "earley/parser/earley_parser.h"
 #include "static_helper.h"
+#include "bracket_index.h"
 #include "model_checking/simplification.h"
 #include "model_checking/smv_parsing/smv_module.h"
 #include "term_compound.h"
@@ -23,6 +26,8 @@
 #include <fstream>
 #include <vector>
 #include <chrono>
+#include <thread>
+#include <unordered_set>
 
 #if __cplusplus >= 201703L // https://stackoverflow.com/a/51536462/7302562 and https://stackoverflow.com/a/60052191/7302562
 #include <filesystem>
@@ -248,6 +253,7 @@ void vfm::CppParser::reset(const std::shared_ptr<DataPack> data_to_take_over, co
    using_mapping_.clear();
    function_definitions_.clear();
    function_signatures_.clear();
+   inlining_templates_.clear();
    ignore_tokens_for_functions_ = { "const", "&" };
    grammars_for_chunks_.clear();
 
@@ -837,14 +843,19 @@ void vfm::CppParser::collectInvariants(const std::string& program) {
 void vfm::CppParser::processUsingKeyword(std::string& code_without_comments)
 {
    addNote("Processing 'using' keyword.");
-   int pos = 0;
-   findNextNotWithinQuotesCore(code_without_comments, "using", pos);
+   std::vector<std::string> using_statements{};
+   code_without_comments = CppLexer(code_without_comments, false).rewriteWithoutUsingStatements(using_statements);
 
-   while (pos >= 0) {
-      int pos2 = code_without_comments.find(';', pos);
-      std::string using_str = code_without_comments.substr(pos, pos2 - pos);
-      std::string alias = StaticHelper::split(using_str, '=')[0];
-      std::string origin = StaticHelper::split(using_str, '=')[1];
+   for (const auto& using_str : using_statements) {
+      const auto alias_and_origin{ StaticHelper::split(using_str, '=') };
+
+      if (alias_and_origin.size() < 2) {
+         addError("Cannot process '" + using_str + "', only 'using alias = type;' is supported.");
+         continue;
+      }
+
+      std::string alias = alias_and_origin[0];
+      std::string origin = alias_and_origin[1];
 
       alias = StaticHelper::replaceAll(alias, "using", "");
       origin = StaticHelper::replaceAll(origin, ";", "");
@@ -859,13 +870,6 @@ void vfm::CppParser::processUsingKeyword(std::string& code_without_comments)
       else {
          using_mapping_.insert({ alias, origin });
       }
-
-      for (size_t i = pos; i <= pos2; i++) {
-         code_without_comments[i] = '-';
-      }
-
-      pos++;
-      findNextNotWithinQuotesCore(code_without_comments, "using", pos);
    }
 }
 
@@ -1264,29 +1268,43 @@ void vfm::CppParser::printInfos()
 std::string vfm::CppParser::preprocessProgram(const std::string& program, const bool preliminary)
 {
    std::string prog = program;
+   std::vector<std::pair<std::string, std::chrono::nanoseconds>> stage_times{};
+   auto stage_begin{ std::chrono::steady_clock::now() };
+
+   const auto stage_done = [&stage_times, &stage_begin](const std::string& stage_name) {
+      const auto now{ std::chrono::steady_clock::now() };
+      stage_times.push_back({ stage_name, now - stage_begin });
+      stage_begin = now;
+   };
 
    prog = StaticHelper::replaceAll(prog, "\\\n", ""); // Ignore sequence of "\ before EOL" which, in this context in C++, can only denote an ongoing line.
    prog = StaticHelper::replaceAllRegex(prog, VFM_CONTINUING_COMMENT_DENOTER + "\\s*//", ""); // vfm's own ongoing line mechanism removing all "// $$ *whitespace* //".
    prog += command_line_argument_;
+   stage_done("continuing lines");
 
    parseOptions(prog);
    performCodeInjection(prog);
    collectLTLSpecs(prog);
    collectCTLSpecs(prog);
    collectKratosSpecs(prog);
+   stage_done("options, injections, specs");
 
    const int loc_original = StaticHelper::split(prog, '\n').size();
    collectInitConstraints(prog);
    for (const auto& aka_mode : { VariableSpecifierModeEnum::AKA, VariableSpecifierModeEnum::TAL, VariableSpecifierModeEnum::INIT }) performTalOrAkaConversion(prog, VariableSpecifierMode(aka_mode));
    collectInvariants(prog);
+   stage_done("inits, TAL/AKA, invariants");
 
    if (!preliminary) {
       prog = StaticHelper::replaceAll(prog, VFM_GENCODE_DENOTER_BEGIN, VFM_GENCODE_PERSISTING_DENOTER + "\n" + VFM_GENCODE_DENOTER_BEGIN);
       prog = StaticHelper::replaceAll(prog, VFM_INSERT_CODE, ""); // Remove prefix for lines that are supposed to be inserted into the vfm code, while commented out to C++.
       prog = StaticHelper::removeMultiLineComments(prog, VFM_CUTOUT_DENOTER_BEGIN, VFM_CUTOUT_DENOTER_END); // Remove code parts marked as vfm cutout.
       prog = StaticHelper::removePartsOutsideOf(prog, VFM_BEGIN, VFM_END); // Remove parts outside of // #vfm-begin ... // #vfm-end
-      prog = StaticHelper::removeComments(prog); // Remove regular single-line and multi-line C++ comments.
-      prog = StaticHelper::removeBlankLines(prog);
+      stage_done("vfm denoters");
+
+      // Remove regular single-line and multi-line C++ comments, and blank lines. Same as removeComments followed by removeBlankLines, in one pass.
+      prog = CppLexer(prog).rewriteWithoutCommentsAndBlankLines();
+      stage_done("comments, blank lines");
 
       int prog_size_temp_before = prog.size();
       prog = StaticHelper::replaceAllRegex(prog, "static_cast\\s*<\\s*[Ii]nt\\s*>\\s*\\(\\s*(.*?)\\s*\\)", "$1"); // Remember, the ? means lazy.
@@ -1295,9 +1313,11 @@ std::string vfm::CppParser::preprocessProgram(const std::string& program, const
       }
 
       prog = StaticHelper::replaceAllRegex(prog, "static_cast\\s*<\\s*[Ff]loat\\s*>\\s*\\(\\s*(.*?)\\s*\\)", "$1"); // TODO: Special case for Viper, replace eventually with more general solution.
+      stage_done("static casts");
 
       StaticHelper::preprocessCppConvertArraysToCStyle(prog);
-      StaticHelper::preprocessCppConvertCStyleArraysToVars(prog);
+      prog = CppLexer(prog, false).rewriteCStyleArraysToVars(); // Same as StaticHelper::preprocessCppConvertCStyleArraysToVars.
+      stage_done("arrays");
       int loc = StaticHelper::split(prog, '\n').size();
 
       addNote("Parsing " + std::to_string(loc) + " (remaining from originally " + std::to_string(loc_original) + ") lines of code.");
@@ -1305,6 +1325,17 @@ std::string vfm::CppParser::preprocessProgram(const std::string& program, const
       addDebugPlain(prog);
       addDebug("*** EO Code to parse ***");
       processUsingKeyword(prog);
+      stage_done("using");
+
+      std::string breakdown{};
+      std::chrono::nanoseconds total{};
+
+      for (const auto& stage : stage_times) {
+         breakdown += "\n   " + stage.first + ": " + StaticHelper::printTimeFormatted(stage.second);
+         total += stage.second;
+      }
+
+      addNote("Preprocessing took " + StaticHelper::printTimeFormatted(total) + ":" + breakdown);
    }
 
    return prog;
@@ -1574,6 +1605,17 @@ std::vector<CppType>& vfm::CppParser::getDataTypes()
    return data_types_;
 }
 
+const std::map<std::string, std::shared_ptr<Term>>& vfm::CppParser::getFunctionDefinitions() const
+{
+   return function_definitions_;
+}
+
+void vfm::CppParser::setNodeParallelism(const int num_threads, const int min_nodes_per_job)
+{
+   node_parallelism_threads_ = num_threads;
+   min_nodes_per_parallel_job_ = min_nodes_per_job;
+}
+
 std::string vfm::CppParser::toStringFunctionSignature(const CppFunctionSignature& func_sig)
 {
    std::string s = func_sig.first->toString() + "(";
@@ -2311,10 +2353,11 @@ std::vector<std::string> extractArgs(const std::string& function_call_raw, const
 
    int begin{ 0 };
    int end_pos{ end_pos_raw - begin_raw + 1 };
+   const BracketIndex index{ function_call, { "(", "\"" }, { ")", "\"" } };
 
    for (;;) {
       last_begin = begin + 1;
-      begin = StaticHelper::indexOfOnTopLevel(function_call, { "," }, begin + 1, "(", ")", { "\"" }, { "\"" });
+      begin = StaticHelper::indexOfOnTopLevel(index, { "," }, begin + 1);
 
       if (begin < 0) {
          break;
@@ -2361,6 +2404,73 @@ void vfm::CppParser::replaceReturnWithAssignment(const TermPtr enc_function, con
    }, TraverseCompoundsType::avoid_compound_structures);
 }
 
+std::vector<std::shared_ptr<TermVar>> vfm::CppParser::collectVariablesForInlining(const TermPtr enc_function)
+{
+   std::vector<std::shared_ptr<TermVar>> variables{};
+
+   enc_function->applyToMeAndMyChildrenIterative([&variables](const MathStructPtr m) {
+      auto m_var{ m->toVariableIfApplicable() };
+
+      if (m_var) {
+         variables.push_back(m_var);
+      }
+   }, TraverseCompoundsType::avoid_compound_structures);
+
+   return variables;
+}
+
+const vfm::CppParser::InliningTemplate& vfm::CppParser::getInliningTemplate(const std::string& function_name, const vfm::CppFunctionSignature& sig)
+{
+   auto meta_term{ parser_->getDynamicTermMeta(function_name, 0) }; // We have always 0 parameters because we don't mimic the calling behavior of the function.
+   auto it{ inlining_templates_.find(function_name) };
+
+   if (it != inlining_templates_.end() && it->second.source_ == meta_term) {
+      return it->second;
+   }
+
+   addDebug("Preparing function '" + function_name + "' for inlining.");
+
+   InliningTemplate& inlining_template{ inlining_templates_[function_name] };
+   inlining_template = {};
+   inlining_template.source_ = meta_term;
+   std::map<std::string, int> local_indices{};
+
+   for (const auto& m_var : collectVariablesForInlining(_id(meta_term->copy()))) {
+      const std::string m_var_name{ m_var->getVariableName() };
+      const std::string m_var_name_clean{ StaticHelper::cleanVarNameOfPossibleRefSymbol(m_var_name) };
+      int local_index{ -1 };
+
+      if (StaticHelper::cleanVarNameOfPossibleRefSymbol(isLocalVarName(m_var_name)) == function_name) { // It's a local variable of this funtion.
+         auto inserted{ local_indices.insert({ m_var_name, (int) inlining_template.locals_.size() }) };
+         local_index = inserted.first->second;
+
+         if (inserted.second) {
+            inlining_template.locals_.push_back({ m_var_name, m_var_name_clean });
+         }
+      }
+
+      std::vector<std::pair<int, bool>> params{};
+
+      for (int par_num = 0; par_num < sig.second.size(); par_num++) {
+         const std::string& param_arg{ sig.second.at(par_num).first };
+
+         if (m_var_name == param_arg
+            || StaticHelper::stringStartsWith(m_var_name, param_arg + ".")
+            || StaticHelper::stringStartsWith(m_var_name, param_arg + ARRAY_INDEX_DENOTER_OPEN)) {
+            params.push_back({ par_num, false });
+         }
+         else if (m_var_name == SYMB_REF + param_arg || StaticHelper::stringStartsWith(m_var_name, SYMB_REF + param_arg + ".")) {
+            params.push_back({ par_num, true });
+         }
+      }
+
+      inlining_template.local_of_variable_.push_back(local_index);
+      inlining_template.params_of_variable_.push_back(params);
+   }
+
+   return inlining_template;
+}
+
 void vfm::CppParser::inlineFunction(
    std::string& result, 
    const int index_begin, 
@@ -2374,8 +2484,9 @@ void vfm::CppParser::inlineFunction(
    auto end_pos{ 0 };
    auto real_args_raw{ extractArgs(result, index_begin, end_pos) };
    std::vector<std::string> real_args{};
-   auto meta_term{ parser_->getDynamicTermMeta(function_name, 0) }; // We have always 0 parameters because we don't mimic the calling behavior of the function.
-   auto enc_function{ _id(meta_term->copy()) };
+   const InliningTemplate& inlining_template{ getInliningTemplate(function_name, sig) };
+   auto enc_function{ _id(inlining_template.source_->copy()) };
+   const auto variables{ collectVariablesForInlining(enc_function) };
 
    // Increment local variable names (isAllowedToDrive.myvar ==> isAllowedToDrive.myvar.called_nr)
    if (!function_call_counters_.count(function_name)) {
@@ -2385,40 +2496,40 @@ void vfm::CppParser::inlineFunction(
       function_call_counters_.at(function_name)++;
    }
 
-   enc_function->applyToMeAndMyChildrenIterative([this, &function_name](const MathStructPtr m) { // Rename local variables.
-      auto m_var{ m->toVariableIfApplicable() };
+   std::vector<std::string> local_names_new{}; // Rename local variables.
 
-      if (m_var) {
-         auto m_var_name{ m_var->getVariableName() };
+   for (const auto& local : inlining_template.locals_) {
+      const std::string m_var_name_new{ localVarNameActualCall(function_name, local.name_) };
+      local_names_new.push_back(m_var_name_new);
 
-         if (StaticHelper::cleanVarNameOfPossibleRefSymbol(isLocalVarName(m_var_name)) == function_name) { // It's a local variable of this funtion.
-            std::string m_var_name_new{ localVarNameActualCall(function_name, m_var_name) };
-            m_var->setVariableName(m_var_name_new);
+      const auto it_type{ types_of_variables_.find(local.name_clean_) };
 
+      if (it_type != types_of_variables_.end()) { // It's a base type ("A a"; not a subtype like "a.x").
+         insertTypeOfVariable(StaticHelper::cleanVarNameOfPossibleRefSymbol(m_var_name_new), { it_type->second.first->copy(true), it_type->second.second }, true);
+      }
 
-            if (types_of_variables_.count(StaticHelper::cleanVarNameOfPossibleRefSymbol(m_var_name))) { // It's a base type ("A a"; not a subtype like "a.x").
-               auto type = types_of_variables_.at(StaticHelper::cleanVarNameOfPossibleRefSymbol(m_var_name));
-               insertTypeOfVariable(StaticHelper::cleanVarNameOfPossibleRefSymbol(m_var_name_new), { type.first->copy(true), type.second }, true);
-            }
+      const auto it_tal{ global_primitives_tal_range_descriptions_.find(local.name_clean_) };
+      const auto it_aka{ global_primitives_aka_descriptions_.find(local.name_clean_) };
+      const auto it_init{ global_primitives_init_values_.find(local.name_clean_) };
 
-            auto it_tal { global_primitives_tal_range_descriptions_.find(StaticHelper::cleanVarNameOfPossibleRefSymbol(m_var_name)) };
-            auto it_aka { global_primitives_aka_descriptions_.find(StaticHelper::cleanVarNameOfPossibleRefSymbol(m_var_name)) };
-            auto it_init{ global_primitives_init_values_.find(StaticHelper::cleanVarNameOfPossibleRefSymbol(m_var_name)) };
+      if (it_tal != global_primitives_tal_range_descriptions_.end()) {
+         global_primitives_tal_range_descriptions_[m_var_name_new] = it_tal->second;
+      }
 
-            if (it_tal != global_primitives_tal_range_descriptions_.end()) {
-               global_primitives_tal_range_descriptions_[m_var_name_new] = it_tal->second;
-            }
+      if (it_aka != global_primitives_aka_descriptions_.end()) {
+         global_primitives_aka_descriptions_[m_var_name_new] = it_aka->second;
+      }
 
-            if (it_aka != global_primitives_aka_descriptions_.end()) {
-               global_primitives_aka_descriptions_[m_var_name_new] = it_aka->second;
-            }
+      if (it_init != global_primitives_init_values_.end()) {
+         global_primitives_init_values_[m_var_name_new] = it_init->second;
+      }
+   }
 
-            if (it_init != global_primitives_init_values_.end()) {
-               global_primitives_init_values_[m_var_name_new] = it_init->second;
-            }
-         }
+   for (int i = 0; i < variables.size(); i++) {
+      if (inlining_template.local_of_variable_[i] >= 0) {
+         variables[i]->setVariableName(local_names_new[inlining_template.local_of_variable_[i]]);
       }
-   }, TraverseCompoundsType::avoid_compound_structures);
+   }
 
    // Handle arrays in function call.
    int orig_par_num{ 0 };
@@ -2442,9 +2553,11 @@ void vfm::CppParser::inlineFunction(
    }
 
    // Match parameters of caller with callee's function signature.
+   std::vector<bool> substitute_param(real_args.size(), false);
+
    for (int par_num = 0; par_num < real_args.size(); par_num++) {
-      std::string real_arg{ real_args.at(par_num) };
-      std::string param_arg{ sig.second.at(par_num).first };
+      std::string& real_arg{ real_args.at(par_num) };
+      const std::string& param_arg{ sig.second.at(par_num).first };
 
       if (StaticHelper::stringStartsWith(real_arg, "&")) {
          addDebug("Ignoring pointerization '&' of argument '" + real_arg + "'.");
@@ -2458,57 +2571,60 @@ void vfm::CppParser::inlineFunction(
          const CppType type_simple{ type_with_qualifiers.first };
          const std::vector<std::string> qualifiers{ type_with_qualifiers.second };
          insertTypeOfVariable(param_arg, { type_simple->copy(true), qualifiers });
+         substitute_param[par_num] = true;
+      }
+      else {
+         addDebug("Found parameter '" + param_arg + "' which is equal to the given argument, so no action is taken.");
+      }
+   }
 
-         enc_function->applyToMeAndMyChildrenIterative([&param_arg, &real_arg, &function_name, this](const MathStructPtr m) {
-            auto m_var{ m->toVariableIfApplicable() };
+   for (int i = 0; i < variables.size(); i++) {
+      for (const auto& param : inlining_template.params_of_variable_[i]) {
+         if (!substitute_param[param.first]) continue;
 
-            if (m_var) {
-               std::string m_var_name{ m_var->getVariableName() };
-
-               // TODO: Find out actual name clashes.
-               //if (m_var_name == real_arg || StaticHelper::stringStartsWith(m_var_name, real_arg + ".")
-               //   || m_var_name == SYMB_REF + real_arg || StaticHelper::stringStartsWith(m_var_name, SYMB_REF + real_arg + ".")) {
-               //   addWarning("Possible name clash between argument '" + real_arg + "' given to function '" + function_name + "' and local variable '" + m_var_name + "' used there. Please check.");
-               //}
-
-               if (m_var_name == param_arg 
-                  || StaticHelper::stringStartsWith(m_var_name, param_arg + ".")
-                  || StaticHelper::stringStartsWith(m_var_name, param_arg + ARRAY_INDEX_DENOTER_OPEN)) {
-                  std::string old_arg{ param_arg + m_var_name.substr(param_arg.size()) };
-                  std::string new_arg{ real_arg + m_var_name.substr(param_arg.size()) };
-                  m_var->setVariableName(new_arg);
-
-                  //if (function_aka_from_new_to_old_.count(old_arg)) {
-                  //   addDebug("Ignoring type for AKA'd variable '" + old_arg + "' (we'll find it later).");
-                  //}
-                  //else {
-                  //   auto pair = types_of_variables_.at(param_arg).first->deriveSubTypeFor(old_arg, false);
+         const std::string m_var_name{ variables[i]->getVariableName() };
+         const std::string& real_arg{ real_args.at(param.first) };
+         const std::string& param_arg{ sig.second.at(param.first).first };
 
-                  //   if (pair.first && pair.first->isConst()) {
-                  //      auto init_value = pair.second.first;
+         // TODO: Find out actual name clashes.
+         //if (m_var_name == real_arg || StaticHelper::stringStartsWith(m_var_name, real_arg + ".")
+         //   || m_var_name == SYMB_REF + real_arg || StaticHelper::stringStartsWith(m_var_name, SYMB_REF + real_arg + ".")) {
+         //   addWarning("Possible name clash between argument '" + real_arg + "' given to function '" + function_name + "' and local variable '" + m_var_name + "' used there. Please check.");
+         //}
 
-                  //      data_->declareVariable(new_arg, true);
+         if (!param.second) {
+            std::string old_arg{ param_arg + m_var_name.substr(param_arg.size()) };
+            std::string new_arg{ real_arg + m_var_name.substr(param_arg.size()) };
+            variables[i]->setVariableName(new_arg);
+
+            //if (function_aka_from_new_to_old_.count(old_arg)) {
+            //   addDebug("Ignoring type for AKA'd variable '" + old_arg + "' (we'll find it later).");
+            //}
+            //else {
+            //   auto pair = types_of_variables_.at(param_arg).first->deriveSubTypeFor(old_arg, false);
+
+            //   if (pair.first && pair.first->isConst()) {
+            //      auto init_value = pair.second.first;
+
+            //      data_->declareVariable(new_arg, true);
+
+            //      if (init_value) {
+            //         auto init_value_str = *init_value;
+            //         auto init_value_float = MathStruct::parseMathStruct(init_value_str, parser_, data_)->eval(data_, parser_);
+            //         data_->addOrSetSingleVal(new_arg, init_value_float);
+            //         m_var->setConstVariable(init_value_float);
+            //      }
+            //   }
+            //   else if (!pair.first) {
+            //      addError("No type found for '" + old_arg + "'.");
+            //   }
+            //}
+         }
+         else {
+            variables[i]->setVariableName(SYMB_REF + real_arg + m_var_name.substr(param_arg.size() + 1));
+         }
 
-                  //      if (init_value) {
-                  //         auto init_value_str = *init_value;
-                  //         auto init_value_float = MathStruct::parseMathStruct(init_value_str, parser_, data_)->eval(data_, parser_);
-                  //         data_->addOrSetSingleVal(new_arg, init_value_float);
-                  //         m_var->setConstVariable(init_value_float);
-                  //      }
-                  //   }
-                  //   else if (!pair.first) {
-                  //      addError("No type found for '" + old_arg + "'.");
-                  //   }
-                  //}
-               }
-               else if (m_var_name == SYMB_REF + param_arg || StaticHelper::stringStartsWith(m_var_name, SYMB_REF + param_arg + ".")) {
-                  m_var->setVariableName(SYMB_REF + real_arg + m_var_name.substr(param_arg.size() + 1));
-               }
-            }
-         }, TraverseCompoundsType::avoid_compound_structures);
-      }
-      else {
-         addDebug("Found parameter '" + param_arg + "' which is equal to the given argument, so no action is taken.");
+         break; // Arguments are substituted simultaneously, only the first parameter a variable refers to counts.
       }
    }
 
@@ -3684,12 +3800,12 @@ void vfm::CppParser::deleteMortyGUIProgressFile() const
 
 void vfm::CppParser::applyConstnessToAllMCItems()
 {
-   applyToAllMCItems([this](const MathStructPtr m) {
+   applyToSelectedMCNodes([this](const MathStructPtr& m) { // Only reads data_, which is not modified meanwhile.
       auto m_var{ m->toVariableIfApplicable() };
-
-      if (m_var && data_->isConst(m_var->getVariableName())) {
-         m_var->setConstVariable(data_->getSingleVal(m_var->getVariableName()));
-      }
+      return m_var && data_->isConst(m_var->getVariableName());
+      }, [this](const MathStructPtr& m) {
+      auto m_var{ m->toVariableIfApplicable() };
+      m_var->setConstVariable(data_->getSingleVal(m_var->getVariableName()));
       }, true);
 }
 
@@ -4091,11 +4207,13 @@ std::vector<std::string> vfm::CppParser::findTokensAfterFunctionCall(const std::
 
 std::string vfm::CppParser::findSurroundingNamespace(const std::string code, const int pos)
 {
+   const BracketIndex index{ code, { "{", "\"" }, { "}", "\"" } };
+
    for (int i = pos; i >= 0; i--) {
       std::string namespace_name;
 
       if (code[i] == '}') {
-         i = StaticHelper::findMatchingBegTagLevelwise(code, "{", "}", i, { "\"" }, { "\"" });
+         i = StaticHelper::findMatchingBegTagLevelwise(index, i);
          continue;
       }
 
@@ -4142,6 +4260,15 @@ std::pair<float, float> vfm::CppParser::getSingleRange(const MathStructPtr m_raw
    auto m = m_raw->copy();
    m = MathStruct::flattenFormula(m->toTermIfApplicable());
 
+   return getSingleRange(
+      m->getOptor(),
+      m->isTermCompound() ? m->toTermCompoundIfApplicable()->getCompoundStructure()->getOptor() : "",
+      range1,
+      range2);
+}
+
+std::pair<float, float> vfm::CppParser::getSingleRange(const std::string& optor, const std::string& compound_optor, const std::pair<float, float>& range1, const std::pair<float, float>& range2) const
+{
    float min = 1; // Invalid inital values that make the relational operators simpler.
    float max = 0;
 
@@ -4165,8 +4292,8 @@ std::pair<float, float> vfm::CppParser::getSingleRange(const MathStructPtr m_raw
       assert(min <= max);
    };
 
-   auto checkOptor = [&m](const std::string& optor) { // A bit over-simplified, but captures std::max = max, vfc::equal = != etc.
-      return m->getOptor() == optor || m->isTermCompound() && m->toTermCompoundIfApplicable()->getCompoundStructure()->getOptor() == optor;
+   auto checkOptor = [&optor, &compound_optor](const std::string& optor_to_check) { // A bit over-simplified, but captures std::max = max, vfc::equal = != etc.
+      return optor == optor_to_check || compound_optor == optor_to_check;
    }; // TODO: Decide for EITHER flattening OR this method, currently this method has no effect, but flattening might be too expensive.
 
    if (checkOptor(SYMB_PLUS)) {
@@ -4373,7 +4500,7 @@ std::pair<float, float> vfm::CppParser::getSingleRange(const MathStructPtr m_raw
          min, max);
    }
    else {
-      addError("Operator '" + m->getOptor() + "' not covered for range extraction.");
+      addError("Operator '" + optor + "' not covered for range extraction.");
    }
 
    // TODO: Should we do floor/ceil or just leave the float ranges?
@@ -4385,9 +4512,8 @@ std::pair<float, float> vfm::CppParser::getSingleRange(const MathStructPtr m_raw
 std::pair<float, float> vfm::CppParser::deriveGlobalRangeFromLeafRanges(const MathStructPtr m) const
 {
    std::map<MathStructPtr, std::pair<float, float>> ranges{};
-   auto tal = prepareVariablesForPrematureTal()->copy();
 
-   m->applyToMeAndMyChildrenIterative([this, &ranges, &tal](const MathStructPtr m) {
+   m->applyToMeAndMyChildrenIterative([this, &ranges](const MathStructPtr m) {
       if (m->isTermVal()) {
          ranges[m] = { m->constEval(), m->constEval() };
          addDebug("Range of constant value '" + m->serializeWithinSurroundingFormula(50, 50) + "' is (" + std::to_string(ranges[m].first) + ".." + std::to_string(ranges[m].second) + ").");
@@ -4924,20 +5050,46 @@ VariablesWithKinds CppParser::kreateKratosFilesAndCheckFormula(const std::string
 
    addNote("Kreating Kratos code and vfm code.");
    VariablesWithKinds fsm_controlled_out{};
-   std::string kratos_code{ serializeKratos(
-      full_formula,
-      main_function_name_,
-      collectEnumsForKratos(),
-      variables_ordering_,
-      IGNORE_THESE,
-      true, // Backwards compatibility towards 1st and 2nd workflow abandoned, therefore always assume no-C++ EM.
-      getAllVariablesExceptImmutableEnumAndBoolTypes(),
-      fsm_controlled_out) };
+   std::string kratos_hash{};
+   bool kratos_stored{};
 
    addNote("Storing Kratos code in '" + kratos_file + "'.");
-   std::ofstream outKratos{ kratos_file };
-   outKratos << kratos_code;
-   outKratos.close();
+   { // Scope which closes the file before it is read below.
+      FileSink kratos_file_sink{ kratos_file };
+      HashingSink kratos_hashing_sink{ &kratos_file_sink };
+      serializeKratos(
+         kratos_hashing_sink,
+         full_formula,
+         main_function_name_,
+         collectEnumsForKratos(),
+         variables_ordering_,
+         IGNORE_THESE,
+         true, // Backwards compatibility towards 1st and 2nd workflow abandoned, therefore always assume no-C++ EM.
+         getAllVariablesExceptImmutableEnumAndBoolTypes(),
+         fsm_controlled_out);
+      kratos_hash = kratos_hashing_sink.getHashHex();
+      addDebug("Kreated Kratos code (" + std::to_string(kratos_hashing_sink.getSize()) + " characters, hash " + kratos_hash + ").");
+
+      kratos_file_sink.flush();
+      kratos_stored = !kratos_file_sink.hasErrorOccurred();
+
+      if (!kratos_stored) {
+         addError("Could not store Kratos code in '" + kratos_file + "'.");
+      }
+   }
+
+   const std::string kratos_hash_file{ kratos_file + ".hash" };
+   const bool kratos_unchanged{ kratos_stored && StaticHelper::readFile(kratos_hash_file) == kratos_hash };
+
+   if (kratos_unchanged) {
+      addNote("Kratos code is unchanged since the last generation (hash " + kratos_hash + ").");
+   }
+   else if (kratos_stored) {
+      StaticHelper::writeTextToFile(kratos_hash, kratos_hash_file);
+   }
+   else {
+      std::filesystem::remove(kratos_hash_file); // The PDF below is created from a broken file.
+   }
 
    std::string vfm_code = full_formula->serialize();
 
@@ -4983,12 +5135,17 @@ VariablesWithKinds CppParser::kreateKratosFilesAndCheckFormula(const std::string
    std::string kratos_code_file{ kratos_file + ".dot" };
    std::string vfm_code_file{ StaticHelper::replaceAll(kratos_code_file, ".k2", ".vfm") };
 
-   addNote("Kreating Kratos PDF code in '" + kratos_code_file + "'.");
-   StaticHelper::createImageFromGraphvizDot(
-      std::string("digraph G {\n")
-      + "r [shape=record label=\"" + StaticHelper::shortenToMaxSize(StaticHelper::replaceManyTimes(kratos_code, replacements), MAX_LABEL_SIZE) + "\\l\"];\n"
-      + "}",
-      kratos_code_file);
+   if (kratos_unchanged && std::filesystem::exists(kratos_code_file + ".pdf")) {
+      addNote("Keeping Kratos PDF '" + kratos_code_file + ".pdf' since the Kratos code is unchanged.");
+   }
+   else {
+      addNote("Kreating Kratos PDF code in '" + kratos_code_file + "'.");
+      StaticHelper::createImageFromGraphvizDot(
+         std::string("digraph G {\n")
+         + "r [shape=record label=\"" + StaticHelper::shortenToMaxSize(StaticHelper::replaceManyTimes(StaticHelper::readFile(kratos_file), replacements), MAX_LABEL_SIZE) + "\\l\"];\n"
+         + "}",
+         kratos_code_file);
+   }
 
    addNote("Creating vfm PDF code in '" + vfm_code_file + "'.");
    StaticHelper::createImageFromGraphvizDot(
@@ -5074,55 +5231,145 @@ void vfm::CppParser::setTypeOrSubTypeConstSafe(const std::string& m_var_name, co
    data_->addConstVariable(m_var_name, const_value);
 }
 
-void vfm::CppParser::applyToAllMCItems(const std::function<void(std::shared_ptr<MathStruct>)>& f, const bool include_constraints, const bool include_all_functions)
+std::vector<vfm::TermPtr*> vfm::CppParser::getMCItemRoots(
+   const bool include_constraints,
+   const bool include_all_functions,
+   std::map<std::string, std::map<int, std::shared_ptr<Term>>>& dynamic_term_metas_copy)
 {
+   std::vector<TermPtr*> roots{};
+
    for (auto& fmla_raw : function_definitions_) {
       if (include_all_functions || fmla_raw.first == main_function_name_) {
-         auto fmla{ _id(fmla_raw.second) };
-         fmla->applyToMeAndMyChildren(f, TraverseCompoundsType::go_into_compound_structures);
-         fmla_raw.second = fmla->getOperands()[0];
+         roots.push_back(&fmla_raw.second);
       }
    }
 
    if (include_all_functions) {
-      for (auto& function_pairs : parser_->getDynamicTermMetas()) {
+      dynamic_term_metas_copy = parser_->getDynamicTermMetas();
+
+      for (auto& function_pairs : dynamic_term_metas_copy) {
          for (auto& function_pair : function_pairs.second) {
-            auto fmla = _id(function_pair.second);
-            fmla->applyToMeAndMyChildren(f, TraverseCompoundsType::go_into_compound_structures);
-            function_pair.second = fmla->getOperands()[0];
+            roots.push_back(&function_pair.second);
          }
       }
    }
 
    if (include_constraints) {
       for (auto& invariant : all_invariants_) {
-         auto fmla = _id(invariant);
-         fmla->applyToMeAndMyChildren(f, TraverseCompoundsType::go_into_compound_structures);
-         invariant = fmla->getOperands()[0];
+         roots.push_back(&invariant);
       }
 
       for (auto& initial_state_constraint : all_initial_state_constraints_) {
-         auto fmla = _id(initial_state_constraint);
-         fmla->applyToMeAndMyChildren(f, TraverseCompoundsType::go_into_compound_structures);
-         initial_state_constraint = fmla->getOperands()[0];
+         roots.push_back(&initial_state_constraint);
+      }
+   }
+
+   return roots;
+}
+
+void vfm::CppParser::applyToMCItemInitFormulas(const std::function<void(std::shared_ptr<MathStruct>)>& f)
+{
+   for (const auto& el : type_abstraction_layer_->getVariablesWithTypes()) {
+      auto init_str = el.second.second;
+
+      if (init_str != FIGURE_OUT_RANDOM_VALUE_FROM_RANGE_LATER) {
+         auto formula = _id(MathStruct::parseMathStruct(init_str, parser_, data_)->toTermIfApplicable());
+         formula->applyToMeAndMyChildren(f, TraverseCompoundsType::go_into_compound_structures);
+         type_abstraction_layer_->setInitValueOf(el.first, formula->getOperands()[0]->serialize());
+         addDebug("{{applyToAllMCItems}} Init value of variable '" + el.first + "' is '" + init_str + "'.");
+      }
+   }
+}
+
+void vfm::CppParser::applyToAllMCItems(const std::function<void(std::shared_ptr<MathStruct>)>& f, const bool include_constraints, const bool include_all_functions)
+{
+   std::map<std::string, std::map<int, std::shared_ptr<Term>>> dynamic_term_metas{};
+
+   for (auto root : getMCItemRoots(include_constraints, include_all_functions, dynamic_term_metas)) {
+      auto fmla{ _id(*root) };
+      fmla->applyToMeAndMyChildren(f, TraverseCompoundsType::go_into_compound_structures);
+      *root = fmla->getOperands()[0];
+   }
+
+   if (include_constraints) {
+      applyToMCItemInitFormulas(f);
+   }
+}
+
+void vfm::CppParser::applyToSelectedMCNodes(
+   const std::function<bool(const MathStructPtr&)>& select,
+   const std::function<void(const MathStructPtr&)>& apply,
+   const bool include_constraints,
+   const bool include_all_functions)
+{
+   std::map<std::string, std::map<int, std::shared_ptr<Term>>> dynamic_term_metas{};
+   const auto roots{ getMCItemRoots(include_constraints, include_all_functions, dynamic_term_metas) };
+   std::vector<TermPtr> fmlas{};
+   std::vector<MathStructPtr> nodes{};
+
+   for (auto root : roots) {
+      fmlas.push_back(_id(*root)); // apply may replace the root.
+      fmlas.back()->applyToMeAndMyChildren([&nodes](const MathStructPtr m) {
+         nodes.push_back(m);
+      }, TraverseCompoundsType::go_into_compound_structures);
+   }
+
+   const int num_threads{ node_parallelism_threads_ > 0 ? node_parallelism_threads_ : (std::max)(1, (int) std::thread::hardware_concurrency()) };
+   const int chunk_size{ (std::max)(min_nodes_per_parallel_job_, (int) (nodes.size() + num_threads - 1) / num_threads) };
+   std::vector<std::vector<MathStructPtr>> selected((nodes.size() + chunk_size - 1) / chunk_size); // One per job, in node order.
+
+   if (selected.size() <= 1) {
+      for (const auto& node : nodes) {
+         if (select(node)) selected[0].push_back(node);
       }
+   }
+   else { // Scope which makes us wait for finishing the jobs before applying.
+      ThreadPool pool(num_threads);
 
-      for (const auto& el : type_abstraction_layer_->getVariablesWithTypes()) { // INIT-Formulas
-         auto init_str = el.second.second;
+      for (int job = 0; job < selected.size(); job++) {
+         pool.enqueue([&select, &nodes, &selected, job, chunk_size] {
+            const int end{ (std::min)((job + 1) * chunk_size, (int) nodes.size()) };
 
-         if (init_str != FIGURE_OUT_RANDOM_VALUE_FROM_RANGE_LATER) {
-            auto formula = _id(MathStruct::parseMathStruct(init_str, parser_, data_)->toTermIfApplicable());
-            formula->applyToMeAndMyChildren(f, TraverseCompoundsType::go_into_compound_structures);
-            type_abstraction_layer_->setInitValueOf(el.first, formula->getOperands()[0]->serialize());
-            addDebug("{{applyToAllMCItems}} Init value of variable '" + el.first + "' is '" + init_str + "'.");
+            for (int i = job * chunk_size; i < end; i++) {
+               if (select(nodes[i])) selected[job].push_back(nodes[i]);
+            }
+         });
+      }
+   }
+
+   std::unordered_set<const MathStruct*> applied{}; // Compound structures are shared among the items, but each node is changed once.
+
+   for (const auto& job_nodes : selected) {
+      for (const auto& node : job_nodes) {
+         if (applied.insert(node.get()).second) {
+            apply(node);
          }
       }
    }
+
+   for (int i = 0; i < roots.size(); i++) {
+      *roots[i] = fmlas[i]->getOperands()[0];
+   }
+
+   if (include_constraints) {
+      applyToMCItemInitFormulas([&select, &apply](const MathStructPtr m) {
+         if (select(m)) apply(m);
+      });
+   }
 }
 
 void vfm::CppParser::createConstantsFromPointRangeVariables()
 {
-   applyToAllMCItems([this](const MathStructPtr m) {
+   applyToSelectedMCNodes([this](const MathStructPtr& m) {
+      if (!m->isTermVar()) return false;
+
+      const auto m_var_name{ StaticHelper::cleanVarNameOfPossibleRefSymbol(m->toVariableIfApplicable()->getVariableName()) };
+
+      if (StaticHelper::isPrivateVar(m_var_name) || IGNORE_THESE.count(m_var_name)) return false;
+
+      const auto range{ type_abstraction_layer_->getRange(m_var_name, false) };
+      return range.first >= range.second; // Point ranges, and missing ones to have them logged in apply.
+   }, [this](const MathStructPtr m) {
       if (m->isTermVar()) {
          auto m_var{ m->toVariableIfApplicable() };
          auto m_var_name{ StaticHelper::cleanVarNameOfPossibleRefSymbol(m_var->getVariableName()) };
@@ -5140,7 +5387,29 @@ void vfm::CppParser::createConstantsFromPointRangeVariables()
 
 void vfm::CppParser::insertLiteralValuesForConstants()
 {
-   applyToAllMCItems([this](const MathStructPtr m) {
+   // Read-only: with ErrorLevelEnum::invalid, deriveSubTypeFor doesn't log (and its Failable singleton exists since reset()).
+   const auto is_const = [this](const std::string& m_var_name) {
+      if (types_of_variables_.count(m_var_name) && containsConstQualifier(types_of_variables_.at(m_var_name))) {
+         return true;
+      }
+
+      const auto base_name{ getTypeBaseName(m_var_name) };
+
+      if (!types_of_variables_.count(base_name)) {
+         return false;
+      }
+
+      const auto type{ types_of_variables_.at(base_name).first->deriveSubTypeFor(m_var_name, !isLocalVarName(m_var_name).empty(), false, ErrorLevelEnum::invalid).first };
+      return type && type->isConst();
+   };
+
+   applyToSelectedMCNodes([&is_const](const MathStructPtr& m) { // Right side uses the plain name, left side the cleaned one.
+      if (!m->isTermVar()) return false;
+
+      const auto m_var_name{ m->toVariableIfApplicable()->getVariableName() };
+      const auto m_var_name_clean{ StaticHelper::cleanVarNameOfPossibleRefSymbol(m_var_name) };
+      return is_const(m_var_name) || m_var_name_clean != m_var_name && is_const(m_var_name_clean);
+   }, [this](const MathStructPtr m) {
       if (m->isTermVarNotOnLeftSideOfAssignment()) {
          auto m_var{ m->toVariableIfApplicable() };
          auto m_var_name{ m_var->getVariableName() };
@@ -5231,7 +5500,23 @@ std::string vfm::CppParser::serializeKratos(
    const std::map<std::string, std::string>& all_variables_except_immutable_enum_and_bool_with_type,
    VariablesWithKinds& fsm_controlled) const
 {
-   std::string s{R"(;; ============================================================================================================
+   StringSink out{};
+   serializeKratos(out, full_formula, entry_function_name, enum_values, variables_ordered, blacklist, native_env_model_wf, all_variables_except_immutable_enum_and_bool_with_type, fsm_controlled);
+   return out.str();
+}
+
+void vfm::CppParser::serializeKratos(
+   OutputSink& out,
+   const TermPtr full_formula,
+   const std::string& entry_function_name,
+   const std::map<std::string, std::string>& enum_values,
+   const std::vector<std::string>& variables_ordered,
+   const std::set<std::string> blacklist,
+   const bool native_env_model_wf,
+   const std::map<std::string, std::string>& all_variables_except_immutable_enum_and_bool_with_type,
+   VariablesWithKinds& fsm_controlled) const
+{
+   const std::string copyright{R"(;; ============================================================================================================
 ;; C O P Y R I G H T
 ;; ------------------------------------------------------------------------------------------------------------
 ;; copyright (C) 2022 Robert Bosch GmbH. All rights reserved.
@@ -5313,10 +5598,31 @@ std::string vfm::CppParser::serializeKratos(
    std::vector<std::string> variables_ordered_kratos_style{};
    for (const auto& var : variables_ordered) variables_ordered_kratos_style.push_back(StaticHelper::replaceAll(var, "::", "____"));
 
-   for (const auto& ivar : variables_ordered_kratos_style) {
+   // The declarations may add missing variables to the TAL, and the init values go through parser_, so both are done
+   // in order. Serializing the initializations is left to serializeKratosInitializations.
+   std::vector<std::string> declarations_per_var(variables_ordered_kratos_style.size());
+   std::vector<TermPtr> init_assignments(variables_ordered_kratos_style.size());
+
+   for (int i = 0; i < variables_ordered_kratos_style.size(); i++) {
+      const auto& ivar{ variables_ordered_kratos_style[i] };
+
       if (fsm_controlled.getInputVariables().count(ivar) && fsm_controlled.getOutputVariables().count(ivar)) {
-         auto declaration = getInitVarStringNuSMVOrKratos(ivar, additional_functions, false, false, true, enum_values);
-         auto initialization = getInitVarStringNuSMVOrKratos(ivar, additional_functions, true, false, true, enum_values);
+         declarations_per_var[i] = getInitVarStringNuSMVOrKratos(ivar, additional_functions, false, false, true, enum_values);
+
+         if (!declarations_per_var[i].empty()) {
+            init_assignments[i] = getInitAssignmentKratos(ivar);
+         }
+      }
+   }
+
+   const auto initializations_per_var{ serializeKratosInitializations(init_assignments, enum_values, additional_functions) };
+
+   for (int i = 0; i < variables_ordered_kratos_style.size(); i++) {
+      const auto& ivar{ variables_ordered_kratos_style[i] };
+
+      if (fsm_controlled.getInputVariables().count(ivar) && fsm_controlled.getOutputVariables().count(ivar)) {
+         const auto& declaration{ declarations_per_var[i] };
+         const auto& initialization{ init_assignments[i] ? initializations_per_var[i] : declaration }; // A DEFINE is its own initialization.
 
          if (!declaration.empty() && !initialization.empty()) {
             declarations += declaration;
@@ -5358,7 +5664,8 @@ std::string vfm::CppParser::serializeKratos(
       main_part = StaticHelper::replaceAll(main_part, "\n(label while0)\n", "\n" + init_constraint_str + "\n(label while0)\n"); // TODO!
    }
 
-   s += R"((function assert ((var cond bool)) (return)
+   out << copyright;
+   out << R"((function assert ((var cond bool)) (return)
 (locals)
 (seq
 (condjump cond (label end))
@@ -5366,7 +5673,7 @@ std::string vfm::CppParser::serializeKratos(
 (label end)))
 )";
 
-   s += R"(
+   out << R"(
 (function rndet ((var lo int) (var hi int)) (return (var ret int)) 
 (locals) 
 (seq (havoc ret) (assume (and (ge ret lo) (le ret hi)))))
@@ -5378,27 +5685,25 @@ std::string vfm::CppParser::serializeKratos(
       addNote("Debug mode Kratos active. I will add internal variables to return interface to make them visible in CEX.");
    }
 
-   s += additional_functions.second;
-
-   s += "\n" + StaticHelper::createKratosNdetFunction("ndet_int2", { "int" , "int" });
-   s += "\n" + StaticHelper::createKratosNdetFunction("ndet_bool2", { "bool" , "bool" });
+   out << additional_functions.second;
 
-   s += std::string("\n(entry ") + /*dummy_func_name*/ entry_function_name + ")\n";
-   s += "(globals" + std::string(native_env_model_wf ? " (! (var loc bool) :location-var true)" : "") + ")\n";
-   s += std::string("(function " + entry_function_name + " (") + pars + "\n)\n\
-(return " + return_variables + (DEBUG_KRATOS ? " ;; EO output vars. Due to debug mode, the internal vars are returned, as well.\n" + declarations : "") + "\n)\n";
-   s += std::string("(locals\n") + (DEBUG_KRATOS ? "" : declarations) + ")\n";
+   out << "\n" << StaticHelper::createKratosNdetFunction("ndet_int2", { "int" , "int" });
+   out << "\n" << StaticHelper::createKratosNdetFunction("ndet_bool2", { "bool" , "bool" });
 
-   s += +"\n(seq\n" + initializations + "\n";
+   out << "\n(entry " << /*dummy_func_name*/ entry_function_name << ")\n";
+   out << "(globals" << (native_env_model_wf ? " (! (var loc bool) :location-var true)" : "") << ")\n";
+   out << "(function " << entry_function_name << " (" << pars << "\n)\n(return " << return_variables;
+   if (DEBUG_KRATOS) out << " ;; EO output vars. Due to debug mode, the internal vars are returned, as well.\n" << declarations;
+   out << "\n)\n";
+   out << "(locals\n" << (DEBUG_KRATOS ? "" : declarations) << ")\n";
 
-   s += main_part;
-   s += ")\n)\n\n";
-   //s += std::string("(function ") + dummy_func_name + " () (return) (locals " + pars + " (var global_return_value int)) (call " + entry_function_name + " " + pars_plain + " global_return_value))";
-   s += "\n";
-
-   addDebug("Kreated Kratos code:\n" + s);
+   out << "\n(seq\n" << initializations << "\n";
 
-   return s;
+   out << main_part;
+   out << ")\n)\n\n";
+   //out << "(function " << dummy_func_name << " () (return) (locals " << pars << " (var global_return_value int)) (call " << entry_function_name << " " << pars_plain << " global_return_value))";
+   out << "\n";
+   out.flush();
 }
 
 void vfm::CppParser::inferRangeForLocalVariables()
@@ -5411,9 +5716,68 @@ void vfm::CppParser::inferRangeForLocalVariables()
 
    float current_count{ 0 };
    int old_percent{ 0 };
-   std::vector<std::pair<std::string, std::shared_ptr<TermVar>>> touched_items{};
 
-   applyToAllMCItems([this, &current_count, &old_percent, &node_count, &touched_items](const MathStructPtr m) {
+   std::vector<std::pair<std::string, std::string>> operators{}; // Operator id ==> (optor, optor of compound structure).
+   std::map<std::pair<std::string, std::string>, int> operator_ids{};
+
+   IntervalAnalysis analysis{ [this, &operators](const int operator_id, const IntervalAnalysis::Interval& range1, const IntervalAnalysis::Interval& range2) {
+      return getSingleRange(operators[operator_id].first, operators[operator_id].second, range1, range2);
+   } };
+
+   const auto get_variable_id = [this, &analysis](const std::string& var_name) {
+      const int num_variables{ analysis.getNumVariables() };
+      const int id{ analysis.getVariableId(var_name) };
+
+      if (id == num_variables) { // New variable, starts with its range from the TAL (or empty if it has none, yet).
+         analysis.setInitialInterval(id, type_abstraction_layer_->getRange(var_name));
+      }
+
+      return id;
+   };
+
+   const auto compile = [this, &analysis, &operators, &operator_ids, &get_variable_id](const MathStructPtr right_side) {
+      std::map<MathStructPtr, int> nodes{};
+
+      right_side->applyToMeAndMyChildrenIterative([this, &analysis, &operators, &operator_ids, &get_variable_id, &nodes](const MathStructPtr m) {
+         if (m->isTermVal()) {
+            nodes[m] = analysis.addConstant(m->constEval());
+         }
+         else if (m->isTermVar()) {
+            nodes[m] = analysis.addVariable(get_variable_id(StaticHelper::cleanVarNameOfPossibleRefSymbol(m->toVariableIfApplicable()->getVariableName())));
+         }
+         else {
+            std::vector<int> operands{};
+
+            for (const auto& operand : m->getTermsJumpIntoCompounds()) {
+               operands.push_back(nodes.at(operand));
+            }
+
+            if (operands.size() > 2) {
+               addError("Operator '" + m->getOptor() + "' has " + std::to_string(operands.size()) + ">2 operands which is not covered for range extraction.");
+            }
+
+            const std::pair<std::string, std::string> optor{
+               m->getOptor(),
+               m->isTermCompound() ? m->toTermCompoundIfApplicable()->getCompoundStructure()->getOptor() : "" };
+            const auto inserted{ operator_ids.insert({ optor, (int) operators.size() }) };
+
+            if (inserted.second) {
+               operators.push_back(optor);
+            }
+
+            nodes[m] = analysis.addOperator(inserted.first->second, operands);
+         }
+      }, TraverseCompoundsType::avoid_compound_structures, FormulaTraversalType::PostOrder);
+
+      return nodes.at(right_side);
+   };
+
+   // First pass: Give boolean and enum targets their type range, collect the assignments to number targets.
+   std::vector<std::pair<std::string, MathStructPtr>> number_assignments{};
+   std::map<std::string, std::shared_ptr<TermVar>> number_targets{};
+   std::vector<std::string> number_targets_in_order{};
+
+   applyToAllMCItems([this, &current_count, &old_percent, &node_count, &number_assignments, &number_targets, &number_targets_in_order](const MathStructPtr m) {
       current_count++;
       int percent = (int) (100 * current_count / node_count);
 
@@ -5431,50 +5795,23 @@ void vfm::CppParser::inferRangeForLocalVariables()
          auto m_var_name{ StaticHelper::cleanVarNameOfPossibleRefSymbol(m->toVariableIfApplicable()->getVariableName()) };
 
          if (StaticHelper::stringContains(m_var_name, TEMP_VAR_BASE_NAME) || !isLocalVarName(m_var_name).empty()) {
-            auto old_range = type_abstraction_layer_->hasRange(m_var_name)
-               ? type_abstraction_layer_->getRange(m_var_name)
-               : std::pair<float, float>({ 1, 0 });
-            
-            addDebug("Extending range (" + std::to_string(old_range.first) + ".." + std::to_string(old_range.second) + ") for variable '" + m_var_name + "' in line '" + m->getFather()->serialize() + "'.");
-
             if (types_of_variables_.count(m_var_name)) {
                auto cpp_type = types_of_variables_.at(m_var_name).first;
 
                if (cpp_type->toBoolIfApplicable()) {
-                  addDebug("Found boolean type, inferring range (0..1). TODO: Using our cool range inferral method, we might reduce this to a constant in some cases.");
+                  addDebug("Found boolean type for '" + m_var_name + "', inferring range (0..1). TODO: Using our cool range inferral method, we might reduce this to a constant in some cases.");
                   type_abstraction_layer_->addBooleanVariable(m_var_name, false);
                }
                else if (cpp_type->toEnumIfApplicable()) {
-                  addDebug("Found enum type, inferring full enum range. TODO: Using our cool range inferral method, we might reduce this to a subset/constant in some cases.");
+                  addDebug("Found enum type for '" + m_var_name + "', inferring full enum range. TODO: Using our cool range inferral method, we might reduce this to a subset/constant in some cases.");
                   type_abstraction_layer_->addVariableWithEnumType(m_var_name, cpp_type->toEnumIfApplicable());
                }
                else {
-                  addDebug("Found number type, inferring range from atomic variables...");
-
-                  auto pair = deriveGlobalRangeFromLeafRanges(m->getFather()->getTermsJumpIntoCompounds()[1]);
-
-                  if (pair.first > pair.second) {
-                     addError("Invalid range <" + std::to_string(pair.first) + ".." + std::to_string(pair.second) + "> received for '" + m_var_name + "'.");
-                  }
-
-                  type_abstraction_layer_->extendOrSetRangeOfIntVariable(m_var_name, pair.first, pair.second);
-
-                  auto new_range = type_abstraction_layer_->getRange(m_var_name);
-
-                  addDebug("New range is: (" + std::to_string(pair.first) + ".." + std::to_string(pair.second) + ").");
-                  addDebug("Extended to : (" + std::to_string(new_range.first) + ".." + std::to_string(new_range.second) + ").");
+                  number_assignments.push_back({ m_var_name, m->getFather()->getTermsJumpIntoCompounds()[1] });
 
-                  touched_items.push_back({ m_var_name, m->toVariableIfApplicable() });
-
-                  if (global_primitives_init_values_.count(m_var_name) && global_primitives_init_values_[m_var_name] == FIGURE_OUT_RANDOM_VALUE_FROM_RANGE_LATER) {
-                     const auto& range = type_abstraction_layer_->getRange(m_var_name);
-                     const int some_random_init_value = range.first;
-                     const std::string some_random_init_value_str = _val(some_random_init_value)->serialize();
-
-                     addDebug("{{inferRangeForLocalVariables}} Initial value of variable '" + m_var_name + "' is '" + some_random_init_value_str + "'.");
-
-                     type_abstraction_layer_->setInitValueOf(m_var_name, some_random_init_value_str);
-                     global_primitives_init_values_[m_var_name] = some_random_init_value;
+                  if (!number_targets.count(m_var_name)) {
+                     number_targets.insert({ m_var_name, m->toVariableIfApplicable() });
+                     number_targets_in_order.push_back(m_var_name);
                   }
                }
             }
@@ -5485,14 +5822,54 @@ void vfm::CppParser::inferRangeForLocalVariables()
       }
    }, false);
 
+   // Second pass: Solve all assignments to number targets together, so that a variable used before
+   // (or in) its own assignment gets the same range as if the program was processed in data flow order.
+   for (const auto& assignment : number_assignments) {
+      const int target{ get_variable_id(assignment.first) };
+      analysis.addAssignment(target, compile(assignment.second));
+   }
+
+   const long evaluations{ analysis.solve() };
+
+   addDebug("{{inferRangeForLocalVariables}} Fixpoint reached after " + std::to_string(evaluations) + " evaluations of " + std::to_string(number_assignments.size()) + " assignments to " + std::to_string(number_targets_in_order.size()) + " number variables.");
+
+   for (const auto& m_var_name : number_targets_in_order) {
+      const auto range{ analysis.getInterval(m_var_name) };
+
+      if (range.first > range.second) {
+         addError("Invalid range <" + std::to_string(range.first) + ".." + std::to_string(range.second) + "> received for '" + m_var_name + "'.");
+         continue;
+      }
+
+      type_abstraction_layer_->extendOrSetRangeOfIntVariable(m_var_name, range.first, range.second);
+      addDebug("Inferred range (" + std::to_string(range.first) + ".." + std::to_string(range.second) + ") for variable '" + m_var_name + "'.");
+
+      if (global_primitives_init_values_.count(m_var_name) && global_primitives_init_values_[m_var_name] == FIGURE_OUT_RANDOM_VALUE_FROM_RANGE_LATER) {
+         const int some_random_init_value = type_abstraction_layer_->getRange(m_var_name).first;
+         const std::string some_random_init_value_str = _val(some_random_init_value)->serialize();
+
+         addDebug("{{inferRangeForLocalVariables}} Initial value of variable '" + m_var_name + "' is '" + some_random_init_value_str + "'.");
+
+         type_abstraction_layer_->setInitValueOf(m_var_name, some_random_init_value_str);
+         global_primitives_init_values_[m_var_name] = some_random_init_value;
+      }
+   }
+
    resumeOutputOfMessages();
 
-   for (const auto& item : touched_items) {
-      const auto& range = type_abstraction_layer_->getRange(item.first);
+   for (const int id : analysis.getVariablesWithFrozenBounds()) {
+      const auto range{ analysis.getInterval(id) };
+      addWarning("Range of '" + analysis.getVariableName(id) + "' did not stabilize, stopped widening at (" + std::to_string(range.first) + ".." + std::to_string(range.second) + "). Values beyond may be cut off.");
+   }
+
+   for (const auto& m_var_name : number_targets_in_order) {
+      if (!type_abstraction_layer_->hasRange(m_var_name)) continue;
+
+      const auto& range = type_abstraction_layer_->getRange(m_var_name);
 
       if (range.first == range.second) {
-         addNote("Range of '" + item.first + "' decayed to constant value '" + std::to_string(range.first) + "'. I'll make it a constant.");
-         setTypeOrSubTypeConstSafe(item.first, range.first, item.second);
+         addNote("Range of '" + m_var_name + "' decayed to constant value '" + std::to_string(range.first) + "'. I'll make it a constant.");
+         setTypeOrSubTypeConstSafe(m_var_name, range.first, number_targets.at(m_var_name));
       }
    }
 }
@@ -5945,17 +6322,9 @@ std::string vfm::CppParser::getInitVarStringNuSMVOrKratos(
    std::string s = "   ";
 
    if (init) {
-      auto val_fmla = MathStruct::parseMathStruct(type_abstraction_layer_->getInitValueFor(evar_doublecolon_reverted), parser_, data_)->toTermIfApplicable();
-
-      if (kratos) {
-         //if (data_->isVarDeclared(evar_raw)) {
-         //   val_fmla = _val(data_->getSingleVal(evar_raw));
-         //}
-
-         val_fmla = _set_alt(_var(evar), val_fmla);
-      }
-
-      std::string val{ kratos ? val_fmla->serializeK2(enum_values, additional_functions) : val_fmla->serializeNuSMV(data_, parser_) };
+      std::string val{ kratos
+         ? getInitAssignmentKratos(evar_raw)->serializeK2(enum_values, additional_functions)
+         : MathStruct::parseMathStruct(type_abstraction_layer_->getInitValueFor(evar_doublecolon_reverted), parser_, data_)->toTermIfApplicable()->serializeNuSMV(data_, parser_) };
 
       //if (!kratos && evar == current_state_var_name) { // Only for old-style nuxmv translation modes.
       //   val = getStateVarName(INVALID_STATE_NUM, false);
@@ -5993,6 +6362,93 @@ std::string vfm::CppParser::getInitVarStringNuSMVOrKratos(
    return s;
 }
 
+TermPtr vfm::CppParser::getInitAssignmentKratos(const std::string& evar_raw) const
+{
+   const std::string evar{ StaticHelper::makeVarNameNuSMVReady(evar_raw) };
+
+   if (all_constants_to_model_checker_.count(evar)) {
+      return nullptr;
+   }
+
+   auto val_fmla = MathStruct::parseMathStruct(type_abstraction_layer_->getInitValueFor(StaticHelper::replaceAll(evar, "____", "::")), parser_, data_)->toTermIfApplicable();
+
+   //if (data_->isVarDeclared(evar_raw)) {
+   //   val_fmla = _val(data_->getSingleVal(evar_raw));
+   //}
+
+   return _set_alt(_var(evar), val_fmla);
+}
+
+std::vector<std::string> vfm::CppParser::serializeKratosInitializations(
+   const std::vector<TermPtr>& init_assignments,
+   const std::map<std::string, std::string>& enum_values,
+   std::pair<std::map<std::string, std::string>, std::string>& additional_functions) const
+{
+   const int num_threads{ node_parallelism_threads_ > 0 ? node_parallelism_threads_ : (std::max)(1, (int) std::thread::hardware_concurrency()) };
+   const int chunk_size{ (std::max)(min_nodes_per_parallel_job_, (int) (init_assignments.size() + num_threads - 1) / num_threads) };
+   const int num_chunks{ (int) (init_assignments.size() + chunk_size - 1) / chunk_size };
+   std::vector<StringSink> chunks(num_chunks);
+   std::vector<std::vector<size_t>> chunk_ends(num_chunks); // Where each initialization ends within the chunk.
+   std::vector<std::pair<std::map<std::string, std::string>, std::string>> chunk_functions(num_chunks, additional_functions);
+
+   const auto serialize_chunk = [&](const int chunk, std::pair<std::map<std::string, std::string>, std::string>& functions) {
+      const int end{ (std::min)((chunk + 1) * chunk_size, (int) init_assignments.size()) };
+      chunks[chunk] = StringSink{};
+      chunk_ends[chunk].clear();
+
+      for (int i = chunk * chunk_size; i < end; i++) {
+         if (init_assignments[i]) {
+            int label_counter{ 0 };
+            chunks[chunk] << "   ";
+            init_assignments[i]->serializeK2(chunks[chunk], enum_values, functions, label_counter);
+            chunks[chunk] << "\n";
+         }
+
+         chunk_ends[chunk].push_back(chunks[chunk].str().size());
+      }
+   };
+
+   if (num_chunks == 1) {
+      serialize_chunk(0, additional_functions);
+   }
+   else if (num_chunks > 1) {
+      const size_t num_functions_before{ additional_functions.first.size() };
+
+      { // Scope which makes us wait for finishing the jobs before merging.
+         ThreadPool pool(num_threads);
+
+         for (int chunk = 0; chunk < num_chunks; chunk++) {
+            pool.enqueue([&serialize_chunk, &chunk_functions, chunk] {
+               serialize_chunk(chunk, chunk_functions[chunk]);
+            });
+         }
+      }
+
+      for (int chunk = 0; chunk < num_chunks; chunk++) {
+         if (chunk_functions[chunk].first.size() == num_functions_before) {
+            continue;
+         }
+
+         // The chunk created ndet functions, which are numbered by creation order. Doing it again based on all functions
+         // created so far yields the same names as a serial run would.
+         serialize_chunk(chunk, additional_functions);
+      }
+   }
+
+   std::vector<std::string> initializations{};
+
+   for (int chunk = 0; chunk < num_chunks; chunk++) {
+      size_t begin{ 0 };
+
+      for (const auto end : chunk_ends[chunk]) {
+         initializations.push_back(chunks[chunk].str().substr(begin, end - begin));
+         begin = end;
+      }
+   }
+
+   return initializations;
+}
+
 std::string vfm::CppParser::getCommandLineArgument() const
 {
    return command_line_argument_;
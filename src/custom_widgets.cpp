@@ -8,6 +8,7 @@
 #include "gui/custom_widgets.h"
 #include "gui/gui.h"
 #include "gui/process_helper.h"
+#include "model_checking/process_runner.h"
 
 #include <filesystem>
 
@@ -688,7 +689,9 @@ void vfm::SingleExpController::cancelButtonCallback(Fl_Widget* widget, void* dat
    if (Fl::event_button() == FL_RIGHT_MOUSE) {
       std::string job_id{ sec->my_id_ };
       sec->mc_scene_->addNote("Sending kill signal to all jobs matching '" + job_id + "'.");
-      auto pids = Process().getPIDs(job_id);
+      const int num_cancelled{ mc::ProcessRunner::cancelAllMatching(job_id) }; // Model checker runs spawned from within this vfm instance.
+      if (num_cancelled) sec->mc_scene_->addNote("Cancelled " + std::to_string(num_cancelled) + " managed model checker process(es).");
+      auto pids = Process().getPIDs(job_id); // Anything else, e.g., processes spawned by another vfm instance.
 
       for (const auto& pid : pids) {
          sec->mc_scene_->addNote("Sending kill signal for PID '" + std::to_string(pid) + "'.");
@@ -57,7 +57,7 @@ bool vfm::DataPack::isStaticArray(const int arr_reference) const
 
 float DataPack::getArrayVal(const std::string& arr_name, const int index) const
 {
-   return getArrayVal(vfm_memory_.at(names_to_addresses_.at(arr_name)), index);
+   return getArrayVal(vfm_memory_.get(names_to_addresses_.at(arr_name)), index);
 }
 
 float DataPack::getArrayVal(const int arr_reference, const int index) const
@@ -83,7 +83,7 @@ float DataPack::getArrayVal(const int arr_reference, const int index) const
 
 void DataPack::setArrayVal(const std::string& arr_name, const int index, const float val)
 {
-   setArrayVal(vfm_memory_.at(names_to_addresses_.at(arr_name)), index, val);
+   setArrayVal(vfm_memory_.get(names_to_addresses_.at(arr_name)), index, val);
 }
 
 void DataPack::setArrayVal(const int arr_reference, const int index, const float val)
@@ -175,7 +175,7 @@ void DataPack::addOrSetSingleVal(const std::string& name_orig, float val, const
       addFatalError("Could not store variable '" + name + "' in memory.");
    }
 
-   vfm_memory_.at(address) = val;
+   vfm_memory_.set(address, val);
    registerAddress(name);
 
    if (hidden) {
@@ -238,7 +238,7 @@ float DataPack::getSingleVal(const std::string& name_orig) const
       return 0;
    }
 
-   return vfm_memory_.at(names_to_addresses_.at(var_name));
+   return vfm_memory_.get(names_to_addresses_.at(var_name));
 }
 
 void vfm::DataPack::addSingleValIfUndeclared(const std::string& name_orig, const bool hidden, const float init_val)
@@ -348,7 +348,7 @@ void vfm::DataPack::setHeapLocation(const int reference, const float val)
    }
 #endif
 
-   vfm_memory_.at(reference) = val;
+   vfm_memory_.set(reference, val);
 
    highest_defined_heap_index_above_free_ = (std::max)(highest_defined_heap_index_above_free_, reference);
 }
@@ -381,7 +381,7 @@ float vfm::DataPack::getHeapLocation(const int reference) const
 #endif
 
    // TODO: Check if in "used" heap range?
-   return vfm_memory_.at(reference);
+   return vfm_memory_.get(reference);
 }
 
 void DataPack::addArrayAndOrSetArrayVal(const std::string& name, const int& index, const float& val, const ArrayMode mode_if_new)
@@ -514,7 +514,7 @@ float* DataPack::getAddressOfSingleVal(const std::string& name) const
       const_cast<DataPack*>(this)->addOrSetSingleVal(var_name, 0);
    }
 
-   return (float*) &vfm_memory_.at(names_to_addresses_.at(new_name));
+   return const_cast<VfmHeap&>(vfm_memory_).getCellAddress(names_to_addresses_.at(new_name));
 }
 
 #define DEFAULT_EXTERNAL_ADDRESS_METHOD_BODY(TYPE, ASSOCIATION_TYPE) \
@@ -809,14 +809,8 @@ void DataPack::reset()
    enum_variables_.clear();
    hidden_vars_.clear();
 
-   if (vfm_memory_.size() != VFM_HEAP_SIZE) {
-      precalculated_external_addresses_.resize(VFM_HEAP_SIZE);
-      vfm_memory_.resize(VFM_HEAP_SIZE);
-
-      for (int i = 0; i < VFM_HEAP_SIZE; i++) {
-         vfm_memory_.at(i) = VFM_HEAP_EMPTY_VALUE;
-      }
-   }
+   // Note that the heap cells are not touched here. Pages get allocated when first written to,
+   // and existing pages stay where they are since JIT-compiled code may point into them.
 
    declareVariable("true", true, false);
    declareVariable("false", true, false);
@@ -827,7 +821,7 @@ void DataPack::reset()
 #define DEFAULT_ASSOCIATION_FUNCTION(EXTERNAL_ADDRESSES) \
 [](\
       const int heap_address, \
-      const std::vector<float>& f,\
+      const VfmHeap& f,\
       const std::string& optional_var_name,\
       const std::map<const std::string, int>& names_to_addresses, \
       const std::map<const int, std::string>& addresses_to_names,\
@@ -853,6 +847,7 @@ void DataPack::reset()
    addAssociationFunctionToExternalValue(DEFAULT_ASSOCIATION_FUNCTION(external_float_addresses), AssociationType::Float);
    addAssociationFunctionToExternalValue(DEFAULT_ASSOCIATION_FUNCTION(external_char_addresses), AssociationType::Char);
    addAssociationFunctionToExternalValue(DEFAULT_ASSOCIATION_FUNCTION(external_bool_addresses), AssociationType::Bool);
+   has_custom_association_functions_ = false;
 #endif
 
    script_data_.reset();
@@ -874,9 +869,7 @@ void DataPack::initializeValuesBy(const DataPack& other)
       stack_terms_for_meta_.push_back(stm);
    }
 
-   for (int i = 0; i < other.getUsedHeapSize(); i++) {
-      vfm_memory_.at(i) = other.vfm_memory_.at(i);
-   }
+   vfm_memory_.copyRangeFrom(other.vfm_memory_, other.getUsedHeapSize());
 
    for (const auto& v : other.internal_variables_) {
       internal_variables_.insert(v);
@@ -934,11 +927,20 @@ void DataPack::initializeValuesBy(const DataPack& other)
          association_functions_.at(pair.first).push_back(f);
       }
    }
+
+   has_custom_association_functions_ = other.has_custom_association_functions_;
 #endif
 
    script_data_ = other.script_data_;
 }
 
+std::shared_ptr<DataPack> vfm::DataPack::fork() const
+{
+   auto copy{ std::make_shared<DataPack>() };
+   copy->initializeValuesBy(*this);
+   return copy;
+}
+
 void vfm::DataPack::initializeValuesBy(const std::shared_ptr<DataPack> other)
 {
    if (other) initializeValuesBy(*other);
@@ -1015,6 +1017,8 @@ bool vfm::DataPack::hasEqualData(
    }
 
    for (const auto& var_name : var_names) {
+      if (sharesHeapCellWith(other, var_name)) continue; // Unchanged since one was forked from the other.
+
       int val1 = this->getSingleVal(var_name);
       int val2 = other.getSingleVal(var_name);
 
@@ -1030,6 +1034,30 @@ bool vfm::DataPack::hasEqualData(
    return true;
 }
 
+bool vfm::DataPack::sharesHeapCellWith(const DataPack& other, const std::string& var_name) const
+{
+#ifndef DISALLOW_EXTERNAL_ASSOCIATIONS
+   if (has_custom_association_functions_ || other.has_custom_association_functions_) return false;
+#endif
+
+   for (const DataPack* data : { this, &other }) {
+      if (data->static_external_bool_addresses_.count(var_name)
+         || data->static_external_char_addresses_.count(var_name)
+         || data->static_external_float_addresses_.count(var_name)
+         || data->private_vars_recursive_levels_.count(var_name)) {
+         return false;
+      }
+   }
+
+   const auto it_this = names_to_addresses_.find(var_name);
+   const auto it_other = other.names_to_addresses_.find(var_name);
+
+   return it_this != names_to_addresses_.end()
+      && it_other != other.names_to_addresses_.end()
+      && it_this->second == it_other->second
+      && vfm_memory_.sharesPageWith(other.vfm_memory_, it_this->second >> VfmHeap::PAGE_BITS);
+}
+
 bool vfm::DataPack::isHidden(const std::string & var_name) const
 {
    return hidden_vars_.count(var_name);
@@ -1342,6 +1370,10 @@ void vfm::DataPack::precalculateExternalAddresses(int max_address_exclusive, int
    assert(min_address_inclusive <= max_address_exclusive);
    assert(max_address_exclusive <= VFM_HEAP_SIZE);
 
+   if (precalculated_external_addresses_.empty()) {
+      precalculated_external_addresses_.resize(VFM_HEAP_SIZE); // Once and for all, JIT code keeps pointers into it.
+   }
+
    for (int reference = min_address_inclusive; reference < max_address_exclusive; reference++) {
       precalculated_external_addresses_.at(reference) = nullptr;
 
@@ -1356,14 +1388,14 @@ void vfm::DataPack::precalculateExternalAddresses(int max_address_exclusive, int
       }
 
       if (!precalculated_external_addresses_.at(reference)) {
-         precalculated_external_addresses_.at(reference) = &vfm_memory_.at(reference);
+         precalculated_external_addresses_.at(reference) = vfm_memory_.getCellAddress(reference);
       }
    }
 
    external_addresses_need_recalculation_from_ = max_address_exclusive;
 }
 
-std::vector<void*> vfm::DataPack::getPrecalculatedExternalAddresses()
+const std::vector<void*>& vfm::DataPack::getPrecalculatedExternalAddresses() const
 {
    return precalculated_external_addresses_;
 }
@@ -1376,6 +1408,7 @@ void vfm::DataPack::setParserForProgramParsing(const std::shared_ptr<FormulaPars
 void vfm::DataPack::addAssociationFunctionToExternalValue(const AssociationFunction& f, const AssociationType type)
 {
    association_functions_.at(type).push_back(f);
+   has_custom_association_functions_ = true;
    external_addresses_need_recalculation_from_ = 0;
 }
 
@@ -1383,7 +1416,7 @@ void vfm::DataPack::addAssociationFunctionToExternalValue(const AssociationFunct
 {
    addAssociationFunctionToExternalValue([f](
       const int heap_address,
-      const std::vector<float>& vfm_memory,
+      const VfmHeap& vfm_memory,
       const std::string& optional_var_name,
       const std::map<const std::string, int>& names_to_addresses, 
       const std::map<const int, std::string>& addresses_to_names,
@@ -1398,7 +1431,7 @@ void vfm::DataPack::addAssociationFunctionToExternalValue(const AssociationFunct
 {
    addAssociationFunctionToExternalValue([f]( // Call core method rather than indirect call.
       const int heap_address,
-      const std::vector<float>& vfm_memory,
+      const VfmHeap& vfm_memory,
       const std::string& optional_var_name,
       const std::map<const std::string, int>& names_to_addresses, 
       const std::map<const int, std::string>& addresses_to_names,
@@ -1413,7 +1446,7 @@ void vfm::DataPack::addAssociationFunctionToExternalValue(const AssociationFunct
 {
    addAssociationFunctionToExternalValue([f]( // Call core method rather than indirect call.
       const int heap_address,
-      const std::vector<float>& vfm_memory,
+      const VfmHeap& vfm_memory,
       const std::string& optional_var_name,
       const std::map<const std::string, int>& names_to_addresses, 
       const std::map<const int, std::string>& addresses_to_names,
@@ -1511,7 +1544,7 @@ std::set<std::string> vfm::DataPack::getAllArrayNamesMatchingRegex(const std::st
    return set;
 }
 
-std::vector<float> vfm::DataPack::getVfmMemory() const
+const VfmHeap& vfm::DataPack::getVfmMemory() const
 {
    return vfm_memory_;
 }
@@ -106,11 +106,13 @@ void Equation::rearrange(const std::shared_ptr<Term>& inv_term, const std::share
       doit = find([](std::shared_ptr<MathStruct> m) {return m->isMetaCompound(); }, inv_term, trace, dirs);
       if (doit) {
          trace[1]->getOperands()[dirs[1]] = getOperands()[from_left]->copy();
+         trace[1]->invalidateAttributes();
       }
    }
 
    this->getOperands()[from_left] = inv_term;
    this->getOperands()[!from_left] = other_side;
+   invalidateAttributes();
 }
 
 bool Equation::resolveTo(const std::function<bool(std::shared_ptr<MathStruct>)>& match_cond, bool from_left)
@@ -0,0 +1,365 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+
+#include "fsm_graph_renderer.h"
+#include "static_helper.h"
+#include <algorithm>
+#include <deque>
+#include <set>
+
+using namespace vfm;
+using namespace fsm;
+
+namespace {
+
+constexpr int MARGIN{ 20 };
+constexpr int NODE_PADDING{ 8 };
+constexpr int NODE_GAP{ 30 };
+constexpr int LAYER_GAP{ 60 };
+constexpr int MAX_LABEL_LINE_LENGTH{ 40 };
+constexpr float ARROW_LENGTH{ 10 };
+constexpr float ARROW_HALF_WIDTH{ 4 };
+
+const Color EDGE_COLOR{ DARK_GREY };
+const Color NODE_FRAME_COLOR{ BLACK };
+const Color NODE_FILL_COLOR{ WHITE };
+const Color CURRENT_NODE_FILL_COLOR{ ORANGE }; // Same as CURRENT_STATE_BACKGROUND_COLOR in the DOT output.
+
+const auto OVERWRITE = [](const Color& /*old_pix*/, const Color& new_pix) -> Color { return new_pix; };
+
+Vec2Df centerOf(const FSMGraphRenderer::NodeGeometry& node)
+{
+   return { node.x_ + node.width_ / 2, node.y_ + node.height_ / 2 };
+}
+
+/// Point where the ray from the center of the node towards target leaves the node's box.
+Vec2Df borderPoint(const FSMGraphRenderer::NodeGeometry& node, const Vec2Df& target)
+{
+   const Vec2Df center{ centerOf(node) };
+   const float dx{ target.x - center.x };
+   const float dy{ target.y - center.y };
+
+   if (dx == 0 && dy == 0) {
+      return center;
+   }
+
+   const float scale_x{ dx != 0 ? (node.width_ / 2) / std::abs(dx) : std::numeric_limits<float>::infinity() };
+   const float scale_y{ dy != 0 ? (node.height_ / 2) / std::abs(dy) : std::numeric_limits<float>::infinity() };
+   const float scale{ std::min(scale_x, scale_y) };
+
+   return { center.x + dx * scale, center.y + dy * scale };
+}
+
+Pol2Df boxPolygon(const FSMGraphRenderer::NodeGeometry& node)
+{
+   Pol2Df pol{};
+   pol.add({ node.x_, node.y_ });
+   pol.add({ node.x_ + node.width_, node.y_ });
+   pol.add({ node.x_ + node.width_, node.y_ + node.height_ });
+   pol.add({ node.x_, node.y_ + node.height_ });
+   return pol;
+}
+
+} // namespace
+
+FSMGraphRenderer::FSMGraphRenderer(const FSMGraphTopology& topology) : Failable("FSMGraphRenderer")
+{
+   layout(topology);
+
+   base_ = Image(width_, height_);
+   base_.fillImg(WHITE);
+   paintGraph(base_);
+   current_image_ = base_;
+}
+
+const Image& FSMGraphRenderer::render(const int current_state)
+{
+   if (current_state == current_state_) {
+      return current_image_;
+   }
+
+   if (nodes_.count(current_state_)) { // Un-mark the previous state.
+      const NodeGeometry& old{ nodes_.at(current_state_) };
+      const int x0{ (int) old.x_ - 1 };
+      const int y0{ (int) old.y_ - 1 };
+      current_image_.insertImage(x0, y0, base_.copyArea(x0, y0, x0 + (int) old.width_ + 3, y0 + (int) old.height_ + 3), false, OVERWRITE);
+   }
+
+   if (nodes_.count(current_state)) {
+      paintNode(current_image_, current_state, true);
+   }
+   else if (current_state >= 0) {
+      addWarning("State " + std::to_string(current_state) + " is not part of the rendered graph.");
+   }
+
+   current_state_ = current_state;
+   return current_image_;
+}
+
+void FSMGraphRenderer::store(const int current_state, const std::string& filename, const OutputType type)
+{
+   if (type != OutputType::pdf) {
+      render(current_state).store(filename, type);
+      return;
+   }
+
+   // Vector output can't be patched, but at least painting it from the cached layout is cheap.
+   Image pdf_image(width_, height_);
+   pdf_image.startOrKeepUpPDF();
+   pdf_image.fillImg(WHITE);
+   paintGraph(pdf_image);
+
+   if (nodes_.count(current_state)) {
+      paintNode(pdf_image, current_state, true);
+   }
+
+   pdf_image.store(filename, OutputType::pdf);
+   pdf_image.flushAndStopPDF();
+}
+
+bool FSMGraphRenderer::startAnimation(const std::string& filename, const int frame_delay_hundredths)
+{
+   finishAnimation();
+   frame_delay_ = frame_delay_hundredths;
+   animation_running_ = GifBegin(&gif_writer_, filename.c_str(), width_, height_, frame_delay_);
+
+   if (!animation_running_) {
+      addError("Could not start animation '" + filename + "'.");
+   }
+
+   return animation_running_;
+}
+
+void FSMGraphRenderer::addAnimationFrame(const int current_state)
+{
+   if (!animation_running_) {
+      addError("No animation running, call startAnimation first.");
+      return;
+   }
+
+   render(current_state);
+   const auto raw{ current_image_.getRawImage() };
+   GifWriteFrame(&gif_writer_, (const uint8_t*) raw.data(), width_, height_, frame_delay_);
+}
+
+void FSMGraphRenderer::finishAnimation()
+{
+   if (animation_running_) {
+      GifEnd(&gif_writer_);
+      animation_running_ = false;
+   }
+}
+
+bool FSMGraphRenderer::isAnimationRunning() const
+{
+   return animation_running_;
+}
+
+const FSMGraphRenderer::NodeGeometry& FSMGraphRenderer::getNodeGeometry(const int state) const
+{
+   return nodes_.at(state);
+}
+
+int FSMGraphRenderer::getWidth() const
+{
+   return width_;
+}
+
+int FSMGraphRenderer::getHeight() const
+{
+   return height_;
+}
+
+void FSMGraphRenderer::layout(const FSMGraphTopology& topology)
+{
+   std::map<int, std::vector<int>> successors{};
+   std::map<int, std::vector<int>> predecessors{};
+   std::map<int, int> layer_of{};
+   std::vector<std::vector<int>> layers{};
+
+   for (const auto& [source, destination] : topology.transitions_) {
+      successors[source].push_back(destination);
+      predecessors[destination].push_back(source);
+      edges_.push_back({ source, destination });
+   }
+
+   // Layers by BFS distance from the initial state; states not reachable from there
+   // start a BFS of their own in the layers below.
+   std::vector<int> roots{};
+
+   if (std::find(topology.states_.begin(), topology.states_.end(), topology.initial_state_) != topology.states_.end()) {
+      roots.push_back(topology.initial_state_);
+   }
+
+   roots.insert(roots.end(), topology.states_.begin(), topology.states_.end());
+
+   for (const int root : roots) {
+      if (layer_of.count(root)) continue;
+
+      const int first_layer{ (int) layers.size() };
+      std::deque<int> queue{ root };
+      layer_of[root] = first_layer;
+
+      while (!queue.empty()) {
+         const int state{ queue.front() };
+         const int layer{ layer_of.at(state) };
+         queue.pop_front();
+
+         if (layer >= (int) layers.size()) {
+            layers.resize(layer + 1);
+         }
+
+         layers[layer].push_back(state);
+
+         for (const int next : successors[state]) {
+            if (!layer_of.count(next)) {
+               layer_of[next] = layer + 1;
+               queue.push_back(next);
+            }
+         }
+      }
+   }
+
+   // One barycenter sweep top-down to reduce crossings.
+   std::map<int, int> index_of{};
+
+   for (size_t l = 0; l < layers.size(); l++) {
+      if (l > 0) {
+         std::map<int, float> barycenter{};
+
+         for (const int state : layers[l]) {
+            float sum{ 0 };
+            int count{ 0 };
+
+            for (const int pred : predecessors[state]) {
+               if (layer_of.at(pred) == (int) l - 1) {
+                  sum += index_of.at(pred);
+                  count++;
+               }
+            }
+
+            barycenter[state] = count ? sum / count : std::numeric_limits<float>::max();
+         }
+
+         std::stable_sort(layers[l].begin(), layers[l].end(), [&barycenter](const int a, const int b) { return barycenter.at(a) < barycenter.at(b); });
+      }
+
+      for (size_t i = 0; i < layers[l].size(); i++) {
+         index_of[layers[l][i]] = i;
+      }
+   }
+
+   // Node sizes from the labels, then coordinates, each layer centered.
+   const Image glyph{ Image::getAsciiImage('M', Image::MONOSPACE_NEW_CACHED_ASCII_TABLE) };
+   const int char_width{ std::max(glyph.getWidth(), 1) };
+   const int line_height{ std::max(glyph.getHeight(), 1) + 2 };
+   std::vector<float> layer_widths(layers.size(), 0);
+   std::vector<float> layer_heights(layers.size(), 0);
+
+   for (size_t l = 0; l < layers.size(); l++) {
+      for (const int state : layers[l]) {
+         NodeGeometry& node{ nodes_[state] };
+         const auto label_it{ topology.labels_.find(state) };
+         size_t max_len{ 1 };
+
+         for (const auto& line : StaticHelper::split(label_it != topology.labels_.end() ? label_it->second : std::to_string(state), '\n')) {
+            node.label_lines_.push_back(StaticHelper::shortenToMaxSize(line, MAX_LABEL_LINE_LENGTH));
+            max_len = std::max(max_len, node.label_lines_.back().size());
+         }
+
+         node.width_ = max_len * char_width + 2 * NODE_PADDING;
+         node.height_ = node.label_lines_.size() * line_height + 2 * NODE_PADDING;
+         layer_widths[l] += node.width_ + (layer_widths[l] > 0 ? NODE_GAP : 0);
+         layer_heights[l] = std::max(layer_heights[l], node.height_);
+      }
+   }
+
+   const float max_width{ layers.empty() ? 0 : *std::max_element(layer_widths.begin(), layer_widths.end()) };
+   float y{ MARGIN };
+
+   for (size_t l = 0; l < layers.size(); l++) {
+      float x{ MARGIN + (max_width - layer_widths[l]) / 2 };
+
+      for (const int state : layers[l]) {
+         NodeGeometry& node{ nodes_.at(state) };
+         node.x_ = x;
+         node.y_ = y + (layer_heights[l] - node.height_) / 2;
+         x += node.width_ + NODE_GAP;
+      }
+
+      y += layer_heights[l] + LAYER_GAP;
+   }
+
+   width_ = std::max(1, (int) (max_width + 2 * MARGIN + 20)); // Some space for self-loops on the right.
+   height_ = std::max(1, (int) (y - LAYER_GAP + MARGIN));
+}
+
+void FSMGraphRenderer::paintGraph(Image& img) const
+{
+   for (const auto& [source, destination] : edges_) {
+      paintEdge(img, source, destination);
+   }
+
+   for (const auto& [state, node] : nodes_) {
+      paintNode(img, state, false);
+   }
+}
+
+void FSMGraphRenderer::paintEdge(Image& img, const int source, const int destination) const
+{
+   if (!nodes_.count(source) || !nodes_.count(destination)) return;
+
+   const NodeGeometry& src{ nodes_.at(source) };
+   const NodeGeometry& dst{ nodes_.at(destination) };
+   Vec2Df tip{};
+   Vec2Df direction{};
+   Pol2Df line{};
+
+   if (source == destination) { // Self-loop on the right side of the box.
+      const float right{ src.x_ + src.width_ };
+      const float top{ src.y_ + src.height_ / 4 };
+      const float bottom{ src.y_ + src.height_ * 3 / 4 };
+      line.add({ right, top });
+      line.add({ right + 12, top });
+      line.add({ right + 12, bottom });
+      line.add({ right, bottom });
+      tip = { right, bottom };
+      direction = { -1, 0 };
+   }
+   else {
+      const Vec2Df from{ borderPoint(src, centerOf(dst)) };
+      tip = borderPoint(dst, centerOf(src));
+      line.add({ from.x, from.y });
+      line.add({ tip.x, tip.y });
+      direction = { tip.x - from.x, tip.y - from.y };
+      const float length{ std::sqrt(direction.x * direction.x + direction.y * direction.y) };
+      direction = length > 0 ? Vec2Df{ direction.x / length, direction.y / length } : Vec2Df{ 0, 1 };
+   }
+
+   img.drawPolygon(line, EDGE_COLOR, false);
+
+   const Vec2Df back{ tip.x - direction.x * ARROW_LENGTH, tip.y - direction.y * ARROW_LENGTH };
+   Pol2Df arrow{};
+   arrow.add({ tip.x, tip.y });
+   arrow.add({ back.x - direction.y * ARROW_HALF_WIDTH, back.y + direction.x * ARROW_HALF_WIDTH });
+   arrow.add({ back.x + direction.y * ARROW_HALF_WIDTH, back.y - direction.x * ARROW_HALF_WIDTH });
+   img.fillPolygon(arrow, EDGE_COLOR);
+}
+
+void FSMGraphRenderer::paintNode(Image& img, const int state, const bool current) const
+{
+   const NodeGeometry& node{ nodes_.at(state) };
+   const Pol2Df box{ boxPolygon(node) };
+   const int line_height{ (int) ((node.height_ - 2 * NODE_PADDING) / std::max<size_t>(node.label_lines_.size(), 1)) };
+
+   img.fillPolygon(box, current ? CURRENT_NODE_FILL_COLOR : NODE_FILL_COLOR);
+   img.drawPolygon(box, NODE_FRAME_COLOR);
+
+   for (size_t i = 0; i < node.label_lines_.size(); i++) {
+      img.writeAsciiText(node.x_ + NODE_PADDING, node.y_ + NODE_PADDING + i * line_height, node.label_lines_[i], CoordTrans::dont_do_it, false);
+   }
+}
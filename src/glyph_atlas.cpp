@@ -0,0 +1,114 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+
+#include "geometry/glyph_atlas.h"
+#include <algorithm>
+
+using namespace vfm;
+
+GlyphAtlas::GlyphAtlas(const std::vector<Image>& ascii_table)
+{
+   for (const auto& glyph : ascii_table) {
+      glyphs_.push_back({ width_, glyph.getWidth(), glyph.getHeight() });
+      width_ += glyph.getWidth();
+      height_ = (std::max)(height_, glyph.getHeight());
+   }
+
+   pixels_.assign(width_ * height_, BLACK);
+   ink_.assign(width_ * height_, false);
+
+   for (size_t i = 0; i < ascii_table.size(); i++) {
+      for (int x = 0; x < glyphs_[i].width_; x++) {
+         for (int y = 0; y < glyphs_[i].height_; y++) {
+            const Color col{ ascii_table[i].getPixel(x, y) };
+            pixels_[y * width_ + glyphs_[i].x_ + x] = col;
+            ink_[y * width_ + glyphs_[i].x_ + x] = col.r != 0 || col.g != 0 || col.b != 0;
+         }
+      }
+   }
+}
+
+const GlyphAtlas& GlyphAtlas::getMonospace()
+{
+   static const GlyphAtlas atlas{ Image::MONOSPACE_NEW_CACHED_ASCII_TABLE };
+   return atlas;
+}
+
+const GlyphAtlas::GlyphRect& GlyphAtlas::getGlyph(const char symbol) const
+{
+   if (symbol >= ' ' && symbol <= '~' && (size_t) (symbol - 32) < glyphs_.size()) {
+      return glyphs_[symbol - 32];
+   }
+
+   return glyphs_[glyphs_.size() - 1];
+}
+
+Color GlyphAtlas::getPixel(const GlyphRect& glyph, const int x, const int y) const
+{
+   return pixels_[y * width_ + glyph.x_ + x];
+}
+
+bool GlyphAtlas::isInk(const GlyphRect& glyph, const int x, const int y) const
+{
+   return ink_[y * width_ + glyph.x_ + x];
+}
+
+std::pair<int, int> GlyphAtlas::measure(const std::string& text) const
+{
+   int width{ 0 };
+   int height{ 0 };
+
+   for (const char c : text) {
+      width += getGlyph(c).width_;
+      height = getGlyph(c).height_;
+   }
+
+   return { width, height };
+}
+
+std::shared_ptr<const GlyphAtlas::RenderedLine> GlyphAtlas::renderLine(const std::string& line) const
+{
+   {
+      std::lock_guard<std::mutex> lock{ cache_mutex_ };
+      const auto it{ cache_.find(line) };
+
+      if (it != cache_.end()) return it->second;
+   }
+
+   auto rendered{ std::make_shared<RenderedLine>() };
+
+   for (const char c : line) {
+      const GlyphRect& glyph{ getGlyph(c) };
+
+      for (int y = 0; y < glyph.height_; y++) {
+         for (int x = 0; x < glyph.width_;) {
+            if (!isInk(glyph, x, y)) {
+               x++;
+               continue;
+            }
+
+            const int begin{ x };
+
+            while (x < glyph.width_ && isInk(glyph, x, y)) x++;
+
+            rendered->runs_.push_back({ y, rendered->width_ + begin, rendered->width_ + x });
+         }
+      }
+
+      rendered->width_ += glyph.width_;
+      rendered->height_ = (std::max)(rendered->height_, glyph.height_);
+   }
+
+   std::lock_guard<std::mutex> lock{ cache_mutex_ };
+
+   if (cache_.size() >= MAX_CACHED_LINES) {
+      cache_.clear();
+   }
+
+   cache_.insert({ line, rendered });
+   return rendered;
+}
@@ -306,12 +306,44 @@ void HighwayImage::plotCar3D(
    const float car_length,
    const Vec2D scale,
    const float angle_rad)
+{
+   plotCars3D({ { pos_car, fill_color } }, lane_width, car_width, car_length);
+}
+
+void HighwayImage::plotCars3D(
+   const std::vector<std::pair<Vec2Df, Color>>& positions_and_fill_colors,
+   const float lane_width,
+   const float car_width,
+   const float car_length)
+{
+   constexpr int FACES_PER_CAR{ 5 };
+   constexpr int OUTLINE_ORDER[FACES_PER_CAR]{ 0, 1, 3, 2, 4 }; // front, left, right, top, back.
+   std::vector<Pol3D> faces{};
+   faces.reserve(positions_and_fill_colors.size() * FACES_PER_CAR);
+
+   for (const auto& car : positions_and_fill_colors) {
+      addCar3DFaces(faces, car.first, lane_width, car_width, car_length);
+   }
+
+   const std::vector<Pol2D> translated_faces{ getTranslator()->translatePolygons(faces) };
+
+   for (int i = 0; i < positions_and_fill_colors.size(); i++) {
+      auto pale_filling{ positions_and_fill_colors[i].second };
+      pale_filling.a = 100;
+
+      for (int j = 0; j < FACES_PER_CAR; j++) {
+         fillTranslatedPolygon(translated_faces[i * FACES_PER_CAR + j], pale_filling);
+      }
+
+      for (const int j : OUTLINE_ORDER) {
+         drawTranslatedPolygon(translated_faces[i * FACES_PER_CAR + j], BLACK);
+      }
+   }
+}
+
+void HighwayImage::addCar3DFaces(std::vector<Pol3D>& faces, const Vec2Df& pos_car, const float lane_width, const float car_width, const float car_length)
 {
    float CAR_FINAL_WIDTH{ car_width / lane_width };
-   auto pale_filling{ fill_color };
-   auto less_pale_filling{ fill_color };
-   pale_filling.a = 100;
-   less_pale_filling.a = 150;
 
    const float ww{ car_length / 2 };
    const float hh{ CAR_FINAL_WIDTH / 2 };
@@ -326,22 +358,11 @@ void HighwayImage::plotCar3D(
    const Vec3D trd{ brd.x, tld.y, 0 };
    const Vec3D bld{ tld.x, brd.y, 0 };
 
-   const Pol3D top{ { tlu, tru, bru, blu } };
-   const Pol3D back{ { tlu, tld, bld, blu } };
-   const Pol3D front{ { bru, tru, trd, brd } };
-   const Pol3D left{ { bru, blu, bld, brd } };
-   const Pol3D right{ { tru, tlu, tld, trd } };
-
-   fillPolygon(front, pale_filling);
-   fillPolygon(left, pale_filling);
-   fillPolygon(top, pale_filling);
-   fillPolygon(right, pale_filling);
-   fillPolygon(back, pale_filling);
-   drawPolygon(front, BLACK);
-   drawPolygon(left, BLACK);
-   drawPolygon(right, BLACK);
-   drawPolygon(top, BLACK);
-   drawPolygon(back, BLACK);
+   faces.push_back(Pol3D{ { bru, tru, trd, brd } }); // front
+   faces.push_back(Pol3D{ { bru, blu, bld, brd } }); // left
+   faces.push_back(Pol3D{ { tlu, tru, bru, blu } }); // top
+   faces.push_back(Pol3D{ { tru, tlu, tld, trd } }); // right
+   faces.push_back(Pol3D{ { tlu, tld, bld, blu } }); // back
 }
 
 static constexpr float ARC_LENGTH = MIN_DISTANCE_BETWEEN_SEGMENTS / 2;
@@ -811,7 +832,7 @@ std::vector<ConnectorPolygonEnding> vfm::HighwayImage::paintStraightRoadScene(
    const auto infinite_road_correction = (infinite_road ? ego->car_rel_pos_ : 0);
    const auto ego_rel_pos = ego ? ego->car_rel_pos_ - infinite_road_correction : 0;
    const auto ego_velocity = ego ? ego->car_velocity_ : 0;
-   const auto others = lane_structure.getOthers();
+   const auto& others = lane_structure.getOthers();
    const auto future_positions_of_others = lane_structure.getFuturePositionsOfOthers();
    const auto road_length = infinite_road ? 300 : lane_structure.getLength();
    const float road_begin = infinite_road ? -300 : 0;
@@ -988,13 +1009,18 @@ std::vector<ConnectorPolygonEnding> vfm::HighwayImage::paintStraightRoadScene(
          fillPolygon(pol, DARK_GREY);
       }
 
-      for (int i = 0; i < cars_sorted_by_distance.size(); i++) {
-         const auto pair = others[id_to_others_vec[cars_sorted_by_distance[i]]];
-         Vec2Df pos{ pair.car_rel_pos_ - infinite_road_correction, pair.car_lane_ - (getHighwayTranslator()->is3D() ? 0 : ego_lane) };
-         if (getHighwayTranslator()->is3D()) plotCar3D(pos, CAR_COLOR, CAR_FRAME_COLOR, lane_width, car_dimension.getCarWidth(), car_dimension.getCarLength());
-      }
+      if (getHighwayTranslator()->is3D()) {
+         std::vector<std::pair<Vec2Df, Color>> cars_3d{};
+
+         for (int i = 0; i < cars_sorted_by_distance.size(); i++) {
+            const auto pair = others[id_to_others_vec[cars_sorted_by_distance[i]]];
+            cars_3d.push_back({ { pair.car_rel_pos_ - infinite_road_correction, pair.car_lane_ }, CAR_COLOR });
+         }
+
+         if (ego) cars_3d.push_back({ { ego_rel_pos, ego_lane }, RED }); // EGO 3D
 
-      if (ego) if (getHighwayTranslator()->is3D()) plotCar3D({ ego_rel_pos, ego_lane }, RED, CAR_FRAME_COLOR, lane_width, car_dimension.getCarWidth(), car_dimension.getCarLength()); // EGO 3D
+         plotCars3D(cars_3d, lane_width, car_dimension.getCarWidth(), car_dimension.getCarLength());
+      }
 
       if (ego) writeAsciiText(ego_rel_pos, getHighwayTranslator()->is3D() ? ego_lane : 0, std::to_string(ego_velocity), CoordTrans::do_it, true, FUNC_IGNORE_BLACK_CONVERT_TO_BLACK);
 
@@ -1045,7 +1071,7 @@ std::vector<ConnectorPolygonEnding> vfm::HighwayImage::paintStraightRoadScene(
 }
 
 void vfm::HighwayImage::paintBezierConnectionsBetweenSections(
-   const std::shared_ptr<RoadGraph> my_r,
+   const RoadGraphIndex& my_r_index,
    const Vec2D& dim_raw,
    const std::shared_ptr<HighwayTranslator> old_trans
    )
@@ -1053,7 +1079,7 @@ void vfm::HighwayImage::paintBezierConnectionsBetweenSections(
    std::vector<Pol2D> additional_arrows{};
 
    for (int i = 0; i <= 30; i++) {
-      my_r->applyToMeAndAllMySuccessorsAndPredecessors([this, i, &dim_raw, &additional_arrows, old_trans](const std::shared_ptr<RoadGraph> r) -> void
+      my_r_index.applyToAll([this, i, &dim_raw, &additional_arrows, old_trans](const std::shared_ptr<RoadGraph> r) -> void
          {
             for (const auto& r_succ : r->getSuccessors()) {
                for (const auto& A : r->connectors_) {
@@ -1198,12 +1224,12 @@ void vfm::HighwayImage::paintBezierConnectionsBetweenSections(
 }
 
 void vfm::HighwayImage::paintGraphConnectionsBetweenSections(
-   const std::shared_ptr<RoadGraph> my_r,
+   const RoadGraphIndex& my_r_index,
    const std::map<std::string, std::string>& var_vals,
    const std::shared_ptr<HighwayTranslator> old_trans
 )
 {
-   my_r->applyToMeAndAllMySuccessorsAndPredecessors([this, &var_vals](const std::shared_ptr<RoadGraph> r) {
+   my_r_index.applyToAll([this, &var_vals](const std::shared_ptr<RoadGraph> r) {
       for (const auto& r_succ : r->getSuccessors()) {
          for (const auto& A : r->connectors_) {
             for (const auto& B : r_succ->connectors_) {
@@ -1283,8 +1309,9 @@ void vfm::HighwayImage::paintRoadGraph(
 
    my_r = my_r->copy();
    my_r->normalizeRoadGraphToEgo();
+   const RoadGraphIndex my_r_index{ my_r }; // Same order as the recursive traversal, but only walked once.
    auto old_trans = getHighwayTranslator();
-   const auto all_nodes = my_r->getAllNodes();
+   const auto& all_nodes = my_r_index.getAllNodes();
    const float lane_width{ my_r->my_road_.getLaneWidth() }; // Assuming all lanes have same width.
    const bool infinite_road{ false /*all_nodes.size() == 1 && my_r->isUnturned()*/ }; // Only a single section, unturned, will be painted as infinite.
 
@@ -1296,7 +1323,7 @@ void vfm::HighwayImage::paintRoadGraph(
    //   dim_raw = { (float)getWidth(), (float)getHeight() };
    //}
 
-   auto r_ego = my_r->findSectionWithEgoIfAny();
+   auto r_ego = my_r_index.findSectionWithCar(RoadGraph::EGO_MOCK_ID);
 
    std::vector<std::shared_ptr<RoadGraph>> all_nodes_ego_in_front{};
 
@@ -1426,10 +1453,10 @@ void vfm::HighwayImage::paintRoadGraph(
    const bool topology_only{ false };
 
    if (topology_only) {
-      paintGraphConnectionsBetweenSections(my_r, var_vals, old_trans);
+      paintGraphConnectionsBetweenSections(my_r_index, var_vals, old_trans);
    }
    else {
-      paintBezierConnectionsBetweenSections(my_r, dim_raw, old_trans);
+      paintBezierConnectionsBetweenSections(my_r_index, dim_raw, old_trans);
    }
 
    label:
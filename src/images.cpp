@@ -6,6 +6,7 @@
 /// @file
 
 #include "geometry/images.h"
+#include "geometry/glyph_atlas.h"
 #include "static_helper.h"
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "geometry/stb_image_write.h"
@@ -72,6 +73,11 @@ std::vector<Image> vfm::Image::retrieveAsciiTableFromPPMString(const std::string
 }
 
 Image vfm::Image::getAsciiImage(const char symbol, const std::vector<Image>& ascii_table)
+{
+   return getAsciiImageRef(symbol, ascii_table);
+}
+
+const Image& vfm::Image::getAsciiImageRef(const char symbol, const std::vector<Image>& ascii_table)
 {
    if (symbol >= ' ' && symbol <= '~' && symbol - 32 < ascii_table.size()) {
       return ascii_table[symbol - 32];
@@ -229,25 +235,70 @@ void Image::putPixelUnsafe(int x, int y, const Color& col)
 void Image::putPixel(int x, int y, const Color& col)
 {
    if (x >= 0 && y >= 0) {
+      if (x >= width_ || y >= height_) {
+         expandToInclude(x, y);
+      }
+
       if (x < width_ && y < height_) {
          putPixelUnsafe(x, y, col);
       }
-      else {
-         if (x >= width_ && expand_dynamically_to_the_right_) {
-            auto new_width{ (std::max)(x - width_, expand_dynamically_to_the_right_) + width_ };
-            auto copy{ *this };              // TODO: Expensive (better resize by preserving old image)
-            resize(new_width, height_);
-            insertImage(0, 0, copy, false);  // TODO: Expensive (better resize by preserving old image)
-            putPixelUnsafe(x, y, col);
-         }
-         if (y >= height_ && expand_dynamically_to_the_bottom_) {
-            auto new_height{ (std::max)(y - height_, expand_dynamically_to_the_bottom_) + height_ };
-            resize(width_, new_height); // Width hasn't changed ==> We can just attach new pixels at the end.
-         }
+   }
+}
+
+void Image::expandToInclude(const int x, const int y)
+{
+   if (x >= width_ && expand_dynamically_to_the_right_) {
+      auto new_width{ (std::max)(x - width_, expand_dynamically_to_the_right_) + width_ };
+      auto copy{ *this };              // TODO: Expensive (better resize by preserving old image)
+      resize(new_width, height_);
+      insertImage(0, 0, copy, false);  // TODO: Expensive (better resize by preserving old image)
+   }
+   if (y >= height_ && expand_dynamically_to_the_bottom_) {
+      auto new_height{ (std::max)(y - height_, expand_dynamically_to_the_bottom_) + height_ };
+      resize(width_, new_height); // Width hasn't changed ==> We can just attach new pixels at the end.
+   }
+}
+
+void Image::fillSpanUnsafe(const int y, const int x_begin, const int x_end, const Color& col)
+{
+   if (col.a == 255) { // Same as putPixelUnsafe for each pixel, without the per-pixel overhead.
+      std::fill(buf_.begin() + y * width_ + x_begin, buf_.begin() + y * width_ + x_end, col);
+   }
+   else {
+      for (int x = x_begin; x < x_end; x++) {
+         putPixelUnsafe(x, y, col);
       }
    }
 }
 
+void Image::rasterizePolygon(const std::vector<Vec2Df>& points, const Color& col, const FillRule rule, const bool anti_aliasing)
+{
+   if (points.empty()) return;
+
+   float max_x{ points[0].x };
+   float max_y{ points[0].y };
+
+   for (const auto& point : points) {
+      max_x = (std::max)(max_x, point.x);
+      max_y = (std::max)(max_y, point.y);
+   }
+
+   if (max_x >= width_ && expand_dynamically_to_the_right_ || max_y >= height_ && expand_dynamically_to_the_bottom_) {
+      expandToInclude(
+         max_x < width_ || !std::isfinite(max_x) ? 0 : (int) max_x,
+         max_y < height_ || !std::isfinite(max_y) ? 0 : (int) max_y);
+   }
+
+   rasterizer_.rasterize(points, width_, height_, rule, anti_aliasing, [this, &col](const int y, const int x_begin, const int x_end, const float coverage) {
+      if (coverage >= 1) {
+         fillSpanUnsafe(y, x_begin, x_end, col);
+      }
+      else {
+         fillSpanUnsafe(y, x_begin, x_end, Color(col.r, col.g, col.b, (color_t) (col.a * coverage)));
+      }
+   });
+}
+
 Color Image::getPixel(const int x, const int y) const
 {
    if (x < 0 || x >= width_ || y < 0 || y >= height_) {
@@ -753,8 +804,11 @@ void Image::cubeBezier(const int x1, const int y1, const int x2, const int y2, c
 
 void vfm::Image::drawPolygon(const Polygon3D<float>& pol, const Color& col, const bool close_polygon, const bool paint_nodes, const bool print_coordinates)
 {
-   Pol2D translated_pol{ translator_->translatePolygon(pol) };
+   drawTranslatedPolygon(translator_->translatePolygon(pol), col, close_polygon, paint_nodes, print_coordinates);
+}
 
+void vfm::Image::drawTranslatedPolygon(const Pol2D& translated_pol, const Color& col, const bool close_polygon, const bool paint_nodes, const bool print_coordinates)
+{
    if (translated_pol.points_.empty()) return;
 
    for (int i = 0; i < translated_pol.points_.size() + close_polygon - 1; i++) {
@@ -765,7 +819,7 @@ void vfm::Image::drawPolygon(const Polygon3D<float>& pol, const Color& col, cons
 
       if (paint_nodes) {
          circle(current_point.x, current_point.y, 3, i == 0 ? RED : col);
-         circle(next_point.x, next_point.y, 3, i == pol.points_.size() - 1 ? RED : col);
+         circle(next_point.x, next_point.y, 3, i == translated_pol.points_.size() - 1 ? RED : col);
       }
 
       if (print_coordinates) {
@@ -777,34 +831,14 @@ void vfm::Image::drawPolygon(const Polygon3D<float>& pol, const Color& col, cons
    drawPolygonPDF(translated_pol, 0.3, col, close_polygon);
 }
 
-void vfm::Image::fillPolygon(const Polygon3D<float>& pol, const Color& col)
+void vfm::Image::fillPolygon(const Polygon3D<float>& pol, const Color& col, const FillRule rule, const bool anti_aliasing)
 {
-   Pol2D translated_pol{ translator_->translatePolygon(pol) };
-
-   if (!translated_pol.points_.empty()) {
-      auto bb = translated_pol.getBoundingBox();
-      float x1 = bb->upper_left_.x;
-      float y1 = bb->upper_left_.y;
-      float x2 = bb->lower_right_.x;
-      float y2 = bb->lower_right_.y;
-
-      for (float i = (std::max)((int)y1, 0); i <= (std::min)((int)y2, (int)height_) + 1; i += 0.999) {
-         auto intersections{ translated_pol.intersect(LinSeg2D{ { x1, i }, { x2, i } }) };
-         std::sort(intersections.begin(), intersections.end(), [](const Vec2D& v1, const Vec2D& v2) {
-            return v1.x < v2.x;
-            });
-
-         for (size_t ii = 0; ii + 1 < intersections.size(); ii += 2) {
-            lineUnsafe(
-               (std::max)((int)intersections[ii].x, 0),
-               i,
-               (std::min)((int)intersections[ii + 1].x, (int)width_),
-               i,
-               col);
-         }
-      }
-   }
+   fillTranslatedPolygon(translator_->translatePolygon(pol), col, rule, anti_aliasing);
+}
 
+void vfm::Image::fillTranslatedPolygon(const Pol2D& translated_pol, const Color& col, const FillRule rule, const bool anti_aliasing)
+{
+   rasterizePolygon(translated_pol.points_, col, rule, anti_aliasing);
    fillPolygonPDF(translated_pol, col);
 }
 
@@ -845,44 +879,15 @@ Image vfm::Image::scale(const Vec2Df factor)
 }
 
 
-/// \brief Standard triangle triangulation algorithm: Split generic triangle into
-/// one with a flat bottom and on with a flat top. Both of those then can be rasterized trivially.
 void vfm::Image::fillTriangle(Vec2Df v1, Vec2Df v2, Vec2Df v3, const Color& col)
 {
-   // Sort the vertices by y1 < y2 < y3
-   // Unrolled bubblesort
-   if (v1.y > v2.y)
-      std::swap(v1, v2);
-   if (v2.y > v3.y)
-      std::swap(v2, v3);
-   if (v1.y > v2.y)
-      std::swap(v1, v2);
-
-
-   if (v2.y == v3.y)
-   {
-      fillBottomFlatTriangle(v1, v2, v3, col);
-   }
-   // check for trivial case of top-flat triangle
-   else if (v1.y == v2.y)
-   {
-      fillTopFlatTriangle(v1, v2, v3, col);
-   }
-   else
-   {
-      // general case - split the triangle in a topflat and bottom-flat one
-      Vec2Df v_mid(
-         (int)(v1.x + ((float)(v2.y - v1.y) / (float)(v3.y - v1.y)) * (v3.x - v1.x)), v2.y);
-
-      fillBottomFlatTriangle(v1, v2, v_mid, col);
-      fillTopFlatTriangle(v2, v_mid, v3, col);
-   }
+   rasterizePolygon({ v1, v2, v3 }, col, FillRule::even_odd, false);
 }
 
 void vfm::Image::fillQuad(Vec2Df v1, Vec2Df v2, Vec2Df v3, Vec2Df v4, const Color& col)
 {
-   fillTriangle(v1, v2, v3, col);
-   fillTriangle(v2, v3, v4, col);
+   // One outline instead of two triangles, so the pixels along the diagonal are not blended twice.
+   rasterizePolygon({ v1, v2, v4, v3 }, col, FillRule::non_zero, false);
    fillPolygonPDF({ v1, v2, v4, v3 }, col);
 }
 
@@ -894,47 +899,6 @@ void vfm::Image::fillTriangleStrip(const Polygon2D<float>& pol, const Color& col
    }
 }
 
-void vfm::Image::fillBottomFlatTriangle(Vec2Df v1, Vec2Df v2, Vec2Df v3, const Color& col)
-{
-   float invslope1 = (v2.x - v1.x) / (v2.y - v1.y);
-   float invslope2 = (v3.x - v1.x) / (v3.y - v1.y);
-
-   float curx1 = v1.x;
-   float curx2 = v1.x;
-
-   for (int scanlineY = v1.y; scanlineY <= v2.y; scanlineY++)
-   {
-      int max_x = _MAX(curx1, curx2);
-      for (int x = (int) _MIN(curx1, curx2); x <= max_x; x++)
-      {
-         putPixel(x, scanlineY, col);
-      }
-      curx1 += invslope1;
-      curx2 += invslope2;
-   }
-}
-
-void vfm::Image::fillTopFlatTriangle(Vec2Df v1, Vec2Df v2, Vec2Df v3, const Color& col)
-{
-   float invslope1 = (v3.x - v1.x) / (v3.y - v1.y);
-   float invslope2 = (v3.x - v2.x) / (v3.y - v2.y);
-
-   float curx1 = v3.x;
-   float curx2 = v3.x;
-
-   for (int scanlineY = v3.y; scanlineY > v1.y; scanlineY--)
-   {
-      int max_x = _MAX(curx1, curx2);
-      for (int x = (int) _MIN(curx1, curx2); x <= max_x; x++)
-      {
-         putPixel(x, scanlineY, col);
-      }
-      //drawLine((int)curx1, scanlineY, (int)curx2, scanlineY);
-      curx1 -= invslope1;
-      curx2 -= invslope2;
-   }
-}
-
 std::shared_ptr<VisTranslator> vfm::Image::getTranslator() const
 {
    return translator_;
@@ -1051,6 +1015,105 @@ void vfm::Image::writeAsciiText(
 {
    // TODO: Not supported in PDF, yet.
 
+   if (&ascii_table != &MONOSPACE_NEW_CACHED_ASCII_TABLE) {
+      writeAsciiTextWithTable(x, y, text, translate_position, center, f, ascii_table);
+      return;
+   }
+
+   const GlyphAtlas& atlas{ GlyphAtlas::getMonospace() };
+   Vec2D point{ translate_position == CoordTrans::do_it ? getTranslator()->translate({x, y}) : Vec2D{x, y} };
+   int xx = point.x;
+   int yy = point.y;
+   int xxx = 0;
+
+   if (center) {
+      const auto size{ atlas.measure(text) };
+      xxx = -size.first;
+      yy += -size.second / 2;
+      xx += xxx / 2;
+   }
+
+   xx = (std::max)(0, xx);
+   yy = (std::max)(0, yy);
+
+   if (!expand_dynamically_to_the_bottom_) {
+      yy = (std::min)(yy, getHeight() - 20);
+   }
+
+   if (!expand_dynamically_to_the_right_) {
+      xx = (std::min)(xx, getWidth() - 20);
+   }
+
+   for (size_t line_begin = 0; ; ) {
+      const size_t line_end{ (std::min)(text.find('\n', line_begin), text.size()) };
+      const std::string line{ text.substr(line_begin, line_end - line_begin) };
+
+      writeAsciiTextLine(atlas, line, xx, yy, f);
+      xx += atlas.measure(line).first;
+
+      if (line_end == text.size()) break;
+
+      xx = x + xxx;
+      yy += atlas.getGlyph(text[0]).height_ + 1;
+      line_begin = line_end + 1;
+   }
+
+   drawTextPDF(text, xx, yy, f(BLUE, BLUE));
+}
+
+void vfm::Image::writeAsciiTextLine(const GlyphAtlas& atlas, const std::string& line, const int x, const int y, const std::function<Color(const Color& oldPix, const Color& newPix)>& f)
+{
+   const auto rendered{ atlas.renderLine(line) };
+
+   if (!rendered->width_ || !rendered->height_) return;
+
+   const int max_x{ x + rendered->width_ - 1 };
+   const int max_y{ y + rendered->height_ - 1 };
+
+   if (max_x >= width_ && expand_dynamically_to_the_right_ || max_y >= height_ && expand_dynamically_to_the_bottom_) {
+      expandToInclude(max_x, max_y); // Like putPixel would do for the bottom right pixel.
+   }
+
+   if (const auto* ignore_black{ f.target<IgnoreBlackConvertTo>() }) {
+      for (const auto& run : rendered->runs_) {
+         const int yy{ y + run.y_ };
+         const int x_begin{ (std::max)(x + run.x_begin_, 0) };
+         const int x_end{ (std::min)(x + run.x_end_, width_) };
+
+         if (yy >= 0 && yy < height_ && x_begin < x_end) {
+            fillSpanUnsafe(yy, x_begin, x_end, ignore_black->color_);
+         }
+      }
+
+      return;
+   }
+
+   int xx{ x };
+
+   for (const char c : line) {
+      const auto& glyph{ atlas.getGlyph(c) };
+
+      for (int i = 0; i < glyph.width_; i++) {
+         for (int j = 0; j < glyph.height_; j++) {
+            putPixel(xx + i, y + j, f(getPixel(xx + i, y + j), atlas.getPixel(glyph, i, j)));
+         }
+      }
+
+      xx += glyph.width_;
+   }
+}
+
+void vfm::Image::writeAsciiTextWithTable(
+   const float x,
+   const float y,
+   const std::string text,
+   const CoordTrans translate_position,
+   const bool center,
+   const std::function<Color(const Color& oldPix, const Color& newPix)>& f,
+   const std::vector<Image>& ascii_table)
+{
+   // TODO: Not supported in PDF, yet.
+
    Vec2D point{ translate_position == CoordTrans::do_it ? getTranslator()->translate({x, y}) : Vec2D{x, y} };
    int xx = point.x;
    int yy = point.y;
@@ -1059,8 +1122,8 @@ void vfm::Image::writeAsciiText(
 
    if (center) {
       for (int i = 0; i < text.size(); i++) {
-         xxx -= getAsciiImage(text[i], ascii_table).width_;
-         yyy = -((std::max)(yyy, (int) getAsciiImage(text[i], ascii_table).height_));
+         xxx -= getAsciiImageRef(text[i], ascii_table).width_;
+         yyy = -((std::max)(yyy, (int) getAsciiImageRef(text[i], ascii_table).height_));
       }
 
       yy += yyy / 2;
@@ -1081,10 +1144,10 @@ void vfm::Image::writeAsciiText(
    for (int i = 0; i < text.size(); i++) {
       if (text[i] == '\n') {
          xx = x + xxx;
-         yy += getAsciiImage(text[0], ascii_table).height_ + 1;
+         yy += getAsciiImageRef(text[0], ascii_table).height_ + 1;
       }
       else {
-         Image img = getAsciiImage(text[i], ascii_table);
+         const Image& img = getAsciiImageRef(text[i], ascii_table);
          insertImage(xx, yy, img, false, f);
          xx += img.width_;
       }
@@ -8,6 +8,8 @@
 #include "testing/interactive_testing.h"
 #include "gui/gui.h"
 #include "model_checking/cex_processing/mc_visualization_launchers.h"
+#include "model_checking/process_runner.h"
+#include "model_checking/mc_portfolio.h"
 #include "vfmacro/script.h"
 
 #include <stdio.h>
@@ -660,6 +662,10 @@ const std::string CMD_MAIN_TEMPLATE{ "--main-template-file" };
 const std::string CMD_CACHE_DIR{ "--chache-dir" };
 const std::string CMD_CEX_FILE{ "--cex-file-name" };
 const std::string CMD_EXECUTE_SCRIPT{ "--execute-script" };
+const std::string CMD_MC_TIMEOUT{ "--mc-timeout" };
+const std::string CMD_MC_MEMORY_LIMIT{ "--mc-memory-limit" };
+const std::string CMD_MC_PORTFOLIO{ "--mc-portfolio" };
+const std::string CMD_MC_PORTFOLIO_PARALLEL{ "--mc-portfolio-parallel" };
 
 #ifdef _WIN32
 const std::string CMD_CPP_EXEC{ "--path-to-cpp" };
@@ -685,6 +691,10 @@ InputParser vfm::test::createInputParserForMC(int& argc, char** argv)
    parser.addParameter(CMD_CEX_FILE, "name of counterexample file in SMV format", "debug_trace_array.txt");
    parser.addParameter(CMD_NUXMV_EXEC, "path to NUXMV executable", "nuxmv.exe");
    parser.addParameter(CMD_KRATOS_EXEC, "path to KRATOS executable", "kratos.exe");
+   parser.addParameter(CMD_MC_TIMEOUT, "wall-clock limit in seconds per model checker process (0 for unlimited)", "0");
+   parser.addParameter(CMD_MC_MEMORY_LIMIT, "memory limit in MB per model checker process (0 for unlimited)", "0");
+   parser.addFlag(CMD_MC_PORTFOLIO, "if several nuXmv engines/options are to be raced against each other, taking the first conclusive result");
+   parser.addParameter(CMD_MC_PORTFOLIO_PARALLEL, "max number of parallel nuXmv processes in portfolio mode", "4");
    parser.addFlag(CMD_EXECUTE_SCRIPT, "if script expansion for file 'script.txt' is to be run");
 #ifdef _WIN32
    parser.addParameter(CMD_CPP_EXEC, "path to CPP preprocessor executable", "cpp.exe");
@@ -815,34 +825,96 @@ int vfm::test::artifactRun(int argc, char* argv[])
       // Since nuXmv 2.2.0 the binary is dynamically linked and ships its shared libraries in a
       // sibling "lib" folder (libnuxmv.so, libgmp, libedit, libicu*, ...). Point LD_LIBRARY_PATH
       // at that folder so the model checker can find them (equivalent to the vendor's nuXmv.sh
-      // wrapper). Only needed on Linux; the command runs through a shell (popen), so an env-var
-      // prefix is sufficient. Older, statically-linked binaries simply have no lib/ folder and
-      // are invoked unchanged.
-      std::string nuxmv_invocation{ nuxmv_fulldir };
+      // wrapper). Only needed on Linux. Older, statically-linked binaries simply have no lib/
+      // folder and are invoked unchanged.
+      std::map<std::string, std::string> nuxmv_env{};
 #if defined(__linux__)
       const std::filesystem::path nuxmv_lib_dir{ nuxmv_exec.parent_path() / "lib" };
       if (std::filesystem::is_directory(nuxmv_lib_dir)) {
-         const std::string lib_dir_str{ nuxmv_lib_dir.generic_string() };
-         nuxmv_invocation = "LD_LIBRARY_PATH=\"" + lib_dir_str + "${LD_LIBRARY_PATH:+:$LD_LIBRARY_PATH}\" " + nuxmv_fulldir;
+         const char* ld_library_path{ std::getenv("LD_LIBRARY_PATH") };
+         nuxmv_env["LD_LIBRARY_PATH"] = nuxmv_lib_dir.generic_string() + (ld_library_path && *ld_library_path ? ":" + std::string(ld_library_path) : "");
       }
 #endif
 
-      std::string command_nuxmv{ nuxmv_invocation
+      std::string command_nuxmv{ nuxmv_fulldir
          + " -int -pre cpp -source " + generated_dir + "script.cmd " + generated_dir + "main.smv"};
 
+      const std::vector<std::string> argv_kratos{ 
+         kratos_fulldir, 
+         "-trans_output_format=nuxmv-module", 
+         "-trans_enum_mode=symbolic", 
+         "-output_file=" + generated_dir + "planner.cpp_combined.k2.smv", 
+         generated_dir + "planner.cpp_combined.k2" };
+
+      const std::vector<std::string> argv_nuxmv{ nuxmv_fulldir, "-int", "-pre", "cpp", "-source", generated_dir + "script.cmd", generated_dir + "main.smv" };
+
+      mc::ProcessLimits limits{};
+      limits.wall_clock_seconds = std::stod(inputs.getCmdOption(CMD_MC_TIMEOUT));
+      limits.memory_bytes = (size_t)(std::stod(inputs.getCmdOption(CMD_MC_MEMORY_LIMIT)) * 1024 * 1024);
+
+      const std::string path_runtimes{ generated_dir + "/mc_runtimes.txt" };
+      const auto store_statistics = [&path_runtimes](const std::string& command, const mc::ProcessStatistics& stats) {
+         StaticHelper::writeTextToFile(StaticHelper::timeStamp() + ": " + StaticHelper::printTimeFormatted(stats.wall_time) + " time elapsed for execution of system command '" + command + "' (" + stats.serialize() + ").\n", path_runtimes, true);
+      };
+
+      const auto print_output = [](const std::string& chunk) { std::cout << chunk << std::flush; };
+
       inputs.addNote("RUNNING KRATOS with command '" + command_kratos + "'.");
-      int success_code_kratos{};
-      int success_code_nuxmv{};
-      StaticHelper::execWithSuccessCode(command_kratos, success_code_kratos, std::make_shared<std::string>(generated_dir + "/mc_runtimes.txt"));
+      mc::ProcessRunner runner{};
+      const auto stats_kratos{ runner.run(argv_kratos, {}, limits, print_output) };
+      store_statistics(command_kratos, stats_kratos);
 
 #ifdef _WIN32
       inputs.addNote("SETTING CPP PATH TO '" + cpp_fulldir + "'");
       _putenv(("CPP=" + cpp_fulldir + "").c_str());
 #endif
 
-      inputs.addNote("RUNNING NUXMV with command '" + command_nuxmv + "'.");
-      std::string result{ StaticHelper::execWithSuccessCode(command_nuxmv, success_code_nuxmv, std::make_shared<std::string>(generated_dir + "/mc_runtimes.txt")) };
-      StaticHelper::writeTextToFile(result, generated_dir + inputs.getCmdOption(CMD_CEX_FILE));
+      const std::string cex_path{ generated_dir + inputs.getCmdOption(CMD_CEX_FILE) };
+      mc::NusmvCexStreamer streamer{ [&inputs, &cex_path, &streamer](const MCTrace& trace, const int cex_num) {
+         if (cex_num == 0) { // Make the first CEX available for the preview before nuXmv terminates.
+            inputs.addNote("First counterexample (" + std::to_string(trace.size()) + " steps) available while nuXmv is still running.");
+            StaticHelper::writeTextToFile(streamer.getFullOutput(), cex_path);
+         }
+      } };
+
+      const std::string script{ StaticHelper::readFile(generated_dir + "script.cmd") };
+      mc::ProcessStatistics stats_nuxmv{};
+
+      if (inputs.getCmdOption(CMD_MC_PORTFOLIO) == "true" && !StaticHelper::stringContains(script, "scengen")) {
+         const std::string main_smv{ StaticHelper::readFile(generated_dir + "main.smv") };
+         const std::string template_name{ mc::McPortfolio::deriveTemplateName(main_smv) };
+         const std::filesystem::path path_statistics{ std::filesystem::absolute(generated_dir).parent_path().parent_path() / mc::FILE_NAME_PORTFOLIO_STATISTICS };
+         mc::McPortfolio portfolio{ path_statistics };
+
+         inputs.addNote("RUNNING NUXMV PORTFOLIO (" + template_name + ") on '" + generated_dir + "main.smv'.");
+         const auto result{ portfolio.run(
+            nuxmv_fulldir,
+            generated_dir + "main.smv",
+            template_name,
+            mc::McPortfolio::createDefaultVariants(template_name, script),
+            nuxmv_env,
+            limits,
+            std::stoi(inputs.getCmdOption(CMD_MC_PORTFOLIO_PARALLEL)),
+            [&inputs, &cex_path](const std::string& output_so_far) { // Same early preview as in the single-engine run below.
+               inputs.addNote("First counterexample available while the nuXmv portfolio is still running.");
+               StaticHelper::writeTextToFile(output_so_far, cex_path);
+            }) };
+
+         print_output(result.output_);
+         stats_nuxmv = result.statistics_;
+         store_statistics(command_nuxmv + " [portfolio winner: '" + result.winner_ + "']", stats_nuxmv);
+         StaticHelper::writeTextToFile(result.output_, cex_path);
+      }
+      else {
+         inputs.addNote("RUNNING NUXMV with command '" + command_nuxmv + "'.");
+         stats_nuxmv = runner.run(argv_nuxmv, nuxmv_env, limits, [&streamer, &print_output](const std::string& chunk) {
+            print_output(chunk);
+            streamer.feed(chunk);
+         });
+         streamer.finish();
+         store_statistics(command_nuxmv, stats_nuxmv);
+         StaticHelper::writeTextToFile(streamer.getFullOutput(), cex_path);
+      }
 
       // Fake call with FALSE SPEC
       inputs.addNote("Running FALSE SPEC for debugging.");
@@ -850,7 +922,8 @@ int vfm::test::artifactRun(int argc, char* argv[])
       const std::string original_main{ StaticHelper::readFile(main_dir) };
       StaticHelper::processFile(main_dir, [](std::string& content) { return StaticHelper::replaceAll(content, std::string("SPEC "), std::string("SPEC FALSE & ")); });
       inputs.addNote("RUNNING NUXMV with command '" + command_nuxmv + "'.");
-      std::string result_fake{ StaticHelper::execWithSuccessCode(command_nuxmv, success_code_nuxmv, nullptr) };
+      std::string result_fake{};
+      runner.run(argv_nuxmv, nuxmv_env, limits, [&result_fake](const std::string& chunk) { result_fake += chunk; });
       StaticHelper::writeTextToFile(result_fake, generated_dir + "debug_trace_array_FALSE.txt");
       StaticHelper::processFile(main_dir, [](std::string& content) { return StaticHelper::replaceAll(content, std::string("SPEC FALSE & "), std::string("SPEC ")); });
       if (original_main != StaticHelper::readFile(main_dir)) {
@@ -858,6 +931,8 @@ int vfm::test::artifactRun(int argc, char* argv[])
       }
       // EO Fake call with FALSE SPEC
 
+      const int success_code_kratos{ stats_kratos.isSuccess() ? EXIT_SUCCESS : EXIT_FAILURE };
+      const int success_code_nuxmv{ stats_nuxmv.isSuccess() ? EXIT_SUCCESS : EXIT_FAILURE };
       success == success && (success_code_kratos == EXIT_SUCCESS) && (success_code_nuxmv == EXIT_SUCCESS);
    }
 
@@ -889,7 +964,8 @@ void vfm::test::convenienceArtifactRunHardcoded(
    const std::string& cache_dir,
    const std::string& path_to_external_folder,
    const std::string& root_dir,
-   const std::string& cex_file_name)
+   const std::string& cex_file_name,
+   const std::string& additional_mc_options)
 {
    std::vector<std::string> executions{};
    
@@ -901,7 +977,7 @@ void vfm::test::convenienceArtifactRunHardcoded(
    }
 
    if (exec == MCExecutionType::all || exec == MCExecutionType::parser_and_mc || exec == MCExecutionType::mc_and_cex || exec == MCExecutionType::mc) {
-      executions.push_back("./vfm.exe --mode mc --targetdir " + target_directory + " --rootdir " + root_dir + " --path-to-kratos " + path_to_external_folder + "/win32/kratos.exe --path-to-cpp " + path_to_external_folder + "/win32/cpp.exe --path-to-nuxmv " + path_to_external_folder + "/win32/nuXmv.exe" + " " + CMD_CEX_FILE + " " + cex_file_name);
+      executions.push_back("./vfm.exe --mode mc --targetdir " + target_directory + " --rootdir " + root_dir + " --path-to-kratos " + path_to_external_folder + "/win32/kratos.exe --path-to-cpp " + path_to_external_folder + "/win32/cpp.exe --path-to-nuxmv " + path_to_external_folder + "/win32/nuXmv.exe" + " " + CMD_CEX_FILE + " " + cex_file_name + additional_mc_options);
    }
 
    if (exec == MCExecutionType::all || exec == MCExecutionType::mc_and_cex || exec == MCExecutionType::cex) {
@@ -913,7 +989,7 @@ void vfm::test::convenienceArtifactRunHardcoded(
    }
 
    if (exec == MCExecutionType::all || exec == MCExecutionType::parser_and_mc || exec == MCExecutionType::mc_and_cex || exec == MCExecutionType::mc) {
-      executions.push_back("./vfm --mode mc --targetdir " + target_directory + " --rootdir " + root_dir + " --path-to-kratos " + path_to_external_folder + "/linux64/kratos --path-to-nuxmv " + path_to_external_folder + "/linux64/nuXmv" + " " + CMD_CEX_FILE + " " + cex_file_name);
+      executions.push_back("./vfm --mode mc --targetdir " + target_directory + " --rootdir " + root_dir + " --path-to-kratos " + path_to_external_folder + "/linux64/kratos --path-to-nuxmv " + path_to_external_folder + "/linux64/nuXmv" + " " + CMD_CEX_FILE + " " + cex_file_name + additional_mc_options);
    }
 
    if (exec == MCExecutionType::all || exec == MCExecutionType::mc_and_cex || exec == MCExecutionType::cex) {
@@ -0,0 +1,232 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+
+#include "cpp_parsing/interval_analysis.h"
+#include <algorithm>
+#include <deque>
+
+using namespace vfm;
+
+const IntervalAnalysis::Interval IntervalAnalysis::EMPTY{ 1, 0 };
+
+namespace {
+bool isEmpty(const IntervalAnalysis::Interval& interval)
+{
+   return !(interval.first <= interval.second);
+}
+}
+
+IntervalAnalysis::IntervalAnalysis(const TransferFunction& transfer) : transfer_(transfer)
+{}
+
+int IntervalAnalysis::getVariableId(const std::string& name)
+{
+   const auto it{ variable_ids_.find(name) };
+
+   if (it != variable_ids_.end()) return it->second;
+
+   const int id = variables_.size();
+   variable_ids_.insert({ name, id });
+   variables_.push_back({});
+   variables_.back().name_ = name;
+   return id;
+}
+
+void IntervalAnalysis::setInitialInterval(const int variable_id, const Interval& interval)
+{
+   variables_[variable_id].interval_ = interval;
+
+   if (!isEmpty(interval)) {
+      thresholds_.push_back(interval.first);
+      thresholds_.push_back(interval.second);
+   }
+}
+
+int IntervalAnalysis::addConstant(const float value)
+{
+   thresholds_.push_back(value);
+   nodes_.push_back({ NodeKind::constant, 0, value, 0, 0 });
+   return nodes_.size() - 1;
+}
+
+int IntervalAnalysis::addVariable(const int variable_id)
+{
+   nodes_.push_back({ NodeKind::variable, variable_id, 0, 0, 0 });
+   return nodes_.size() - 1;
+}
+
+int IntervalAnalysis::addOperator(const int operator_id, const std::vector<int>& operands)
+{
+   nodes_.push_back({ NodeKind::optor, operator_id, 0, (int) operands_.size(), (int) operands.size() });
+   operands_.insert(operands_.end(), operands.begin(), operands.end());
+   return nodes_.size() - 1;
+}
+
+int IntervalAnalysis::addAssignment(const int target_variable_id, const int expression_root)
+{
+   assignments_.push_back({ target_variable_id, first_node_of_next_assignment_, expression_root });
+   first_node_of_next_assignment_ = nodes_.size();
+   return assignments_.size() - 1;
+}
+
+long IntervalAnalysis::solve()
+{
+   std::sort(thresholds_.begin(), thresholds_.end());
+   thresholds_.erase(std::unique(thresholds_.begin(), thresholds_.end()), thresholds_.end());
+
+   for (int i = 0; i < (int) assignments_.size(); i++) {
+      for (int node = assignments_[i].first_node_; node <= assignments_[i].root_; node++) {
+         if (nodes_[node].kind_ == NodeKind::variable) {
+            auto& readers{ variables_[nodes_[node].id_].readers_ };
+            if (readers.empty() || readers.back() != i) readers.push_back(i);
+         }
+      }
+   }
+
+   std::deque<int> worklist{};
+   std::vector<bool> in_worklist(assignments_.size(), true);
+   long evaluations{ 0 };
+
+   for (int i = 0; i < (int) assignments_.size(); i++) {
+      worklist.push_back(i); // In program order, so the first round sees what a single pass would see.
+   }
+
+   while (!worklist.empty()) {
+      const int i{ worklist.front() };
+      worklist.pop_front();
+      in_worklist[i] = false;
+      evaluations++;
+
+      VariableState& target{ variables_[assignments_[i].target_] };
+
+      if (joinInto(target, evaluate(assignments_[i]))) {
+         for (const int reader : target.readers_) {
+            if (!in_worklist[reader]) {
+               in_worklist[reader] = true;
+               worklist.push_back(reader);
+            }
+         }
+      }
+   }
+
+   return evaluations;
+}
+
+IntervalAnalysis::Interval IntervalAnalysis::getInterval(const int variable_id) const
+{
+   return variables_[variable_id].interval_;
+}
+
+IntervalAnalysis::Interval IntervalAnalysis::getInterval(const std::string& name) const
+{
+   const auto it{ variable_ids_.find(name) };
+   return it == variable_ids_.end() ? EMPTY : getInterval(it->second);
+}
+
+bool IntervalAnalysis::isConstant(const int variable_id) const
+{
+   const auto& interval{ variables_[variable_id].interval_ };
+   return interval.first == interval.second;
+}
+
+const std::string& IntervalAnalysis::getVariableName(const int variable_id) const
+{
+   return variables_[variable_id].name_;
+}
+
+int IntervalAnalysis::getNumVariables() const
+{
+   return variables_.size();
+}
+
+std::vector<int> IntervalAnalysis::getVariablesWithFrozenBounds() const
+{
+   std::vector<int> result{};
+
+   for (int i = 0; i < (int) variables_.size(); i++) {
+      if (variables_[i].frozen_low_ || variables_[i].frozen_high_) result.push_back(i);
+   }
+
+   return result;
+}
+
+IntervalAnalysis::Interval IntervalAnalysis::evaluate(const Assignment& assignment)
+{
+   scratch_.resize(assignment.root_ - assignment.first_node_ + 1);
+
+   for (int i = assignment.first_node_; i <= assignment.root_; i++) {
+      const Node& node{ nodes_[i] };
+      Interval& result{ scratch_[i - assignment.first_node_] };
+
+      if (node.kind_ == NodeKind::constant) {
+         result = { node.value_, node.value_ };
+      }
+      else if (node.kind_ == NodeKind::variable) {
+         result = variables_[node.id_].interval_;
+      }
+      else {
+         const Interval& operand1{ scratch_[operands_[node.first_operand_] - assignment.first_node_] };
+         const Interval& operand2{ node.num_operands_ == 2 ? scratch_[operands_[node.first_operand_ + 1] - assignment.first_node_] : Interval{ 0, 0 } };
+
+         result = (node.num_operands_ == 1 || node.num_operands_ == 2) && !isEmpty(operand1) && !isEmpty(operand2)
+            ? transfer_(node.id_, operand1, operand2)
+            : EMPTY;
+      }
+   }
+
+   return scratch_.back();
+}
+
+bool IntervalAnalysis::joinInto(VariableState& variable, const Interval& interval)
+{
+   if (isEmpty(interval)) return false;
+
+   if (isEmpty(variable.interval_)) {
+      variable.interval_ = interval;
+      return true;
+   }
+
+   bool changed{ false };
+
+   if (interval.first < variable.interval_.first && !variable.frozen_low_) {
+      float low{ interval.first };
+
+      if (++variable.growths_low_ > WIDENING_DELAY) {
+         const auto it{ std::upper_bound(thresholds_.begin(), thresholds_.end(), low) }; // First threshold > low.
+
+         if (it == thresholds_.begin()) {
+            variable.frozen_low_ = true;
+         }
+         else {
+            low = *(it - 1);
+         }
+      }
+
+      variable.interval_.first = low;
+      changed = true;
+   }
+
+   if (interval.second > variable.interval_.second && !variable.frozen_high_) {
+      float high{ interval.second };
+
+      if (++variable.growths_high_ > WIDENING_DELAY) {
+         const auto it{ std::lower_bound(thresholds_.begin(), thresholds_.end(), high) }; // First threshold >= high.
+
+         if (it == thresholds_.end()) {
+            variable.frozen_high_ = true;
+         }
+         else {
+            high = *it;
+         }
+      }
+
+      variable.interval_.second = high;
+      changed = true;
+   }
+
+   return changed;
+}
@@ -31,6 +31,7 @@
 #include "term_val.h"
 #include "term_var.h"
 #include "meta_rule.h"
+#include "meta_rule_index.h"
 #include "term_compound.h"
 #include "term_array.h"
 #include "static_helper.h"
@@ -41,6 +42,7 @@
 #include "earley/parser/earley_parser.h"
 #include "simplification/simplification.h"
 #include "simplification/simplification_pos.h"
+#include "output_sink.h"
 #include <map>
 #include <functional>
 #include <string>
@@ -177,6 +179,7 @@ std::vector<float> MathStruct::rand_vars(100);
 int MathStruct::rand_var_count = 0;
 int MathStruct::first_free_private_var_num_ = 0;
 std::shared_ptr<std::vector<std::string>> MathStruct::additional_test_info_ = nullptr;
+bool MathStruct::cross_check_attribute_cache_ = false;
 
 bool isAutoExtractedName(const std::string& name)
 {
@@ -1047,6 +1050,7 @@ void MathStruct::swap()
    auto temp = opnds_[0];
    opnds_[0] = opnds_[1];
    opnds_[1] = temp;
+   invalidateAttributes();
 }
 
 void vfm::MathStruct::swapJumpIntoCompounds()
@@ -1054,6 +1058,7 @@ void vfm::MathStruct::swapJumpIntoCompounds()
    auto temp{ getTermsJumpIntoCompounds()[0] };
    getTermsJumpIntoCompounds()[0] = getTermsJumpIntoCompounds()[1];
    getTermsJumpIntoCompounds()[1] = temp;
+   invalidateAttributes();
 }
 
 bool vfm::MathStruct::isRootTerm() const
@@ -1589,23 +1594,34 @@ std::string vfm::MathStruct::getCPPOperator() const
    return getOptor();
 }
 
-std::string vfm::MathStruct::serializeK2(
+void vfm::MathStruct::serializeK2(
+   OutputSink& out,
    const std::map<std::string, std::string>& enum_values, 
    std::pair<std::map<std::string, std::string>, std::string>& additional_functions, 
    int& label_counter) const
 {
    auto this_ptr{ const_cast<MathStruct*>(this) };
-   std::string s{};
-   std::string operands{};
+
+   out << StaticHelper::makeString(OPENING_BRACKET) << this_ptr->getK2Operator();
 
    for (const auto& child : this_ptr->getTermsJumpIntoCompounds()) {
-      operands += " " + child->serializeK2(enum_values, additional_functions, label_counter);
+      out << " ";
+      child->serializeK2(out, enum_values, additional_functions, label_counter);
    }
 
-   s = StaticHelper::makeString(OPENING_BRACKET) + this_ptr->getK2Operator() + operands + StaticHelper::makeString(CLOSING_BRACKET);
+   out << StaticHelper::makeString(CLOSING_BRACKET);
+}
 
-   return s;
+std::string vfm::MathStruct::serializeK2(
+   const std::map<std::string, std::string>& enum_values, 
+   std::pair<std::map<std::string, std::string>, std::string>& additional_functions, 
+   int& label_counter) const
+{
+   StringSink out{};
+   serializeK2(out, enum_values, additional_functions, label_counter);
+   return out.str();
 }
+
 std::string vfm::MathStruct::serializeK2() const
 {
    std::pair<std::map<std::string, std::string>, std::string> dummy{};
@@ -1815,6 +1831,12 @@ int vfm::MathStruct::getNodeCount()
 
 int vfm::MathStruct::getNodeCount(const TraverseCompoundsType include_compound_structures)
 {
+   const auto attributes{ getAttributes() };
+
+   if (attributes->cacheable_) { // No compounds below, so include_compound_structures makes no difference.
+      return attributes->node_count_;
+   }
+
    int num = 0;
 
    applyToMeAndMyChildren([&num](const std::shared_ptr<MathStruct> m) {
@@ -1824,6 +1846,198 @@ int vfm::MathStruct::getNodeCount(const TraverseCompoundsType include_compound_s
    return num;
 }
 
+int vfm::MathStruct::getDepth()
+{
+   const auto attributes{ getAttributes() };
+
+   if (attributes->cacheable_) {
+      return attributes->depth_;
+   }
+
+   int depth{ 0 };
+
+   for (const auto& opnd : opnds_) {
+      depth = (std::max)(depth, opnd->getDepth());
+   }
+
+   return depth + 1;
+}
+
+static void combineHash(size_t& seed, const size_t hash)
+{
+   seed ^= hash + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+static size_t nodeHash(MathStruct* m)
+{
+   size_t hash{ std::hash<std::string>{}(m->getOptor()) };
+   const auto val{ m->toValueIfApplicable() };
+
+   combineHash(hash, m->getOperands().size());
+   if (val) combineHash(hash, std::hash<float>{}(val->getValue()));
+
+   return hash;
+}
+
+size_t vfm::MathStruct::getStructuralHash()
+{
+   const auto attributes{ getAttributes() };
+
+   if (attributes->cacheable_) {
+      return attributes->hash_;
+   }
+
+   size_t hash{ nodeHash(this) };
+
+   for (const auto& opnd : opnds_) {
+      combineHash(hash, opnd->getStructuralHash());
+   }
+
+   return hash;
+}
+
+std::set<std::string> vfm::MathStruct::getVariableNames()
+{
+   if (attributes_ && attributes_->cacheable_ && attributes_->variables_) {
+      if (cross_check_attribute_cache_) crossCheckAttributes(*attributes_);
+      return *attributes_->variables_;
+   }
+
+   const auto attributes{ getAttributes() };
+   std::set<std::string> variables{};
+   const auto var{ toVariableIfApplicable() };
+
+   if (var) variables.insert(var->getVariableName());
+
+   if (attributes->cacheable_) {
+      std::shared_ptr<const std::set<std::string>> single_source{};
+      int sources{ 0 };
+
+      for (const auto& opnd : opnds_) {
+         opnd->getVariableNames();
+         const auto& opnd_variables{ opnd->attributes_->variables_ };
+
+         if (!opnd_variables->empty() && opnd_variables != single_source) {
+            single_source = opnd_variables;
+            sources++;
+         }
+
+         variables.insert(opnd_variables->begin(), opnd_variables->end());
+      }
+
+      // Share the set with the only child contributing variables, which is the common case in chains.
+      attributes_->variables_ = !var && sources == 1 ? single_source : std::make_shared<const std::set<std::string>>(variables);
+      return variables;
+   }
+
+   for (const auto& opnd : opnds_) {
+      const auto opnd_variables{ opnd->getVariableNames() };
+      variables.insert(opnd_variables.begin(), opnd_variables.end());
+   }
+
+   return variables;
+}
+
+std::shared_ptr<const NodeAttributes> vfm::MathStruct::getAttributes()
+{
+   if (!attributes_) {
+      attributes_ = computeAttributes();
+   }
+   else if (cross_check_attribute_cache_ && attributes_->cacheable_) {
+      crossCheckAttributes(*attributes_);
+   }
+
+   return attributes_;
+}
+
+std::shared_ptr<NodeAttributes> vfm::MathStruct::computeAttributes()
+{
+   auto attributes{ std::make_shared<NodeAttributes>() };
+
+   if (!isValid() || isTermCompound() || isCompoundStructure() || isCompoundOperator()) {
+      return attributes; // Not cacheable.
+   }
+
+   attributes->node_count_ = 1;
+   attributes->hash_ = nodeHash(this);
+   attributes->sideeffects_ = hasSideeffectsThis();
+   attributes->purely_numbers_ = !isMetaCompound() && (!opnds_.empty() || toValueIfApplicable());
+
+   for (const auto& opnd : opnds_) {
+      const auto opnd_attributes{ opnd->getAttributes() };
+
+      if (!opnd_attributes->cacheable_) {
+         return std::make_shared<NodeAttributes>();
+      }
+
+      attributes->node_count_ += opnd_attributes->node_count_;
+      attributes->depth_ = (std::max)(attributes->depth_, opnd_attributes->depth_);
+      combineHash(attributes->hash_, opnd_attributes->hash_);
+      attributes->sideeffects_ = attributes->sideeffects_ || opnd_attributes->sideeffects_;
+      attributes->purely_numbers_ = attributes->purely_numbers_ && opnd_attributes->purely_numbers_;
+   }
+
+   attributes->depth_++;
+   attributes->constant_ = isOverallConstant(); // Looks only at the children's cached values.
+   attributes->cacheable_ = true;
+
+   return attributes;
+}
+
+void vfm::MathStruct::crossCheckAttributes(const NodeAttributes& cached)
+{
+   int node_count{ 0 };
+   int depth{ 0 };
+   std::set<std::string> variables{};
+   std::function<size_t(const MathStructPtr&, const int)> hash_and_count{};
+
+   hash_and_count = [&node_count, &depth, &variables, &hash_and_count](const MathStructPtr& m, const int level) {
+      size_t hash{ nodeHash(m.get()) };
+      const auto var{ m->toVariableIfApplicable() };
+
+      if (var) variables.insert(var->getVariableName());
+
+      node_count++;
+      depth = (std::max)(depth, level);
+
+      for (const auto& opnd : m->getOperands()) {
+         combineHash(hash, hash_and_count(opnd, level + 1));
+      }
+
+      return hash;
+   };
+
+   const size_t hash{ hash_and_count(shared_from_this(), 1) };
+   const bool constant{ isOverallConstant(nullptr, std::make_shared<std::set<std::shared_ptr<MathStruct>>>()) }; // Non-null "visited" bypasses the cache.
+   std::vector<std::string> mismatches{};
+
+   if (cached.constant_ != constant) mismatches.push_back("constant");
+   if (cached.sideeffects_ != hasSideeffectsByTraversal()) mismatches.push_back("sideeffects");
+   if (cached.purely_numbers_ != consistsPurelyOfNumbersByTraversal()) mismatches.push_back("purely_numbers");
+   if (cached.node_count_ != node_count) mismatches.push_back("node_count");
+   if (cached.depth_ != depth) mismatches.push_back("depth");
+   if (cached.hash_ != hash) mismatches.push_back("hash");
+   if (cached.variables_ && *cached.variables_ != variables) mismatches.push_back("variables");
+
+   if (!mismatches.empty()) {
+      Failable::getSingleton("AttributeCache")->addError("Stale cached attribute(s) '" + StaticHelper::tokensAsString(mismatches, true, ", ") + "' at '" + serializeWithinSurroundingFormula() + "'.");
+   }
+}
+
+void vfm::MathStruct::invalidateAttributes()
+{
+   attributes_.reset();
+
+   for (auto father{ father_.lock() }; father && father->attributes_; father = father->father_.lock()) {
+      father->attributes_.reset();
+   }
+}
+
+void vfm::MathStruct::setCrossCheckAttributeCache(const bool cross_check)
+{
+   cross_check_attribute_cache_ = cross_check;
+}
+
 int vfm::MathStruct::getLeafCount()
 {
    return getLeafCount(TraverseCompoundsType::avoid_compound_structures);
@@ -2436,6 +2650,10 @@ std::shared_ptr<MathStruct> MathStruct::setChildrensFathers(
       opnds_[0]->setChildrensFathers(stype, recursive);
    }
 
+   if (!recursive) { // Typically called right after changing the operands.
+      invalidateAttributes();
+   }
+
    makeValid();
 
    if (!visited.count(ptr_to_this)) {
@@ -2448,6 +2666,10 @@ std::shared_ptr<MathStruct> MathStruct::setChildrensFathers(
                t->father_.reset();
             }
             else {
+               if (t->father_.lock() != ptr_to_this) { // New child, so our sub-tree has changed.
+                  invalidateAttributes();
+               }
+
                t->father_ = ptr_to_this;
                t->makeValid();
             }
@@ -3115,13 +3337,30 @@ bool MathStruct::isOverallConstant(const std::shared_ptr<std::vector<int>> non_c
    bool all_constant = true;
 
    for (const auto& term : opnds_) {
-      all_constant = all_constant && term->isOverallConstant(non_const_metas, visited);
+      if (!all_constant) break;
+
+      if (!non_const_metas && !visited) { // Plain request, the children's cached results can be used.
+         const auto attributes{ term->getAttributes() };
+
+         if (attributes->cacheable_) {
+            all_constant = attributes->constant_;
+            continue;
+         }
+      }
+
+      all_constant = term->isOverallConstant(non_const_metas, visited);
    }
 
    return all_constant;
 }
 
 bool vfm::MathStruct::consistsPurelyOfNumbers()
+{
+   const auto attributes{ getAttributes() };
+   return attributes->cacheable_ ? attributes->purely_numbers_ : consistsPurelyOfNumbersByTraversal();
+}
+
+bool vfm::MathStruct::consistsPurelyOfNumbersByTraversal()
 {
    bool has_non_number_term{ false };
 
@@ -3150,6 +3389,12 @@ bool MathStruct::hasSideeffectsThis() const
 }
 
 bool vfm::MathStruct::hasSideeffects() const
+{
+   const auto attributes{ const_cast<MathStruct*>(this)->getAttributes() };
+   return attributes->cacheable_ ? attributes->sideeffects_ : hasSideeffectsByTraversal();
+}
+
+bool vfm::MathStruct::hasSideeffectsByTraversal() const
 {
    bool sideeffects{ false };
 
@@ -3342,19 +3587,21 @@ TermPtr MathStruct::simplify(
 
    auto formula = _id(term);
 
-   for (const auto& rrr : MetaRule::getMetaRulesByStage(all_rules)) {
+   const auto rules_by_stage{ MetaRule::getMetaRulesByStage(all_rules) };
+
+   for (const auto& rrr : rules_by_stage) {
       if (print_trace) {
          int stage = rrr.first;
          Failable::getSingleton()->addNotePlain("Entering simplification stage #" + std::to_string(stage) + ".");
       }
 
-      std::map<std::string, std::map<int, std::set<MetaRule>>> rules{ rrr.second };
+      const MetaRuleIndex rule_index{ rrr.second }; // Only rules whose pattern fits the node structurally are tried (and copied).
 
       bool changed = true;
       while (changed) {
          printTraceAndCheckForInfiniteLoop(formula, i, print_trace, old_terms);
          changed = false;
-         formula->getOperands()[0]->applyToMeAndMyChildrenIterative([&changed, rules_raw, p, &rules, print_trace](const MathStructPtr m) {
+         formula->getOperands()[0]->applyToMeAndMyChildrenIterative([&changed, &rule_index, print_trace](const MathStructPtr m) {
             //std::string ser = m->getPtrToRoot()->getTermsJumpIntoCompounds()[0]->serializePlainOldVFMStyleWithCompounds();
             //if (last != ser) {
             //   std::cout << "     FAST:   " << ser << std::endl;
@@ -3368,22 +3615,25 @@ TermPtr MathStruct::simplify(
                changed_this_time = true; // Since it's not a leaf, there was definitely a change.
             }
             else if (!m->isTermCompound()) {
-               auto& vec{ rules.at(m->getOptor()).at(m->getOpStruct().arg_num) };
+               int fired_anyway_group{ -1 };
+               bool refilter{ true };
 
-               for (const auto& r : vec) {
-                  if (m->applyMetaRule(r, print_trace)) {
-                     changed_this_time = true;
-                     break;
-                  }
-               }
+               // First the rules for the node's operator, then the SYMB_ANYWAY rules (at most one per group).
+               while (refilter) {
+                  refilter = false;
+
+                  for (const auto& candidate : rule_index.getCandidates(m)) {
+                     if (candidate.group_ <= fired_anyway_group) continue;
+
+                     if (m->applyMetaRule(*candidate.rule_, print_trace)) {
+                        changed_this_time = true;
 
-               if (!changed_this_time) {
-                  for (const auto& r_by_symb : rules.at(SYMB_ANYWAY)) {
-                     for (const auto& r : r_by_symb.second) {
-                        if (m->applyMetaRule(r, print_trace)) {
-                           changed_this_time = true;
-                           break;
+                        if (candidate.group_ > 0) {
+                           fired_anyway_group = candidate.group_;
+                           refilter = true; // m has changed, so the candidates of the remaining groups have to be determined anew.
                         }
+
+                        break;
                      }
                   }
                }
@@ -3507,6 +3757,7 @@ bool vfm::MathStruct::isValid() const
 
 void vfm::MathStruct::makeInvalid(const bool recursive)
 {
+   if (is_valid_) invalidateAttributes();
    is_valid_ = false;
 
    if (recursive) {
@@ -3518,6 +3769,7 @@ void vfm::MathStruct::makeInvalid(const bool recursive)
 
 void vfm::MathStruct::makeValid(const bool recursive)
 {
+   if (!is_valid_) invalidateAttributes();
    is_valid_ = true;
 
    if (recursive) {
@@ -3611,6 +3863,7 @@ void MathStruct::replaceOperand(const std::shared_ptr<Term> old, const std::shar
          }
          
          term->father_ = shared_from_this();
+         invalidateAttributes();
          return;
       }
    }
@@ -3623,6 +3876,7 @@ void vfm::MathStruct::replaceOperand(const int op_num, const std::shared_ptr<Ter
    }
    by->father_ = shared_from_this();
    opnds_[op_num] = by;
+   invalidateAttributes();
 }
 
 void vfm::MathStruct::replace(const std::shared_ptr<Term> by, const bool make_old_invalid)
@@ -3643,6 +3897,7 @@ void MathStruct::replaceOperandLookIntoCompounds(const std::shared_ptr<Term> old
          }
          term_raw = by; // We need to replace the actual term, not the possible CompoundOperator (which would invalidate the TermCompound)
          term_raw->father_ = shared_from_this();
+         invalidateAttributes();
          return;
       }
    }
@@ -3686,6 +3941,9 @@ void vfm::MathStruct::swapSubtrees(const TermPtr sub_formula1, const TermPtr sub
       }
    }
 
+   father1->invalidateAttributes();
+   father2->invalidateAttributes();
+
    assert(success1 && success2);
 }
 
@@ -3791,6 +4049,8 @@ bool MathStruct::applicableMetaRule(
                   new_term->getTermsJumpIntoCompounds()[i] = m->getOperands()[i + 1];
                }
 
+               new_term->thisPtrGoIntoCompound()->invalidateAttributes(); // Operands were written directly.
+
                m_term_anyway->replaceJumpOverCompounds(new_term, false);
 
                if (m == actual_from) {
@@ -3868,13 +4128,20 @@ bool MathStruct::applicableMetaRule(
          auto blacklist{ std::make_shared<std::vector<std::shared_ptr<MathStruct>>>() };
 
          auto func = [meta_num, actual_ptr, blacklist] (std::shared_ptr<MathStruct> m) {
+            bool replaced{ false };
+
             for (auto& mc : m->opnds_) {
                if (mc->isMetaSimplification() && mc->getTermsJumpIntoCompounds()[0]->constEval() == meta_num) {
                   mc = actual_ptr->/*copy()->*/toTermIfApplicable();
                   //m->setChildrensFathers(false, false);
                   blacklist->push_back(mc);
+                  replaced = true;
                }
             }
+
+            if (replaced) { // Not via replaceOperand since actual_ptr has to keep its father in the formula.
+               m->invalidateAttributes();
+            }
          };
 
          actual_from->getPtrToRoot()->applyToMeAndMyChildren(func, TraverseCompoundsType::avoid_compound_structures, nullptr, nullptr, blacklist);
@@ -3918,6 +4185,63 @@ bool MathStruct::applicableMetaRule(
    return !root || condition_ok;
 }
 
+bool MathStruct::mayApplyMetaRule(
+   const std::shared_ptr<vfm::Term>& from,
+   std::map<float, std::shared_ptr<MathStruct>>& bound_metas,
+   const bool concrete)
+{
+   auto ptr_to_this{ thisPtrGoIntoCompound() };
+   auto actual_from{ from->thisPtrGoIntoCompound() };
+
+   if (concrete && actual_from->isMetaSimplification()) {
+      return true; // Metas within the formula are left to applicableMetaRule.
+   }
+
+   int size{ (int) ptr_to_this->getOperands().size() };
+   int from_size{ (int) actual_from->getOperands().size() };
+   bool anyway{ actual_from->toTermAnywayIfApplicable() != nullptr };
+   bool matches{ actual_from->getOptor() == ptr_to_this->getOptor() && from_size == size || anyway && from_size - 1 == size };
+
+   if (matches && !ptr_to_this->isMetaSimplification()) {
+      if (anyway) {
+         return true; // TermAnyways are expanded in applicableMetaRule.
+      }
+
+      if (ptr_to_this->isTermVal() && actual_from->isTermVal() && ptr_to_this->constEval() != actual_from->constEval()) {
+         return false;
+      }
+
+      for (int i = 0; i < size; i++) {
+         if (!ptr_to_this->getOperands()[i]->mayApplyMetaRule(actual_from->getOperands()[i], bound_metas, concrete)) {
+            return false;
+         }
+      }
+
+      return true;
+   }
+   else if (matches) { // Don't match metas.
+      return false;
+   }
+   else if (actual_from->isTermOptional()) {
+      return mayApplyMetaRule(actual_from->getTermsJumpIntoCompounds()[0], bound_metas, concrete);
+   }
+   else if (actual_from->isMetaSimplification()) {
+      float meta_num{ actual_from->getOperands()[0]->constEval() };
+      auto bound{ bound_metas.find(meta_num) };
+
+      if (bound == bound_metas.end()) {
+         bound_metas.insert({ meta_num, shared_from_this() });
+         return true;
+      }
+
+      auto bound_term{ bound->second->toTermIfApplicable() };
+      return !bound_term || mayApplyMetaRule(bound_term, bound_metas, true); // Later occurrence has to look like the bound node.
+   }
+
+   return actual_from->getOpStruct().arg_num == 2 // Optional child is decided in applicableMetaRule.
+      && (actual_from->getOperands()[0]->isTermOptional() || actual_from->getOperands()[1]->isTermOptional());
+}
+
 bool MathStruct::applyMetaRule(const MetaRule& rule, const bool print_application_note)
 {
    //std::cout << "RULE: " << rule.serialize() << std::endl;
@@ -3939,6 +4263,12 @@ bool MathStruct::applyMetaRule(const MetaRule& rule, const bool print_applicatio
       return false;
    }
 
+   std::map<float, std::shared_ptr<MathStruct>> bound_metas{};
+
+   if (!mayApplyMetaRule(rule.getFrom(), bound_metas)) {
+      return false; // Only copy the rule if it can match.
+   }
+
    MetaRule cp{ rule.copy(true, true, true) };
 
    auto from{ cp.getFrom() };
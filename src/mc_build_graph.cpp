@@ -0,0 +1,114 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+
+#include "model_checking/mc_build_graph.h"
+#include "static_helper.h"
+
+using namespace vfm;
+using namespace mc;
+
+McBuildGraph::McBuildGraph(const std::filesystem::path& path_generated_config_level)
+   : Failable("McBuildGraph"), path_generated_config_level_(path_generated_config_level)
+{
+   load();
+}
+
+void McBuildGraph::setInput(const std::string& stage, const std::string& input_name, const std::string& content)
+{
+   current_inputs_[stage][input_name] = StaticHelper::hashFNV1aHex(content);
+}
+
+void McBuildGraph::setInputFromFile(const std::string& stage, const std::string& input_name, const std::filesystem::path& path)
+{
+   setInput(stage, input_name, StaticHelper::readFile(path));
+}
+
+void McBuildGraph::setInputFromFileList(
+   const std::string& stage,
+   const std::string& input_name,
+   const std::filesystem::path& path_to_file_list_file,
+   const std::string& separator)
+{
+   const std::string file_list{ StaticHelper::readFile(path_to_file_list_file) };
+   const std::filesystem::path parent_dir{ path_to_file_list_file.parent_path() };
+   uint64_t hash{ StaticHelper::hashFNV1a(file_list) };
+
+   for (const auto& file_name_raw : StaticHelper::split(StaticHelper::removeComments(file_list), separator)) {
+      const std::string file_name{ StaticHelper::removeWhiteSpace(file_name_raw) };
+
+      if (!file_name.empty()) {
+         hash = StaticHelper::hashFNV1a(StaticHelper::readFile(parent_dir / file_name), hash);
+      }
+   }
+
+   current_inputs_[stage][input_name] = StaticHelper::hashFNV1aHex(std::to_string(hash));
+}
+
+bool McBuildGraph::isUpToDate(const std::string& stage, const std::vector<std::filesystem::path>& required_outputs) const
+{
+   if (!stored_.contains(stage) || !current_inputs_.count(stage)) return false;
+
+   for (const auto& output : required_outputs) {
+      if (!StaticHelper::existsFileSafe(output)) {
+         addNote("Stage '" + stage + "' is out of date since output '" + output.string() + "' is missing.");
+         return false;
+      }
+   }
+
+   const auto& stored_inputs{ stored_.at(stage) };
+
+   if (stored_inputs.size() != current_inputs_.at(stage).size()) return false;
+
+   for (const auto& [input_name, hash] : current_inputs_.at(stage)) {
+      if (!stored_inputs.contains(input_name) || stored_inputs.at(input_name).get<std::string>() != hash) {
+         addNote("Stage '" + stage + "' is out of date since input '" + input_name + "' has changed.");
+         return false;
+      }
+   }
+
+   return true;
+}
+
+void McBuildGraph::markBuilt(const std::string& stage)
+{
+   if (!current_inputs_.count(stage)) {
+      addError("Cannot mark stage '" + stage + "' as built since no inputs have been registered for it.");
+      return;
+   }
+
+   stored_[stage] = current_inputs_.at(stage);
+   store();
+}
+
+void McBuildGraph::invalidate(const std::string& stage)
+{
+   if (stored_.contains(stage)) {
+      stored_.erase(stage);
+      store();
+   }
+}
+
+void McBuildGraph::load()
+{
+   const std::filesystem::path path{ path_generated_config_level_ / FILE_NAME_MC_BUILD_GRAPH };
+   stored_ = nlohmann::json::object();
+
+   if (!StaticHelper::existsFileSafe(path)) return;
+
+   try {
+      stored_ = nlohmann::json::parse(StaticHelper::readFile(path));
+   }
+   catch (const nlohmann::json::parse_error& e) {
+      addWarning("Build graph '" + path.string() + "' is corrupt and will be ignored. Error: " + e.what());
+      stored_ = nlohmann::json::object();
+   }
+}
+
+void McBuildGraph::store() const
+{
+   StaticHelper::writeTextToFile(stored_.dump(3), path_generated_config_level_ / FILE_NAME_MC_BUILD_GRAPH);
+}
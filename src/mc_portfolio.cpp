@@ -0,0 +1,229 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+
+#include "model_checking/mc_portfolio.h"
+#include "static_helper.h"
+#include "json_parsing/json.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <regex>
+#include <thread>
+
+using namespace vfm;
+using namespace mc;
+
+std::mutex McPortfolio::statistics_mutex_{};
+
+McPortfolio::McPortfolio(const std::filesystem::path& path_to_statistics_file)
+   : Failable("McPortfolio"), path_to_statistics_file_(path_to_statistics_file)
+{}
+
+std::vector<PortfolioVariant> McPortfolio::createDefaultVariants(const std::string& template_name, const std::string& generated_script)
+{
+   int bmc_depth{ 100 };
+   std::smatch match{};
+
+   if (std::regex_search(generated_script, match, std::regex("-k\\s+([0-9]+)"))) {
+      bmc_depth = std::stoi(match[1].str());
+   }
+
+   const int bmc_depth_short{ std::max(1, bmc_depth / 4) };
+
+   if (template_name == PORTFOLIO_TEMPLATE_LTL) {
+      return {
+         { "bmc_k" + std::to_string(bmc_depth_short), "go_msat\nmsat_check_ltlspec_bmc -k " + std::to_string(bmc_depth_short) + "\nquit\n" },
+         { "bmc_k" + std::to_string(bmc_depth), "go_msat\nmsat_check_ltlspec_bmc -k " + std::to_string(bmc_depth) + "\nquit\n" },
+         { "ic3", "go_msat\ncheck_ltlspec_ic3 -i -a 1 -O 2\nquit\n" },
+         { "bdd", "go\ncheck_ltlspec\nquit\n" },
+      };
+   }
+
+   return {
+      { "bmc_k" + std::to_string(bmc_depth_short), "go_msat\nmsat_check_invar_bmc -i -a falsification -k " + std::to_string(bmc_depth_short) + "\nquit\n" },
+      { "bmc_k" + std::to_string(bmc_depth), "go_msat\nmsat_check_invar_bmc -i -a falsification -k " + std::to_string(bmc_depth) + "\nquit\n" },
+      { "ic3", "go_msat\ncheck_invar_ic3 -i -a 1 -O 2\nquit\n" },
+      { "bdd", "go\ncheck_invar\nquit\n" },
+   };
+}
+
+std::string McPortfolio::deriveTemplateName(const std::string& main_smv)
+{
+   return StaticHelper::stringContains(main_smv, "LTLSPEC") ? PORTFOLIO_TEMPLATE_LTL : PORTFOLIO_TEMPLATE_INVAR;
+}
+
+McVerdict McPortfolio::classifyNuXmvOutput(const std::string& output)
+{
+   int num_true{ 0 };
+   int num_undecided{ 0 };
+
+   for (const auto& line_raw : StaticHelper::split(output, '\n')) {
+      const std::string line{ StaticHelper::trimAndReturn(line_raw) };
+
+      if (!StaticHelper::stringStartsWith(line, "-- ")) continue;
+
+      if (StaticHelper::stringEndsWith(line, " is false")) {
+         return McVerdict::falsified; // One CEX is enough to decide the run.
+      }
+      else if (StaticHelper::stringEndsWith(line, " is true")) {
+         num_true++;
+      }
+      else if (StaticHelper::stringStartsWith(line, "-- no counterexample found")) {
+         num_undecided++;
+      }
+   }
+
+   return num_true > 0 && num_undecided == 0 ? McVerdict::proved : McVerdict::inconclusive;
+}
+
+PortfolioResult McPortfolio::run(
+   const std::string& nuxmv_exec,
+   const std::filesystem::path& path_main_smv,
+   const std::string& template_name,
+   const std::vector<PortfolioVariant>& variants,
+   const std::map<std::string, std::string>& env,
+   const ProcessLimits& limits,
+   const int max_parallel,
+   const std::function<void(const std::string& output_so_far)>& on_first_cex)
+{
+   const auto ordered{ orderByPastWins(template_name, variants) };
+   const int n{ (int)ordered.size() };
+   PortfolioResult result{};
+   std::vector<std::unique_ptr<ProcessRunner>> runners{};
+   std::vector<std::unique_ptr<NusmvCexStreamer>> streamers{};
+   std::vector<ProcessStatistics> statistics(n);
+   std::vector<bool> launched(n, false);
+   std::vector<std::thread> threads{};
+   std::mutex mutex{};
+   std::condition_variable slot_freed{};
+   int running{ 0 };
+   bool first_cex_handed_out{ false };
+
+   for (int i = 0; i < n; i++) {
+      runners.push_back(std::make_unique<ProcessRunner>());
+      streamers.push_back(std::make_unique<NusmvCexStreamer>([&, i](const MCTrace& trace, const int cex_num) {
+         std::lock_guard<std::mutex> lock{ mutex };
+
+         if (on_first_cex && !first_cex_handed_out) {
+            first_cex_handed_out = true;
+            on_first_cex(streamers[i]->getFullOutput());
+         }
+      }));
+   }
+
+   for (int i = 0; i < n; i++) {
+      {
+         std::unique_lock<std::mutex> lock{ mutex };
+         slot_freed.wait(lock, [&running, &result, max_parallel]() { return running < std::max(1, max_parallel) || !result.winner_.empty(); });
+         if (!result.winner_.empty()) break;
+         running++;
+         launched[i] = true;
+      }
+
+      const std::filesystem::path path_script{ path_main_smv.parent_path() / ("script_portfolio_" + ordered[i].name_ + ".cmd") };
+      StaticHelper::writeTextToFile(ordered[i].script_, path_script);
+      addNote("Launching portfolio variant '" + ordered[i].name_ + "' (" + template_name + ").");
+
+      threads.emplace_back([&, i, path_script]() {
+         statistics[i] = runners[i]->run(
+            { nuxmv_exec, "-int", "-pre", "cpp", "-source", path_script.string(), path_main_smv.string() },
+            env,
+            limits,
+            [&streamers, i](const std::string& chunk) { streamers[i]->feed(chunk); });
+
+         streamers[i]->finish();
+         const std::string& output{ streamers[i]->getFullOutput() };
+         const McVerdict verdict{ classifyNuXmvOutput(output) };
+
+         {
+            std::lock_guard<std::mutex> lock{ mutex };
+            running--;
+
+            if (verdict != McVerdict::inconclusive && !statistics[i].cancelled && result.winner_.empty()) {
+               result.winner_ = ordered[i].name_;
+               result.verdict_ = verdict;
+               result.output_ = output;
+               result.statistics_ = statistics[i];
+
+               for (int j = 0; j < n; j++) {
+                  if (j != i) runners[j]->cancel();
+               }
+            }
+         }
+
+         slot_freed.notify_all();
+      });
+   }
+
+   for (auto& thread : threads) thread.join();
+
+   if (result.winner_.empty()) {
+      addWarning("No portfolio variant came to a conclusive result for '" + path_main_smv.string() + "'.");
+      result.output_ = streamers.empty() ? "" : streamers[0]->getFullOutput();
+      result.statistics_ = statistics.empty() ? ProcessStatistics{} : statistics[0];
+   }
+   else {
+      addNote("Portfolio variant '" + result.winner_ + "' won after " + StaticHelper::printTimeFormatted(result.statistics_.wall_time) + ".");
+   }
+
+   for (int i = 0; i < n; i++) {
+      if (launched[i]) recordRun(template_name, ordered[i].name_, ordered[i].name_ == result.winner_, statistics[i].wall_time);
+   }
+
+   return result;
+}
+
+std::vector<PortfolioVariant> McPortfolio::orderByPastWins(const std::string& template_name, const std::vector<PortfolioVariant>& variants) const
+{
+   std::lock_guard<std::mutex> lock{ statistics_mutex_ };
+   nlohmann::json stats{};
+
+   try {
+      const std::string stats_str{ StaticHelper::readFile(path_to_statistics_file_) };
+      if (!stats_str.empty()) stats = nlohmann::json::parse(stats_str);
+   }
+   catch (const nlohmann::json::parse_error& e) {
+      addWarning("Portfolio statistics '" + path_to_statistics_file_.string() + "' are corrupt and will be ignored.");
+   }
+
+   const auto wins = [&stats, &template_name](const PortfolioVariant& variant) -> int {
+      if (stats.contains(template_name) && stats.at(template_name).contains(variant.name_)) {
+         return stats.at(template_name).at(variant.name_).value("wins", 0);
+      }
+
+      return 0;
+   };
+
+   auto ordered{ variants };
+   std::stable_sort(ordered.begin(), ordered.end(), [&wins](const PortfolioVariant& a, const PortfolioVariant& b) { return wins(a) > wins(b); });
+   return ordered;
+}
+
+void McPortfolio::recordRun(const std::string& template_name, const std::string& variant, const bool won, const std::chrono::nanoseconds& wall_time)
+{
+   std::lock_guard<std::mutex> lock{ statistics_mutex_ };
+   nlohmann::json stats = nlohmann::json::object();
+
+   try {
+      const std::string stats_str{ StaticHelper::readFile(path_to_statistics_file_) };
+      if (!stats_str.empty()) stats = nlohmann::json::parse(stats_str);
+   }
+   catch (const nlohmann::json::parse_error& e) {
+      stats = nlohmann::json::object();
+   }
+
+   auto& entry{ stats[template_name][variant] };
+   entry["runs"] = entry.value("runs", 0) + 1;
+   entry["wins"] = entry.value("wins", 0) + (won ? 1 : 0);
+
+   if (won) {
+      entry["seconds_to_win_total"] = entry.value("seconds_to_win_total", 0.0) + std::chrono::duration<double>(wall_time).count();
+   }
+
+   StaticHelper::writeTextToFile(stats.dump(3), path_to_statistics_file_);
+}
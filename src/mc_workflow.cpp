@@ -6,6 +6,7 @@
 /// @file
 
 #include "model_checking/mc_workflow.h"
+#include "model_checking/mc_build_graph.h"
 #include "testing/interactive_testing.h"
 #include "vfmacro/script.h"
 #include <thread>
@@ -189,16 +190,14 @@ void McWorkflow::runMCJob(
    const auto path_external{ getExternalDir(path_json, json_tpl_filename) };
    const auto cex_file_name{ getCEXFileName(path_json, json_tpl_filename) };
    bool generate_preview{ false };
+   bool mc_up_to_date{ false };
+   McBuildGraph build_graph{ path_generated_config_level };
    
    {
       std::lock_guard<std::mutex> lock{ main_file_mutex_ };
 
       addNote("Running model checker and creating preview for folder '" + path_generated_config_level.string() + "' (config: '" + config_name + "').");
 
-      if (delete_old_output) {
-         deleteMCOutputFromFolder(path_generated_config_level, true, path_json, previous_write_time);
-      }
-
       preprocessAndRewriteJSONTemplate(path_json, json_tpl_filename, formula_evaluation_mutex);
 
       if (!putJSONIntoDataPack(path_json, json_tpl_filename)) return;
@@ -211,9 +210,6 @@ void McWorkflow::runMCJob(
       std::string script_template{ StaticHelper::readFile(path_template + "/script.tpl") };
       std::string main_template{ StaticHelper::readFile(path_template + "/main.tpl") };
       std::string generated_script{ CppParser::generateScript(script_template, data_, parser_) };
-      StaticHelper::writeTextToFile(generated_script, path_generated_config_level / "script.cmd");
-
-      addNote("Created script.cmd with the following content:\n" + StaticHelper::readFile(path_generated_config_level / "script.cmd") + "<EOF>");
 
       static const std::string SPEC_BEGIN{ "--SPEC-STUFF" };
       static const std::string SPEC_END{ "--EO-SPEC-STUFF" };
@@ -243,25 +239,92 @@ void McWorkflow::runMCJob(
          generate_preview = true;
       }
 
-      StaticHelper::writeTextToFile(main_smv, path_generated_config_level / "main.smv");
+      // Register everything the model checker run depends on. If nothing changed since the last
+      // successful run, we keep main.smv, script.cmd and the CEX as they are.
+      const nlohmann::json j_instances{ getJSON(path_json + "/" + getJsonFileNameFromJsonTemplateFileName(json_tpl_filename)) };
+      const nlohmann::json j_template{ getJSON(path_json + "/" + json_tpl_filename) };
+      const auto path_envmodel_folder{ getEnvmodelDir(path_json, json_tpl_filename) };
+
+      build_graph.setInputFromFileList(MC_STAGE_MODEL_CHECKING, MC_INPUT_PLANNER, getBPIncludesFileDir(path_json, json_tpl_filename), std::string(1, PROGRAM_COMMAND_SEPARATOR));
+      build_graph.setInputFromFileList(MC_STAGE_MODEL_CHECKING, MC_INPUT_ENVMODEL, path_envmodel_folder / test::ENVMODEL_INCLUDES_FILENAME, "\n");
+      build_graph.setInput(MC_STAGE_MODEL_CHECKING, MC_INPUT_CONFIG, (j_instances.contains(config_name) ? j_instances.at(config_name).dump() : "") + j_template.dump());
+      build_graph.setInput(MC_STAGE_MODEL_CHECKING, MC_INPUT_SPEC, spec_part);
+      build_graph.setInput(MC_STAGE_MODEL_CHECKING, MC_INPUT_SCRIPT, generated_script);
+      build_graph.setInput(MC_STAGE_MODEL_CHECKING, MC_INPUT_MAIN_SMV, main_smv);
+
+      mc_up_to_date = incremental_mode_ && build_graph.isUpToDate(
+         MC_STAGE_MODEL_CHECKING,
+         { path_generated_config_level / cex_file_name, path_generated_config_level / "script.cmd", path_generated_config_level / "main.smv" });
+
+      if (mc_up_to_date) {
+         addNote("Inputs of folder '" + path_generated_config_level.string() + "' unchanged since last run. Reusing main.smv and CEX.");
+      }
+      else {
+         if (delete_old_output) {
+            deleteMCOutputFromFolder(path_generated_config_level, true, path_json, previous_write_time);
+         }
+
+         StaticHelper::writeTextToFile(generated_script, path_generated_config_level / "script.cmd");
+         addNote("Created script.cmd with the following content:\n" + StaticHelper::readFile(path_generated_config_level / "script.cmd") + "<EOF>");
+         StaticHelper::writeTextToFile(main_smv, path_generated_config_level / "main.smv");
+      }
+   }
+
+   if (!mc_up_to_date) {
+      build_graph.invalidate(MC_STAGE_MODEL_CHECKING);
+
+      test::convenienceArtifactRunHardcoded(
+         test::MCExecutionType::mc, 
+         path_generated_config_level.string(), 
+         "FAKE_PATH_NOT_USED", 
+         path_template, 
+         "FAKE_PATH_NOT_USED", 
+         path_cached.string(), 
+         path_external.string(),
+         ".",
+         cex_file_name.string(),
+         portfolio_mode_ ? " --mc-portfolio" : "");
+
+      if (StaticHelper::existsFileSafe(path_generated_config_level / cex_file_name)) {
+         build_graph.markBuilt(MC_STAGE_MODEL_CHECKING);
+      }
    }
 
-   test::convenienceArtifactRunHardcoded(
-      test::MCExecutionType::mc, 
-      path_generated_config_level.string(), 
-      "FAKE_PATH_NOT_USED", 
-      path_template, 
-      "FAKE_PATH_NOT_USED", 
-      path_cached.string(), 
-      path_external.string(),
-      ".",
-      cex_file_name.string());
+   if (generate_preview) {
+      build_graph.setInputFromFile(MC_STAGE_PREVIEW, MC_INPUT_CEX, path_generated_config_level / cex_file_name);
 
-   if (generate_preview) generatePreview(path_generated_config_level, 0);
+      if (incremental_mode_ && build_graph.isUpToDate(MC_STAGE_PREVIEW, { path_generated_config_level / "0" })) {
+         addNote("CEX of folder '" + path_generated_config_level.string() + "' unchanged since last run. Reusing preview.");
+      }
+      else {
+         generatePreview(path_generated_config_level, 0);
+         build_graph.markBuilt(MC_STAGE_PREVIEW);
+      }
+   }
 
    addNote("Model checker run finished for folder '" + path_generated_config_level.string() + "'.");
 }
 
+void McWorkflow::setIncrementalMode(const bool incremental)
+{
+   incremental_mode_ = incremental;
+}
+
+bool McWorkflow::isIncrementalMode() const
+{
+   return incremental_mode_;
+}
+
+void McWorkflow::setPortfolioMode(const bool portfolio)
+{
+   portfolio_mode_ = portfolio;
+}
+
+bool McWorkflow::isPortfolioMode() const
+{
+   return portfolio_mode_;
+}
+
 void McWorkflow::createTestCase(
    const std::string& generated_parent_dir, 
    const std::string& id, 
@@ -0,0 +1,201 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+
+#include "meta_rule_index.h"
+#include <algorithm>
+
+using namespace vfm;
+
+MetaRuleIndex::MetaRuleIndex(const Rules& rules)
+{
+   int order{ 0 };
+   int anyway_group{ 0 };
+
+   for (const auto& [optor, rules_by_arity] : rules) {
+      const bool anyway{ optor == SYMB_ANYWAY };
+
+      for (const auto& [arg_num, rule_set] : rules_by_arity) {
+         int root_num{ 0 };
+
+         if (anyway) {
+            anyway_group++;
+         }
+         else {
+            root_num = nodes_.size();
+            nodes_.push_back({});
+            roots_[{ optor, arg_num }] = root_num;
+         }
+
+         for (const auto& rule : rule_set) {
+            insert(root_num, rule, anyway ? anyway_group : 0, order++);
+         }
+      }
+   }
+}
+
+std::vector<MetaRuleIndex::Candidate> MetaRuleIndex::getCandidates(const MathStructPtr& m) const
+{
+   std::vector<Candidate> result{};
+   const auto it{ roots_.find({ m->getOptor(), m->getOpStruct().arg_num }) };
+
+   if (it != roots_.end()) {
+      collectFrom(it->second, m, result);
+   }
+
+   collectFrom(0, m, result);
+
+   return result;
+}
+
+int MetaRuleIndex::size() const
+{
+   return size_;
+}
+
+void MetaRuleIndex::insert(const int root_num, const MetaRule& rule, const int group, const int order)
+{
+   std::vector<int> path{};
+   flattenPattern(rule.getFrom(), path);
+
+   int node_num{ root_num };
+
+   for (const int symbol : path) {
+      int next{ symbol == WILDCARD ? nodes_[node_num].wildcard_child_ : -1 };
+
+      if (symbol != WILDCARD) {
+         const auto it{ nodes_[node_num].children_.find(symbol) };
+         if (it != nodes_[node_num].children_.end()) next = it->second;
+      }
+
+      if (next < 0) {
+         next = nodes_.size();
+         nodes_.push_back({}); // Invalidates references into nodes_, hence the indices.
+
+         if (symbol == WILDCARD) nodes_[node_num].wildcard_child_ = next;
+         else nodes_[node_num].children_[symbol] = next;
+      }
+
+      node_num = next;
+   }
+
+   nodes_[node_num].rules_.push_back({ &rule, group, order });
+   size_++;
+}
+
+void MetaRuleIndex::flattenPattern(const MathStructPtr& pattern, std::vector<int>& path)
+{
+   const auto actual{ pattern->thisPtrGoIntoCompound() };
+   auto& operands{ actual->getOperands() };
+   const bool has_optional_operand{ actual->getOpStruct().arg_num == 2 && operands.size() == 2
+      && (operands[0]->isTermOptional() || operands[1]->isTermOptional()) };
+
+   if (actual->isMetaSimplification() || actual->isTermOptional() || has_optional_operand) {
+      path.push_back(WILDCARD); // Can be bound to the whole sub-tree.
+      return;
+   }
+
+   auto& terms{ actual->getTermsJumpIntoCompounds() };
+
+   if (actual->toTermAnywayIfApplicable()) { // First operand is the identificator, operator is arbitrary.
+      const int arity{ (int) operands.size() - 1 };
+      auto it{ anyway_symbol_ids_.find(arity) };
+
+      if (it == anyway_symbol_ids_.end()) {
+         it = anyway_symbol_ids_.insert({ arity, getOrCreateSymbol(SYMB_ANYWAY, arity) }).first;
+      }
+
+      path.push_back(it->second);
+
+      for (size_t i = 1; i < terms.size(); i++) {
+         flattenPattern(terms[i], path);
+      }
+
+      return;
+   }
+
+   path.push_back(getOrCreateSymbol(actual->getOptor(), operands.size()));
+
+   for (const auto& term : terms) {
+      flattenPattern(term, path);
+   }
+}
+
+void MetaRuleIndex::collectFrom(const int root_num, const MathStructPtr& m, std::vector<Candidate>& result) const
+{
+   const size_t begin{ result.size() };
+   std::vector<MathStructPtr> pending{ m };
+
+   collect(root_num, pending, result);
+   std::sort(result.begin() + begin, result.end());
+}
+
+void MetaRuleIndex::collect(const int node_num, std::vector<MathStructPtr>& pending, std::vector<Candidate>& result) const
+{
+   const Node& node{ nodes_[node_num] };
+
+   if (pending.empty()) {
+      result.insert(result.end(), node.rules_.begin(), node.rules_.end());
+      return;
+   }
+
+   const MathStructPtr m{ pending.back() };
+   pending.pop_back();
+
+   if (node.wildcard_child_ >= 0) {
+      collect(node.wildcard_child_, pending, result);
+   }
+
+   const auto ptr_to_m{ m->thisPtrGoIntoCompound() };
+
+   if (!ptr_to_m->isMetaSimplification()) { // Metas in the formula are never matched by operators.
+      const int arity{ (int) ptr_to_m->getOperands().size() };
+      const auto it{ node.children_.find(symbolOf(m)) };
+      const auto it_anyway{ anyway_symbol_ids_.find(arity) };
+      std::vector<int> next_nodes{};
+
+      if (it != node.children_.end()) next_nodes.push_back(it->second);
+
+      if (it_anyway != anyway_symbol_ids_.end()) {
+         const auto it_anyway_child{ node.children_.find(it_anyway->second) };
+         if (it_anyway_child != node.children_.end() && it_anyway_child != it) next_nodes.push_back(it_anyway_child->second);
+      }
+
+      if (!next_nodes.empty()) {
+         auto& terms{ m->getTermsJumpIntoCompounds() };
+         const size_t old_size{ pending.size() };
+
+         for (int i = std::min<int>(arity, terms.size()) - 1; i >= 0; i--) {
+            pending.push_back(terms[i]);
+         }
+
+         for (const int next : next_nodes) {
+            collect(next, pending, result);
+         }
+
+         pending.resize(old_size);
+      }
+   }
+
+   pending.push_back(m);
+}
+
+int MetaRuleIndex::symbolOf(const MathStructPtr& m) const
+{
+   const auto ptr_to_m{ m->thisPtrGoIntoCompound() };
+   const auto it{ symbol_ids_.find(symbolName(ptr_to_m->getOptor(), ptr_to_m->getOperands().size())) };
+   return it == symbol_ids_.end() ? WILDCARD : it->second;
+}
+
+int MetaRuleIndex::getOrCreateSymbol(const std::string& optor, const int arity)
+{
+   return symbol_ids_.insert({ symbolName(optor, arity), (int) symbol_ids_.size() }).first->second;
+}
+
+std::string MetaRuleIndex::symbolName(const std::string& optor, const int arity)
+{
+   return optor + "/" + std::to_string(arity);
+}
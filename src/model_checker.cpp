@@ -7,6 +7,10 @@
 
 #include "model_checking/model_checker.h"
 #include "simulation/highway_image.h"
+#include <atomic>
+#include <cstring>
+#include <deque>
+#include <thread>
 
 using namespace vfm;
 
@@ -21,58 +25,37 @@ const ModelConfiguration MC::CONFIG_HELLO_WORLD = {
    } };
 
 // ACC
-const int SPEED_MIN_ACC = 0;                             // 0
-const int SPEED_MAX_ACC = 2;                   // 10     // 2
-const int SPEED_STEP_ACC = 1;                            // 1
-const int DISTANCE_MIN_ACC = 9;  // "Close"    // 10     // 9
-const int DISTANCE_MAX_ACC = 27; // "Infinite" // 25     // 27
-const int DISTANCE_STEP_ACC = 9;               // 3      // 9
-
-const ModelConfiguration MC::CONFIG_SIMPLE_ACC = {
-   MC::generateFullSystemSeedACC(), // SEED
-   [](const SystemState& state) {   // TRANSITION FUNCTION.
+ModelConfiguration MC::createConfigSimpleACC(const AccRanges& ranges)
+{
+   return {
+   MC::generateFullSystemSeedACC(ranges), // SEED
+   [ranges](const SystemState& state) {   // TRANSITION FUNCTION.
       SystemStateVec vec;
       SystemState s1 = state, s2 = state, s3 = state;
       int egoSpeed = getEgoSpeed(state);
       int otherSpeed = getOtherSpeed(state, 0);
       int otherPos = getOtherPos(state, 0);
 
-      // if (otherPos < DISTANCE_MAX_ACC) {
-         if (egoSpeed > otherSpeed) {
-            otherPos -= DISTANCE_STEP_ACC * (egoSpeed - otherSpeed);
-            egoSpeed -= SPEED_STEP_ACC;
-         } else if (egoSpeed < otherSpeed) {
-            otherPos += DISTANCE_STEP_ACC * (otherSpeed - egoSpeed);
-            egoSpeed += SPEED_STEP_ACC;
-         }
-      // } else {
-         // for (int i = SPEED_MIN_ACC; i < egoSpeed; i++) {
-         //    SystemState s = state;
-         //    setOtherPos(s, 0, DISTANCE_MAX_ACC - DISTANCE_STEP_ACC);
-         //    setOtherSpeed(s, 0, i);
-         //    vec.push_back(s);
-         // }
-
-         // return vec;
-      // }
-
-      // if (otherPos >= DISTANCE_MAX_ACC) { // Only one state in case of "infinite" distance.
-      //    otherPos = DISTANCE_MAX_ACC;
-      //    otherSpeed = SPEED_MIN_ACC - SPEED_STEP_ACC;
-      // }
-
-      if (otherPos < DISTANCE_MIN_ACC) { // No valid following states available.
+      if (egoSpeed > otherSpeed) {
+         otherPos -= ranges.distance_step_ * (egoSpeed - otherSpeed);
+         egoSpeed -= ranges.speed_step_;
+      } else if (egoSpeed < otherSpeed) {
+         otherPos += ranges.distance_step_ * (otherSpeed - egoSpeed);
+         egoSpeed += ranges.speed_step_;
+      }
+
+      if (otherPos < ranges.distance_min_) { // No valid following states available.
          return vec;
       }
 
       setEgoSpeed(s1, egoSpeed);
-      setOtherSpeed(s1, 0, std::min(std::max(otherSpeed, SPEED_MIN_ACC), SPEED_MAX_ACC));
+      setOtherSpeed(s1, 0, std::min(std::max(otherSpeed, ranges.speed_min_), ranges.speed_max_));
       setOtherPos(s1, 0, otherPos);
       setEgoSpeed(s2, egoSpeed);
-      setOtherSpeed(s2, 0, std::min(SPEED_MAX_ACC, otherSpeed + 1));
+      setOtherSpeed(s2, 0, std::min(ranges.speed_max_, otherSpeed + 1));
       setOtherPos(s2, 0, otherPos);
       setEgoSpeed(s3, egoSpeed);
-      setOtherSpeed(s3, 0, std::max(SPEED_MIN_ACC, otherSpeed - 1));
+      setOtherSpeed(s3, 0, std::max(ranges.speed_min_, otherSpeed - 1));
       setOtherPos(s3, 0, otherPos);
 
       vec.push_back(s1);
@@ -81,6 +64,9 @@ const ModelConfiguration MC::CONFIG_SIMPLE_ACC = {
 
       return vec;
    } };
+}
+
+const ModelConfiguration MC::CONFIG_SIMPLE_ACC = MC::createConfigSimpleACC();
 
 const std::vector<float> DRAW_CONFIG_ACC{ 230, 40, -9 };
 
@@ -278,6 +264,189 @@ void vfm::MC::generateOnePath(const int num_to_take_on_nondeterminism, const std
    }
 }
 
+namespace {
+
+inline size_t mixHash(uint64_t x) // splitmix64 finalizer.
+{
+   x ^= x >> 30;
+   x *= 0xbf58476d1ce4e5b9ULL;
+   x ^= x >> 27;
+   x *= 0x94d049bb133111ebULL;
+   x ^= x >> 31;
+   return x;
+}
+
+inline void hashCombine(uint64_t& seed, float val)
+{
+   uint32_t bits;
+   val = val == 0 ? 0 : val; // -0 == 0, so they have to hash the same.
+   std::memcpy(&bits, &val, sizeof(bits));
+   seed = mixHash(seed ^ (bits + 0x9e3779b97f4a7c15ULL));
+}
+
+inline void hashCombine(uint64_t& seed, const CarPars& car)
+{
+   hashCombine(seed, car.car_lane_);
+   hashCombine(seed, car.car_rel_pos_);
+   hashCombine(seed, (float) car.car_velocity_);
+}
+
+/// Hash set of the visited states which also numbers them 1, 2, ... in the order of insertion.
+/// Open addressing over the state numbers, so every state is stored once only.
+class StateNumbering {
+public:
+   StateNumbering() : slots_(1024, 0) {}
+
+   /// @return The number of the state, and if it has been inserted right now.
+   inline std::pair<int, bool> insert(const SystemState& state, const size_t hash)
+   {
+      size_t pos{ hash & (slots_.size() - 1) };
+
+      for (; slots_[pos]; pos = (pos + 1) & (slots_.size() - 1)) {
+         const int num{ slots_[pos] };
+
+         if (hashes_[num - 1] == hash && states_[num - 1] == state) {
+            return { num, false };
+         }
+      }
+
+      states_.push_back(state);
+      hashes_.push_back(hash);
+      slots_[pos] = states_.size();
+
+      if (states_.size() * 2 > slots_.size()) {
+         grow();
+      }
+
+      return { (int) states_.size(), true };
+   }
+
+   inline const SystemState& getState(const int num) const { return states_[num - 1]; }
+   inline int size() const { return states_.size(); }
+
+private:
+   void grow()
+   {
+      std::vector<int> slots(slots_.size() * 2, 0);
+
+      for (int num = 1; num <= size(); num++) {
+         size_t pos{ hashes_[num - 1] & (slots.size() - 1) };
+         while (slots[pos]) pos = (pos + 1) & (slots.size() - 1);
+         slots[pos] = num;
+      }
+
+      slots_ = std::move(slots);
+   }
+
+   std::vector<SystemState> states_{};
+   std::vector<size_t> hashes_{};
+   std::vector<int> slots_{}; // 0 means empty, size is a power of 2.
+};
+
+/// Bloom filter for "bitstate hashing": a state counts as visited if all of its bits are set.
+class BitstateFilter {
+public:
+   static constexpr int NUM_BITS_PER_STATE{ 3 };
+
+   BitstateFilter(const int log2_bits) : bits_(((size_t) 1 << std::max(log2_bits, 6)) / 64, 0), mask_(((size_t) 1 << std::max(log2_bits, 6)) - 1) {}
+
+   /// @return True if the state has not been seen before (or, rarely, is mistaken for a seen one).
+   inline bool insert(const size_t hash)
+   {
+      const size_t step{ mixHash(hash) | 1 }; // Double hashing.
+      bool is_new{ false };
+
+      for (int i = 0; i < NUM_BITS_PER_STATE; i++) {
+         const size_t bit{ (hash + i * step) & mask_ };
+         uint64_t& word{ bits_[bit >> 6] };
+         const uint64_t flag{ (uint64_t) 1 << (bit & 63) };
+         is_new |= !(word & flag);
+         word |= flag;
+      }
+
+      return is_new;
+   }
+
+private:
+   std::vector<uint64_t> bits_;
+   size_t mask_;
+};
+
+struct Successors {
+   SystemStateVec states_{};
+   std::vector<size_t> hashes_{};
+};
+
+/// Computes the successors of all the source states, without duplicates per source and in the order
+/// the transition function yields them. The sources are distributed over up to num_threads threads.
+std::vector<Successors> expandStates(const TransFuncType& trans_func, const std::vector<const SystemState*>& sources, const int num_threads)
+{
+   constexpr size_t CHUNK_SIZE{ 16 };
+   const SystemStateHash hasher{};
+   std::vector<Successors> result(sources.size());
+   std::atomic<size_t> next_chunk{ 0 };
+
+   const auto work = [&]() {
+      for (size_t begin = next_chunk.fetch_add(CHUNK_SIZE); begin < sources.size(); begin = next_chunk.fetch_add(CHUNK_SIZE)) {
+         for (size_t k = begin; k < std::min(begin + CHUNK_SIZE, sources.size()); k++) {
+            Successors& succ{ result[k] };
+
+            for (auto& next_state : trans_func(*sources[k])) {
+               const size_t hash{ hasher(next_state) };
+               bool duplicate{ false };
+
+               for (size_t j = 0; j < succ.states_.size() && !duplicate; j++) {
+                  duplicate = succ.hashes_[j] == hash && succ.states_[j] == next_state;
+               }
+
+               if (!duplicate) {
+                  succ.states_.push_back(std::move(next_state));
+                  succ.hashes_.push_back(hash);
+               }
+            }
+         }
+      }
+   };
+
+   const int threads_needed{ (int) std::min<size_t>(num_threads, (sources.size() + CHUNK_SIZE - 1) / CHUNK_SIZE) };
+
+   if (threads_needed <= 1) {
+      work();
+   }
+   else {
+      std::vector<std::thread> threads{};
+
+      for (int t = 0; t < threads_needed; t++) {
+         threads.emplace_back(work);
+      }
+
+      for (auto& thread : threads) {
+         thread.join();
+      }
+   }
+
+   return result;
+}
+
+int resolveNumThreads(const ExplorationOptions& options)
+{
+   return options.num_threads_ > 0 ? options.num_threads_ : std::max(1, (int) std::thread::hardware_concurrency());
+}
+
+} // namespace
+
+size_t vfm::SystemStateHash::operator()(const SystemState& state) const
+{
+   uint64_t seed{ state.second.size() };
+   hashCombine(seed, state.first);
+
+   for (const auto& car : state.second) {
+      hashCombine(seed, car);
+   }
+
+   return seed;
+}
+
 void vfm::MC::generateModel(
    const bool try_reinserting_immediate_next_state,
    const int abort_after_n_transitions,
@@ -285,69 +454,110 @@ void vfm::MC::generateModel(
    const int insert_only_first_n_for_every_state,
    const bool complement_of_transitions, 
    const int insert_every_nth_transition_only, 
-   const bool insert_unconnected_system_states)
+   const bool insert_unconnected_system_states,
+   const ExplorationOptions& options)
 {
-   int state_counter = 1;
-   std::map<SystemState, int> all_states;
-   std::map<int, SystemState> all_states_rev;
-   std::vector<int> unprocessed;
-   int i = 0;
+   stats_ = {};
+   exploration_start_ = std::chrono::steady_clock::now();
+   last_progress_ = exploration_start_;
+
+   if (options.bitstate_) {
+      if (try_reinserting_immediate_next_state || complement_of_transitions) {
+         addWarning("Bitstate exploration builds no model, ignoring the options for reinserting states and complementing transitions.");
+      }
+
+      exploreBitstate(abort_after_n_states, options);
+      return;
+   }
+
+   const int num_threads{ resolveNumThreads(options) };
+   const SystemStateHash hasher{};
+   StateNumbering all_states{};
+   std::deque<int> unprocessed{};
+   long i = 0;
    int num_old_trans = -1;
    int num_old_states = -1;
-   int num_old_unprocessed = -1;
+   size_t num_old_unprocessed = -1;
+   bool abort{ false };
 
    for (const auto& s : seed_) {
-      addStateToSystem(s, all_states, all_states_rev, unprocessed, state_counter);
+      if (all_states.insert(s, hasher(s)).second) {
+         unprocessed.push_back(all_states.size());
+      }
    }
 
-   while (!unprocessed.empty()) {
-      int current_state_num = unprocessed[0];
-      SystemState current_state = all_states_rev[current_state_num];
-      auto next_states_vec = trans_func_(current_state);
-      std::set<SystemState> next_states(next_states_vec.begin(), next_states_vec.end());
-      
-      int next_state_counter = 0;
+   while (!unprocessed.empty() && !abort) {
+      // A whole level of the breadth-first search at once, except when reinserting since the
+      // order of processing is then decided state by state.
+      const size_t batch_size{ try_reinserting_immediate_next_state ? 1 : unprocessed.size() };
+      std::vector<int> batch(unprocessed.begin(), unprocessed.begin() + batch_size);
+      std::vector<const SystemState*> sources{};
 
-      addPainting(current_state_num, current_state);
+      if (!try_reinserting_immediate_next_state) {
+         unprocessed.erase(unprocessed.begin(), unprocessed.begin() + batch_size);
+      }
 
-      for (const auto& next_state : next_states) {
-         i++;
-         int next_state_num = addStateToSystem(next_state, all_states, all_states_rev, unprocessed, state_counter);
-         if (i % insert_every_nth_transition_only == 0 && next_state_counter++ < insert_only_first_n_for_every_state) {
-            model_.addTransition(current_state_num, next_state_num);
+      stats_.num_levels_++;
 
-            if (try_reinserting_immediate_next_state) {
-               unprocessed.insert(unprocessed.begin(), next_state_num);
+      for (const int num : batch) {
+         sources.push_back(&all_states.getState(num)); // Stable: no insertions while expanding.
+      }
+
+      const auto successors{ expandStates(trans_func_, sources, num_threads) };
+
+      for (size_t k = 0; k < batch.size() && !abort; k++) {
+         const int current_state_num{ batch[k] };
+         int next_state_counter = 0;
+
+         for (size_t j = 0; j < successors[k].states_.size(); j++) {
+            i++;
+            const auto [next_state_num, is_new] = all_states.insert(successors[k].states_[j], successors[k].hashes_[j]);
+
+            if (is_new) {
+               unprocessed.push_back(next_state_num);
+            }
+
+            if (i % insert_every_nth_transition_only == 0 && next_state_counter++ < insert_only_first_n_for_every_state) {
+               model_.addTransition(current_state_num, next_state_num);
+
+               if (try_reinserting_immediate_next_state) {
+                  unprocessed.push_front(next_state_num);
+               }
+            }
+            else if (insert_unconnected_system_states) {
+               model_.addUnconnectedStateIfNotExisting(current_state_num);
+               model_.addUnconnectedStateIfNotExisting(next_state_num);
             }
          }
-         else if (insert_unconnected_system_states) {
-            model_.addUnconnectedStateIfNotExisting(current_state_num);
-            model_.addUnconnectedStateIfNotExisting(next_state_num);
+
+         if (try_reinserting_immediate_next_state) {
+            unprocessed.pop_front(); // As before: after the push_fronts above, i.e., not necessarily the current state.
          }
-         addPainting(next_state_num, next_state);
-      }
 
-      unprocessed.erase(unprocessed.begin());
-      addNote("System states: " + std::to_string(model_.getNumStates()) + ", transitions: " + std::to_string(model_.getTransitions()->size()) 
-              + " (" + std::to_string(i) + ")" + ", unprocessed: " + std::to_string(unprocessed.size()));
+         const size_t num_unprocessed{ unprocessed.size() + batch.size() - k - 1 };
+         reportProgress(options, all_states.size(), i, num_unprocessed);
 
-      if (model_.getTransitions()->size() >= abort_after_n_transitions) {
-         break;
-      }
+         abort = model_.getTransitions()->size() >= abort_after_n_transitions
+            || model_.getNumStates() >= abort_after_n_states
+            || (num_old_states == model_.getNumStates()
+               && num_old_trans == model_.getTransitions()->size()
+               && num_old_unprocessed == num_unprocessed);
 
-      if (model_.getNumStates() >= abort_after_n_states) {
-         break;
+         num_old_states = model_.getNumStates();
+         num_old_trans = model_.getTransitions()->size();
+         num_old_unprocessed = num_unprocessed;
       }
+   }
 
-      if (num_old_states == model_.getNumStates()
-            && num_old_trans == model_.getTransitions()->size()
-            && num_old_unprocessed == unprocessed.size()) {
-         break;
-      }
+   stats_.num_states_ = all_states.size();
+   stats_.num_successors_ = i;
+   stats_.seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - exploration_start_).count();
+   reportProgress(options, all_states.size(), i, unprocessed.size(), true);
 
-      num_old_states = model_.getNumStates();
-      num_old_trans = model_.getTransitions()->size();
-      num_old_unprocessed = unprocessed.size();
+   if (options.paint_states_) {
+      for (int num = 1; num <= all_states.size(); num++) {
+         addPainting(num, all_states.getState(num));
+      }
    }
 
    if (complement_of_transitions) {
@@ -359,38 +569,107 @@ void vfm::MC::generateModel(
    addNote("Generation complete.");
 }
 
-SystemStateVec vfm::MC::generateFullSystemSeedACC()
+void vfm::MC::exploreBitstate(const int abort_after_n_states, const ExplorationOptions& options)
+{
+   const int num_threads{ resolveNumThreads(options) };
+   const SystemStateHash hasher{};
+   BitstateFilter visited{ options.bitstate_log2_bits_ };
+   SystemStateVec level{};
+   long num_states{ 0 };
+   long i{ 0 };
+
+   for (const auto& s : seed_) {
+      if (visited.insert(hasher(s))) {
+         level.push_back(s);
+         num_states++;
+      }
+   }
+
+   while (!level.empty() && num_states < abort_after_n_states) {
+      std::vector<const SystemState*> sources{};
+      SystemStateVec next_level{};
+      stats_.num_levels_++;
+
+      for (const auto& state : level) {
+         sources.push_back(&state);
+      }
+
+      auto successors{ expandStates(trans_func_, sources, num_threads) };
+
+      for (auto& succ : successors) {
+         for (size_t j = 0; j < succ.states_.size(); j++) {
+            i++;
+
+            if (visited.insert(succ.hashes_[j])) {
+               next_level.push_back(std::move(succ.states_[j]));
+               num_states++;
+            }
+         }
+      }
+
+      level = std::move(next_level); // States of earlier levels are not kept.
+      reportProgress(options, num_states, i, level.size());
+   }
+
+   stats_.num_states_ = num_states;
+   stats_.num_successors_ = i;
+   stats_.seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - exploration_start_).count();
+   reportProgress(options, num_states, i, level.size(), true);
+   addNote("Bitstate exploration complete (no model has been built).");
+}
+
+void vfm::MC::reportProgress(const ExplorationOptions& options, const long num_states, const long num_successors, const size_t num_unprocessed, const bool force)
+{
+   const auto now{ std::chrono::steady_clock::now() };
+
+   if (!force && now - last_progress_ < std::chrono::milliseconds(options.progress_interval_ms_)) {
+      return;
+   }
+
+   const double seconds{ std::chrono::duration<double>(now - exploration_start_).count() };
+   last_progress_ = now;
+   addNote("System states: " + std::to_string(num_states) + ", transitions: " + std::to_string(model_.getTransitions()->size())
+      + " (" + std::to_string(num_successors) + ")" + ", unprocessed: " + std::to_string(num_unprocessed)
+      + ", " + std::to_string((long) (seconds > 0 ? num_states / seconds : 0)) + " states/s.");
+}
+
+ExplorationStats vfm::MC::getLastExplorationStats() const
+{
+   return stats_;
+}
+
+SystemStateVec vfm::MC::generateFullSystemSeedACC(const AccRanges& ranges)
 {
    SystemStateVec vec;
 
-   std::vector<float> vals{ (float) SPEED_MIN_ACC, (float) SPEED_MIN_ACC, (float) DISTANCE_MIN_ACC};
+   std::vector<float> vals{ (float) ranges.speed_min_, (float) ranges.speed_min_, (float) ranges.distance_min_};
 
    for (;;) {
-      if (vals[2] != DISTANCE_MAX_ACC || vals[1] == 0) {
+      if (vals[2] != ranges.distance_max_ || vals[1] == ranges.speed_min_) {
          SystemState state = { { 0, 0, (int) vals[0], 0, DEFAULT_CAR_DIMENSIONS_M }, { { 0, vals[2], (int) vals[1], 1, DEFAULT_CAR_DIMENSIONS_M } } };
          vec.push_back(state);
       }
 
-      if (vals[2] < DISTANCE_MAX_ACC) {
-         vals[2] += DISTANCE_STEP_ACC;
+      if (vals[2] < ranges.distance_max_) {
+         vals[2] += ranges.distance_step_;
       }
       else {
-         vals[2] = DISTANCE_MIN_ACC;
-         if (vals[1] < SPEED_MAX_ACC) {
-            vals[1] += SPEED_STEP_ACC;
+         vals[2] = ranges.distance_min_;
+         if (vals[1] < ranges.speed_max_) {
+            vals[1] += ranges.speed_step_;
          }
          else {
-            vals[1] = SPEED_MIN_ACC;
-            if (vals[0] < SPEED_MAX_ACC) {
-               vals[0] += SPEED_STEP_ACC;
+            vals[1] = ranges.speed_min_;
+            if (vals[0] < ranges.speed_max_) {
+               vals[0] += ranges.speed_step_;
             }
             else {
-               vals[0] = SPEED_MIN_ACC;
+               vals[0] = ranges.speed_min_;
             }
          }
       }
 
-      if (vals[0] == SPEED_MIN_ACC && vals[1] == SPEED_MIN_ACC && vals[2] == DISTANCE_MIN_ACC) {
+      if (vals[0] == ranges.speed_min_ && vals[1] == ranges.speed_min_ && vals[2] == ranges.distance_min_) {
          break;
       }
    }
@@ -412,29 +691,6 @@ void vfm::MC::addPainting(const int state_num, const SystemState& state)
    }
 }
 
-int vfm::MC::addStateToSystem(
-   const SystemState& state,
-   std::map<SystemState, int>& states,
-   std::map<int, SystemState>& states_rev,
-   std::vector<int>& unprocessed,
-   int& state_counter)
-{
-   for (const auto& pair : states) {
-      SystemState s = pair.first;
-
-      if (s == state) {
-         return states[s];
-      }
-   }
-
-   states[state] = state_counter;
-   states_rev[state_counter] = state;
-   unprocessed.push_back(state_counter);
-   state_counter++;
-
-   return state_counter - 1;
-}
-
 float vfm::MC::getSpeed(const CarPars& cp)
 {
    return cp.car_velocity_;
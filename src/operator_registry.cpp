@@ -0,0 +1,168 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+
+#include "operator_registry.h"
+#include <stdexcept>
+
+using namespace vfm;
+
+OperatorRegistry::OperatorId OperatorRegistry::intern(const std::string& name)
+{
+   const auto it{ ids_.find(name) };
+
+   if (it != ids_.end()) return it->second;
+
+   const OperatorId id = entries_.size();
+   ids_.insert({ name, id });
+   entries_.push_back({});
+   entries_.back().name_ = name;
+   return id;
+}
+
+OperatorRegistry::OperatorId OperatorRegistry::find(const std::string& name) const
+{
+   const auto it{ ids_.find(name) };
+   return it == ids_.end() ? NO_OPERATOR : it->second;
+}
+
+const OperatorRegistry::Entry& OperatorRegistry::getEntry(const OperatorId id) const
+{
+   return entries_.at(id);
+}
+
+const OperatorRegistry::Entry* OperatorRegistry::findDeclared(const std::string& name) const
+{
+   const OperatorId id{ find(name) };
+   return id != NO_OPERATOR && entries_[id].declared_ ? &entries_[id] : nullptr;
+}
+
+void OperatorRegistry::registerNativeFactory(const std::string& name, const int num_operands, const NativeFactory factory)
+{
+   Entry& entry{ entries_[intern(name)] };
+
+   if (num_operands == ANY_NUMBER_OF_OPERANDS) {
+      entry.native_any_num_operands_ = factory;
+      return;
+   }
+
+   if (num_operands >= (int) entry.native_by_num_operands_.size()) {
+      entry.native_by_num_operands_.resize(num_operands + 1, nullptr);
+   }
+
+   entry.native_by_num_operands_[num_operands] = factory;
+}
+
+OperatorRegistry::NativeFactory OperatorRegistry::getNativeFactory(const OperatorId id, const int num_operands) const
+{
+   const Entry& entry{ entries_[id] };
+
+   if (num_operands < (int) entry.native_by_num_operands_.size() && entry.native_by_num_operands_[num_operands]) {
+      return entry.native_by_num_operands_[num_operands];
+   }
+
+   return entry.native_any_num_operands_;
+}
+
+void OperatorRegistry::refresh(
+   const std::string& name,
+   const std::map<std::string, std::map<int, OperatorStructure>>& all_ops,
+   const std::map<std::string, std::map<int, std::shared_ptr<Term>>>& dynamic_term_metas)
+{
+   refreshEntry(entries_[intern(name)], all_ops, dynamic_term_metas);
+}
+
+void OperatorRegistry::refreshAll(
+   const std::map<std::string, std::map<int, OperatorStructure>>& all_ops,
+   const std::map<std::string, std::map<int, std::shared_ptr<Term>>>& dynamic_term_metas)
+{
+   for (const auto& ops : all_ops) {
+      intern(ops.first);
+   }
+
+   for (const auto& metas : dynamic_term_metas) {
+      intern(metas.first);
+   }
+
+   for (auto& entry : entries_) {
+      refreshEntry(entry, all_ops, dynamic_term_metas);
+   }
+}
+
+bool OperatorRegistry::getPrecedence(const Entry& entry, const int num_params, int& precedence) const
+{
+   if (entry.has_flexible_) {
+      precedence = entry.flexible_precedence_;
+      return true;
+   }
+
+   if (num_params >= 0 && num_params < (int) entry.left_assoc_by_num_params_.size() && entry.left_assoc_by_num_params_[num_params] >= 0) {
+      precedence = entry.precedence_by_num_params_[num_params];
+      return true;
+   }
+
+   const auto it{ entry.op_structs_.find(num_params) }; // Negative modes other than flexible.
+
+   if (it != entry.op_structs_.end()) {
+      precedence = it->second.precedence;
+      return true;
+   }
+
+   return false;
+}
+
+bool OperatorRegistry::isLeftAssoc(const Entry& entry, const int num_params) const
+{
+   if (entry.has_flexible_) {
+      return entry.flexible_left_assoc_;
+   }
+
+   if (num_params >= 0 && num_params < (int) entry.left_assoc_by_num_params_.size() && entry.left_assoc_by_num_params_[num_params] >= 0) {
+      return entry.left_assoc_by_num_params_[num_params];
+   }
+
+   return entry.op_structs_.at(num_params).associativity == AssociativityTypeEnum::left;
+}
+
+void OperatorRegistry::refreshEntry(
+   Entry& entry,
+   const std::map<std::string, std::map<int, OperatorStructure>>& all_ops,
+   const std::map<std::string, std::map<int, std::shared_ptr<Term>>>& dynamic_term_metas)
+{
+   const auto ops{ all_ops.find(entry.name_) };
+   const auto metas{ dynamic_term_metas.find(entry.name_) };
+
+   entry.declared_ = ops != all_ops.end();
+   entry.op_structs_ = entry.declared_ ? ops->second : std::map<int, OperatorStructure>{};
+   entry.metas_ = metas != dynamic_term_metas.end() ? metas->second : std::map<int, std::shared_ptr<Term>>{};
+   entry.num_params_.clear();
+   entry.precedence_by_num_params_.clear();
+   entry.left_assoc_by_num_params_.clear();
+
+   const auto flexible{ entry.op_structs_.find(PARNUM_FLEXIBLE_MODE) };
+   entry.has_flexible_ = flexible != entry.op_structs_.end();
+
+   if (entry.has_flexible_) {
+      entry.flexible_precedence_ = flexible->second.precedence;
+      entry.flexible_left_assoc_ = flexible->second.associativity == AssociativityTypeEnum::left;
+   }
+
+   for (const auto& op_struct : entry.op_structs_) {
+      const int num_params{ op_struct.first };
+
+      if (num_params < 0) continue;
+
+      entry.num_params_.insert(num_params);
+
+      if (num_params >= (int) entry.left_assoc_by_num_params_.size()) {
+         entry.precedence_by_num_params_.resize(num_params + 1, 0);
+         entry.left_assoc_by_num_params_.resize(num_params + 1, -1);
+      }
+
+      entry.precedence_by_num_params_[num_params] = op_struct.second.precedence;
+      entry.left_assoc_by_num_params_[num_params] = op_struct.second.associativity == AssociativityTypeEnum::left;
+   }
+}
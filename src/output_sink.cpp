@@ -0,0 +1,133 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+
+#include "output_sink.h"
+#include "static_helper.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace vfm;
+
+void OutputSink::write(const std::string& str)
+{
+   write(str.data(), str.size());
+}
+
+OutputSink& OutputSink::operator<<(const std::string& str)
+{
+   write(str.data(), str.size());
+   return *this;
+}
+
+OutputSink& OutputSink::operator<<(const char* str)
+{
+   write(str, std::strlen(str));
+   return *this;
+}
+
+void StringSink::write(const char* data, const size_t size)
+{
+   str_.append(data, size);
+}
+
+const std::string& StringSink::str() const
+{
+   return str_;
+}
+
+FileSink::FileSink(const std::filesystem::path& path, const size_t buffer_size)
+   : Failable("FileSink"), buffer_(std::max<size_t>(buffer_size, 1))
+{
+   file_ = std::fopen(path.string().c_str(), "w"); // Text mode, same line endings as the previous std::ofstream based output.
+
+   if (!file_) {
+      addError("Could not open file '" + path.string() + "' for writing.");
+   }
+}
+
+FileSink::~FileSink()
+{
+   if (file_) {
+      flush();
+      std::fclose(file_);
+   }
+}
+
+void FileSink::write(const char* data, const size_t size)
+{
+   if (!file_) return;
+
+   if (used_ + size > buffer_.size()) {
+      flush();
+
+      if (size >= buffer_.size()) { // Too large to be buffered anyway.
+         if (std::fwrite(data, 1, size, file_) != size) {
+            addError("Could not write to file.");
+         }
+
+         return;
+      }
+   }
+
+   std::memcpy(buffer_.data() + used_, data, size);
+   used_ += size;
+}
+
+void FileSink::flush()
+{
+   if (!file_) return;
+
+   if (used_ > 0 && std::fwrite(buffer_.data(), 1, used_, file_) != used_) {
+      addError("Could not write to file.");
+   }
+
+   used_ = 0;
+
+   if (std::fflush(file_) != 0) {
+      addError("Could not flush file.");
+   }
+}
+
+bool FileSink::isOpen() const
+{
+   return file_;
+}
+
+HashingSink::HashingSink(OutputSink* next) : next_(next)
+{}
+
+void HashingSink::write(const char* data, const size_t size)
+{
+   hash_ = StaticHelper::hashFNV1a(data, size, hash_);
+   size_ += size;
+
+   if (next_) {
+      next_->write(data, size);
+   }
+}
+
+void HashingSink::flush()
+{
+   if (next_) {
+      next_->flush();
+   }
+}
+
+uint64_t HashingSink::getHash() const
+{
+   return hash_;
+}
+
+std::string HashingSink::getHashHex() const
+{
+   return StaticHelper::hashToHex(hash_);
+}
+
+size_t HashingSink::getSize() const
+{
+   return size_;
+}
@@ -11,6 +11,7 @@
 #include "math_struct.h"
 #include "term_compound.h"
 #include "static_helper.h"
+#include "bracket_index.h"
 #include "operator_structure.h"
 #include "term.h"
 #include "fsm.h"
@@ -29,6 +30,7 @@ using namespace vfm;
 
 FormulaParser::FormulaParser() : Parsable("FormulaParser")
 {
+    registerNativeTerms();
     init();
 }
 
@@ -359,6 +361,7 @@ void FormulaParser::init() {
    curr_terms_.clear();
    dynamic_term_metas_.clear();
    forward_declared_terms_.clear();
+   operator_registry_.refreshAll(all_ops_, dynamic_term_metas_);
    //operators_with_flexible_number_of_arguments_.clear();
 
    //requestFlexibleNumberOfArgumentsFor(SYMB_FUNC_EVAL);
@@ -378,46 +381,6 @@ std::shared_ptr<Term> FormulaParser::termFactory(
       return TermCompound::compoundFactory(actual_term->getOperands(), compound_structure, actual_term->getOpStruct());
    }
 
-   if (optor == SYMB_PLUS && terms.size() == OPNUM_PLUS) return std::make_shared<TermPlus>(terms);
-   if (optor == SYMB_POW && terms.size() == OPNUM_POW) return std::make_shared<TermPow>(terms);
-   if (optor == SYMB_LN && terms.size() == OPNUM_LN) return std::make_shared<TermLn>(terms);
-   if (optor == SYMB_SIN && terms.size() == OPNUM_SIN) return std::make_shared<TermSin>(terms);
-   if (optor == SYMB_COS && terms.size() == OPNUM_COS) return std::make_shared<TermCos>(terms);
-   if (optor == SYMB_TAN && terms.size() == OPNUM_TAN) return std::make_shared<TermTan>(terms);
-   if (optor == SYMB_ARCSIN && terms.size() == OPNUM_ARCSIN) return std::make_shared<TermASin>(terms);
-   if (optor == SYMB_ARCCOS && terms.size() == OPNUM_ARCCOS) return std::make_shared<TermACos>(terms);
-   if (optor == SYMB_ARCTAN && terms.size() == OPNUM_ARCTAN) return std::make_shared<TermATan>(terms);
-   if (optor == SYMB_MINUS && terms.size() == OPNUM_MINUS) return std::make_shared<TermMinus>(terms);
-   if (optor == SYMB_MULT && terms.size() == OPNUM_MULT) return std::make_shared<TermMult>(terms);
-   if (optor == SYMB_DIV && terms.size() == OPNUM_DIV) return std::make_shared<TermDiv>(terms);
-   if (optor == SYMB_NEG && terms.size() == OPNUM_NEG) return std::make_shared<TermNeg>(terms[0]);
-   if (optor == SYMB_MOD && terms.size() == OPNUM_MOD) return std::make_shared<TermMod>(terms);
-   if (optor == SYMB_MAX && terms.size() == OPNUM_MAX) return std::make_shared<TermMax>(terms);
-   if (optor == SYMB_MIN && terms.size() == OPNUM_MIN) return std::make_shared<TermMin>(terms);
-   if (optor == SYMB_AND && terms.size() == OPNUM_AND) return std::make_shared<TermLogicAnd>(terms);
-   if (optor == SYMB_OR && terms.size() == OPNUM_OR) return std::make_shared<TermLogicOr>(terms);
-   if (optor == SYMB_SM && terms.size() == OPNUM_SM) return std::make_shared<TermLogicSm>(terms);
-   if (optor == SYMB_SMEQ && terms.size() == OPNUM_SMEQ) return std::make_shared<TermLogicSmEq>(terms);
-   if (optor == SYMB_EQ && terms.size() == OPNUM_EQ) return std::make_shared<TermLogicEq>(terms);
-   if (optor == SYMB_NEQ && terms.size() == OPNUM_NEQ) return std::make_shared<TermLogicNeq>(terms);
-   if (optor == SYMB_GREQ && terms.size() == OPNUM_GREQ) return std::make_shared<TermLogicGrEq>(terms);
-   if (optor == SYMB_GR && terms.size() == OPNUM_GR) return std::make_shared<TermLogicGr>(terms);
-   if (optor == SYMB_LENGTH && terms.size() == OPNUM_LENGTH) return std::make_shared<TermArrayLength>(terms[0]);
-   if (optor == SYMB_RAND && terms.size() == OPNUM_RAND) return std::make_shared<TermRand>(terms[0]);
-   if (optor == SYMB_ABS && terms.size() == OPNUM_ABS) return std::make_shared<TermAbs>(terms[0]);
-   if (optor == SYMB_TRUNC && terms.size() == OPNUM_TRUNC) return std::make_shared<TermTrunc>(terms[0]);
-
-   if (optor == SYMB_META_CMP && terms.size() == OPNUM_META_CMP) return std::make_shared<TermMetaCompound>(terms[0]);
-   if (optor == SYMB_META_SIMP && terms.size() == OPNUM_META_SIMP) return std::make_shared<TermMetaSimplification>(terms[0]);
-   if (optor == SYMB_OPTIONAL && terms.size() == OPNUM_OPTIONAL) return std::make_shared<TermOptional>(terms[0], terms[1]);
-   if (optor == SYMB_ANYWAY) return std::make_shared<TermAnyway>(terms); // Regardless of terms.size(), construct TermAnyway with any number or operands.
-   if (optor == SYMB_WHILELIM && terms.size() == OPNUM_WHILELIM) return std::make_shared<TermWhileLimited>(terms);
-   if (optor == SYMB_SQRT && terms.size() == OPNUM_SQRT) return std::make_shared<TermSQRT>(terms[0]);
-   if (optor == SYMB_RSQRT && terms.size() == OPNUM_RSQRT) return std::make_shared<TermRSQRT>(terms[0]);
-   if (optor == SYMB_SET_VAR && terms.size() == OPNUM_SET_VAR) return std::make_shared<TermSetVar>(terms[0], terms[1]);
-   if (optor == SYMB_SET_ARR && terms.size() == OPNUM_SET_ARR) return std::make_shared<TermSetArr>(terms[0], terms[1], terms[2]);
-   if (optor == SYMB_GET_ARR && terms.size() == OPNUM_GET_ARR) return std::make_shared<TermGetArr>(terms[0], terms[1]);
-
    if (optor == SYMB_FUNC_REF) {
       if (!suppress_create_new_dynamic_term_via_term_func_ref) {
          if (StaticHelper::stringStartsWith(optor, StaticHelper::makeString(NATIVE_ARRAY_PREFIX_FIRST))) {
@@ -432,14 +395,11 @@ std::shared_ptr<Term> FormulaParser::termFactory(
       return std::make_shared<TermFuncRef>(terms);
    }
 
-   if (optor == SYMB_FUNC_EVAL) return std::make_shared<TermFuncEval>(terms);
-   if (optor == SYMB_LAMBDA && terms.size() == OPNUM_LAMBDA) return std::make_shared<TermFuncLambda>(terms);
-   if (optor == SYMB_LITERAL && terms.size() == OPNUM_LITERAL) return std::make_shared<TermLiteral>(terms);
-   if (optor == SYMB_MALLOC && terms.size() == OPNUM_MALLOC) return std::make_shared<TermMalloc>(terms);
-   if (optor == SYMB_DELETE && terms.size() == OPNUM_DELETE) return std::make_shared<TermDelete>(terms);
-   if (optor == SYMB_PRINT && terms.size() == OPNUM_PRINT) return std::make_shared<TermPrint>(terms);
-   if (optor == SYMB_ID && terms.size() == OPNUM_ID) return std::make_shared<TermID>(terms);
-   if (optor == SYMB_FCTIN && terms.size() == OPNUM_FCTIN) return std::make_shared<TermFctIn>();
+   const auto id{ operator_registry_.find(optor) };
+
+   if (id != OperatorRegistry::NO_OPERATOR) {
+      if (const auto factory{ operator_registry_.getNativeFactory(id, terms.size()) }) return factory(terms);
+   }
 
    /* 
     * Leading dot "." used to denote static arrays. Keep the array factory below the
@@ -462,16 +422,19 @@ std::shared_ptr<Term> FormulaParser::termFactory(
       }
    }
 
-   auto meta_key = dynamic_term_metas_.find(optor);
-   auto op_key = all_ops_.find(optor);
+   const auto dynamic_id{ operator_registry_.find(optor) }; // Only now, isArray may have declared it.
 
-   // TODO: Here and below some optiomizations are possible, see comments.
-   if (op_key != all_ops_.end()
-      && !all_ops_.at(optor).count(PARNUM_FLEXIBLE_MODE)
-      && !all_ops_.at(optor).count(terms.size())) { // TODO: Use already found element, here and below.
+   if (dynamic_id == OperatorRegistry::NO_OPERATOR) {
+      return nullptr;
+   }
+
+   const OperatorRegistry::Entry& entry{ operator_registry_.getEntry(dynamic_id) };
+   const int num_terms = terms.size();
+
+   if (entry.declared_ && !entry.has_flexible_ && !entry.op_structs_.count(num_terms)) {
       std::string possible = " ";
 
-      for (const auto& el : all_ops_.at(optor)) {
+      for (const auto& el : entry.op_structs_) {
          possible += std::to_string(el.first) + " ";
       }
 
@@ -484,19 +447,20 @@ std::shared_ptr<Term> FormulaParser::termFactory(
       return _var(PARSING_ERROR_STRING + "OPERATOR_" + OperatorStructure(optor, terms.size()).serialize() + "_MISSING#");
    }
 
-   if (meta_key != dynamic_term_metas_.end() && meta_key->second.count(terms.size()) && meta_key->second.at(terms.size())) { // Operator fully defined. // TODO: Avoid double effort for count and at. Do we need the last "at" part?
-      std::shared_ptr<Term> meta_term = dynamic_term_metas_.at(optor).at(terms.size()); // TODO: Avoid this third lookup as well.
-      OperatorStructure opstruct{ all_ops_.at(optor).at(terms.size()) };
-      return TermCompound::compoundFactory(terms, meta_term, opstruct);
-   } else if (meta_key != dynamic_term_metas_.end() && meta_key->second.count(PARNUM_FLEXIBLE_MODE) && meta_key->second.at(PARNUM_FLEXIBLE_MODE)) { // Operator fully defined. // TODO: Do we need the last "at" part?
-      std::shared_ptr<Term> meta_term = dynamic_term_metas_.at(optor).at(PARNUM_FLEXIBLE_MODE); // TODO: Avoid this third lookup as well.
-      OperatorStructure opstruct{ all_ops_.at(optor).at(PARNUM_FLEXIBLE_MODE) };
-      return TermCompound::compoundFactory(terms, meta_term, opstruct);
-   } else if (op_key != all_ops_.end()) { // Operator forward declared.
+   const auto meta_it{ entry.metas_.find(num_terms) };
+   const auto meta_flexible_it{ entry.metas_.find(PARNUM_FLEXIBLE_MODE) };
+
+   if (meta_it != entry.metas_.end() && meta_it->second) { // Operator fully defined.
+      OperatorStructure opstruct{ entry.op_structs_.at(num_terms) };
+      return TermCompound::compoundFactory(terms, meta_it->second, opstruct);
+   } else if (meta_flexible_it != entry.metas_.end() && meta_flexible_it->second) { // Operator fully defined.
+      OperatorStructure opstruct{ entry.op_structs_.at(PARNUM_FLEXIBLE_MODE) };
+      return TermCompound::compoundFactory(terms, meta_flexible_it->second, opstruct);
+   } else if (entry.declared_) { // Operator forward declared.
       OperatorStructure opstruct{ 
-         all_ops_.at(optor).count(PARNUM_FLEXIBLE_MODE) // Always return flexible if available. (TODO: Prohibit other entrances if flexible available.)
-         ? OperatorStructure(all_ops_.at(optor).at(PARNUM_FLEXIBLE_MODE))
-         : OperatorStructure(all_ops_.at(optor).at(terms.size()))};
+         entry.has_flexible_ // Always return flexible if available. (TODO: Prohibit other entrances if flexible available.)
+         ? entry.op_structs_.at(PARNUM_FLEXIBLE_MODE)
+         : entry.op_structs_.at(num_terms) };
       std::shared_ptr<Term> dummy_meta = std::make_shared<TermVar>(FORWARD_DECLARATION_PREFIX + "<" + optor + ", " + std::to_string(terms.size()) + ">");
       auto unfinished_term = TermCompound::compoundFactory(terms, dummy_meta, opstruct);
       forward_declared_terms_.push_back(unfinished_term);
@@ -505,6 +469,58 @@ std::shared_ptr<Term> FormulaParser::termFactory(
 
    return nullptr;
 }
+
+/// The built-in terms, by name and number of operands. (@f is treated in termFactory directly since
+/// creating it declares a function.) Dynamic terms are looked up only if none of these matches.
+void FormulaParser::registerNativeTerms()
+{
+   operator_registry_.registerNativeFactory(SYMB_PLUS, OPNUM_PLUS, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermPlus>(terms); });
+   operator_registry_.registerNativeFactory(SYMB_POW, OPNUM_POW, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermPow>(terms); });
+   operator_registry_.registerNativeFactory(SYMB_LN, OPNUM_LN, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermLn>(terms); });
+   operator_registry_.registerNativeFactory(SYMB_SIN, OPNUM_SIN, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermSin>(terms); });
+   operator_registry_.registerNativeFactory(SYMB_COS, OPNUM_COS, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermCos>(terms); });
+   operator_registry_.registerNativeFactory(SYMB_TAN, OPNUM_TAN, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermTan>(terms); });
+   operator_registry_.registerNativeFactory(SYMB_ARCSIN, OPNUM_ARCSIN, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermASin>(terms); });
+   operator_registry_.registerNativeFactory(SYMB_ARCCOS, OPNUM_ARCCOS, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermACos>(terms); });
+   operator_registry_.registerNativeFactory(SYMB_ARCTAN, OPNUM_ARCTAN, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermATan>(terms); });
+   operator_registry_.registerNativeFactory(SYMB_MINUS, OPNUM_MINUS, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermMinus>(terms); });
+   operator_registry_.registerNativeFactory(SYMB_MULT, OPNUM_MULT, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermMult>(terms); });
+   operator_registry_.registerNativeFactory(SYMB_DIV, OPNUM_DIV, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermDiv>(terms); });
+   operator_registry_.registerNativeFactory(SYMB_NEG, OPNUM_NEG, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermNeg>(terms[0]); });
+   operator_registry_.registerNativeFactory(SYMB_MOD, OPNUM_MOD, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermMod>(terms); });
+   operator_registry_.registerNativeFactory(SYMB_MAX, OPNUM_MAX, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermMax>(terms); });
+   operator_registry_.registerNativeFactory(SYMB_MIN, OPNUM_MIN, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermMin>(terms); });
+   operator_registry_.registerNativeFactory(SYMB_AND, OPNUM_AND, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermLogicAnd>(terms); });
+   operator_registry_.registerNativeFactory(SYMB_OR, OPNUM_OR, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermLogicOr>(terms); });
+   operator_registry_.registerNativeFactory(SYMB_SM, OPNUM_SM, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermLogicSm>(terms); });
+   operator_registry_.registerNativeFactory(SYMB_SMEQ, OPNUM_SMEQ, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermLogicSmEq>(terms); });
+   operator_registry_.registerNativeFactory(SYMB_EQ, OPNUM_EQ, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermLogicEq>(terms); });
+   operator_registry_.registerNativeFactory(SYMB_NEQ, OPNUM_NEQ, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermLogicNeq>(terms); });
+   operator_registry_.registerNativeFactory(SYMB_GREQ, OPNUM_GREQ, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermLogicGrEq>(terms); });
+   operator_registry_.registerNativeFactory(SYMB_GR, OPNUM_GR, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermLogicGr>(terms); });
+   operator_registry_.registerNativeFactory(SYMB_LENGTH, OPNUM_LENGTH, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermArrayLength>(terms[0]); });
+   operator_registry_.registerNativeFactory(SYMB_RAND, OPNUM_RAND, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermRand>(terms[0]); });
+   operator_registry_.registerNativeFactory(SYMB_ABS, OPNUM_ABS, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermAbs>(terms[0]); });
+   operator_registry_.registerNativeFactory(SYMB_TRUNC, OPNUM_TRUNC, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermTrunc>(terms[0]); });
+   operator_registry_.registerNativeFactory(SYMB_META_CMP, OPNUM_META_CMP, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermMetaCompound>(terms[0]); });
+   operator_registry_.registerNativeFactory(SYMB_META_SIMP, OPNUM_META_SIMP, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermMetaSimplification>(terms[0]); });
+   operator_registry_.registerNativeFactory(SYMB_OPTIONAL, OPNUM_OPTIONAL, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermOptional>(terms[0], terms[1]); });
+   operator_registry_.registerNativeFactory(SYMB_ANYWAY, OperatorRegistry::ANY_NUMBER_OF_OPERANDS, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermAnyway>(terms); }); // Regardless of terms.size(), construct TermAnyway with any number or operands.
+   operator_registry_.registerNativeFactory(SYMB_WHILELIM, OPNUM_WHILELIM, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermWhileLimited>(terms); });
+   operator_registry_.registerNativeFactory(SYMB_SQRT, OPNUM_SQRT, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermSQRT>(terms[0]); });
+   operator_registry_.registerNativeFactory(SYMB_RSQRT, OPNUM_RSQRT, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermRSQRT>(terms[0]); });
+   operator_registry_.registerNativeFactory(SYMB_SET_VAR, OPNUM_SET_VAR, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermSetVar>(terms[0], terms[1]); });
+   operator_registry_.registerNativeFactory(SYMB_SET_ARR, OPNUM_SET_ARR, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermSetArr>(terms[0], terms[1], terms[2]); });
+   operator_registry_.registerNativeFactory(SYMB_GET_ARR, OPNUM_GET_ARR, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermGetArr>(terms[0], terms[1]); });
+   operator_registry_.registerNativeFactory(SYMB_FUNC_EVAL, OperatorRegistry::ANY_NUMBER_OF_OPERANDS, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermFuncEval>(terms); });
+   operator_registry_.registerNativeFactory(SYMB_LAMBDA, OPNUM_LAMBDA, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermFuncLambda>(terms); });
+   operator_registry_.registerNativeFactory(SYMB_LITERAL, OPNUM_LITERAL, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermLiteral>(terms); });
+   operator_registry_.registerNativeFactory(SYMB_MALLOC, OPNUM_MALLOC, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermMalloc>(terms); });
+   operator_registry_.registerNativeFactory(SYMB_DELETE, OPNUM_DELETE, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermDelete>(terms); });
+   operator_registry_.registerNativeFactory(SYMB_PRINT, OPNUM_PRINT, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermPrint>(terms); });
+   operator_registry_.registerNativeFactory(SYMB_ID, OPNUM_ID, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermID>(terms); });
+   operator_registry_.registerNativeFactory(SYMB_FCTIN, OPNUM_FCTIN, [](const std::vector<std::shared_ptr<Term>>& terms) -> std::shared_ptr<Term> { return std::make_shared<TermFctIn>(); });
+}
 // --- EO Register static operators. ---
 
 void vfm::FormulaParser::addDynamicTermViaFuncRef(const std::vector<std::shared_ptr<Term>>& terms)
@@ -616,9 +632,9 @@ std::shared_ptr<Term> vfm::FormulaParser::termFactoryDummy(const std::string& op
 
 std::set<int> FormulaParser::getNumParams(const std::string& optor)
 {
-   auto ops = all_ops_.find(optor);
+   const auto entry{ operator_registry_.findDeclared(optor) };
 
-   if (ops == all_ops_.end()) {
+   if (!entry) {
       if (isArray(optor)) {
          return { 1 };
       }
@@ -626,15 +642,7 @@ std::set<int> FormulaParser::getNumParams(const std::string& optor)
       return {}; // No instance of this operator name declared.
    }
 
-   std::set<int> par_nums;
-
-   for (const auto& par_num : ops->second) { // Has to have at least one declared instance.
-      if (par_num.first >= 0) {
-         par_nums.insert(par_num.first);
-      }
-   }
-
-   return par_nums;
+   return entry->num_params_;
 }
 
 OperatorStructure FormulaParser::getOperatorStructure(const std::string& op_name, const int num_params)
@@ -644,24 +652,22 @@ OperatorStructure FormulaParser::getOperatorStructure(const std::string& op_name
 
 bool FormulaParser::isLeftAssoc(const std::string& optor, const int num_params) const
 {
-   if (all_ops_.at(optor).count(PARNUM_FLEXIBLE_MODE)) { // TODO: Optimizing this function might make parsing faster.
-      return all_ops_.at(optor).at(PARNUM_FLEXIBLE_MODE).associativity == AssociativityTypeEnum::left;
+   const auto entry{ operator_registry_.findDeclared(optor) };
+
+   if (!entry) {
+      throw std::out_of_range("Operator '" + optor + "' not found.");
    }
 
-   return all_ops_.at(optor).at(num_params).associativity == AssociativityTypeEnum::left;
+   return operator_registry_.isLeftAssoc(*entry, num_params);
 }
 
 int FormulaParser::prio(const std::string& optor, const int num_params) const
 {
-   if (all_ops_.count(optor)) {
-      auto at_optor{ all_ops_.at(optor) };
+   const auto entry{ operator_registry_.findDeclared(optor) };
+   int precedence{};
 
-      if (at_optor.count(PARNUM_FLEXIBLE_MODE)) { // TODO: Optimizing this function might make parsing faster.
-         return at_optor.at(PARNUM_FLEXIBLE_MODE).precedence;
-      }
-      else if (at_optor.count(num_params)) {
-         return at_optor.at(num_params).precedence;
-      }
+   if (entry && operator_registry_.getPrecedence(*entry, num_params, precedence)) {
+      return precedence;
    }
 
    addError("Operator '" + optor + "' with " + std::to_string(num_params) + " parameters not found.");
@@ -825,6 +831,7 @@ void vfm::FormulaParser::initializeValuesBy(const FormulaParser& other)
    is_in_function_ref_mode_ = other.is_in_function_ref_mode_;
    //operators_with_flexible_number_of_arguments_ = other.operators_with_flexible_number_of_arguments_;
    native_funcs_ = other.native_funcs_;
+   operator_registry_.refreshAll(all_ops_, dynamic_term_metas_);
 
    //for (const auto& op : getAllOps()) {
    //   addFailableChild(op.second, "");
@@ -840,11 +847,13 @@ void vfm::FormulaParser::resetRawDynamicTerm(const std::string& op_name, const T
 {
    dynamic_term_metas_.at(op_name) = {};
    dynamic_term_metas_.at(op_name).insert({ num_params, new_term });
+   operator_registry_.refresh(op_name, all_ops_, dynamic_term_metas_);
 }
 
 void vfm::FormulaParser::removeDynamicTerm(const std::string& op_name, const int num_params)
 {
    dynamic_term_metas_.at(op_name).erase(num_params);
+   operator_registry_.refresh(op_name, all_ops_, dynamic_term_metas_);
 }
 
 std::map<std::string, std::map<int, std::set<MetaRule>>> vfm::FormulaParser::getAllRelevantSimplificationRulesOrMore()
@@ -877,6 +886,7 @@ bool FormulaParser::isArray(const std::string& optor)
    if (isit) { // Note that term_array_float has the same op_struct as TermArray.
       all_ops_.insert({ optor, { { 1, TermArray::getOpStruct(optor) } } });
       all_arrs_.insert({ optor, { { 1, TermArray::getOpStruct(optor) } } });
+      operator_registry_.refresh(optor, all_ops_, dynamic_term_metas_);
    }
 
    return isit;
@@ -885,7 +895,7 @@ bool FormulaParser::isArray(const std::string& optor)
 bool vfm::FormulaParser::isFunctionOrOperator(const std::string& optor) const
 {
    const bool regular_function_or_optor{ /*arg_num == -1
-      ?*/ (bool) all_ops_.count(optor)
+      ?*/ (bool) operator_registry_.findDeclared(optor)
       /*: (bool) all_ops_.count(optor) && all_ops_.at(optor).count(arg_num)*/
    };
    
@@ -1127,6 +1137,7 @@ void FormulaParser::addDynamicTerm(
    registerAddress(op_struct.op_name, auto_num); // Don't update if existing.
    dynamic_term_metas_.insert({ op_struct.op_name, {} }); // Don't update if existing.
    dynamic_term_metas_[op_struct.op_name].insert({ {auto_num, meta_struct} }); // Don't update if existing.
+   operator_registry_.refresh(op_struct.op_name, all_ops_, dynamic_term_metas_);
 
    if (meta_struct) { // If fully defined...
       std::string name = op_struct.op_name;
@@ -1140,6 +1151,7 @@ void FormulaParser::addDynamicTerm(
       all_ops_.at(name).at(auto_num) = op_struct;
       all_ops_.at(name).at(auto_num).setArgNumIfInAutoMode(auto_num);
       registerAddress(op_struct.op_name, auto_num);
+      operator_registry_.refresh(name, all_ops_, dynamic_term_metas_);
       //}
 
       for (const auto& unfinished_term : forward_declared_terms_) { // Look if top-level unfinished terms can be updated.
@@ -1606,10 +1618,12 @@ std::string vfm::FormulaParser::preprocessProgram(const std::string& program) co
 std::string vfm::FormulaParser::preprocessProgramBraceStyleFunctionDenotation(const std::string& program) const
 {
    std::string prog_result = program;
-   int ind_op_brace = StaticHelper::indexOfFirstInnermostBeginBracket(prog_result, open_brace, close_brace, { "\"" }, { "\"" });
+   auto brace_index{ std::make_unique<BracketIndex>(prog_result, StaticHelper::tagsWithPrepended(open_brace, { "\"" }), StaticHelper::tagsWithPrepended(close_brace, { "\"" })) };
+   int ind_op_brace = StaticHelper::indexOfFirstInnermostBeginBracket(*brace_index);
 
    while (ind_op_brace >= 0) {
-      int ind_cl_brace = StaticHelper::findMatchingEndTagLevelwise(prog_result, open_brace, close_brace, ind_op_brace, { "\"" }, { "\"" });
+      int dummy = ind_op_brace;
+      int ind_cl_brace = StaticHelper::findMatchingEndTagLevelwise(*brace_index, dummy);
 
       if (ind_cl_brace >= 0) {
          int closing = prog_result.rfind(CLOSING_BRACKET, ind_op_brace);
@@ -1644,7 +1658,8 @@ std::string vfm::FormulaParser::preprocessProgramBraceStyleFunctionDenotation(co
                + second_inner_part
                + CLOSING_BRACKET + after;
 
-            ind_op_brace = StaticHelper::indexOfFirstInnermostBeginBracket(prog_result, open_brace, close_brace, { "\"" }, { "\"" });
+            brace_index = std::make_unique<BracketIndex>(prog_result, StaticHelper::tagsWithPrepended(open_brace, { "\"" }), StaticHelper::tagsWithPrepended(close_brace, { "\"" }));
+            ind_op_brace = StaticHelper::indexOfFirstInnermostBeginBracket(*brace_index);
          }
       }
       else {
@@ -1657,11 +1672,13 @@ std::string vfm::FormulaParser::preprocessProgramBraceStyleFunctionDenotation(co
 
 std::string vfm::FormulaParser::preprocessProgramSquareStyleArrayAccess(const std::string& program) const
 {
-   int ind_op_square = StaticHelper::indexOfFirstInnermostBeginBracket(program, open_square, close_square, { "\"" }, { "\"" });
+   const BracketIndex square_index{ program, StaticHelper::tagsWithPrepended(open_square, { "\"" }), StaticHelper::tagsWithPrepended(close_square, { "\"" }) };
+   int ind_op_square = StaticHelper::indexOfFirstInnermostBeginBracket(square_index);
 
    if (ind_op_square >= 0) {
       std::string prog_result = program;
-      int ind_cl_square = StaticHelper::findMatchingEndTagLevelwise(program, open_square, close_square, ind_op_square, { "\"" }, { "\"" });
+      int dummy = ind_op_square;
+      int ind_cl_square = StaticHelper::findMatchingEndTagLevelwise(square_index, dummy);
 
       if (ind_cl_square >= 0) {
          int ind_pos_of_array_name_begin = ind_op_square - 1;
@@ -1686,7 +1703,7 @@ std::string vfm::FormulaParser::preprocessProgramSquareStyleArrayAccess(const st
          int current_pos = ind_op_square + 1;
 
          while (program[current_pos - 1] != CLOSING_BRACKET_SQUARE_STYLE_FOR_ARRAYS) {
-            int ind_of_comma = StaticHelper::indexOfOnTopLevel(program, { comma, close_square }, current_pos, open_square, close_square, { "\"" }, { "\"" });
+            int ind_of_comma = StaticHelper::indexOfOnTopLevel(square_index, { comma, close_square }, current_pos);
             std::string argument = program.substr(current_pos, ind_of_comma - current_pos);
             StaticHelper::trim(argument);
 
@@ -1767,7 +1784,7 @@ bool vfm::FormulaParser::parseProgram(const std::string& dynamic_term_commands)
    return !error_in_current_call;
 }
 
-std::map<std::string, std::map<int, OperatorStructure>>& vfm::FormulaParser::getAllOps()
+const std::map<std::string, std::map<int, OperatorStructure>>& vfm::FormulaParser::getAllOps() const
 {
    return all_ops_;
 }
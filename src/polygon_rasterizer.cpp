@@ -0,0 +1,216 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+
+#include "geometry/polygon_rasterizer.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace vfm;
+
+namespace {
+int clampToInt(const float value, const int min, const int max) // Also safe for huge values and infinity.
+{
+   return value <= min ? min : value >= max ? max : (int) value;
+}
+}
+
+void PolygonRasterizer::rasterize(
+   const std::vector<Vec2Df>& points,
+   const int width,
+   const int height,
+   const FillRule rule,
+   const bool anti_aliasing,
+   const SpanCallback& span)
+{
+   if (points.size() < 3 || width <= 0 || height <= 0) return;
+
+   buildEdgeTable(points);
+
+   if (edges_.empty()) return;
+
+   width_ = width;
+   float y_min{ edges_.front().y_top_ };
+   float y_max{ y_min };
+
+   for (const auto& edge : edges_) {
+      y_max = (std::max)(y_max, edge.y_bottom_);
+   }
+
+   const int row_begin{ clampToInt(std::floor(y_min), 0, height) };
+   const int row_end{ clampToInt(std::ceil(y_max), 0, height) };
+
+   if (!anti_aliasing) {
+      for (int row = row_begin; row < row_end; row++) {
+         advanceTo(row + 0.5f);
+
+         forEachInsideInterval(rule, [this, row, &span](const float x_left, const float x_right) {
+            const int x_begin{ clampToInt(std::ceil(x_left - 0.5f), 0, width_) }; // First pixel with center >= x_left.
+            const int x_end{ clampToInt(std::ceil(x_right - 0.5f), 0, width_) };
+
+            if (x_begin < x_end) {
+               span(row, x_begin, x_end, 1);
+            }
+         });
+      }
+
+      return;
+   }
+
+   coverage_.assign(width_ + 1, 0);
+   full_.assign(width_ + 1, 0);
+   constexpr float SUBSAMPLE_WEIGHT{ 1.0f / SUBSAMPLES_Y };
+   constexpr float FULL_COVERAGE{ 1 - SUBSAMPLE_WEIGHT / 64 }; // Absorbs rounding errors of the partial coverages.
+   constexpr float MIN_COVERAGE{ 1.0f / 256 };
+
+   for (int row = row_begin; row < row_end; row++) {
+      row_min_x_ = width_;
+      row_max_x_ = -1;
+
+      for (int sub = 0; sub < SUBSAMPLES_Y; sub++) {
+         advanceTo(row + (sub + 0.5f) * SUBSAMPLE_WEIGHT);
+
+         forEachInsideInterval(rule, [this](const float x_left, const float x_right) {
+            addCoverage(x_left, x_right, SUBSAMPLE_WEIGHT);
+         });
+      }
+
+      float run{ 0 };
+      int span_begin{ -1 };
+      float span_coverage{ 0 };
+
+      for (int x = row_min_x_; x <= row_max_x_ + 1; x++) {
+         float coverage{ 0 };
+
+         if (x <= row_max_x_) {
+            run += full_[x];
+            coverage = run + coverage_[x];
+            coverage = coverage >= FULL_COVERAGE ? 1 : coverage < MIN_COVERAGE ? 0 : coverage;
+         }
+
+         if (span_begin >= 0 && coverage != span_coverage) {
+            span(row, span_begin, x, span_coverage);
+            span_begin = -1;
+         }
+
+         if (span_begin < 0 && coverage > 0) {
+            span_begin = x;
+            span_coverage = coverage;
+         }
+      }
+
+      if (row_max_x_ >= row_min_x_) {
+         std::fill(coverage_.begin() + row_min_x_, coverage_.begin() + row_max_x_ + 2, 0.0f);
+         std::fill(full_.begin() + row_min_x_, full_.begin() + row_max_x_ + 2, 0.0f);
+      }
+   }
+}
+
+void PolygonRasterizer::buildEdgeTable(const std::vector<Vec2Df>& points)
+{
+   edges_.clear();
+   active_.clear();
+   next_edge_ = 0;
+
+   for (size_t i = 0; i < points.size(); i++) {
+      const Vec2Df& p{ points[i] };
+      const Vec2Df& q{ points[(i + 1) % points.size()] };
+
+      if (!std::isfinite(p.x) || !std::isfinite(p.y) || !std::isfinite(q.x) || !std::isfinite(q.y) || p.y == q.y) {
+         continue; // Horizontal edges never cross a scanline.
+      }
+
+      const bool downwards{ p.y < q.y };
+      const Vec2Df& top{ downwards ? p : q };
+      const Vec2Df& bottom{ downwards ? q : p };
+
+      edges_.push_back({ top.y, bottom.y, top.x, (bottom.x - top.x) / (bottom.y - top.y), downwards ? 1 : -1 });
+   }
+
+   std::sort(edges_.begin(), edges_.end(), [](const Edge& e1, const Edge& e2) { return e1.y_top_ < e2.y_top_; });
+}
+
+void PolygonRasterizer::advanceTo(const float y)
+{
+   // An edge is active on the half-open interval [y_top_, y_bottom_).
+   active_.erase(std::remove_if(active_.begin(), active_.end(), [this, y](const int i) { return edges_[i].y_bottom_ <= y; }), active_.end());
+
+   for (; next_edge_ < edges_.size() && edges_[next_edge_].y_top_ <= y; next_edge_++) {
+      if (edges_[next_edge_].y_bottom_ > y) {
+         active_.push_back(next_edge_);
+      }
+   }
+
+   for (const int i : active_) {
+      Edge& edge{ edges_[i] };
+      edge.x_ = edge.x_at_top_ + (y - edge.y_top_) * edge.dx_per_dy_;
+   }
+
+   for (size_t i = 1; i < active_.size(); i++) { // Insertion sort, the order barely changes between scanlines.
+      const int current{ active_[i] };
+      size_t j{ i };
+
+      for (; j > 0 && edges_[active_[j - 1]].x_ > edges_[current].x_; j--) {
+         active_[j] = active_[j - 1];
+      }
+
+      active_[j] = current;
+   }
+}
+
+template<class F>
+void PolygonRasterizer::forEachInsideInterval(const FillRule rule, const F& f)
+{
+   if (rule == FillRule::even_odd) {
+      for (size_t i = 0; i + 1 < active_.size(); i += 2) {
+         f(edges_[active_[i]].x_, edges_[active_[i + 1]].x_);
+      }
+
+      return;
+   }
+
+   int winding{ 0 };
+   float x_left{ 0 };
+
+   for (const int i : active_) {
+      const int previous_winding{ winding };
+      winding += edges_[i].winding_;
+
+      if (previous_winding == 0 && winding != 0) {
+         x_left = edges_[i].x_;
+      }
+      else if (previous_winding != 0 && winding == 0) {
+         f(x_left, edges_[i].x_);
+      }
+   }
+}
+
+void PolygonRasterizer::addCoverage(const float x_left_raw, const float x_right_raw, const float weight)
+{
+   const float x_left{ (std::max)(x_left_raw, 0.0f) };
+   const float x_right{ (std::min)(x_right_raw, (float) width_) };
+
+   if (x_left >= x_right) return;
+
+   const int first{ (int) x_left };
+   const int last{ (std::min)((int) x_right, width_) };
+
+   if (first == last) {
+      coverage_[first] += (x_right - x_left) * weight;
+   }
+   else {
+      coverage_[first] += (first + 1 - x_left) * weight;
+      full_[first + 1] += weight;
+      full_[last] -= weight;
+
+      if (last < width_) {
+         coverage_[last] += (x_right - last) * weight;
+      }
+   }
+
+   row_min_x_ = (std::min)(row_min_x_, first);
+   row_max_x_ = (std::max)(row_max_x_, (std::min)(last, width_ - 1));
+}
@@ -0,0 +1,370 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+
+#include "model_checking/process_runner.h"
+#include "static_helper.h"
+#include <algorithm>
+#include <array>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+#endif
+
+using namespace vfm;
+using namespace mc;
+
+std::mutex ProcessRunner::running_mutex_{};
+std::set<ProcessRunner*> ProcessRunner::running_{};
+
+std::string ProcessStatistics::serialize() const
+{
+   return "pid=" + std::to_string(pid)
+      + " exit_code=" + std::to_string(exit_code)
+      + " signal=" + std::to_string(term_signal)
+      + " timed_out=" + std::to_string(timed_out)
+      + " cancelled=" + std::to_string(cancelled)
+      + " max_rss=" + std::to_string(max_rss_kb) + "kB"
+      + " user=" + std::to_string(user_time_seconds) + "s"
+      + " sys=" + std::to_string(system_time_seconds) + "s"
+      + " wall=" + StaticHelper::printTimeFormatted(wall_time);
+}
+
+ProcessRunner::ProcessRunner() : Failable("ProcessRunner")
+{}
+
+ProcessRunner::~ProcessRunner()
+{
+   std::lock_guard<std::mutex> lock{ running_mutex_ };
+   running_.erase(this);
+}
+
+void ProcessRunner::cancel()
+{
+   cancel_requested_ = true;
+}
+
+bool ProcessRunner::isRunning() const
+{
+   return pid_ > 0;
+}
+
+std::string ProcessRunner::getCommandLine() const
+{
+   return command_line_;
+}
+
+int ProcessRunner::cancelAllMatching(const std::string& command_line_substring)
+{
+   std::lock_guard<std::mutex> lock{ running_mutex_ };
+   int cnt{ 0 };
+
+   for (auto* runner : running_) {
+      if (StaticHelper::stringContains(runner->getCommandLine(), command_line_substring)) {
+         runner->cancel();
+         cnt++;
+      }
+   }
+
+   return cnt;
+}
+
+#if defined(__linux__)
+ProcessStatistics ProcessRunner::run(
+   const std::vector<std::string>& argv,
+   const std::map<std::string, std::string>& additional_env,
+   const ProcessLimits& limits,
+   const ProcessOutputCallback& on_output)
+{
+   ProcessStatistics stats{};
+   command_line_ = "";
+
+   for (const auto& arg : argv) command_line_ += arg + " ";
+
+   if (cancel_requested_) {
+      // Cancelled before the process was even spawned (e.g., a portfolio variant that lost the race early).
+      cancel_requested_ = false;
+      stats.cancelled = true;
+      return stats;
+   }
+
+   if (argv.empty()) {
+      addError("Cannot run process with empty command line.");
+      return stats;
+   }
+
+   addNote("Spawning process: '" + command_line_ + "'.");
+
+   std::vector<std::string> spawn_argv{};
+
+   if (limits.memory_bytes > 0) {
+      // The limit has to be active before the model checker starts, so it is set by a shell
+      // which then replaces itself by the actual process (setrlimit in our own, multi-threaded
+      // process would affect all threads; prlimit after spawning would leave a window).
+      const size_t limit_kb{ (std::max)((size_t) 1, limits.memory_bytes / 1024) };
+      spawn_argv = { "/bin/sh", "-c", "ulimit -v " + std::to_string(limit_kb) + " && exec \"$@\"", "sh" };
+   }
+
+   spawn_argv.insert(spawn_argv.end(), argv.begin(), argv.end());
+
+   std::vector<char*> argv_c{};
+   for (const auto& arg : spawn_argv) argv_c.push_back(const_cast<char*>(arg.c_str()));
+   argv_c.push_back(nullptr);
+
+   std::vector<std::string> env{};
+   for (char** e = environ; *e; e++) {
+      const std::string entry{ *e };
+      const std::string name{ entry.substr(0, entry.find('=')) };
+      if (!additional_env.count(name)) env.push_back(entry);
+   }
+   for (const auto& [name, value] : additional_env) env.push_back(name + "=" + value);
+
+   std::vector<char*> env_c{};
+   for (const auto& entry : env) env_c.push_back(const_cast<char*>(entry.c_str()));
+   env_c.push_back(nullptr);
+
+   int fds[2];
+   if (pipe2(fds, O_CLOEXEC) != 0) {
+      addError("Could not create pipe for process output: " + std::string(std::strerror(errno)) + ".");
+      return stats;
+   }
+
+   posix_spawn_file_actions_t actions;
+   posix_spawn_file_actions_init(&actions);
+   posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+   posix_spawn_file_actions_adddup2(&actions, fds[1], STDERR_FILENO);
+
+   posix_spawnattr_t attr;
+   posix_spawnattr_init(&attr);
+   posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP);
+   posix_spawnattr_setpgroup(&attr, 0); // Own process group, so we can kill the whole tree.
+
+   const auto time_start{ std::chrono::steady_clock::now() };
+   pid_t pid{};
+   const int spawn_res{ posix_spawnp(&pid, argv_c[0], &actions, &attr, argv_c.data(), env_c.data()) };
+
+   posix_spawn_file_actions_destroy(&actions);
+   posix_spawnattr_destroy(&attr);
+   close(fds[1]);
+
+   if (spawn_res != 0) {
+      close(fds[0]);
+      addError("Could not spawn '" + argv[0] + "': " + std::string(std::strerror(spawn_res)) + ".");
+      return stats;
+   }
+
+   stats.pid = pid;
+   stats.spawned = true;
+   pid_ = pid;
+
+   {
+      std::lock_guard<std::mutex> lock{ running_mutex_ };
+      running_.insert(this);
+   }
+
+   const auto kill_group = [pid]() { kill(-pid, SIGKILL); };
+   std::array<char, 4096> buffer{};
+   bool killed{ false };
+   pollfd pfd{ fds[0], POLLIN, 0 };
+
+   for (;;) {
+      const int poll_res{ poll(&pfd, 1, 100) };
+
+      if (poll_res > 0) {
+         const ssize_t n{ read(fds[0], buffer.data(), buffer.size()) };
+
+         if (n > 0) {
+            if (on_output) on_output(std::string(buffer.data(), n));
+         }
+         else if (n == 0 || errno != EINTR) {
+            break; // EOF, i.e., the process (group) closed its output.
+         }
+      }
+      else if (poll_res < 0 && errno != EINTR) {
+         break;
+      }
+
+      if (!killed) {
+         const double elapsed{ std::chrono::duration<double>(std::chrono::steady_clock::now() - time_start).count() };
+
+         if (cancel_requested_) {
+            addNote("Cancelling process " + std::to_string(pid) + ".");
+            stats.cancelled = true;
+            kill_group();
+            killed = true;
+         }
+         else if (limits.wall_clock_seconds > 0 && elapsed > limits.wall_clock_seconds) {
+            addWarning("Process " + std::to_string(pid) + " exceeded wall-clock limit of " + std::to_string(limits.wall_clock_seconds) + "s. Killing it.");
+            stats.timed_out = true;
+            kill_group();
+            killed = true;
+         }
+      }
+   }
+
+   close(fds[0]);
+
+   int status{};
+   struct rusage usage{};
+   while (wait4(pid, &status, 0, &usage) < 0 && errno == EINTR) {} // Retry if interrupted by a signal.
+
+   {
+      std::lock_guard<std::mutex> lock{ running_mutex_ };
+      running_.erase(this);
+   }
+
+   pid_ = -1;
+   cancel_requested_ = false;
+   stats.wall_time = std::chrono::steady_clock::now() - time_start;
+   stats.max_rss_kb = usage.ru_maxrss;
+   stats.user_time_seconds = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6;
+   stats.system_time_seconds = usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+
+   if (WIFEXITED(status)) {
+      stats.exit_code = WEXITSTATUS(status);
+   }
+   else if (WIFSIGNALED(status)) {
+      stats.term_signal = WTERMSIG(status);
+   }
+
+   addNote("Process finished: " + stats.serialize() + ".");
+
+   return stats;
+}
+#else
+ProcessStatistics ProcessRunner::run(
+   const std::vector<std::string>& argv,
+   const std::map<std::string, std::string>& additional_env,
+   const ProcessLimits& limits,
+   const ProcessOutputCallback& on_output)
+{
+   // No posix_spawn available; fall back to the blocking shell-based execution. Limits, cancellation
+   // of a running process and streaming are not supported, the output is delivered in one chunk at the end.
+   ProcessStatistics stats{};
+   command_line_ = "";
+
+   for (const auto& arg : argv) command_line_ += "\"" + arg + "\" ";
+
+   if (!additional_env.empty()) {
+      addError("Additional environment variables are not supported on this platform. Ignoring them for '" + command_line_ + "'.");
+   }
+
+   if (limits.wall_clock_seconds > 0 || limits.memory_bytes > 0) {
+      addError("Process limits are not supported on this platform. Running '" + command_line_ + "' without limits.");
+   }
+
+   if (cancel_requested_) {
+      addNote("Process '" + command_line_ + "' has been cancelled before being started.");
+      cancel_requested_ = false;
+      stats.cancelled = true;
+      return stats;
+   }
+
+   {
+      std::lock_guard<std::mutex> lock{ running_mutex_ };
+      running_.insert(this);
+   }
+
+   const auto time_start{ std::chrono::steady_clock::now() };
+   int exit_code{};
+   const std::string output{ StaticHelper::execWithSuccessCode(command_line_, exit_code, nullptr) };
+
+   {
+      std::lock_guard<std::mutex> lock{ running_mutex_ };
+      running_.erase(this);
+   }
+
+   if (cancel_requested_) {
+      addError("Cancelling a running process is not supported on this platform. '" + command_line_ + "' ran to completion.");
+      cancel_requested_ = false;
+   }
+
+   if (on_output) on_output(output);
+
+   stats.spawned = true;
+   stats.exit_code = exit_code;
+   stats.wall_time = std::chrono::steady_clock::now() - time_start;
+   return stats;
+}
+#endif
+
+NusmvCexStreamer::NusmvCexStreamer(const std::function<void(const MCTrace& trace, const int cex_num)>& on_cex)
+   : on_cex_(on_cex)
+{}
+
+void NusmvCexStreamer::feed(const std::string& chunk)
+{
+   output_ += chunk;
+   processCompleteLines(false);
+}
+
+void NusmvCexStreamer::finish()
+{
+   processCompleteLines(true);
+}
+
+const std::string& NusmvCexStreamer::getFullOutput() const
+{
+   return output_;
+}
+
+int NusmvCexStreamer::getNumCexsFound() const
+{
+   return num_cexs_found_;
+}
+
+void NusmvCexStreamer::processCompleteLines(const bool at_end)
+{
+   static const std::string CEX_BEGIN{ "Trace Type: Counterexample" };
+
+   for (;;) {
+      const size_t line_end{ output_.find('\n', scan_pos_) };
+
+      if (line_end == std::string::npos) break;
+
+      const std::string line{ StaticHelper::trimAndReturn(output_.substr(scan_pos_, line_end - scan_pos_)) };
+
+      if (StaticHelper::stringStartsWith(line, CEX_BEGIN)) {
+         emitCurrentCex(scan_pos_);
+         current_cex_begin_ = scan_pos_;
+      }
+      else if (current_cex_begin_ != std::string::npos
+         && (StaticHelper::stringStartsWith(line, "-- specification")
+            || StaticHelper::stringStartsWith(line, "-- invariant")
+            || StaticHelper::stringStartsWith(line, "-- no counterexample")
+            || StaticHelper::stringStartsWith(line, "nuXmv >"))) {
+         emitCurrentCex(scan_pos_);
+      }
+
+      scan_pos_ = line_end + 1;
+   }
+
+   if (at_end) emitCurrentCex(output_.size());
+}
+
+void NusmvCexStreamer::emitCurrentCex(const size_t end_pos)
+{
+   if (current_cex_begin_ == std::string::npos) return;
+
+   const auto traces{ StaticHelper::extractMCTracesFromNusmv(output_.substr(current_cex_begin_, end_pos - current_cex_begin_)) };
+   current_cex_begin_ = std::string::npos;
+
+   for (const auto& trace : traces) {
+      if (on_cex_) on_cex_(trace, num_cexs_found_);
+      num_cexs_found_++;
+   }
+}
@@ -3,6 +3,7 @@
 #include "geometry/bezier_functions.h"
 #include <vector>
 #include <cmath>
+#include <deque>
 
 
 using namespace vfm;
@@ -195,7 +196,7 @@ bool StraightRoadSection::isValid() const
    return getNumActualLanes() >= 0;
 }
 
-std::map<float, LaneSegment> StraightRoadSection::getSegments() const
+const std::map<float, LaneSegment>& StraightRoadSection::getSegments() const
 {
    return segments_;
 }
@@ -234,7 +235,7 @@ std::shared_ptr<CarPars> vfm::StraightRoadSection::getEgo() const
 {
    return ego_;
 }
-CarParsVec StraightRoadSection::getOthers() const
+const CarParsVec& StraightRoadSection::getOthers() const
 {
    return others_;
 }
@@ -863,6 +864,36 @@ bool vfm::RoadGraph::parseProgram(const std::string& program_raw)
 
 using namespace xml;
 
+static const std::vector<std::pair<std::string, std::string>> OSM_BORDER_TAGS{
+   { "Painting::LineWidth", "0.300000" },
+   { "Painting::LineWidth", "0.300000" },
+   { "Painting::MarkingType", "Solid" },
+   { "Painting::SingleLineOffsets", "-0.000000" },
+   { "Painting::SingleLineWidths", "0.300000" },
+   { "color", "white" },
+   { "subtype", "solid" },
+   { "type", "line_thick" },
+   { "width", "0.300000" },
+};
+
+static const std::vector<std::pair<std::string, std::string>> OSM_ROAD_LINK_TAGS{
+   { "type", "road_link" },
+   { "rl:meta:country_code", "276" },
+   { "rl:meta:is_controlled", "false" },
+   { "rl:meta:is_motorway", "false" },
+   { "rl:meta:is_separated_structurally", "false" },
+   { "rl:meta:is_urban", "false" },
+   { "rl:predecessors", "" },
+   { "rl:successors", "" },
+   { "rl:travel_direction", "along" },
+   { "rl:type", "no_special" },
+};
+
+void vfm::resetOSMIdCounter(const int first_free_id)
+{
+   global_id_first_free = first_free_id;
+}
+
 vfm::Way::Way(const std::shared_ptr<RoadGraph> my_father_rg) : Failable("OSM-Way"),
 way_ids_{ WayIDs{} },
    origin_node_left_id_{ global_id_first_free++ },
@@ -877,6 +908,36 @@ way_ids_{ WayIDs{} },
 }
 
 std::shared_ptr<xml::CodeXML> vfm::Way::getNodesXML() const
+{
+   std::shared_ptr<xml::CodeXML> res{};
+
+   computeNodes([&res](const int id, const double lat, const double lon) {
+      auto node = getNodeXML(id, lat, lon);
+
+      if (res) {
+         res->appendAtTheEnd(node);
+      }
+      else {
+         res = node;
+      }
+   });
+
+   return res;
+}
+
+void vfm::Way::writeNodes(xml::XmlWriter& writer) const
+{
+   computeNodes([&writer](const int id, const double lat, const double lon) {
+      writer.emptyElement("node", { // Attributes in the (alphabetical) order CodeXML writes them.
+         { "id", std::to_string(id) },
+         { "lat", std::to_string(lat) },
+         { "lon", std::to_string(lon) },
+         { "version", "1" },
+         { "visible", "true" } });
+   });
+}
+
+void vfm::Way::computeNodes(const std::function<void(const int id, const double lat, const double lon)>& node_callback) const
 {
    auto origin = my_road_graph_->getOriginPoint();
    auto drain = my_road_graph_->getDrainPoint();
@@ -894,11 +955,10 @@ std::shared_ptr<xml::CodeXML> vfm::Way::getNodesXML() const
    auto target_left_coord = StaticHelper::cartesianToWGS84(drain_left.x, drain_left.y);
    auto origin_right_coord = StaticHelper::cartesianToWGS84(origin_right.x, origin_right.y);
    auto target_right_coord = StaticHelper::cartesianToWGS84(drain_right.x, drain_right.y);
-   auto res =
-      getNodeXML(origin_node_left_id_, origin_left_coord.first, origin_left_coord.second);
-   res->appendAtTheEnd(getNodeXML(target_node_left_id_, target_left_coord.first, target_left_coord.second));
-   res->appendAtTheEnd(getNodeXML(origin_node_right_id_, origin_right_coord.first, origin_right_coord.second));
-   res->appendAtTheEnd(getNodeXML(target_node_right_id_, target_right_coord.first, target_right_coord.second));
+   node_callback(origin_node_left_id_, origin_left_coord.first, origin_left_coord.second);
+   node_callback(target_node_left_id_, target_left_coord.first, target_left_coord.second);
+   node_callback(origin_node_right_id_, origin_right_coord.first, origin_right_coord.second);
+   node_callback(target_node_right_id_, target_right_coord.first, target_right_coord.second);
 
    // Connectors towards successors.
    for (const auto& r_succ : my_road_graph_->getSuccessors()) {
@@ -926,10 +986,10 @@ std::shared_ptr<xml::CodeXML> vfm::Way::getNodesXML() const
 
       if (!arrow.points_.size() % 2) addError("Bezier road block has odd number of points: '" + std::to_string(arrow.points_.size()) + "'.");
 
-      auto func = [&node_ids_left, &node_ids_right, &res](const Vec2D point, const bool left) {
+      auto func = [&node_ids_left, &node_ids_right, &node_callback](const Vec2D point, const bool left) {
          int id = global_id_first_free++;
          auto coord = StaticHelper::cartesianToWGS84(point.x, point.y);
-         res->appendAtTheEnd(getNodeXML(id, coord.first, coord.second));
+         node_callback(id, coord.first, coord.second);
          (left ? node_ids_left : node_ids_right).push_back(id);
       };
 
@@ -945,8 +1005,6 @@ std::shared_ptr<xml::CodeXML> vfm::Way::getNodesXML() const
       ids_to_connector_successor_nodes_right_.push_back(node_ids_right);
       ids_for_connector_successor_ways_.push_back(WayIDs());
    }
-
-   return res;
 }
 
 std::shared_ptr<xml::CodeXML> vfm::Way::getWayXMLGeneric(
@@ -960,15 +1018,9 @@ std::shared_ptr<xml::CodeXML> vfm::Way::getWayXMLGeneric(
    auto way_inner_right = xml::CodeXML::emptyXML();
    auto way_inner_link = xml::CodeXML::emptyXML();
 
-   dummy->appendAtTheEnd(xml::CodeXML::retrieveParsOnlyElement("tag", { {"k", "Painting::LineWidth"}, {"v", "0.300000"} }));
-   dummy->appendAtTheEnd(xml::CodeXML::retrieveParsOnlyElement("tag", { {"k", "Painting::LineWidth"}, {"v", "0.300000"} }));
-   dummy->appendAtTheEnd(xml::CodeXML::retrieveParsOnlyElement("tag", { {"k", "Painting::MarkingType"}, {"v", "Solid"} }));
-   dummy->appendAtTheEnd(xml::CodeXML::retrieveParsOnlyElement("tag", { {"k", "Painting::SingleLineOffsets"}, {"v", "-0.000000"} }));
-   dummy->appendAtTheEnd(xml::CodeXML::retrieveParsOnlyElement("tag", { {"k", "Painting::SingleLineWidths"}, {"v", "0.300000"} }));
-   dummy->appendAtTheEnd(xml::CodeXML::retrieveParsOnlyElement("tag", { {"k", "color"}, {"v", "white"} }));
-   dummy->appendAtTheEnd(xml::CodeXML::retrieveParsOnlyElement("tag", { {"k", "subtype"}, {"v", "solid"} }));
-   dummy->appendAtTheEnd(xml::CodeXML::retrieveParsOnlyElement("tag", { {"k", "type"}, {"v", "line_thick"} }));
-   dummy->appendAtTheEnd(xml::CodeXML::retrieveParsOnlyElement("tag", { {"k", "width"}, {"v", "0.300000"} }));
+   for (const auto& [k, v] : OSM_BORDER_TAGS) {
+      dummy->appendAtTheEnd(xml::CodeXML::retrieveParsOnlyElement("tag", { {"k", k}, {"v", v} }));
+   }
 
    for (const auto& id : left_ids) {
       way_inner_left->appendAtTheEnd(xml::CodeXML::retrieveParsOnlyElement("nd", { {"ref", std::to_string(id) } }));
@@ -982,16 +1034,9 @@ std::shared_ptr<xml::CodeXML> vfm::Way::getWayXMLGeneric(
    way_inner_left->appendAtTheEnd(dummy);
    way_inner_right->appendAtTheEnd(dummy);
 
-   way_inner_link->appendAtTheEnd(xml::CodeXML::retrieveParsOnlyElement("tag", { {"k", "type"}, {"v", "road_link"} }));
-   way_inner_link->appendAtTheEnd(xml::CodeXML::retrieveParsOnlyElement("tag", { {"k", "rl:meta:country_code"}, {"v", "276"} }));
-   way_inner_link->appendAtTheEnd(xml::CodeXML::retrieveParsOnlyElement("tag", { {"k", "rl:meta:is_controlled"}, {"v", "false"} }));
-   way_inner_link->appendAtTheEnd(xml::CodeXML::retrieveParsOnlyElement("tag", { {"k", "rl:meta:is_motorway"}, {"v", "false"} }));
-   way_inner_link->appendAtTheEnd(xml::CodeXML::retrieveParsOnlyElement("tag", { {"k", "rl:meta:is_separated_structurally"}, {"v", "false"} }));
-   way_inner_link->appendAtTheEnd(xml::CodeXML::retrieveParsOnlyElement("tag", { {"k", "rl:meta:is_urban"}, {"v", "false"} }));
-   way_inner_link->appendAtTheEnd(xml::CodeXML::retrieveParsOnlyElement("tag", { {"k", "rl:predecessors"}, {"v", ""} }));
-   way_inner_link->appendAtTheEnd(xml::CodeXML::retrieveParsOnlyElement("tag", { {"k", "rl:successors"}, {"v", ""} }));
-   way_inner_link->appendAtTheEnd(xml::CodeXML::retrieveParsOnlyElement("tag", { {"k", "rl:travel_direction"}, {"v", "along"} }));
-   way_inner_link->appendAtTheEnd(xml::CodeXML::retrieveParsOnlyElement("tag", { {"k", "rl:type"}, {"v", "no_special"} }));
+   for (const auto& [k, v] : OSM_ROAD_LINK_TAGS) {
+      way_inner_link->appendAtTheEnd(xml::CodeXML::retrieveParsOnlyElement("tag", { {"k", k}, {"v", v} }));
+   }
 
    auto relation_inner = xml::CodeXML::emptyXML();
    relation_inner->appendAtTheEnd(xml::CodeXML::retrieveParsOnlyElement("member", { { "type","way" }, { "ref", std::to_string(way_ids.left_border_id_) }, { "role", "left" } }));
@@ -1011,10 +1056,51 @@ std::shared_ptr<xml::CodeXML> vfm::Way::getWayXMLGeneric(
    return xml;
 }
 
-std::shared_ptr<xml::CodeXML> vfm::Way::getWayXML() const
+void vfm::Way::writeWayGeneric(
+   xml::XmlWriter& writer,
+   const WayIDs& way_ids,
+   const std::vector<int>& left_ids,
+   const std::vector<int>& right_ids)
+{
+   // Attributes in the (alphabetical) order CodeXML writes them.
+   const auto head_pars = [](const int id) -> xml::XmlAttributes { return { { "id", std::to_string(id) }, { "version", "1" }, { "visible", "true" } }; };
+   const auto write_nds = [&writer](const std::vector<int>& ids) {
+      for (const auto& id : ids) writer.emptyElement("nd", { { "ref", std::to_string(id) } });
+   };
+   const auto write_tags = [&writer](const std::vector<std::pair<std::string, std::string>>& tags) {
+      for (const auto& [k, v] : tags) writer.emptyElement("tag", { { "k", k }, { "v", v } });
+   };
+
+   writer.startElement("way", head_pars(way_ids.left_border_id_));
+   write_nds(left_ids);
+   write_tags(OSM_BORDER_TAGS);
+   writer.endElement();
+
+   writer.startElement("way", head_pars(way_ids.right_border_id_));
+   write_nds(right_ids);
+   write_tags(OSM_BORDER_TAGS);
+   writer.endElement();
+
+   writer.startElement("way", head_pars(way_ids.road_link_id_));
+   write_nds(left_ids);
+   write_tags(OSM_ROAD_LINK_TAGS);
+   writer.endElement();
+
+   writer.startElement("relation", head_pars(way_ids.relation_id_));
+   writer.emptyElement("member", { { "ref", std::to_string(way_ids.left_border_id_) }, { "role", "left" }, { "type", "way" } });
+   writer.emptyElement("member", { { "ref", std::to_string(way_ids.right_border_id_) }, { "role", "right" }, { "type", "way" } });
+   write_tags({
+      { "location", "nonurban" },
+      { "rl:direction", "along" },
+      { "rl:id", std::to_string(way_ids.road_link_id_) },
+      { "speed_limit", "130.000000" },
+      { "subtype", "highway" },
+      { "type", "lanelet" } });
+   writer.endElement();
+}
+
+void vfm::Way::checkConnectorIDs() const
 {
-   auto res = getWayXMLGeneric(way_ids_, { origin_node_left_id_, target_node_left_id_ }, { origin_node_right_id_, target_node_right_id_ });
-   
    if (ids_to_connector_successor_nodes_left_.size() != ids_to_connector_successor_nodes_right_.size()) {
       addError("Different number of connector ways to the left (" 
          + std::to_string(ids_to_connector_successor_nodes_left_.size()) + ") and right (" 
@@ -1026,6 +1112,13 @@ std::shared_ptr<xml::CodeXML> vfm::Way::getWayXML() const
          + std::to_string(ids_for_connector_successor_ways_.size()) + ") and left node ids ("
          + std::to_string(ids_to_connector_successor_nodes_left_.size()) + ").");
    }
+}
+
+std::shared_ptr<xml::CodeXML> vfm::Way::getWayXML() const
+{
+   auto res = getWayXMLGeneric(way_ids_, { origin_node_left_id_, target_node_left_id_ }, { origin_node_right_id_, target_node_right_id_ });
+   
+   checkConnectorIDs();
 
    for (int i = 0; i < ids_to_connector_successor_nodes_left_.size(); i++) {
       auto ways = ids_for_connector_successor_ways_.at(i);
@@ -1048,6 +1141,17 @@ std::pair<std::shared_ptr<xml::CodeXML>, std::shared_ptr<xml::CodeXML>> vfm::Way
    return { xml_nodes, xml_ways };
 }
 
+void vfm::Way::writeWays(xml::XmlWriter& writer) const
+{
+   writeWayGeneric(writer, way_ids_, { origin_node_left_id_, target_node_left_id_ }, { origin_node_right_id_, target_node_right_id_ });
+
+   checkConnectorIDs();
+
+   for (int i = 0; i < ids_to_connector_successor_nodes_left_.size(); i++) {
+      writeWayGeneric(writer, ids_for_connector_successor_ways_.at(i), ids_to_connector_successor_nodes_left_.at(i), ids_to_connector_successor_nodes_right_.at(i));
+   }
+}
+
 std::shared_ptr<xml::CodeXML> vfm::RoadGraph::generateOSM() const
 {
    auto xml = CodeXML::beginXML();
@@ -1068,6 +1172,26 @@ std::shared_ptr<xml::CodeXML> vfm::RoadGraph::generateOSM() const
    return xml;
 }
 
+void vfm::RoadGraph::generateOSM(xml::XmlWriter& writer) const
+{
+   std::deque<Way> ways{}; // Only the ids are kept until all nodes are written.
+
+   writer.declaration();
+   writer.startElement("osm", { { "generator", "vfm" }, { "upload", "false" }, { "version", "0.6" } });
+
+   const_cast<RoadGraph*>(this)->findFirstSectionWithProperty([&ways, &writer](const std::shared_ptr<RoadGraph> r) -> bool {
+      ways.emplace_back(r);
+      ways.back().writeNodes(writer);
+      return false;
+   });
+
+   for (const auto& way : ways) {
+      way.writeWays(writer);
+   }
+
+   writer.endElement();
+}
+
 std::shared_ptr<RoadGraph> vfm::RoadGraph::copy() const
 {
    std::map<int, std::shared_ptr<RoadGraph>> dummy{};
@@ -0,0 +1,327 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+
+#include "simulation/road_graph_index.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <unordered_set>
+
+using namespace vfm;
+
+static constexpr int MAX_GRID_CELLS{ 1 << 20 };
+
+RoadGraphIndex::RoadGraphIndex(const std::shared_ptr<RoadGraph> r, const float grid_cell_size) : Failable("RoadGraphIndex")
+{
+   if (!r) {
+      addError("Cannot build index for empty road graph.");
+      return;
+   }
+
+   // Depth-first pre-order over successors, then predecessors, i.e., the same nodes in the same order as
+   // RoadGraph::applyToMeAndAllMySuccessorsAndPredecessors() visits them (without recursion).
+   std::unordered_set<RoadGraph*> visited{};
+   std::vector<std::shared_ptr<RoadGraph>> stack{ r };
+
+   while (!stack.empty()) {
+      const auto node{ stack.back() };
+      stack.pop_back();
+
+      if (!visited.insert(node.get()).second) continue;
+
+      nodes_.push_back(node);
+
+      const auto successors{ node->getSuccessors() };
+      const auto predecessors{ node->getPredecessors() };
+      stack.insert(stack.end(), predecessors.rbegin(), predecessors.rend());
+      stack.insert(stack.end(), successors.rbegin(), successors.rend());
+   }
+
+   buildSections();
+   buildGrid(grid_cell_size);
+   refreshCarIndex();
+}
+
+void RoadGraphIndex::buildSections()
+{
+   std::unordered_map<RoadGraph*, int> ptr_to_index{};
+   sections_.reserve(nodes_.size());
+
+   for (int i = 0; i < (int) nodes_.size(); i++) {
+      ptr_to_index[nodes_[i].get()] = i;
+
+      if (!id_to_index_.insert({ nodes_[i]->getID(), i }).second) {
+         addWarning("Section id '" + std::to_string(nodes_[i]->getID()) + "' occurs more than once in road graph. Only the first occurrence can be found by id.");
+      }
+   }
+
+   for (const auto& node : nodes_) {
+      auto& road{ node->getMyRoad() };
+      Section sec{};
+
+      sec.id_ = node->getID();
+      sec.origin_ = node->getOriginPoint();
+      sec.drain_ = node->getDrainPoint();
+      sec.angle_ = node->getAngle();
+      sec.length_ = road.getLength();
+      sec.lane_width_ = road.getLaneWidth();
+      sec.num_actual_lanes_ = road.getNumActualLanes();
+      sec.ghost_ = node->isGhost();
+
+      // The lanes extend sideways from the origin-drain line; since the side depends on the
+      // translator, we take both sides into account.
+      const float lateral{ std::max(0.0f, sec.lane_width_ * sec.num_actual_lanes_) };
+      Vec2D normal{ -std::sin(sec.angle_) * lateral, std::cos(sec.angle_) * lateral };
+      sec.footprint_.upper_left_ = { std::min(sec.origin_.x, sec.drain_.x) - std::abs(normal.x), std::min(sec.origin_.y, sec.drain_.y) - std::abs(normal.y) };
+      sec.footprint_.lower_right_ = { std::max(sec.origin_.x, sec.drain_.x) + std::abs(normal.x), std::max(sec.origin_.y, sec.drain_.y) + std::abs(normal.y) };
+
+      sec.first_segment_ = (int) segments_.size();
+      for (const auto& [begin, segment] : road.getSegments()) segments_.push_back(segment);
+      sec.num_segments_ = (int) segments_.size() - sec.first_segment_;
+
+      sec.first_successor_ = (int) successors_.size();
+      for (const auto& succ : node->getSuccessors()) successors_.push_back(ptr_to_index.at(succ.get()));
+      sec.num_successors_ = (int) successors_.size() - sec.first_successor_;
+
+      sec.first_predecessor_ = (int) predecessors_.size();
+      for (const auto& pred : node->getPredecessors()) predecessors_.push_back(ptr_to_index.at(pred.get()));
+      sec.num_predecessors_ = (int) predecessors_.size() - sec.first_predecessor_;
+
+      sections_.push_back(sec);
+   }
+}
+
+void RoadGraphIndex::buildGrid(const float grid_cell_size)
+{
+   if (sections_.empty()) return;
+
+   Vec2D min{ sections_[0].footprint_.upper_left_ };
+   Vec2D max{ sections_[0].footprint_.lower_right_ };
+
+   for (const auto& sec : sections_) {
+      min.x = std::min(min.x, sec.footprint_.upper_left_.x);
+      min.y = std::min(min.y, sec.footprint_.upper_left_.y);
+      max.x = std::max(max.x, sec.footprint_.lower_right_.x);
+      max.y = std::max(max.y, sec.footprint_.lower_right_.y);
+   }
+
+   grid_origin_ = min;
+   grid_cell_size_ = std::max(grid_cell_size, 1.0f);
+
+   const auto dimension_for = [&min, &max](const float cell_size) {
+      return std::make_pair(
+         std::max(1, (int) std::ceil((max.x - min.x) / cell_size)),
+         std::max(1, (int) std::ceil((max.y - min.y) / cell_size)));
+   };
+
+   while ((long long) dimension_for(grid_cell_size_).first * dimension_for(grid_cell_size_).second > MAX_GRID_CELLS) {
+      grid_cell_size_ *= 2; // Very large maps: coarser grid rather than excessive memory.
+   }
+
+   std::tie(grid_width_, grid_height_) = dimension_for(grid_cell_size_);
+
+   // Two passes (count, then fill) to get the flat CSR layout.
+   std::vector<int> counts(grid_width_ * grid_height_ + 1, 0);
+   const auto for_each_cell = [this](const Section& sec, const std::function<void(const int cell)>& action) {
+      const auto [x0, y0] = cellOf(sec.footprint_.upper_left_);
+      const auto [x1, y1] = cellOf(sec.footprint_.lower_right_);
+
+      for (int y = y0; y <= y1; y++) {
+         for (int x = x0; x <= x1; x++) {
+            action(y * grid_width_ + x);
+         }
+      }
+   };
+
+   for (const auto& sec : sections_) {
+      for_each_cell(sec, [&counts](const int cell) { counts[cell + 1]++; });
+   }
+
+   grid_offsets_.resize(counts.size());
+   std::partial_sum(counts.begin(), counts.end(), grid_offsets_.begin());
+   grid_items_.resize(grid_offsets_.back());
+   std::vector<int> fill(grid_offsets_.begin(), grid_offsets_.end() - 1);
+
+   for (int i = 0; i < (int) sections_.size(); i++) {
+      for_each_cell(sections_[i], [this, &fill, i](const int cell) { grid_items_[fill[cell]++] = i; });
+   }
+}
+
+std::pair<int, int> RoadGraphIndex::cellOf(const Vec2D& point) const
+{
+   const int x{ (int) std::floor((point.x - grid_origin_.x) / grid_cell_size_) };
+   const int y{ (int) std::floor((point.y - grid_origin_.y) / grid_cell_size_) };
+
+   return { std::clamp(x, 0, grid_width_ - 1), std::clamp(y, 0, grid_height_ - 1) };
+}
+
+int RoadGraphIndex::size() const
+{
+   return (int) sections_.size();
+}
+
+int RoadGraphIndex::indexOf(const int section_id) const
+{
+   const auto it{ id_to_index_.find(section_id) };
+   return it == id_to_index_.end() ? -1 : it->second;
+}
+
+int RoadGraphIndex::indexOfSectionWithCar(const int car_id) const
+{
+   const auto it{ car_to_index_.find(car_id) };
+   return it == car_to_index_.end() ? -1 : it->second;
+}
+
+const RoadGraphIndex::Section& RoadGraphIndex::getSection(const int index) const
+{
+   return sections_.at(index);
+}
+
+const std::vector<RoadGraphIndex::Section>& RoadGraphIndex::getSections() const
+{
+   return sections_;
+}
+
+const std::vector<LaneSegment>& RoadGraphIndex::getSegments() const
+{
+   return segments_;
+}
+
+SectionIndexRange RoadGraphIndex::getSuccessorIndices(const int index) const
+{
+   const auto& sec{ sections_.at(index) };
+   return { successors_.data() + sec.first_successor_, successors_.data() + sec.first_successor_ + sec.num_successors_ };
+}
+
+SectionIndexRange RoadGraphIndex::getPredecessorIndices(const int index) const
+{
+   const auto& sec{ sections_.at(index) };
+   return { predecessors_.data() + sec.first_predecessor_, predecessors_.data() + sec.first_predecessor_ + sec.num_predecessors_ };
+}
+
+std::vector<int> RoadGraphIndex::querySections(const Rec2D& area) const
+{
+   std::vector<int> res{};
+
+   if (sections_.empty()) return res;
+
+   const auto [x0, y0] = cellOf(area.upper_left_);
+   const auto [x1, y1] = cellOf(area.lower_right_);
+
+   for (int y = y0; y <= y1; y++) {
+      for (int x = x0; x <= x1; x++) {
+         const int cell{ y * grid_width_ + x };
+
+         for (int i = grid_offsets_[cell]; i < grid_offsets_[cell + 1]; i++) {
+            const int sec{ grid_items_[i] };
+            if (sections_[sec].footprint_.intersect(area)) res.push_back(sec);
+         }
+      }
+   }
+
+   std::sort(res.begin(), res.end());
+   res.erase(std::unique(res.begin(), res.end()), res.end());
+
+   return res;
+}
+
+std::vector<int> RoadGraphIndex::querySectionsAt(const Vec2D& point) const
+{
+   std::vector<int> res{};
+
+   if (sections_.empty()) return res;
+
+   const auto [x, y] = cellOf(point);
+   const int cell{ y * grid_width_ + x };
+
+   for (int i = grid_offsets_[cell]; i < grid_offsets_[cell + 1]; i++) {
+      const int sec{ grid_items_[i] };
+      if (sections_[sec].footprint_.isPointInside(point)) res.push_back(sec);
+   }
+
+   return res;
+}
+
+void RoadGraphIndex::refreshCarIndex()
+{
+   car_to_index_.clear();
+
+   for (int i = 0; i < (int) nodes_.size(); i++) {
+      const auto& road{ nodes_[i]->getMyRoad() };
+
+      if (road.getEgo()) car_to_index_.insert({ RoadGraph::EGO_MOCK_ID, i });
+      for (const auto& other : road.getOthers()) car_to_index_.insert({ other.car_id_, i });
+   }
+}
+
+std::shared_ptr<RoadGraph> RoadGraphIndex::getNode(const int index) const
+{
+   return index >= 0 && index < (int) nodes_.size() ? nodes_[index] : nullptr;
+}
+
+std::shared_ptr<RoadGraph> RoadGraphIndex::findSectionWithID(const int id) const
+{
+   return getNode(indexOf(id));
+}
+
+std::shared_ptr<RoadGraph> RoadGraphIndex::findSectionWithCar(const int car_id) const
+{
+   return getNode(indexOfSectionWithCar(car_id));
+}
+
+std::shared_ptr<RoadGraph> RoadGraphIndex::findSectionWithEgoIfAny() const
+{
+   for (const auto& node : nodes_) {
+      if (node->getMyRoad().getEgo()) return node;
+   }
+
+   return nullptr;
+}
+
+RoadGraph::CarLocation RoadGraphIndex::findEgo() const
+{
+   // No use of the car index here since ego moves every step; a linear scan over the flat array is cheap.
+   if (const auto ego_section = findSectionWithEgoIfAny()) {
+      return RoadGraph::CarLocation{ ego_section, nullptr, ego_section->getMyRoad().getEgo() };
+   }
+
+   for (int i = 0; i < (int) nodes_.size(); i++) {
+      for (const int succ : getSuccessorIndices(i)) {
+         for (const auto& car : nodes_[i]->getNonegosOnCrossingTowardsSuccessor(nodes_[succ])) {
+            if (car.car_id_ == RoadGraph::EGO_MOCK_ID) {
+               return RoadGraph::CarLocation{
+                  nodes_[i],
+                  nodes_[succ],
+                  std::make_shared<CarPars>(car.car_lane_, car.car_rel_pos_, car.car_velocity_, car.car_id_, DEFAULT_CAR_DIMENSIONS_M) };
+            }
+         }
+      }
+   }
+
+   return RoadGraph::CarLocation{ nullptr, nullptr, nullptr };
+}
+
+const std::vector<std::shared_ptr<RoadGraph>>& RoadGraphIndex::getAllNodes() const
+{
+   return nodes_;
+}
+
+void RoadGraphIndex::applyToAll(const std::function<void(const std::shared_ptr<RoadGraph>)>& action) const
+{
+   for (const auto& node : nodes_) action(node);
+}
+
+void RoadGraphIndex::cleanFromAllCars()
+{
+   car_to_index_.clear();
+
+   for (const auto& node : nodes_) {
+      node->getMyRoad().setEgo(nullptr);
+      node->getMyRoad().setOthers({});
+      node->clearNonegosOnCrossingsTowardsAny();
+   }
+}
@@ -6,6 +6,7 @@
 /// @file
 
 #include "vfmacro/script.h"
+#include "bracket_index.h"
 #include "geometry/bezier_functions.h"
 #include "parser.h"
 #include "simplification/simplification.h"
@@ -903,23 +904,16 @@ std::string Script::removeTaggedPartsOnTopLevel(
 {
    std::string s;
    int count = 0;
+   const BracketIndex ignored{ code, ignoreBegTags, ignoreEndTags };
 
    for (int i = 0; i < code.length(); i++) {
       if (StaticHelper::stringStartsWith(code, beginTag, i)
-         && !StaticHelper::isWithinAnyLevelwise(
-            code,
-            i,
-            ignoreBegTags,
-            ignoreEndTags)) {
+         && !ignored.isWithinAny(i)) {
          count++;
          i += beginTag.length() - 1;
       }
       else if (StaticHelper::stringStartsWith(code, endTag, i)
-         && !StaticHelper::isWithinAnyLevelwise(
-            code,
-            i,
-            ignoreBegTags,
-            ignoreEndTags)) {
+         && !ignored.isWithinAny(i)) {
          count--;
          i += endTag.length() - 1;
       }
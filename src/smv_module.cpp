@@ -7,6 +7,9 @@
 
 #include "model_checking/smv_parsing/smv_module.h"
 #include "static_helper.h"
+#include "bracket_index.h"
+#include <cassert>
+#include <cctype>
 
 using namespace vfm::mc::smv;
 
@@ -15,11 +18,21 @@ vfm::mc::smv::Module::Module() : Failable("SMV Module Element") {}
 
 std::string vfm::mc::smv::Module::serialize() const
 {
-   std::string s = "MODULE " + module_name_ + "\n\n";
+   size_t size{ module_name_.size() + 9 };
+
+   for (const auto& pair : elements_singleton_) {
+      std::visit([&size](auto&& module_element) {
+         size += module_element.getModuleElementName().size() + module_element.getRawCodeRef().size() + 2;
+      }, pair.second);
+   }
+
+   std::string s{};
+   s.reserve(size);
+   s += "MODULE " + module_name_ + "\n\n";
 
    for (const auto& pair : elements_singleton_) {
       std::visit([&s](auto&& module_element) {
-         s += module_element.serialize();
+         module_element.serializeInto(s);
       }, pair.second);
    }
    
@@ -30,10 +43,13 @@ void vfm::mc::smv::Module::clear()
 {
    elements_singleton_.clear();
    module_name_ = "";
+   invalidateCaches("");
 }
 
 bool vfm::mc::smv::Module::parseProgram(const std::string& program_raw)
 {
+   invalidateCaches("");
+
    std::string program = StaticHelper::removeSingleLineComments(program_raw, "--");
 
    for (const auto& el_names_pair : elements_singleton_) {
@@ -63,35 +79,102 @@ bool vfm::mc::smv::Module::parseProgram(const std::string& program_raw)
    return true;
 }
 
-std::vector<std::string> vfm::mc::smv::Module::splitAlongLines(const std::string& raw_code) const
+void vfm::mc::smv::Module::invalidateCaches(const std::string& section_name)
 {
-   auto res_raw = vfm::StaticHelper::removeBlankLines(vfm::StaticHelper::removeSingleLineComments(raw_code, "--"));
-   auto res = vfm::StaticHelper::split(
-      res_raw,
-      ";",
-      [](const std::string& split_str, const int pos) -> bool {
-         return !StaticHelper::isWithinLevelwise(split_str, pos, "case", "esac");
-      });
+   const bool all{ section_name.empty() };
 
-   for (auto&& el : res) {
-      StaticHelper::trim(el);
+   if (all) {
+      section_indices_.clear();
+   }
+   else {
+      section_indices_.erase(section_name);
    }
 
-   res.erase(std::remove_if(res.begin(), res.end(), [](const std::string& s) { return StaticHelper::isEmptyExceptWhiteSpaces(s); }), res.end());
+   if (all || section_name == NAME_VAR) {
+      variables_with_types_.reset();
+      variables_and_defines_.reset();
+   }
 
-   return res;
+   if (all || section_name == NAME_ASSIGN) {
+      variable_inits_.reset();
+   }
+
+   if (all || section_name == NAME_DEFINE) {
+      variable_defines_.reset();
+      variables_and_defines_.reset();
+   }
+}
+
+void vfm::mc::smv::Module::setSectionCode(const std::string& section_name, const std::string& code)
+{
+   if (!elements_singleton_.count(section_name)) {
+      addError("Unknown SMV section '" + section_name + "'.");
+      return;
+   }
+
+   std::visit([&code](auto&& module_element) {
+      module_element.setCode(code);
+   }, elements_singleton_.at(section_name));
+
+   invalidateCaches(section_name);
+}
+
+const SectionIndex& vfm::mc::smv::Module::getSectionIndex(const std::string& section_name) const
+{
+   const auto it{ section_indices_.find(section_name) };
+
+   if (it != section_indices_.end()) return it->second;
+
+   SectionIndex& index{ section_indices_[section_name] };
+
+   if (elements_singleton_.count(section_name)) {
+      std::visit([&index](auto&& module_element) {
+         index.code_ = StaticHelper::removeBlankLines(StaticHelper::removeSingleLineComments(module_element.getRawCodeRef(), "--"));
+      }, elements_singleton_.at(section_name));
+   }
+
+   const std::string& code{ index.code_ };
+   const auto add_trimmed = [&code, &index](int begin, int end) {
+      while (begin < end && std::isspace((unsigned char) code[begin])) begin++;
+      while (end > begin && std::isspace((unsigned char) code[end - 1])) end--;
+
+      if (begin < end) {
+         index.statements_.push_back({ begin, end - begin });
+      }
+   };
+
+   int last{ 0 };
+
+   for (const int pos : BracketIndex(code, { "case" }, { "esac" }).findOnTopLevel(";")) {
+      add_trimmed(last, pos);
+      last = pos + 1;
+   }
+
+   add_trimmed(last, code.size());
+
+   return index;
 }
 
-std::map<std::string, std::shared_ptr<SMVDatatype>> vfm::mc::smv::Module::getVariablesWithTypes() const
+std::string vfm::mc::smv::Module::getStatement(const std::string& section_name, const SectionStatement& statement) const
 {
+   return getSectionIndex(section_name).code_.substr(statement.begin_, statement.length_);
+}
+
+const std::map<std::string, std::shared_ptr<SMVDatatype>>& vfm::mc::smv::Module::getVariablesWithTypes() const
+{
+   if (variables_with_types_) return *variables_with_types_;
+
    const static std::string TEMP_DOUBLE_COLON_REPLACEMENT = "$$$-DC-$$$";
-   std::map<std::string, std::shared_ptr<SMVDatatype>> res;
+   variables_with_types_.emplace();
+   auto& res{ *variables_with_types_ };
 
-   for (const auto& line_raw : splitAlongLines(std::get<VarSection>(elements_singleton_.at(NAME_VAR)).getRawCode())) {
-      auto line = StaticHelper::split(StaticHelper::trimAndReturn(StaticHelper::replaceAll(line_raw, "::", TEMP_DOUBLE_COLON_REPLACEMENT)), ":");
+   for (const auto& statement : getSectionIndex(NAME_VAR).statements_) {
+      const std::string line_raw{ getStatement(NAME_VAR, statement) };
+      auto line = StaticHelper::split(StaticHelper::replaceAll(line_raw, "::", TEMP_DOUBLE_COLON_REPLACEMENT), ":");
 
       if (line.size() != 2) {
          addError("Line '" + line_raw + "' malformed, cannot derive variable with type.");
+         continue;
       }
 
       std::string name = StaticHelper::replaceAll(StaticHelper::trimAndReturn(line[0]), TEMP_DOUBLE_COLON_REPLACEMENT, "::");
@@ -128,34 +211,48 @@ std::map<std::string, std::shared_ptr<SMVDatatype>> vfm::mc::smv::Module::getVar
    return res;
 }
 
-std::map<std::string, std::string> vfm::mc::smv::Module::getAllVariableInits() const
+std::shared_ptr<SMVDatatype> vfm::mc::smv::Module::getVariableType(const std::string& var_name) const
 {
-   std::map<std::string, std::string> res;
+   const auto& vars{ getVariablesWithTypes() };
+   const auto it{ vars.find(var_name) };
+   return it == vars.end() ? nullptr : it->second;
+}
 
-   for (const auto& line_raw : splitAlongLines(std::get<AssignSection>(elements_singleton_.at(NAME_ASSIGN)).getRawCode())) {
-      auto line = StaticHelper::removeWhiteSpace(line_raw);
+const std::map<std::string, std::string>& vfm::mc::smv::Module::getAllVariableInits() const
+{
+   if (variable_inits_) return *variable_inits_;
 
-      if (StaticHelper::stringStartsWith(line, "init(")) {
-         auto pair = StaticHelper::split(line, ":=");
+   variable_inits_.emplace();
+   auto& res{ *variable_inits_ };
+   const SectionIndex& index{ getSectionIndex(NAME_ASSIGN) };
 
-         assert(pair.size() == 2);
+   for (const auto& statement : index.statements_) {
+      auto line = StaticHelper::removeWhiteSpace(getStatement(NAME_ASSIGN, statement));
 
-         auto name = StaticHelper::replaceAll(StaticHelper::replaceAll(pair[0], "init(", ""), ")", "");
-         auto init = StaticHelper::replaceAll(pair[1], ";", "");
+      if (!StaticHelper::stringStartsWith(line, "init(")) continue;
 
-         res.insert({ name, init });
-      }
+      auto pair = StaticHelper::split(line, ":=");
+
+      assert(pair.size() == 2);
+
+      auto name = StaticHelper::replaceAll(StaticHelper::replaceAll(pair[0], "init(", ""), ")", "");
+      auto init = StaticHelper::replaceAll(pair[1], ";", "");
+
+      res.insert({ name, init });
    }
 
    return res;
 }
 
-std::map<std::string, std::string> vfm::mc::smv::Module::getVariableDefines() const
+const std::map<std::string, std::string>& vfm::mc::smv::Module::getVariableDefines() const
 {
-   std::map<std::string, std::string> res;
-   auto raw_code = splitAlongLines(std::get<DefineSection>(elements_singleton_.at(NAME_DEFINE)).getRawCode());
+   if (variable_defines_) return *variable_defines_;
+
+   variable_defines_.emplace();
+   auto& res{ *variable_defines_ };
 
-   for (const auto& line_raw : raw_code) {
+   for (const auto& statement : getSectionIndex(NAME_DEFINE).statements_) {
+      const std::string line_raw{ getStatement(NAME_DEFINE, statement) };
       auto line_split = StaticHelper::split(line_raw, ":=");
 
       if (line_split.size() == 2) {
@@ -170,18 +267,18 @@ std::map<std::string, std::string> vfm::mc::smv::Module::getVariableDefines() co
    return res;
 }
 
-std::set<std::string> vfm::mc::smv::Module::getAllVariablesAndDefinesForOutsideUsage() const
+const std::set<std::string>& vfm::mc::smv::Module::getAllVariablesAndDefinesForOutsideUsage() const
 {
-   std::set<std::string> vec{};
+   if (variables_and_defines_) return *variables_and_defines_;
 
-   auto vars = getVariablesWithTypes();
-   auto defs = getVariableDefines();
+   variables_and_defines_.emplace();
+   auto& vec{ *variables_and_defines_ };
 
-   for (const auto& var : vars) {
+   for (const auto& var : getVariablesWithTypes()) {
       vec.insert(var.first);
    }
 
-   for (const auto& def : defs) {
+   for (const auto& def : getVariableDefines()) {
       vec.insert(def.first);
    }
 
@@ -23,6 +23,11 @@ std::string vfm::mc::smv::ModuleElementBase::getRawCode() const
    return raw_code_;
 }
 
+const std::string& vfm::mc::smv::ModuleElementBase::getRawCodeRef() const
+{
+   return raw_code_;
+}
+
 void vfm::mc::smv::ModuleElementBase::setCode(const std::string& to)
 {
    raw_code_ = to;
@@ -35,9 +40,19 @@ void vfm::mc::smv::ModuleElementBase::appendCodeLine(const std::string& line)
 
 std::string vfm::mc::smv::ModuleElementBase::serialize() const
 {
-   if (getRawCode().empty()) {
-      return "";
+   std::string s{};
+   serializeInto(s);
+   return s;
+}
+
+void vfm::mc::smv::ModuleElementBase::serializeInto(std::string& s) const
+{
+   if (raw_code_.empty()) {
+      return;
    }
 
-   return getModuleElementName() + "\n" + getRawCode() + "\n";
+   s += getModuleElementName();
+   s += "\n";
+   s += raw_code_;
+   s += "\n";
 }
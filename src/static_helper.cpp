@@ -6,6 +6,7 @@
 /// @file
 
 #include "static_helper.h"
+#include "bracket_index.h"
 #include "parser.h"
 #include "failable.h"
 #include "meta_rule.h"
@@ -236,16 +237,23 @@ bool StaticHelper::isEmptyExceptWhiteSpaces(const std::string& string)
 
 std::string vfm::StaticHelper::removeMultiLineComments(const std::string& string, const std::string& comment_open, const std::string& comment_close)
 {
-   int beg = indexOfFirstInnermostBeginBracket(string, comment_open, comment_close);
+   const BracketIndex index{ string, { comment_open }, { comment_close } };
+   std::string result{};
+   int copied_until{ 0 };
+   int beg = string.find(comment_open);
+
+   while (beg >= 0) { // Removing each outermost comment at once is the same as removing innermost comments until none is left.
+      int beg_dummy{ beg };
+      const int end{ index.findMatchingEndTag(beg_dummy, 0) };
 
-   if (beg >= 0) {
-      int end = findMatchingEndTagLevelwise(string, comment_open, comment_close, beg);
-      std::string comment_part = string.substr(beg, end - beg + comment_close.size());
+      if (end < 0) break;
 
-      return removeMultiLineComments(StaticHelper::replaceAll(string, comment_part, ""), comment_open, comment_close);
+      result += string.substr(copied_until, beg - copied_until);
+      copied_until = end + comment_close.size();
+      beg = string.find(comment_open, copied_until);
    }
 
-   return string;
+   return result + string.substr(copied_until);
 }
 
 std::string vfm::StaticHelper::removeSingleLineComments(const std::string& string, const std::string& comment_denoter)
@@ -510,34 +518,43 @@ std::vector<std::string> StaticHelper::extractSubstringsLevelwise(
    const int beginTagPos,
    const bool stopAfterFirstMatch,
    std::vector<std::string>& soFar) {
-   int curBegin = string.find(beginTag, beginTagPos);
+   const BracketIndex index{ string, tagsWithPrepended(beginTag, ignoreBegTags), tagsWithPrepended(endTag, ignoreEndTags) };
+   std::vector<std::string> found{};
+   int from = beginTagPos;
 
-   /* 
-    * Find first non-ignored begin tag. This will be the start point of 
-    * the string extracted by this method call. The end will be the first
-    * non-ignored matching end tag.
-    */
-   while (curBegin >= 0
-      && isWithinAnyLevelwise(string, curBegin, ignoreBegTags, ignoreEndTags)) {
-      curBegin = string.find(beginTag, curBegin + 1);
-   }
+   for (;;) {
+      int curBegin = string.find(beginTag, from);
 
-   if (curBegin < 0) {
-      return soFar;
-   }
+      /* 
+       * Find first non-ignored begin tag. This will be the start point of 
+       * the string extracted in this round. The end will be the first
+       * non-ignored matching end tag.
+       */
+      while (curBegin >= 0 && index.isWithinAnyOther(curBegin, 0)) {
+         curBegin = string.find(beginTag, curBegin + 1);
+      }
 
-   int endPos = findMatchingEndTagLevelwise(string, beginTag, endTag, curBegin,
-      ignoreBegTags, ignoreEndTags);
+      if (curBegin < 0) {
+         break;
+      }
 
-   if (endPos >= 0) {
-      if (!stopAfterFirstMatch) { // Go on recursively with rest of string.
-         extractSubstringsLevelwise(string.substr(endPos + endTag.length()), beginTag, endTag, ignoreBegTags, ignoreEndTags, 0, stopAfterFirstMatch, soFar);
+      int endPos = index.findMatchingEndTag(curBegin, 0);
+
+      if (endPos < 0) {
+         break;
       }
 
       auto innerPartBegin = curBegin + beginTag.length();
-      soFar.push_back(string.substr(innerPartBegin, endPos - innerPartBegin));
+      found.push_back(string.substr(innerPartBegin, endPos - innerPartBegin));
+
+      if (stopAfterFirstMatch) {
+         break;
+      }
+
+      from = endPos + endTag.length();
    }
 
+   soFar.insert(soFar.end(), found.rbegin(), found.rend()); // Last match first, as always.
    return soFar;
 }
 
@@ -554,6 +571,11 @@ int StaticHelper::findMatchingEndTagLevelwise(
    const std::string& endTag,
    const std::vector<std::string>& ignoreBegTags,
    const std::vector<std::string>& ignoreEndTags) {
+   if (!ignoreBegTags.empty()) {
+      return findMatchingEndTagLevelwise(BracketIndex(string, tagsWithPrepended(beginTag, ignoreBegTags), tagsWithPrepended(endTag, ignoreEndTags)), pos);
+   }
+
+   // Without ignore tags, a plain scan is linear in the distance to the match, cheaper than indexing the whole string.
    while (pos < string.size() && !stringStartsWith(string, beginTag, pos)) pos++;
 
    int count = 0; // Because we start on a begin tag.
@@ -562,14 +584,12 @@ int StaticHelper::findMatchingEndTagLevelwise(
    for (int i = pos; i < string.length(); i += next_inc) {
       next_inc = 1;
 
-      if (stringStartsWith(string, beginTag, i)
-         && !isWithinAnyLevelwise(string, i, ignoreBegTags, ignoreEndTags)) {
+      if (stringStartsWith(string, beginTag, i)) {
          count++;
          next_inc = beginTag.size();
       }
 
-      if (stringStartsWith(string, endTag, i)
-         && !isWithinAnyLevelwise(string, i, ignoreBegTags, ignoreEndTags)) {
+      if (stringStartsWith(string, endTag, i)) {
          count--;
          next_inc = endTag.size();
       }
@@ -582,6 +602,11 @@ int StaticHelper::findMatchingEndTagLevelwise(
    return -1;
 }
 
+int StaticHelper::findMatchingEndTagLevelwise(const BracketIndex& index, int& pos)
+{
+   return index.findMatchingEndTag(pos, 0);
+}
+
 int StaticHelper::findMatchingBegTagLevelwise(
    const std::string& string,
    const std::string& beginTag, 
@@ -589,16 +614,18 @@ int StaticHelper::findMatchingBegTagLevelwise(
    const int pos,
    const std::vector<std::string>& ignoreBegTags,
    const std::vector<std::string>& ignoreEndTags) {
+   if (!ignoreBegTags.empty()) {
+      return findMatchingBegTagLevelwise(BracketIndex(string, tagsWithPrepended(beginTag, ignoreBegTags), tagsWithPrepended(endTag, ignoreEndTags)), pos);
+   }
+
    int count = 0;               // Because we start on an end tag.
 
    for (int i = pos; i >= 0; i--) {
-      if (stringStartsWith(string, beginTag, i)
-         && !isWithinAnyLevelwise(string, i, ignoreBegTags, ignoreEndTags)) {
+      if (stringStartsWith(string, beginTag, i)) {
          count++;
       }
 
-      if (stringStartsWith(string, endTag, i)
-         && !isWithinAnyLevelwise(string, i, ignoreBegTags, ignoreEndTags)) {
+      if (stringStartsWith(string, endTag, i)) {
          count--;
       }
 
@@ -610,6 +637,11 @@ int StaticHelper::findMatchingBegTagLevelwise(
    return -1;
 }
 
+int StaticHelper::findMatchingBegTagLevelwise(const BracketIndex& index, const int pos)
+{
+   return index.findMatchingBegTag(pos, 0);
+}
+
 int StaticHelper::indexOfFirstInnermostBeginBracket(
    const std::string& string, 
    const std::string& beg, 
@@ -618,14 +650,24 @@ int StaticHelper::indexOfFirstInnermostBeginBracket(
    const std::vector<std::string>& ignoreEndTags,
    const std::function<bool(const std::string& str, const int index)>& begin_function,
    const std::function<bool(const std::string& str, const int index)>& end_function) {
+   return indexOfFirstInnermostBeginBracket(BracketIndex(string, tagsWithPrepended(beg, ignoreBegTags), tagsWithPrepended(end, ignoreEndTags)), begin_function, end_function);
+}
+
+int StaticHelper::indexOfFirstInnermostBeginBracket(
+   const BracketIndex& index,
+   const std::function<bool(const std::string& str, const int index)>& begin_function,
+   const std::function<bool(const std::string& str, const int index)>& end_function) {
+   const std::string& string{ index.getString() };
+   const std::string& beg{ index.getBeginTags()[0] };
+   const std::string& end{ index.getEndTags()[0] };
    int firstBeg = string.find(beg);
    int firstEnd = string.find(end, firstBeg);
 
-   while (isWithinAnyLevelwise(string, firstBeg, ignoreBegTags, ignoreEndTags)) {
+   while (index.isWithinAnyOther(firstBeg, 0)) {
       firstBeg = string.find(beg, firstBeg + 1);
    }
 
-   while (isWithinAnyLevelwise(string, firstEnd, ignoreBegTags, ignoreEndTags)) {
+   while (index.isWithinAnyOther(firstEnd, 0)) {
       firstEnd = string.find(end, firstEnd + 1);
    }
 
@@ -633,12 +675,14 @@ int StaticHelper::indexOfFirstInnermostBeginBracket(
       return -1;
    }
 
-   int result = findMatchingBegTagLevelwise(string, beg, end, firstEnd, ignoreBegTags, ignoreEndTags);
+   int result = findMatchingBegTagLevelwise(index, firstEnd);
 
    if (begin_function(string, result) && end_function(string, firstEnd)) {
       return result;
    }
    else {
+      const std::vector<std::string> ignoreBegTags(index.getBeginTags().begin() + 1, index.getBeginTags().end());
+      const std::vector<std::string> ignoreEndTags(index.getEndTags().begin() + 1, index.getEndTags().end());
       auto string_copy = string;
       static constexpr char c = '#';
       bool collides = true;
@@ -670,6 +714,13 @@ int StaticHelper::indexOfFirstInnermostBeginBracket(
    }
 }
 
+std::vector<std::string> StaticHelper::tagsWithPrepended(const std::string& tag, const std::vector<std::string>& tags)
+{
+   std::vector<std::string> result{ tag };
+   result.insert(result.end(), tags.begin(), tags.end());
+   return result;
+}
+
 bool StaticHelper::isWithinAnyLevelwise(
    const std::string& string, 
    const int pos, 
@@ -702,7 +753,7 @@ bool StaticHelper::isWithinLevelwise(
       bool within = false;
 
       for (int i = pos; i >= 0; i--) {
-         if (string.substr(i, beginTag.length()) == beginTag) {
+         if (!string.compare(i, beginTag.length(), beginTag)) {
             within = !within;
          }
       }
@@ -780,8 +831,17 @@ int StaticHelper::indexOfOnTopLevel(
    const std::vector<std::string>& ignoreBegTags,
    const std::vector<std::string>& ignoreEndTags) 
 {
+   return indexOfOnTopLevel(BracketIndex(string, tagsWithPrepended(beginTag, ignoreBegTags), tagsWithPrepended(endTag, ignoreEndTags)), find, startPos);
+}
+
+int StaticHelper::indexOfOnTopLevel(const BracketIndex& index, const std::vector<std::string>& find, const int startPos)
+{
+   const std::string& string{ index.getString() };
+   const std::string& beginTag{ index.getBeginTags()[0] };
+   const std::string& endTag{ index.getEndTags()[0] };
+
    for (int i = startPos; i < string.length(); i++) { // Find the next point matching any of the find strings and not within the ignore tags.
-      if (!isWithinAnyLevelwise(string, i, ignoreBegTags, ignoreEndTags)) {
+      if (!index.isWithinAnyOther(i, 0)) {
          for (const auto& findstr : find) {
             if (StaticHelper::stringStartsWith(string, findstr, i)) {
                return i;
@@ -1599,6 +1659,21 @@ std::vector<std::string> StaticHelper::split(const std::vector<std::string>& ss,
    return result;
 }
 
+std::vector<std::string> StaticHelper::splitOnTopLevel(const std::string& s, const std::string& delim, const std::vector<std::string>& beginTags, const std::vector<std::string>& endTags)
+{
+   std::vector<std::string> result;
+   int last = 0;
+
+   for (const int pos : BracketIndex(s, beginTags, endTags).findOnTopLevel(delim)) {
+      result.push_back(s.substr(last, pos - last));
+      last = pos + delim.size();
+   }
+
+   result.push_back(s.substr(last));
+
+   return result;
+}
+
 size_t spaceLeft(const size_t line_length, const size_t word_length)
 {
    return line_length >= word_length ? line_length - word_length : 0;
@@ -2215,6 +2290,35 @@ std::vector<MCTrace> vfm::StaticHelper::extractMCTracesFromKratos(const std::str
    return trace.empty() ? std::vector<MCTrace>{} : std::vector<MCTrace>{ trace };
 }
 
+uint64_t StaticHelper::hashFNV1a(const std::string& str, const uint64_t seed)
+{
+   return hashFNV1a(str.data(), str.size(), seed);
+}
+
+uint64_t StaticHelper::hashFNV1a(const char* data, const size_t size, const uint64_t seed)
+{
+   uint64_t hash{ seed };
+
+   for (size_t i = 0; i < size; i++) {
+      hash ^= (unsigned char) data[i];
+      hash *= 0x100000001b3ULL;
+   }
+
+   return hash;
+}
+
+std::string StaticHelper::hashFNV1aHex(const std::string& str)
+{
+   return hashToHex(hashFNV1a(str));
+}
+
+std::string StaticHelper::hashToHex(const uint64_t hash)
+{
+   std::stringstream ss{};
+   ss << std::hex << std::setw(16) << std::setfill('0') << hash;
+   return ss.str();
+}
+
 std::string StaticHelper::readFile(const std::filesystem::path& path, const bool from_utf16)
 {
    std::string ce_raw{};
@@ -2478,6 +2582,7 @@ std::shared_ptr<BracketStructure> vfm::StaticHelper::extractArbitraryBracketStru
       return 0;
    };
 
+   const BracketIndex index{ bracket_structure_as_string, tagsWithPrepended(opening_bracket, ignoreBegTags), tagsWithPrepended(closing_bracket, ignoreEndTags) };
    int next_inc = 1;
    std::string current_element;
    for (int i = 0; i < bracket_structure_as_string.size(); i += next_inc) {
@@ -2491,7 +2596,7 @@ std::shared_ptr<BracketStructure> vfm::StaticHelper::extractArbitraryBracketStru
          } else {
             if (bracket_structure_as_string.substr(i, opening_bracket.size()) == opening_bracket) {
                int pos_beg = i;
-               int pos_end = findMatchingEndTagLevelwise(bracket_structure_as_string, pos_beg, opening_bracket, closing_bracket, ignoreBegTags, ignoreEndTags);
+               int pos_end = findMatchingEndTagLevelwise(index, pos_beg);
                std::string part = bracket_structure_as_string.substr(pos_beg + opening_bracket.size(), pos_end - pos_beg - opening_bracket.size());
                overall_structure->children_.push_back(extractArbitraryBracketStructure(part, opening_bracket, closing_bracket, delimiter, ignoreBegTags, ignoreEndTags, false));
                i = pos_end + closing_bracket.size() + 1 - next_inc;
@@ -2534,12 +2639,9 @@ void vfm::StaticHelper::preprocessCppConvertCStyleArraysToVars(std::string& prog
 void vfm::StaticHelper::preprocessCppConvertArraysToCStyle(std::string& program, const std::set<std::string>& possible_array_type_names)
 {
    std::string array_type_name;
+   const BracketIndex index{ program, { "<", "\"" }, { ">", "\"" } };
    int begin_array = indexOfFirstInnermostBeginBracket(
-      program,
-      "<",
-      ">",
-      { "\"" },
-      { "\"" },
+      index,
       [&possible_array_type_names, &array_type_name](const std::string& str, const int index) {
          int dummy_ind = index - 1;
          auto single_token = tokenize(
@@ -2554,7 +2656,8 @@ void vfm::StaticHelper::preprocessCppConvertArraysToCStyle(std::string& program,
       });
 
    if (begin_array >= 0) {
-      int end_array = findMatchingEndTagLevelwise(program, begin_array, "<", ">", { "\"" }, { "\"" });
+      int dummy = begin_array;
+      int end_array = findMatchingEndTagLevelwise(index, dummy);
       int real_begin = begin_array;
       int prefix_length = 0;
 
@@ -2627,13 +2730,10 @@ void vfm::StaticHelper::preprocessCppConvertArraysToCStyle(std::string& program,
 void vfm::StaticHelper::preprocessCppConvertElseIfToPlainElse(std::string& program)
 {
    std::string condition;
+   const BracketIndex index{ program, { "{", "\"" }, { "}", "\"" } };
 
    int begin_if_else = indexOfFirstInnermostBeginBracket(
-      program, 
-      "{", 
-      "}", 
-      { "\"" }, 
-      { "\"" }, 
+      index, 
       [&condition](const std::string& str, const int index) {
       condition = ")";
       int dummy_ind = index;
@@ -2671,7 +2771,8 @@ void vfm::StaticHelper::preprocessCppConvertElseIfToPlainElse(std::string& progr
    });
 
    if (begin_if_else >= 0) {
-      int end_if_else = findMatchingEndTagLevelwise(program, begin_if_else, "{", "}", { "\"" }, { "\"" });
+      int dummy_begin = begin_if_else;
+      int end_if_else = findMatchingEndTagLevelwise(index, dummy_begin);
       int overall_begin = begin_if_else;
       int dummy = 0;
       int bracket_count = 0;
@@ -2711,11 +2812,13 @@ void vfm::StaticHelper::preprocessCppConvertElseIfToPlainElse(std::string& progr
          }
       }
 
-      int end_else_if_blocks = has_elseif_bracket ? findMatchingEndTagLevelwise(after_if_else, dummy, "(", ")", { "\"" }, { "\"" }) : dummy;
+      const BracketIndex round_index{ after_if_else, { "(", "\"" }, { ")", "\"" } }; // after_if_else stays the same until the end of the loop below.
+      const BracketIndex curly_index{ after_if_else, { "{", "\"" }, { "}", "\"" } };
+      int end_else_if_blocks = has_elseif_bracket ? findMatchingEndTagLevelwise(round_index, dummy) : dummy;
       auto plain_between_part = removeWhiteSpace(after_if_else.substr(temp, dummy - temp));
 
       while (plain_between_part == "elseif" || plain_between_part == "else") {
-         end_else_if_blocks = findMatchingEndTagLevelwise(after_if_else, dummy, "{", "}", { "\"" }, { "\"" });
+         end_else_if_blocks = findMatchingEndTagLevelwise(curly_index, dummy);
          int opening_brace_pos = dummy;
          dummy = end_else_if_blocks;
          temp = end_else_if_blocks + 1;
@@ -2732,10 +2835,10 @@ void vfm::StaticHelper::preprocessCppConvertElseIfToPlainElse(std::string& progr
          }
 
          if (has_elseif_bracket) {
-            end_else_if_blocks = findMatchingEndTagLevelwise(after_if_else, dummy, "(", ")", { "\"" }, { "\"" });
+            end_else_if_blocks = findMatchingEndTagLevelwise(round_index, dummy);
          }
          else {
-            end_else_if_blocks = findMatchingEndTagLevelwise(after_if_else, opening_brace_pos, "{", "}", { "\"" }, { "\"" });
+            end_else_if_blocks = findMatchingEndTagLevelwise(curly_index, opening_brace_pos);
             temp = end_else_if_blocks + 1;
          }
 
@@ -2757,12 +2860,9 @@ void vfm::StaticHelper::preprocessCppConvertElseIfToPlainElse(std::string& progr
 
 void vfm::StaticHelper::preprocessCppConvertAllSwitchsToIfs(std::string& program)
 {
+   const BracketIndex index{ program, { "{", "\"" }, { "}", "\"" } };
    int begin_switch = indexOfFirstInnermostBeginBracket(
-      program, 
-      "{", 
-      "}", 
-      { "\"" }, 
-      { "\"" }, 
+      index, 
       [](const std::string& str, const int index) {
          int dummy_ind = index;
          auto tokens = tokenize(str, *SingletonFormulaParser::getLightInstance(), dummy_ind, 5, true);
@@ -2770,7 +2870,8 @@ void vfm::StaticHelper::preprocessCppConvertAllSwitchsToIfs(std::string& program
       });
 
    if (begin_switch >= 0) {
-      int end_switch = findMatchingEndTagLevelwise(program, begin_switch, "{", "}", { "\"" }, { "\"" });
+      int dummy = begin_switch;
+      int end_switch = findMatchingEndTagLevelwise(index, dummy);
 
       while (program[begin_switch] != '(') begin_switch--;
       while (program[begin_switch] != 's') begin_switch--;
@@ -3100,8 +3201,10 @@ SwitchBlock vfm::StaticHelper::extractCases(const std::string& switch_block_chun
 {
    std::string new_switch_block_chunk;
    int last_begin = 0;
+   const BracketIndex index{ switch_block_chunk, { "{", "\"" }, { "}", "\"" } };
    int index_beg = switch_block_chunk.find("{", switch_block_chunk.find("case", switch_block_chunk.find("{", switch_block_chunk.find("switch")))); // First case inner part of first switch.
-   int index_end = findMatchingEndTagLevelwise(switch_block_chunk, index_beg, "{", "}", { "\"" }, { "\"" });
+   int dummy = index_beg;
+   int index_end = findMatchingEndTagLevelwise(index, dummy);
 
    while (index_beg >= 0 && index_end >= 0) {
       auto before_str = switch_block_chunk.substr(last_begin, index_beg);
@@ -3115,7 +3218,8 @@ SwitchBlock vfm::StaticHelper::extractCases(const std::string& switch_block_chun
 
       last_begin = index_beg;
       index_beg = switch_block_chunk.find("{", switch_block_chunk.find("case", index_end));
-      index_end = findMatchingEndTagLevelwise(switch_block_chunk, index_beg, "{", "}", { "\"" }, { "\"" });
+      dummy = index_beg;
+      index_end = findMatchingEndTagLevelwise(index, dummy);
    }
 
    auto tokens = getChunkTokens(new_switch_block_chunk, AkaTalProcessing::none);
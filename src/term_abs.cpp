@@ -6,6 +6,7 @@
 /// @file
 
 #include "term_abs.h"
+#include "output_sink.h"
 #include "meta_rule.h"
 #include "parser.h"
 
@@ -60,12 +61,14 @@ std::set<MetaRule> vfm::TermAbs::getSimplificationRules(const std::shared_ptr<Fo
    return vec;
 }
 
-std::string vfm::TermAbs::serializeK2(const std::map<std::string, std::string>& enum_values, std::pair<std::map<std::string, std::string>, std::string>& additional_functions, int& label_counter) const
+void vfm::TermAbs::serializeK2(OutputSink& out, const std::map<std::string, std::string>& enum_values, std::pair<std::map<std::string, std::string>, std::string>& additional_functions, int& label_counter) const
 {
    // (abs a) becomes (ite (ge a (const 0 int)) a (neg a))
-   auto greq_part = _greq_plain(child0(), _val0())->serializeK2(enum_values, additional_functions, label_counter);
-   auto pos_a = child0()->serializeK2(enum_values, additional_functions, label_counter);
-   auto neg_a = _neg_plain(child0())->serializeK2(enum_values, additional_functions, label_counter);
-
-   return "(ite " + greq_part + " " + pos_a + " " + neg_a + ")";
+   out << "(ite ";
+   _greq_plain(child0(), _val0())->serializeK2(out, enum_values, additional_functions, label_counter);
+   out << " ";
+   child0()->serializeK2(out, enum_values, additional_functions, label_counter);
+   out << " ";
+   _neg_plain(child0())->serializeK2(out, enum_values, additional_functions, label_counter);
+   out << ")";
 }
@@ -9,6 +9,7 @@
 // #define PRINT_ADDRESSES_IN_GRAPHVIZ // (Un-)comment to add/remove addresses from graph view.
 
 #include "term_compound.h"
+#include "output_sink.h"
 
 using namespace vfm;
 
@@ -298,91 +299,108 @@ std::string vfm::TermCompound::getK2Operator() const
    return MathStruct::getK2Operator();
 }
 
-std::string vfm::TermCompound::serializeK2(const std::map<std::string, std::string>& enum_values, std::pair<std::map<std::string, std::string>, std::string>& additional_functions, int& label_counter) const
+void vfm::TermCompound::serializeK2(OutputSink& out, const std::map<std::string, std::string>& enum_values, std::pair<std::map<std::string, std::string>, std::string>& additional_functions, int& label_counter) const
 {
-   std::string s{};
    auto dummy_this{ const_cast<TermCompound*>(this) };
 
    if (getCompoundOperator()->getOptor() == SYMB_IF_ELSE || getCompoundOperator()->getOptor() == SYMB_IF) {
       const int my_label{ label_counter++ };
 
-      s += StaticHelper::makeString(OPENING_BRACKET)
-         + "condjump " + _not_plain(dummy_this->getCompoundOperator()->child0())->serializeK2(enum_values, additional_functions, label_counter) + " "
-         + StaticHelper::makeString(OPENING_BRACKET)
-         + "label else" + std::to_string(my_label)
-         + StaticHelper::makeString(CLOSING_BRACKET)
-         + StaticHelper::makeString(CLOSING_BRACKET) + "\n";
-
-      s += dummy_this->getCompoundOperator()->child1()->serializeK2(enum_values, additional_functions, label_counter) + "\n";
-      s += StaticHelper::makeString(OPENING_BRACKET)
-         + "jump "
-         + StaticHelper::makeString(OPENING_BRACKET)
-         + "label endif" + std::to_string(my_label)
-         + StaticHelper::makeString(CLOSING_BRACKET)
-         + StaticHelper::makeString(CLOSING_BRACKET) + "\n";
-
-      s += StaticHelper::makeString(OPENING_BRACKET)
-         + "label else" + std::to_string(my_label)
-         + StaticHelper::makeString(CLOSING_BRACKET) + "\n";
+      out << StaticHelper::makeString(OPENING_BRACKET) << "condjump ";
+      _not_plain(dummy_this->getCompoundOperator()->child0())->serializeK2(out, enum_values, additional_functions, label_counter);
+      out << " "
+         << StaticHelper::makeString(OPENING_BRACKET)
+         << "label else" + std::to_string(my_label)
+         << StaticHelper::makeString(CLOSING_BRACKET)
+         << StaticHelper::makeString(CLOSING_BRACKET) << "\n";
+
+      dummy_this->getCompoundOperator()->child1()->serializeK2(out, enum_values, additional_functions, label_counter);
+      out << "\n";
+      out << StaticHelper::makeString(OPENING_BRACKET)
+         << "jump "
+         << StaticHelper::makeString(OPENING_BRACKET)
+         << "label endif" + std::to_string(my_label)
+         << StaticHelper::makeString(CLOSING_BRACKET)
+         << StaticHelper::makeString(CLOSING_BRACKET) << "\n";
+
+      out << StaticHelper::makeString(OPENING_BRACKET)
+         << "label else" + std::to_string(my_label)
+         << StaticHelper::makeString(CLOSING_BRACKET) << "\n";
 
       if (getCompoundOperator()->getOptor() == SYMB_IF_ELSE) {
-         s += dummy_this->getCompoundOperator()->child2()->serializeK2(enum_values, additional_functions, label_counter) + "\n";
+         dummy_this->getCompoundOperator()->child2()->serializeK2(out, enum_values, additional_functions, label_counter);
+         out << "\n";
       }
 
-      s += StaticHelper::makeString(OPENING_BRACKET)
-         + "label endif" + std::to_string(my_label)
-         + StaticHelper::makeString(CLOSING_BRACKET);
+      out << StaticHelper::makeString(OPENING_BRACKET)
+         << "label endif" + std::to_string(my_label)
+         << StaticHelper::makeString(CLOSING_BRACKET);
    }
    else if (getCompoundOperator()->getOptor() == SYMB_WHILE) {
       const int my_label = label_counter++;
 
-      s += StaticHelper::makeString(OPENING_BRACKET)
-         + "label while" + std::to_string(my_label)
-         + StaticHelper::makeString(CLOSING_BRACKET) + "\n";
-
-      s += dummy_this->getCompoundOperator()->child1()->serializeK2(enum_values, additional_functions, label_counter) + "\n";
-
-      s += dummy_this->getCompoundOperator()->child0()->isAlwaysTrue()
-         ? StaticHelper::makeString(OPENING_BRACKET)
-         + "jump "
-         + StaticHelper::makeString(OPENING_BRACKET)
-         + "label while" + std::to_string(my_label)
-         + StaticHelper::makeString(CLOSING_BRACKET)
-         + StaticHelper::makeString(CLOSING_BRACKET) + "\n"
-         : StaticHelper::makeString(OPENING_BRACKET)
-         + "condjump " + dummy_this->getCompoundOperator()->child0()->serializeK2(enum_values, additional_functions, label_counter) + " "
-         + StaticHelper::makeString(OPENING_BRACKET)
-         + "label while" + std::to_string(my_label)
-         + StaticHelper::makeString(CLOSING_BRACKET)
-         + StaticHelper::makeString(CLOSING_BRACKET) + "\n";
+      out << StaticHelper::makeString(OPENING_BRACKET)
+         << "label while" + std::to_string(my_label)
+         << StaticHelper::makeString(CLOSING_BRACKET) << "\n";
+
+      dummy_this->getCompoundOperator()->child1()->serializeK2(out, enum_values, additional_functions, label_counter);
+      out << "\n";
+
+      if (dummy_this->getCompoundOperator()->child0()->isAlwaysTrue()) {
+         out << StaticHelper::makeString(OPENING_BRACKET) << "jump ";
+      }
+      else {
+         out << StaticHelper::makeString(OPENING_BRACKET) << "condjump ";
+         dummy_this->getCompoundOperator()->child0()->serializeK2(out, enum_values, additional_functions, label_counter);
+         out << " ";
+      }
+
+      out << StaticHelper::makeString(OPENING_BRACKET)
+         << "label while" + std::to_string(my_label)
+         << StaticHelper::makeString(CLOSING_BRACKET)
+         << StaticHelper::makeString(CLOSING_BRACKET) << "\n";
    }
    else if (getCompoundOperator()->getOptor() == SYMB_SEQUENCE) {
-      std::string elements{};
+      std::vector<StringSink> elements{}; // From last to first, which is the order the labels are numbered in.
       auto ptr{ shared_from_this() };
 
       while (ptr->getOptorJumpIntoCompound() == SYMB_SEQUENCE) {
-         elements = ptr->child1JumpIntoCompounds()->serializeK2(enum_values, additional_functions, label_counter) + "\n" + elements;
+         elements.emplace_back();
+         ptr->child1JumpIntoCompounds()->serializeK2(elements.back(), enum_values, additional_functions, label_counter);
          ptr = ptr->child0JumpIntoCompounds();
       }
 
-      elements = ptr->serializeK2(enum_values, additional_functions, label_counter) + "\n" + elements;
+      elements.emplace_back();
+      ptr->serializeK2(elements.back(), enum_values, additional_functions, label_counter);
 
-      s = StaticHelper::makeString(OPENING_BRACKET) + "seq\n" + elements + StaticHelper::makeString(CLOSING_BRACKET);
+      out << StaticHelper::makeString(OPENING_BRACKET) << "seq\n";
+
+      for (auto it = elements.rbegin(); it != elements.rend(); it++) {
+         out << it->str() << "\n";
+      }
+
+      out << StaticHelper::makeString(CLOSING_BRACKET);
    }
    else if (getCompoundOperator()->getOptor() == SYMB_NEG_ALT) {
-      s += StaticHelper::makeString(OPENING_BRACKET) + "neg " + dummy_this->getCompoundOperator()->child0()->serializeK2(enum_values, additional_functions, label_counter) + StaticHelper::makeString(CLOSING_BRACKET);
+      out << StaticHelper::makeString(OPENING_BRACKET) << "neg ";
+      dummy_this->getCompoundOperator()->child0()->serializeK2(out, enum_values, additional_functions, label_counter);
+      out << StaticHelper::makeString(CLOSING_BRACKET);
    }
    else if (getCompoundOperator()->getOptor() == SYMB_NOT) {
-      s += StaticHelper::makeString(OPENING_BRACKET) + "not " + dummy_this->getCompoundOperator()->child0()->serializeK2(enum_values, additional_functions, label_counter) + StaticHelper::makeString(CLOSING_BRACKET);
+      out << StaticHelper::makeString(OPENING_BRACKET) << "not ";
+      dummy_this->getCompoundOperator()->child0()->serializeK2(out, enum_values, additional_functions, label_counter);
+      out << StaticHelper::makeString(CLOSING_BRACKET);
    }
    else if (getCompoundOperator()->getOptor() == SYMB_SET_VAR_A && dummy_this->getCompoundOperator()->child1JumpIntoCompounds()->getOptorJumpIntoCompound() == "rndet") {
       // (call rndet (const 0 int) (const 6 int) veh___619___.a)
 
-      auto first { dummy_this->getCompoundOperator()->child1JumpIntoCompounds()->child0()->child0()->serializeK2(enum_values, additional_functions, label_counter) };
-      auto second{ dummy_this->getCompoundOperator()->child1JumpIntoCompounds()->child0()->child1()->serializeK2(enum_values, additional_functions, label_counter) };
-      auto third { dummy_this->getCompoundOperator()->child0JumpIntoCompounds()->serializeK2(enum_values, additional_functions, label_counter) };
-
-      s += StaticHelper::makeString(OPENING_BRACKET) + "call rndet " + first + " " + second + " " + third + StaticHelper::makeString(CLOSING_BRACKET);
+      out << StaticHelper::makeString(OPENING_BRACKET) << "call rndet ";
+      dummy_this->getCompoundOperator()->child1JumpIntoCompounds()->child0()->child0()->serializeK2(out, enum_values, additional_functions, label_counter);
+      out << " ";
+      dummy_this->getCompoundOperator()->child1JumpIntoCompounds()->child0()->child1()->serializeK2(out, enum_values, additional_functions, label_counter);
+      out << " ";
+      dummy_this->getCompoundOperator()->child0JumpIntoCompounds()->serializeK2(out, enum_values, additional_functions, label_counter);
+      out << StaticHelper::makeString(CLOSING_BRACKET);
    }
    else if (getCompoundOperator()->getOptor() == SYMB_SET_VAR_A && dummy_this->getCompoundOperator()->child1()->getOptorJumpIntoCompound() == "ndet") {
       auto choices{ dummy_this->getCompoundOperator()->child1()->getTermsJumpIntoCompounds() };
@@ -420,22 +438,23 @@ std::string vfm::TermCompound::serializeK2(const std::map<std::string, std::stri
          }
       }
 
-      s += StaticHelper::makeString(OPENING_BRACKET) + "call " + function_name;
+      out << StaticHelper::makeString(OPENING_BRACKET) << "call " << function_name;
 
       for (const auto& choice : choices) {
-         s += " " + choice->serializeK2(enum_values, additional_functions, label_counter);
+         out << " ";
+         choice->serializeK2(out, enum_values, additional_functions, label_counter);
       }
 
-      s += " " + dummy_this->getCompoundOperator()->child0()->serializeK2(enum_values, additional_functions, label_counter) + StaticHelper::makeString(CLOSING_BRACKET);
+      out << " ";
+      dummy_this->getCompoundOperator()->child0()->serializeK2(out, enum_values, additional_functions, label_counter);
+      out << StaticHelper::makeString(CLOSING_BRACKET);
    }
    else if (getCompoundOperator()->getOptor() == "std::abs") { // TODO magic string!
-      s = _abs_plain(getCompoundOperator()->child0())->serializeK2(enum_values, additional_functions, label_counter);
+      _abs_plain(getCompoundOperator()->child0())->serializeK2(out, enum_values, additional_functions, label_counter);
    }
    else {
-      s = MathStruct::serializeK2(enum_values, additional_functions, label_counter);
+      MathStruct::serializeK2(out, enum_values, additional_functions, label_counter);
    }
-
-   return s;
 }
 
 bool TermCompound::isTermSequence() const {
@@ -119,6 +119,7 @@ std::string vfm::TermGetArr::getArrName(const std::shared_ptr<DataPack> d, const
 void vfm::TermGetArr::changeArrToSet(const std::string& var_name, const std::shared_ptr<DataPack> d)
 {
    getOperands()[0] = _val(d->getAddressOf(var_name));
+   invalidateAttributes();
 }
 
 std::shared_ptr<Term> TermGetArr::getArrAddress(const std::string& var_name, const std::shared_ptr<DataPack> d)
@@ -6,6 +6,7 @@
 /// @file
 
 #include "term_logic_eq.h"
+#include "output_sink.h"
 #include "meta_rule.h"
 #include "parser.h"
 #include <functional>
@@ -73,18 +74,20 @@ std::string vfm::TermLogicEq::getK2Operator() const
    return "eq";
 }
 
-std::string vfm::TermLogicEq::serializeK2(const std::map<std::string, std::string>& enum_values, std::pair<std::map<std::string, std::string>, std::string>& additional_functions, int& label_counter) const
+void vfm::TermLogicEq::serializeK2(OutputSink& out, const std::map<std::string, std::string>& enum_values, std::pair<std::map<std::string, std::string>, std::string>& additional_functions, int& label_counter) const
 {
    // TODO: Revert back to plain rem, once native operation available in Kratos.
 
    if (child0()->getOptor() == SYMB_MOD) {
       if (child1()->isAlwaysFalse()) {
-         return _or(_eq(child0()->child0(), _val(0)), _or(_eq(child0()->child0(), _val(2)), _eq(child0()->child0(), _val(4))))->serializeK2(enum_values, additional_functions, label_counter);
+         _or(_eq(child0()->child0(), _val(0)), _or(_eq(child0()->child0(), _val(2)), _eq(child0()->child0(), _val(4))))->serializeK2(out, enum_values, additional_functions, label_counter);
       }
       else {
-         return _or(_eq(child0()->child0(), _val(1)), _eq(child0()->child0(), _val(3)))->serializeK2(enum_values, additional_functions, label_counter);
+         _or(_eq(child0()->child0(), _val(1)), _eq(child0()->child0(), _val(3)))->serializeK2(out, enum_values, additional_functions, label_counter);
       }
+
+      return;
    }
 
-   return MathStruct::serializeK2(enum_values, additional_functions, label_counter);
+   MathStruct::serializeK2(out, enum_values, additional_functions, label_counter);
 }
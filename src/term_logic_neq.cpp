@@ -6,6 +6,7 @@
 /// @file
 
 #include "term_logic_neq.h"
+#include "output_sink.h"
 #include "meta_rule.h"
 #include "parser.h"
 #include <functional>
@@ -39,9 +40,9 @@ std::shared_ptr<x86::Xmm> TermLogicNeq::createSubAssembly(asmjit::x86::Compiler&
 }
 #endif
 
-std::string vfm::TermLogicNeq::serializeK2(const std::map<std::string, std::string>& enum_values, std::pair<std::map<std::string, std::string>, std::string>& additional_functions, int& label_counter) const
+void vfm::TermLogicNeq::serializeK2(OutputSink& out, const std::map<std::string, std::string>& enum_values, std::pair<std::map<std::string, std::string>, std::string>& additional_functions, int& label_counter) const
 {
-   return _not_plain(_eq_plain(child0(), child1()))->serializeK2(enum_values, additional_functions, label_counter);
+   _not_plain(_eq_plain(child0(), child1()))->serializeK2(out, enum_values, additional_functions, label_counter);
 }
 
 TermLogicNeq::TermLogicNeq(const std::vector<std::shared_ptr<Term>>& opds) : TermLogic(opds)
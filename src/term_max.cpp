@@ -6,6 +6,7 @@
 /// @file
 
 #include "term_max.h"
+#include "output_sink.h"
 #include "meta_rule.h"
 #include "parser.h"
 #include <cmath>
@@ -50,14 +51,16 @@ std::shared_ptr<x86::Xmm> TermMax::createSubAssembly(asmjit::x86::Compiler & cc,
 }
 #endif
 
-std::string vfm::TermMax::serializeK2(const std::map<std::string, std::string>& enum_values, std::pair<std::map<std::string, std::string>, std::string>& additional_functions, int& label_counter) const
+void vfm::TermMax::serializeK2(OutputSink& out, const std::map<std::string, std::string>& enum_values, std::pair<std::map<std::string, std::string>, std::string>& additional_functions, int& label_counter) const
 {
    // (max a b) becomes (ite (ge a b) a b)
-   auto greq_part = _greq_plain(child0(), child1())->serializeK2(enum_values, additional_functions, label_counter);
-   auto alt1 = child0()->serializeK2(enum_values, additional_functions, label_counter);
-   auto alt2 = child1()->serializeK2(enum_values, additional_functions, label_counter);
-
-   return "(ite " + greq_part + " " + alt1 + " " + alt2 + ")";
+   out << "(ite ";
+   _greq_plain(child0(), child1())->serializeK2(out, enum_values, additional_functions, label_counter);
+   out << " ";
+   child0()->serializeK2(out, enum_values, additional_functions, label_counter);
+   out << " ";
+   child1()->serializeK2(out, enum_values, additional_functions, label_counter);
+   out << ")";
 }
 
 std::shared_ptr<Term> TermMax::copy(const std::shared_ptr<std::map<std::shared_ptr<Term>, std::shared_ptr<Term>>> already_copied) {
@@ -6,6 +6,7 @@
 /// @file
 
 #include "term_min.h"
+#include "output_sink.h"
 #include "meta_rule.h"
 #include "parser.h"
 #include <cmath>
@@ -65,12 +66,14 @@ std::set<MetaRule> vfm::TermMin::getSimplificationRules(const std::shared_ptr<Fo
    return vec;
 }
 
-std::string vfm::TermMin::serializeK2(const std::map<std::string, std::string>& enum_values, std::pair<std::map<std::string, std::string>, std::string>& additional_functions, int& label_counter) const
+void vfm::TermMin::serializeK2(OutputSink& out, const std::map<std::string, std::string>& enum_values, std::pair<std::map<std::string, std::string>, std::string>& additional_functions, int& label_counter) const
 {
    // (min a b) becomes (ite (le a b) a b)
-   auto smeq_part = _smeq_plain(child0(), child1())->serializeK2(enum_values, additional_functions, label_counter);
-   auto alt1 = child0()->serializeK2(enum_values, additional_functions, label_counter);
-   auto alt2 = child1()->serializeK2(enum_values, additional_functions, label_counter);
-
-   return "(ite " + smeq_part + " " + alt1 + " " + alt2 + ")";
+   out << "(ite ";
+   _smeq_plain(child0(), child1())->serializeK2(out, enum_values, additional_functions, label_counter);
+   out << " ";
+   child0()->serializeK2(out, enum_values, additional_functions, label_counter);
+   out << " ";
+   child1()->serializeK2(out, enum_values, additional_functions, label_counter);
+   out << ")";
 }
@@ -29,8 +29,8 @@ float TermPrint::eval(const std::shared_ptr<DataPack>& varVals, const std::share
 
    if (len >= 0) {
       for (int i = beg; i < beg + len; i++) {
-         auto val = varVals->getVfmMemory();
-         std::cout << (char) val.at(i);
+         const auto& val = varVals->getVfmMemory();
+         std::cout << (char) val.get(i);
       }
    }
    else {
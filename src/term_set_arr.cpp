@@ -82,6 +82,7 @@ std::string vfm::TermSetArr::getArrName(const std::shared_ptr<DataPack> d, const
 void vfm::TermSetArr::changeArrToSet(const std::string& var_name, const std::shared_ptr<DataPack> d)
 {
    getOperands()[0] = _val(d->getAddressOf(var_name));
+   invalidateAttributes();
 }
 
 std::shared_ptr<Term> TermSetArr::getArrAddress(const std::string& var_name, const std::shared_ptr<DataPack> d)
@@ -95,6 +95,7 @@ std::string vfm::TermSetVar::getVarName(const std::shared_ptr<DataPack> d, const
 void vfm::TermSetVar::changeVarToSet(const std::string& var_name, const std::shared_ptr<DataPack> d)
 {
    getOperands()[0] = _val(d->getAddressOf(var_name));
+   invalidateAttributes();
 }
 
 std::shared_ptr<Term> TermSetVar::getVarAddress(const std::string& var_name, const std::shared_ptr<DataPack> d)
@@ -6,6 +6,7 @@
 /// @file
 
 #include "term_val.h"
+#include "output_sink.h"
 #include "term_neg.h"
 #include "static_helper.h"
 #include "parser.h"
@@ -158,7 +159,7 @@ std::shared_ptr<Term> TermVal::copy(const std::shared_ptr<std::map<std::shared_p
    return std::shared_ptr<Term> (new TermVal(this->val_));
 }
 
-std::string vfm::TermVal::serializeK2(const std::map<std::string, std::string>& enum_values, std::pair<std::map<std::string, std::string>, std::string>& additional_functions, int& label_counter) const
+void vfm::TermVal::serializeK2(OutputSink& out, const std::map<std::string, std::string>& enum_values, std::pair<std::map<std::string, std::string>, std::string>& additional_functions, int& label_counter) const
 {
-   return StaticHelper::makeString(OPENING_BRACKET) + "const " + std::to_string((int) val_) + " int" + StaticHelper::makeString(CLOSING_BRACKET);
+   out << StaticHelper::makeString(OPENING_BRACKET) << "const " << std::to_string((int) val_) << " int" << StaticHelper::makeString(CLOSING_BRACKET);
 }
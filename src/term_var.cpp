@@ -6,6 +6,7 @@
 /// @file
 
 #include "term_var.h"
+#include "output_sink.h"
 #include "static_helper.h"
 #include "math_struct.h"
 #include "parser.h"
@@ -240,12 +241,14 @@ void vfm::TermVar::setConstVariable(const float val)
 {
    constant_ = true;
    constant_value_ = val;
+   invalidateAttributes();
 }
 
 void vfm::TermVar::makeNonConst()
 {
    constant_ = false;
    constant_value_ = std::numeric_limits<float>::min();
+   invalidateAttributes();
 }
 
 bool vfm::TermVar::isConstVariable() const
@@ -253,9 +256,9 @@ bool vfm::TermVar::isConstVariable() const
    return constant_;
 }
 
-std::string vfm::TermVar::serializeK2(const std::map<std::string, std::string>& enum_values, std::pair<std::map<std::string, std::string>, std::string>& additional_functions, int& label_counter) const
+void vfm::TermVar::serializeK2(OutputSink& out, const std::map<std::string, std::string>& enum_values, std::pair<std::map<std::string, std::string>, std::string>& additional_functions, int& label_counter) const
 {
    auto res = getVariableName();
    replacementsMC(res, true, enum_values);
-   return res;
+   out << res;
 }
@@ -392,14 +392,14 @@ bool vfm::mc::TypeAbstractionLayer::hasRange(const std::string& var_name) const
    return range.first <= range.second;
 }
 
-std::pair<float, float> vfm::mc::TypeAbstractionLayer::getRange(const std::string& var_name) const
+std::pair<float, float> vfm::mc::TypeAbstractionLayer::getRange(const std::string& var_name, const bool log_if_unavailable) const
 {
    float min = std::numeric_limits<float>::infinity();
    float max = -std::numeric_limits<float>::infinity();
 
    if (variable_mc_types_.count(var_name)) {
-      auto full_type = variable_mc_types_.at(var_name).first;
-      auto cpp_type = full_type.cpp_type_;
+      const auto& full_type = variable_mc_types_.at(var_name).first;
+      const auto& cpp_type = full_type.cpp_type_;
 
       if (cpp_type->toBoolIfApplicable()) {
          min = 0;
@@ -412,10 +412,10 @@ std::pair<float, float> vfm::mc::TypeAbstractionLayer::getRange(const std::strin
          }
       }
       else { // Assume integer type.
-         auto vec = getMCValues(full_type);
+         const auto& vec = full_type.mc_type_values_;
 
          if (vec.empty()) {
-            addDebug("Cannot derive range for '" + var_name + "' because it has no MCValues attached.");
+            if (log_if_unavailable) addDebug("Cannot derive range for '" + var_name + "' because it has no MCValues attached.");
             // Error case. Denoted by min > max in returned pair.
          } else {
             min = std::stof(vec.front());
@@ -423,7 +423,7 @@ std::pair<float, float> vfm::mc::TypeAbstractionLayer::getRange(const std::strin
          }
       }
    }
-   else {
+   else if (log_if_unavailable) {
       addDebug("Cannot derive range for '" + var_name + "' because it is missing in TAL.");
       // Error case. Denoted by min > max in returned pair.
    }
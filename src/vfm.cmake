@@ -82,6 +82,7 @@ SOURCES
    # asmjit/src/asmjit/x86/x86regalloc.cpp
    # asmjit/src/asmjit/x86/x86regalloc_p.h
    data_pack.cpp
+   vfm_heap.cpp
    dat_src_arr_as_float_vector.cpp
    dat_src_arr.cpp
    dat_src_arr_as_random_access_file.cpp
@@ -100,13 +101,21 @@ SOURCES
    fsm_resolver_remain_on_no_transition_and_obey_insertion_order.cpp
    fsm_resolver_default_max_trans_weight.cpp
    fsm_resolver_factory.cpp
+   fsm_graph_renderer.cpp
    math_struct.cpp
    meta_rule.cpp
+   meta_rule_index.cpp
    mc_types.cpp
    mc_workflow.cpp
+   mc_build_graph.cpp
+   output_sink.cpp
+   process_runner.cpp
+   mc_portfolio.cpp
    operator_structure.cpp
+   operator_registry.cpp
    parser.cpp
    failable.cpp
+   bracket_index.cpp
    static_helper.cpp
    term.cpp
    term_abs.cpp
@@ -145,6 +154,7 @@ SOURCES
    term_rand.cpp
    term_trunc.cpp
    term_val.cpp
+   compact_term.cpp
    term_var.cpp
    term_set_var.cpp
    term_get_arr.cpp
@@ -159,12 +169,17 @@ SOURCES
    term_fctin.cpp
    term_print.cpp
    term_id.cpp
+   glyph_atlas.cpp
    images.cpp
+   polygon_rasterizer.cpp
+   view_projection.cpp
    model_checker.cpp
    type_abstraction_layer.cpp
    cpp_type_struct.cpp
    cpp_type_atomic.cpp
    cpp_type_enum.cpp
+   cpp_lexer.cpp
+   interval_analysis.cpp
    cpp_parser.cpp
    earley_parser.cpp
    earley_edge.cpp
@@ -194,7 +209,9 @@ SOURCES
    interpreter_terminal.cpp
    custom_widgets.cpp
    road_graph.cpp
+   road_graph_index.cpp
    xml_generator.cpp
+   xml_writer.cpp
 haru/hpdf_3dmeasure.c
 haru/hpdf_annotation.c
 haru/hpdf_array.c
@@ -0,0 +1,126 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+
+#include "vfm_heap.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+using namespace vfm;
+
+static float* emptyPage()
+{
+   static const std::vector<float> EMPTY_PAGE(VfmHeap::PAGE_SIZE, VFM_HEAP_EMPTY_VALUE);
+   return const_cast<float*>(EMPTY_PAGE.data()); // Only ever read from.
+}
+
+VfmHeap::VfmHeap()
+   : page_table_(NUM_PAGES, emptyPage()), pages_(NUM_PAGES), pinned_(NUM_PAGES, false)
+{}
+
+VfmHeap::VfmHeap(const VfmHeap& other) : VfmHeap()
+{
+   *this = other;
+}
+
+VfmHeap& VfmHeap::operator=(const VfmHeap& other)
+{
+   if (this != &other) {
+      copyRangeFrom(other, size());
+   }
+
+   return *this;
+}
+
+float VfmHeap::get(const int address) const
+{
+   checkAddress(address);
+   return (*this)[address];
+}
+
+void VfmHeap::set(const int address, const float val)
+{
+   checkAddress(address);
+   writablePage(address >> PAGE_BITS)[address & PAGE_MASK] = val;
+}
+
+float* VfmHeap::getCellAddress(const int address)
+{
+   checkAddress(address);
+   float* page{ writablePage(address >> PAGE_BITS) };
+   pinned_[address >> PAGE_BITS] = true;
+   return page + (address & PAGE_MASK);
+}
+
+int VfmHeap::size() const
+{
+   return VFM_HEAP_SIZE;
+}
+
+bool VfmHeap::isPageLive(const int page_num) const
+{
+   return (bool) pages_.at(page_num);
+}
+
+int VfmHeap::getNumLivePages() const
+{
+   return std::count_if(pages_.begin(), pages_.end(), [](const std::shared_ptr<float[]>& page) { return (bool) page; });
+}
+
+bool VfmHeap::sharesPageWith(const VfmHeap& other, const int page_num) const
+{
+   return page_table_.at(page_num) == other.page_table_.at(page_num);
+}
+
+void VfmHeap::copyRangeFrom(const VfmHeap& other, const int end_exclusive)
+{
+   const int end{ std::min(end_exclusive, size()) };
+
+   for (int page_num = 0; page_num * PAGE_SIZE < end; page_num++) {
+      const int page_begin{ page_num * PAGE_SIZE };
+      const int page_end{ std::min(page_begin + PAGE_SIZE, size()) };
+
+      if (sharesPageWith(other, page_num)) continue;
+
+      // A pinned page can be written to from outside at any time, so it must neither be shared with nor
+      // replaced by another heap. Otherwise, whole pages are shared and un-shared on the next write.
+      if (page_end <= end && !pinned_[page_num] && !other.pinned_[page_num]) {
+         pages_[page_num] = other.pages_[page_num];
+         page_table_[page_num] = other.page_table_[page_num];
+      }
+      else {
+         copyIntoPage(other, page_num, page_begin, std::min(page_end, end));
+      }
+   }
+}
+
+void VfmHeap::checkAddress(const int address) const
+{
+   if (address < 0 || address >= size()) {
+      throw std::out_of_range("vfm heap address " + std::to_string(address) + " out of range [0, " + std::to_string(size()) + ").");
+   }
+}
+
+float* VfmHeap::writablePage(const int page_num)
+{
+   auto& page{ pages_[page_num] };
+
+   if (!page || page.use_count() > 1) {
+      std::shared_ptr<float[]> own_page{ new float[PAGE_SIZE] };
+      std::copy(page_table_[page_num], page_table_[page_num] + PAGE_SIZE, own_page.get());
+      page = own_page;
+      page_table_[page_num] = page.get();
+   }
+
+   return page_table_[page_num];
+}
+
+void VfmHeap::copyIntoPage(const VfmHeap& other, const int page_num, const int begin, const int end)
+{
+   const float* source{ other.page_table_[page_num] + (begin & PAGE_MASK) };
+   std::copy(source, source + (end - begin), writablePage(page_num) + (begin & PAGE_MASK));
+}
@@ -0,0 +1,141 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+
+#include "geometry/view_projection.h"
+#include <limits>
+
+using namespace vfm;
+
+void ViewProjection::update(const VisPerspective& perspective, const bool mirrored, const float width, const float height)
+{
+   if (valid_ && perspective_version_ == perspective.getVersion() && mirrored_ == mirrored && width_ == width && height_ == height) {
+      return;
+   }
+
+   valid_ = true;
+   perspective_version_ = perspective.getVersion();
+   mirrored_ = mirrored;
+   width_ = width;
+   height_ = height;
+
+   // Cf. https://en.wikipedia.org/w/index.php?title=3D_projection&oldid=1190317936#Mathematical_formula
+   // The camera sees the world point (x, y, z) as (z, +-y, x); the rotation rows below are the expanded formula.
+   const double sx{ perspective.getRotationCameraXSin() };
+   const double sy{ perspective.getRotationCameraYSin() };
+   const double sz{ perspective.getRotationCameraZSin() };
+   const double cx{ perspective.getRotationCameraXCos() };
+   const double cy{ perspective.getRotationCameraYCos() };
+   const double cz{ perspective.getRotationCameraZCos() };
+   const double camera[3]{ perspective.getCameraX(), perspective.getCameraY(), perspective.getCameraZ() };
+   const double rotation[3][3]{
+      { cy * cz,                cy * sz,                -sy },
+      { sx * sy * cz - cx * sz, sx * sy * sz + cx * cz, sx * cy },
+      { cx * sy * cz + sx * sz, cx * sy * sz - sx * cz, cx * cy } };
+
+   double view[3][4]{}; // World to camera coordinates.
+
+   for (int row = 0; row < 3; row++) {
+      const double* r{ rotation[row] };
+      view[row][0] = r[2];
+      view[row][1] = r[1] * (mirrored ? -1 : 1);
+      view[row][2] = r[0];
+      view[row][3] = -(r[0] * camera[0] + r[1] * camera[1] + r[2] * camera[2]);
+   }
+
+   const double ex{ perspective.getDisplayWindowX() };
+   const double ey{ perspective.getDisplayWindowY() };
+   const double ez{ perspective.getDisplayWindowZ() };
+   display_z_ = ez;
+
+   for (int col = 0; col < 4; col++) {
+      matrix_[col] = (ez * view[0][col] + ex * view[2][col]) * width;
+      matrix_[4 + col] = (ez * view[1][col] + ey * view[2][col]) * height;
+      matrix_[8 + col] = view[2][col];
+      matrix_[12 + col] = view[2][col];
+   }
+}
+
+Vec2D ViewProjection::project(const Vec3D& p) const
+{
+   const float* m{ matrix_.data() };
+   const float w{ m[12] * p.x + m[13] * p.y + m[14] * p.z + m[15] };
+
+   if (w < 0) { // Behind the camera. For polygons partially behind the camera use projectPolygon(...).
+      return { std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::quiet_NaN() };
+   }
+
+   return { (m[0] * p.x + m[1] * p.y + m[2] * p.z + m[3]) / w, (m[4] * p.x + m[5] * p.y + m[6] * p.z + m[7]) / w };
+}
+
+void ViewProjection::transformVertices(const std::vector<Vec3D>& points)
+{
+   const int n{ (int) points.size() };
+   xs_.resize(n);
+   ys_.resize(n);
+   ws_.resize(n);
+
+   const float* m{ matrix_.data() };
+   float* xs{ xs_.data() };
+   float* ys{ ys_.data() };
+   float* ws{ ws_.data() };
+   const Vec3D* ps{ points.data() };
+
+   for (int i = 0; i < n; i++) { // Kept free of branches and calls so it gets vectorized.
+      const float x{ ps[i].x };
+      const float y{ ps[i].y };
+      const float z{ ps[i].z };
+      xs[i] = m[0] * x + m[1] * y + m[2] * z + m[3];
+      ys[i] = m[4] * x + m[5] * y + m[6] * z + m[7];
+      ws[i] = m[12] * x + m[13] * y + m[14] * z + m[15];
+   }
+}
+
+Pol2D ViewProjection::projectPolygon(const Pol3D& pol)
+{
+   const int n{ (int) pol.points_.size() };
+   Pol2D result{};
+
+   if (n == 0) return result;
+
+   transformVertices(pol.points_);
+
+   int first{ 0 };
+
+   while (first < n && !(ws_[first] >= 0)) first++; // Start at the first point in front of the camera.
+
+   if (first == n) return result;
+
+   result.points_.reserve(n + 2);
+
+   const auto add_intersection = [this, &result](const int i, const int j) { // With the display plane.
+      const float t{ (display_z_ - ws_[i]) / (ws_[j] - ws_[i]) };
+      const float x{ xs_[i] + t * (xs_[j] - xs_[i]) };
+      const float y{ ys_[i] + t * (ys_[j] - ys_[i]) };
+      const float w{ ws_[i] + t * (ws_[j] - ws_[i]) };
+      result.add({ x / w, y / w });
+   };
+
+   int last{ (first + n - 1) % n };
+
+   for (int k = 0; k < n; k++) {
+      const int current{ (first + k) % n };
+      const bool current_visible{ ws_[current] > 0 };
+      const bool last_visible{ ws_[last] > 0 };
+
+      if (current_visible != last_visible) {
+         add_intersection(last, current);
+      }
+
+      if (current_visible) {
+         result.add({ xs_[current] / ws_[current], ys_[current] / ws_[current] });
+      }
+
+      last = current;
+   }
+
+   return result;
+}
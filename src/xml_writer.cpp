@@ -0,0 +1,159 @@
+//============================================================================================================
+// C O P Y R I G H T
+//------------------------------------------------------------------------------------------------------------
+/// \copyright (C) 2025 Robert Bosch GmbH. All rights reserved.
+//============================================================================================================
+/// @file
+
+#include "xml/xml_writer.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace vfm;
+using namespace xml;
+
+XmlWriter::XmlWriter(OutputSink& sink, const XmlFormat& format) : Failable("XmlWriter"), sink_(sink), format_(format)
+{}
+
+XmlWriter::~XmlWriter()
+{
+   if (!open_tags_.empty()) {
+      addWarning("XML output finished with " + std::to_string(open_tags_.size()) + " unclosed element(s), innermost is '" + open_tags_.back() + "'.");
+   }
+
+   sink_.flush();
+}
+
+XmlWriter& XmlWriter::declaration(const XmlAttributes& pars)
+{
+   writeIndentation();
+   sink_.write("<?xml", 5);
+   writeAttributes(pars);
+   sink_.write("?>", 2);
+   writeLineEnd();
+   return *this;
+}
+
+XmlWriter& XmlWriter::emptyElement(const std::string& tag, const XmlAttributes& pars)
+{
+   writeIndentation();
+   sink_.write("<", 1);
+   sink_.write(tag);
+   writeAttributes(pars);
+   sink_.write(format_.self_closing_end_);
+   writeLineEnd();
+   return *this;
+}
+
+XmlWriter& XmlWriter::textElement(const std::string& tag, const XmlAttributes& pars, const std::string& text)
+{
+   writeIndentation();
+   sink_.write("<", 1);
+   sink_.write(tag);
+   writeAttributes(pars);
+   sink_.write(">", 1);
+   writeEscaped(text);
+   sink_.write("</", 2);
+   sink_.write(tag);
+   sink_.write(">", 1);
+   writeLineEnd();
+   return *this;
+}
+
+XmlWriter& XmlWriter::startElement(const std::string& tag, const XmlAttributes& pars)
+{
+   writeIndentation();
+   sink_.write("<", 1);
+   sink_.write(tag);
+   writeAttributes(pars);
+   sink_.write(">", 1);
+   writeLineEnd();
+   open_tags_.push_back(tag);
+   return *this;
+}
+
+XmlWriter& XmlWriter::endElement()
+{
+   if (open_tags_.empty()) {
+      addError("No open element to close.");
+      return *this;
+   }
+
+   const std::string tag{ open_tags_.back() };
+   open_tags_.pop_back();
+   writeIndentation();
+   sink_.write("</", 2);
+   sink_.write(tag);
+   sink_.write(">", 1);
+   writeLineEnd();
+   return *this;
+}
+
+XmlWriter& XmlWriter::raw(const std::string& text)
+{
+   sink_.write(text);
+   return *this;
+}
+
+int XmlWriter::getDepth() const
+{
+   return open_tags_.size();
+}
+
+std::string XmlWriter::escape(const std::string& str)
+{
+   StringSink sink{};
+   XmlWriter writer{ sink };
+   writer.writeEscaped(str);
+   return sink.str();
+}
+
+void XmlWriter::writeIndentation()
+{
+   if (!format_.pretty_) return;
+
+   for (size_t i = 0; i < open_tags_.size(); i++) {
+      sink_.write(format_.indentation_);
+   }
+}
+
+void XmlWriter::writeLineEnd()
+{
+   if (format_.pretty_) sink_.write("\n", 1);
+}
+
+void XmlWriter::writeAttributes(const XmlAttributes& pars)
+{
+   for (const auto& [name, value] : pars) {
+      sink_.write(" ", 1);
+      sink_.write(name);
+      sink_.write("=\"", 2);
+      writeEscaped(value);
+      sink_.write("\"", 1);
+   }
+}
+
+void XmlWriter::writeEscaped(const std::string& str)
+{
+   size_t chunk_begin{ 0 };
+
+   // Write unproblematic stretches in one go.
+   for (size_t i = 0; i < str.size(); i++) {
+      const char* replacement{ nullptr };
+
+      switch (str[i]) {
+      case '&': replacement = "&amp;"; break;
+      case '<': replacement = "&lt;"; break;
+      case '>': replacement = "&gt;"; break;
+      case '"': replacement = "&quot;"; break;
+      case '\'': replacement = "&apos;"; break;
+      default: continue;
+      }
+
+      sink_.write(str.data() + chunk_begin, i - chunk_begin);
+      sink_.write(replacement, std::strlen(replacement));
+      chunk_begin = i + 1;
+   }
+
+   sink_.write(str.data() + chunk_begin, str.size() - chunk_begin);
+}